@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/scene/gl_pixel_buffer.h"
+#include "src/server/frontend_wayland/wlshmbuffer.h"
+
+#include "mir/anonymous_shm_file.h"
+#include "mir/renderer/gl/context.h"
+#include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_gl_buffer.h"
+
+#include <benchmark/benchmark.h>
+#include <wayland-client.h>
+
+#include <boost/throw_exception.hpp>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace geom = mir::geometry;
+namespace mf = mir::frontend;
+namespace ms = mir::scene;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+/* A wl_shm buffer created by an in-process client, for constructing WlShmBuffers from.
+ * Neither end runs its own event loop: pump() exchanges pending messages between them.
+ */
+class ShmBufferClient
+{
+public:
+    ShmBufferClient(int width, int height) :
+        server_display{wl_display_create()},
+        shm_file{static_cast<size_t>(width * height * 4)}
+    {
+        wl_display_init_shm(server_display);
+
+        int fds[2];
+        if (socketpair(AF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0)
+            BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create socket pair"}));
+
+        client = wl_client_create(server_display, fds[0]);
+        client_display = wl_display_connect_to_fd(fds[1]);
+
+        auto const registry = wl_display_get_registry(client_display);
+        wl_registry_add_listener(registry, &registry_listener, this);
+        pump();
+
+        if (!shm)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Server did not advertise wl_shm"});
+
+        auto const pool = wl_shm_create_pool(shm, shm_file.fd(), width * height * 4);
+        buffer = wl_shm_pool_create_buffer(pool, 0, width, height, width * 4, WL_SHM_FORMAT_ARGB8888);
+        wl_shm_pool_destroy(pool);
+        wl_registry_destroy(registry);
+        pump();
+
+        resource = wl_client_get_object(client, wl_proxy_get_id(reinterpret_cast<wl_proxy*>(buffer)));
+        if (!resource)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Server did not create the wl_buffer"});
+    }
+
+    ~ShmBufferClient()
+    {
+        wl_buffer_destroy(buffer);
+        wl_shm_destroy(shm);
+        pump();
+        wl_display_disconnect(client_display);
+        wl_display_destroy(server_display);
+    }
+
+    /// Delivers the client's requests to the server, and the server's events to the client
+    void pump()
+    {
+        wl_display_flush(client_display);
+        wl_event_loop_dispatch(wl_display_get_event_loop(server_display), 0);
+        wl_display_flush_clients(server_display);
+
+        while (wl_display_prepare_read(client_display) != 0)
+            wl_display_dispatch_pending(client_display);
+
+        pollfd readable{wl_display_get_fd(client_display), POLLIN, 0};
+        if (poll(&readable, 1, 0) > 0)
+            wl_display_read_events(client_display);
+        else
+            wl_display_cancel_read(client_display);
+
+        wl_display_dispatch_pending(client_display);
+    }
+
+    wl_resource* resource{nullptr};
+
+private:
+    static void new_global(void* data, wl_registry* registry, uint32_t id, char const* interface, uint32_t)
+    {
+        auto const self = static_cast<ShmBufferClient*>(data);
+        if (strcmp(interface, wl_shm_interface.name) == 0)
+            self->shm = static_cast<wl_shm*>(wl_registry_bind(registry, id, &wl_shm_interface, 1));
+    }
+
+    static void global_remove(void*, wl_registry*, uint32_t) {}
+
+    static wl_registry_listener const registry_listener;
+
+    wl_display* const server_display;
+    wl_client* client{nullptr};
+    wl_display* client_display{nullptr};
+    wl_shm* shm{nullptr};
+    wl_buffer* buffer{nullptr};
+    mir::AnonymousShmFile shm_file;
+};
+
+wl_registry_listener const ShmBufferClient::registry_listener{new_global, global_remove};
+
+// Each WlShmBuffer copies the client's pixels on construction, so cost scales with the area
+void wl_shm_buffer_from_wl_buffer(benchmark::State& state)
+{
+    ShmBufferClient client{static_cast<int>(state.range(0)), static_cast<int>(state.range(1))};
+
+    int released{0};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mf::WlShmBuffer::mir_buffer_from_wl_buffer(client.resource, []{}));
+
+        // Destroying the buffer queues a wl_buffer.release, so don't let those pile up
+        if (++released == 256)
+        {
+            state.PauseTiming();
+            client.pump();
+            released = 0;
+            state.ResumeTiming();
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1) * 4);
+}
+
+struct StubGLContext : mir::renderer::gl::Context
+{
+    void make_current() const override {}
+    void release_current() const override {}
+};
+
+/* There's no GPU here, so glReadPixels() is a MockGL no-op: this measures the CPU side of
+ * taking a screenshot, which flips the rows and (for RGBA) swizzles every pixel.
+ */
+void gl_pixel_buffer_as_argb_8888(benchmark::State& state)
+{
+    NiceMock<mtd::MockGL> mock_gl;
+    NiceMock<mtd::MockGLBuffer> buffer{
+        geom::Size{state.range(0), state.range(1)}, geom::Stride{state.range(0) * 4}, mir_pixel_format_argb_8888};
+
+    bool const read_as_rgba{state.range(2) != 0};
+    ON_CALL(mock_gl, glGetError()).WillByDefault(Return(read_as_rgba ? GL_INVALID_ENUM : GL_NO_ERROR));
+
+    ms::GLPixelBuffer pixels{std::make_unique<StubGLContext>()};
+
+    for (auto _ : state)
+    {
+        // Only the first as_argb_8888() after a fill_from() does any work
+        state.PauseTiming();
+        pixels.fill_from(buffer);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(pixels.as_argb_8888());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1) * 4);
+}
+}
+
+BENCHMARK(wl_shm_buffer_from_wl_buffer)->Args({64, 64})->Args({640, 480})->Args({1920, 1080});
+BENCHMARK(gl_pixel_buffer_as_argb_8888)
+    ->ArgNames({"width", "height", "rgba"})
+    ->Args({640, 480, 0})->Args({640, 480, 1})
+    ->Args({1920, 1080, 0})->Args({1920, 1080, 1});
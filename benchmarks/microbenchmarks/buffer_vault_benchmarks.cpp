@@ -0,0 +1,205 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/client/buffer_vault.h"
+#include "src/client/buffer_factory.h"
+#include "src/client/connection_surface_map.h"
+#include "mir/client/client_buffer_factory.h"
+#include "mir/mir_buffer.h"
+#include "mir/test/fake_shared.h"
+
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace geom = mir::geometry;
+namespace mcl = mir::client;
+namespace mt = mir::test;
+
+namespace
+{
+unsigned int const nbuffers = 3;
+geom::Size const buffer_size{640, 480};
+
+// A buffer that does nothing, so that only the vault's own costs are measured
+struct StubBuffer : mcl::MirBuffer
+{
+    StubBuffer(int id) : id{id} {}
+
+    int rpc_id() const override { return id; }
+    void submitted() override {}
+    void received() override {}
+    void received(MirBufferPackage const&) override {}
+    std::shared_ptr<mcl::ClientBuffer> client_buffer() const override { return nullptr; }
+    MirGraphicsRegion map_region() override { return MirGraphicsRegion{}; }
+    void unmap_region() override {}
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    MirBufferUsage buffer_usage() const override { return mir_buffer_usage_hardware; }
+#pragma GCC diagnostic pop
+    MirPixelFormat pixel_format() const override { return mir_pixel_format_abgr_8888; }
+    geom::Size size() const override { return buffer_size; }
+    MirConnection* allocating_connection() const override { return nullptr; }
+    void increment_age() override {}
+    bool valid() const override { return true; }
+    char const* error_message() const override { return ""; }
+    void set_callback(MirBufferCallback, void*) override {}
+
+    int const id;
+};
+
+struct StubClientBufferFactory : mcl::ClientBufferFactory
+{
+    std::shared_ptr<mcl::ClientBuffer> create_buffer(
+        std::shared_ptr<MirBufferPackage> const&, geom::Size, MirPixelFormat) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<mcl::ClientBuffer> create_buffer(
+        std::shared_ptr<MirBufferPackage> const&, unsigned int, unsigned int) override
+    {
+        return nullptr;
+    }
+};
+
+// Returns submitted buffers from another thread, as the RPC thread does
+struct ImmediatelyReturningServer : mcl::ServerBufferRequests
+{
+    ImmediatelyReturningServer() :
+        rpc_thread{[this] { run(); }}
+    {
+    }
+
+    ~ImmediatelyReturningServer()
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+        }
+        changed.notify_one();
+        if (rpc_thread.joinable())
+            rpc_thread.join();
+    }
+
+    void allocate_buffer(geom::Size, MirPixelFormat, int) override {}
+    void free_buffer(int) override {}
+
+    void submit_buffer(mcl::MirBuffer& buffer) override
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            submitted.push_back(buffer.rpc_id());
+        }
+        changed.notify_one();
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        while (!stopping)
+        {
+            if (submitted.empty())
+            {
+                changed.wait(lock);
+                continue;
+            }
+
+            auto const id = submitted.front();
+            submitted.pop_front();
+            lock.unlock();
+            vault->wire_transfer_inbound(id);
+            lock.lock();
+        }
+    }
+
+    mcl::BufferVault* vault{nullptr};
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<int> submitted;
+    bool stopping{false};
+    std::thread rpc_thread;
+};
+
+// A vault whose buffers are all back from the server
+struct ReadyVault
+{
+    ReadyVault()
+    {
+        for (auto id = 1u; id <= nbuffers; ++id)
+            surface_map->insert(id, std::make_shared<StubBuffer>(id));
+
+        server.vault = &vault;
+        for (auto id = 1u; id <= nbuffers; ++id)
+            vault.wire_transfer_inbound(id);
+    }
+
+    ~ReadyVault()
+    {
+        // The vault must outlive the RPC thread
+        server.stop();
+    }
+
+    template<typename Acquire>
+    void draw_frame(Acquire const& acquire)
+    {
+        auto const buffer = acquire();
+        vault.deposit(buffer);
+        vault.wire_transfer_outbound(buffer, []{});
+    }
+
+    StubClientBufferFactory platform_factory;
+    mcl::BufferFactory buffer_factory;
+    std::shared_ptr<mcl::ConnectionSurfaceMap> const surface_map{std::make_shared<mcl::ConnectionSurfaceMap>()};
+    ImmediatelyReturningServer server;
+    mcl::BufferVault vault{
+        mt::fake_shared(platform_factory), mt::fake_shared(buffer_factory),
+        mt::fake_shared(server), surface_map,
+        buffer_size, mir_pixel_format_abgr_8888, 0, nbuffers};
+};
+
+void buffer_vault_withdraw(benchmark::State& state)
+{
+    ReadyVault vault;
+
+    for (auto _ : state)
+        vault.draw_frame([&] { return vault.vault.withdraw().get(); });
+}
+
+void buffer_vault_try_withdraw(benchmark::State& state)
+{
+    ReadyVault vault;
+
+    for (auto _ : state)
+        vault.draw_frame([&]
+            {
+                if (auto buffer = vault.vault.try_withdraw())
+                    return buffer;
+                return vault.vault.withdraw().get();
+            });
+}
+}
+
+BENCHMARK(buffer_vault_withdraw)->UseRealTime();
+BENCHMARK(buffer_vault_try_withdraw)->UseRealTime();
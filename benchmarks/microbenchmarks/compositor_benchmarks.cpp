@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stub_surfaces.h"
+
+#include "src/server/compositor/occlusion.h"
+#include "src/server/scene/surface_stack.h"
+#include "src/server/report/null_report_factory.h"
+
+#include "mir/test/doubles/fake_renderable.h"
+#include "mir/test/doubles/stub_scene_element.h"
+
+#include <benchmark/benchmark.h>
+
+namespace mc = mir::compositor;
+namespace mr = mir::report;
+namespace ms = mir::scene;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+namespace
+{
+auto scene_elements(int count) -> mc::SceneElementSequence
+{
+    mc::SceneElementSequence elements;
+    for (int i = 0; i != count; ++i)
+    {
+        elements.push_back(std::make_shared<mtd::StubSceneElement>(
+            std::make_shared<mtd::FakeRenderable>(mt::cascaded_window(i))));
+    }
+    return elements;
+}
+
+void filter_occlusions_from(benchmark::State& state)
+{
+    auto const elements = scene_elements(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto visible = elements;
+        benchmark::DoNotOptimize(mc::filter_occlusions_from(visible, mt::output_area));
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+void scene_elements_for(benchmark::State& state)
+{
+    ms::SurfaceStack stack{mr::null_scene_report()};
+    auto const surfaces = mt::add_stub_surfaces(stack, state.range(0));
+
+    int const compositor{0};
+    stack.register_compositor(&compositor);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(stack.scene_elements_for(&compositor));
+    }
+
+    stack.unregister_compositor(&compositor);
+    state.SetComplexityN(state.range(0));
+}
+}
+
+BENCHMARK(filter_occlusions_from)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
+BENCHMARK(scene_elements_for)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/events/event_builders.h"
+#include "mir/events/event_private.h"
+
+#include <benchmark/benchmark.h>
+
+#include <linux/input.h>
+#include <xkbcommon/xkbcommon.h>
+
+namespace mev = mir::events;
+
+using namespace std::chrono;
+
+namespace
+{
+MirInputDeviceId const device_id{1};
+std::vector<uint8_t> const cookie(32, 0);
+
+auto a_pointer_event() -> mir::EventUPtr
+{
+    return mev::make_event(
+        device_id, nanoseconds{1}, cookie, mir_input_event_modifier_none,
+        mir_pointer_action_motion, mir_pointer_button_primary, 100, 200, 0, 0, 1, -1);
+}
+
+void make_key_event(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mev::make_event(
+            device_id, nanoseconds{1}, cookie, mir_keyboard_action_down, XKB_KEY_a, KEY_A,
+            mir_input_event_modifier_none));
+    }
+}
+
+void make_pointer_event(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a_pointer_event());
+    }
+}
+
+void clone_pointer_event(benchmark::State& state)
+{
+    auto const event = a_pointer_event();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mev::clone_event(*event));
+    }
+}
+
+void serialize_pointer_event(benchmark::State& state)
+{
+    auto const event = a_pointer_event();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(MirEvent::serialize(event.get()));
+    }
+}
+
+void serialize_pointer_event_into_buffer(benchmark::State& state)
+{
+    auto const event = a_pointer_event();
+    std::vector<char> buffer(MirEvent::serialized_size(event.get()));
+
+    for (auto _ : state)
+    {
+        MirEvent::serialize(event.get(), buffer.data(), buffer.size());
+        benchmark::ClobberMemory();
+    }
+}
+
+void deserialize_pointer_event(benchmark::State& state)
+{
+    auto const serialized = MirEvent::serialize(a_pointer_event().get());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(MirEvent::deserialize(serialized));
+    }
+}
+}
+
+BENCHMARK(make_key_event);
+BENCHMARK(make_pointer_event);
+BENCHMARK(clone_pointer_event);
+BENCHMARK(serialize_pointer_event);
+BENCHMARK(serialize_pointer_event_into_buffer);
+BENCHMARK(deserialize_pointer_event);
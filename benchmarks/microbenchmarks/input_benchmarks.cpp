@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stub_surfaces.h"
+
+#include "src/server/input/surface_input_dispatcher.h"
+#include "src/server/scene/surface_stack.h"
+#include "src/server/report/null_report_factory.h"
+
+#include "mir/events/event_builders.h"
+
+#include <benchmark/benchmark.h>
+
+namespace mev = mir::events;
+namespace mi = mir::input;
+namespace mr = mir::report;
+namespace ms = mir::scene;
+namespace mt = mir::test;
+
+using namespace std::chrono;
+
+namespace
+{
+MirInputDeviceId const pointer_id{1};
+
+auto pointer_motion_to(int x, int y) -> std::shared_ptr<MirEvent const>
+{
+    return mev::make_event(
+        pointer_id, steady_clock::now().time_since_epoch(), std::vector<uint8_t>{}, mir_input_event_modifier_none,
+        mir_pointer_action_motion, 0, x, y, 0, 0, 0, 0);
+}
+
+/* SurfaceInputDispatcher::find_target_surface() is private, so this measures it through
+ * dispatching pointer motion over a stack of surfaces: each event is hit-tested against
+ * the stack, and most move the pointer between surfaces.
+ */
+void dispatch_pointer_motion(benchmark::State& state)
+{
+    auto const stack = std::make_shared<ms::SurfaceStack>(mr::null_scene_report());
+    auto const surfaces = mt::add_stub_surfaces(*stack, state.range(0));
+
+    mi::SurfaceInputDispatcher dispatcher{stack};
+    dispatcher.start();
+
+    std::vector<std::shared_ptr<MirEvent const>> events;
+    for (int i = 0; i != 64; ++i)
+    {
+        auto const target = mt::cascaded_window(i * 7).top_left;
+        events.push_back(pointer_motion_to(target.x.as_int() + 10, target.y.as_int() + 10));
+    }
+
+    size_t next{0};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(dispatcher.dispatch(events[next]));
+        next = (next + 1) % events.size();
+    }
+
+    dispatcher.stop();
+    state.SetComplexityN(state.range(0));
+}
+}
+
+BENCHMARK(dispatch_pointer_motion)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_MICROBENCHMARKS_STUB_SURFACES_H_
+#define MIR_TEST_MICROBENCHMARKS_STUB_SURFACES_H_
+
+#include "src/server/scene/basic_surface.h"
+#include "src/server/report/null_report_factory.h"
+
+#include "mir/input/input_reception_mode.h"
+#include "mir/shell/surface_stack.h"
+#include "mir/test/doubles/stub_buffer_stream.h"
+
+#include <memory>
+#include <vector>
+
+namespace mir
+{
+namespace test
+{
+geometry::Rectangle const output_area{{0, 0}, {1920, 1080}};
+
+/// The i'th of a cascade of windows, each of which partly covers those below
+inline auto cascaded_window(int i) -> geometry::Rectangle
+{
+    return {{(i * 37) % 1600, (i * 23) % 840}, {320, 240}};
+}
+
+/// Adds count cascaded windows with stub buffer streams to the stack (bottom first)
+inline auto add_stub_surfaces(shell::SurfaceStack& stack, int count)
+    -> std::vector<std::shared_ptr<scene::BasicSurface>>
+{
+    std::vector<std::shared_ptr<scene::BasicSurface>> surfaces;
+    for (int i = 0; i != count; ++i)
+    {
+        auto const surface = std::make_shared<scene::BasicSurface>(
+            "stub surface",
+            cascaded_window(i),
+            mir_pointer_unconfined,
+            std::list<scene::StreamInfo>{{std::make_shared<doubles::StubBufferStream>(), {}, {}}},
+            std::shared_ptr<graphics::CursorImage>{},
+            report::null_scene_report());
+
+        stack.add_surface(surface, input::InputReceptionMode::normal);
+        surfaces.push_back(surface);
+    }
+    return surfaces;
+}
+}
+}
+
+#endif // MIR_TEST_MICROBENCHMARKS_STUB_SURFACES_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/recursive_read_write_mutex.h"
+#include "mir/thread/basic_thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+// Shared by the threads of each multi-threaded run
+mir::RecursiveReadWriteMutex contended_mutex;
+
+void recursive_read_lock(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        mir::RecursiveReadLock lock{contended_mutex};
+    }
+}
+
+void recursive_read_lock_nested(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        mir::RecursiveReadLock outer{contended_mutex};
+        mir::RecursiveReadLock inner{contended_mutex};
+    }
+}
+
+auto thread_index(benchmark::State const& state) -> int
+{
+#ifdef MIR_BENCHMARK_THREAD_INDEX_IS_A_MEMBER
+    return state.thread_index;
+#else
+    return state.thread_index();
+#endif
+}
+
+// The first thread writes, as the compositor does to the scene, while the others read
+void recursive_read_write_mix(benchmark::State& state)
+{
+    auto const writer = thread_index(state) == 0;
+
+    for (auto _ : state)
+    {
+        if (writer)
+        {
+            mir::RecursiveWriteLock lock{contended_mutex};
+        }
+        else
+        {
+            mir::RecursiveReadLock lock{contended_mutex};
+        }
+    }
+}
+
+void thread_pool_run(benchmark::State& state)
+{
+    mir::thread::BasicThreadPool pool{1};
+
+    for (auto _ : state)
+    {
+        pool.run([]{}).wait();
+    }
+}
+
+// Tasks with the same id always run on the same worker thread
+void thread_pool_run_by_id(benchmark::State& state)
+{
+    mir::thread::BasicThreadPool pool{1};
+    std::vector<int> ids(state.range(0));
+
+    size_t next{0};
+    for (auto _ : state)
+    {
+        pool.run([]{}, &ids[next]).wait();
+        next = (next + 1) % ids.size();
+    }
+}
+}
+
+BENCHMARK(recursive_read_lock)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(recursive_read_lock_nested)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(recursive_read_write_mix)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK(thread_pool_run)->UseRealTime();
+BENCHMARK(thread_pool_run_by_id)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
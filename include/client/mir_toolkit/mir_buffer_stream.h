@@ -22,6 +22,8 @@
 #include <mir_toolkit/client_types.h>
 #include <mir_toolkit/deprecations.h>
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 /**
  * \addtogroup mir_toolkit
@@ -279,6 +281,24 @@ int mir_buffer_stream_get_swapinterval(MirBufferStream* stream);
  */
 unsigned long mir_buffer_stream_get_microseconds_till_vblank(MirBufferStream const* stream);
 
+/**
+ * Query the time at which a frame submitted to the buffer stream now is
+ * expected to be presented on screen. Clients can use this to place
+ * animations where they will be when the user sees them, rather than where
+ * they were when rendering started.
+ *
+ * The prediction is phase-locked to the presentation feedback the stream
+ * gets from the server, so it becomes more accurate over the first few
+ * frames.
+ *
+ *   \param [in] stream   The buffer stream
+ *   \return              Predicted presentation time in nanoseconds of
+ *                        CLOCK_MONOTONIC. This is the current time if the
+ *                        stream is not synchronized to a display, and zero
+ *                        if the stream is not presented at all.
+ */
+int64_t mir_buffer_stream_get_predicted_present_time(MirBufferStream const* stream);
+
 /**
  * Set the physical size of the buffers provided by the buffer stream.
  *
@@ -127,6 +127,21 @@ public:
      */
     virtual bool apply_if_configuration_preserves_display_buffers(DisplayConfiguration const& conf) = 0;
 
+    /**
+     * Executes a functor for each output group that configure() would leave in place
+     * when applying \p conf.
+     *
+     * The groups (and their DisplayBuffers) remain valid, and may continue to be used,
+     * while \p conf is applied. By default no groups are preserved.
+     *
+     * \param conf [in] Configuration that may be applied next.
+     */
+    virtual void for_each_display_sync_group_preserved_by(
+        DisplayConfiguration const& /*conf*/,
+        std::function<void(DisplaySyncGroup&)> const& /*f*/)
+    {
+    }
+
     /**
      * Sets a new output configuration.
      */
@@ -34,6 +34,8 @@ struct InputDeviceInfo
     std::string name;
     std::string unique_id;
     DeviceCapabilities capabilities;
+    /// The seat the device belongs to (as udev's ID_SEAT)
+    std::string seat{"seat0"};
 };
 
 }
@@ -115,6 +115,9 @@ public:
 
     virtual void buffer_available(mir::protobuf::Buffer const& buffer) = 0;
     virtual void buffer_unavailable() = 0;
+
+    // CLOCK_MONOTONIC time at which a frame submitted now is expected to be presented
+    virtual std::chrono::nanoseconds predicted_present_time() const = 0;
 protected:
     MirBufferStream() = default;
     MirBufferStream(const MirBufferStream&) = delete;
@@ -19,8 +19,13 @@
 #ifndef MIR_COMPOSITOR_COMPOSITOR_H_
 #define MIR_COMPOSITOR_COMPOSITOR_H_
 
+#include "mir/raii.h"
+
+#include <functional>
+
 namespace mir
 {
+namespace graphics { class DisplayConfiguration; }
 namespace compositor
 {
 
@@ -32,6 +37,19 @@ public:
     virtual void start() = 0;
     virtual void stop() = 0;
 
+    /**
+     * Runs \p apply, which applies the display configuration \p conf, with
+     * compositing stopped.
+     *
+     * Implementations may continue compositing the outputs \p conf leaves
+     * unchanged. By default compositing is stopped on all outputs.
+     */
+    virtual void reconfigure(graphics::DisplayConfiguration const& /*conf*/, std::function<void()> const& apply)
+    {
+        auto const restart = raii::paired_calls([this] { stop(); }, [this] { start(); });
+        apply();
+    }
+
 protected:
     Compositor() = default;
     Compositor(Compositor const&) = delete;
@@ -20,6 +20,9 @@
 #define MIR_COMPOSITOR_COMPOSITOR_REPORT_H_
 
 #include "mir/graphics/renderable.h"
+#include "mir/graphics/buffer_id.h"
+
+#include <cstddef>
 
 namespace mir
 {
@@ -31,10 +34,26 @@ class CompositorReport
 public:
     typedef const void* SubCompositorId;  // e.g. thread/display buffer ID
     virtual void added_display(int width, int height, int x, int y, SubCompositorId id) = 0;
+    /// The scene is about to be snapshotted for the next frame of the display buffer
+    virtual void began_scene_snapshot(SubCompositorId id) = 0;
     virtual void began_frame(SubCompositorId id) = 0;
+    /// Number of scene elements found to be hidden by others in the frame
+    virtual void filtered_occlusions(SubCompositorId id, std::size_t occluded) = 0;
     virtual void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) = 0;
     virtual void rendered_frame(SubCompositorId id) = 0;
     virtual void finished_frame(SubCompositorId id) = 0;
+    /// The display buffer's finished frame has been posted to its output
+    virtual void posted_frame(SubCompositorId id) = 0;
+    /// A client has submitted a buffer for a stream
+    virtual void submitted_buffer(graphics::BufferID buffer) = 0;
+    /// Cumulative texture cache counters, reported once per rendered frame
+    virtual void texture_cache_usage(
+        SubCompositorId id,
+        std::size_t hits,
+        std::size_t misses,
+        std::size_t evictions,
+        std::size_t uploaded_bytes,
+        std::size_t resident_bytes) = 0;
     virtual void started() = 0;
     virtual void stopped() = 0;
     virtual void scheduled() = 0;
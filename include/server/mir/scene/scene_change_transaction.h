@@ -0,0 +1,50 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_SCENE_CHANGE_TRANSACTION_H_
+#define MIR_SCENE_SCENE_CHANGE_TRANSACTION_H_
+
+namespace mir
+{
+namespace scene
+{
+/// Groups the scene changes made by the calling thread so that observers see them together.
+///
+/// While a transaction is open, surface moves and resizes and changes to the stacking
+/// order are applied immediately, but their notifications are held back. When the
+/// outermost transaction is committed each changed surface reports its final position and
+/// size once, and each scene observer gets a single surfaces_reordered()/scene_changed().
+/// Transactions nest. An outermost transaction destroyed without being committed (e.g.
+/// by an exception) drops the notifications it held back.
+class SceneChangeTransaction
+{
+public:
+    SceneChangeTransaction();
+    ~SceneChangeTransaction();
+
+    /// Ends the transaction, notifying the observers if it is the outermost
+    void commit();
+
+    SceneChangeTransaction(SceneChangeTransaction const&) = delete;
+    SceneChangeTransaction& operator=(SceneChangeTransaction const&) = delete;
+
+private:
+    bool committed{false};
+};
+}
+}
+
+#endif /* MIR_SCENE_SCENE_CHANGE_TRANSACTION_H_ */
@@ -30,6 +30,8 @@ namespace mir { namespace geometry { struct Rectangle; }}
 
 namespace mir_test_framework
 {
+struct VirtualOutputs;
+
 /** Basic fixture for tests that don't use graphics or input hardware.
  *  This provides a mechanism for temporarily setting environment variables.
  *  It automatically sets "MIR_SERVER_PLATFORM_GRAPHICS_LIB" to "graphics-dummy.so"
@@ -48,6 +50,9 @@ public:
     /// Override initial display layout
     void initial_display_layout(std::vector<mir::geometry::Rectangle> const& display_rects);
 
+    /// Use "graphics-virtual.so", which simulates the timing of the given outputs, instead of "graphics-dummy.so"
+    void use_virtual_outputs(VirtualOutputs const& outputs);
+
 private:
     std::unique_ptr<mir::SharedLibrary> server_platform_graphics_lib;
 };
@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_FRAMEWORK_VIRTUAL_OUTPUT_PLATFORM_H_
+#define MIR_TEST_FRAMEWORK_VIRTUAL_OUTPUT_PLATFORM_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mir_test_framework
+{
+/** The outputs simulated by the "graphics-virtual.so" platform.
+ *  Each output presents frames on its own simulated vblank: a posted frame is
+ *  shown on the first vblank at least flip_latency later, with a presentation
+ *  time randomly offset by up to flip_jitter. The jitter is pseudo-random but
+ *  seeded per output, so a run is reproducible.
+ *  Reconfiguring takes modeset_time if any output is added, removed or changed;
+ *  outputs left unchanged keep presenting meanwhile.
+ */
+struct VirtualOutputs
+{
+    /// Comma separated output sizes ("1920x1080,1280x720"), placed left to right
+    std::string sizes{"1920x1080"};
+    double refresh_rate_hz{60.0};
+    std::chrono::microseconds flip_latency{0};
+    std::chrono::microseconds flip_jitter{0};
+    std::chrono::milliseconds modeset_time{0};
+};
+
+/// A frame presented on a virtual output
+struct VirtualOutputFrame
+{
+    unsigned int output_id;
+    int64_t msc;                                        ///< The vblank it was presented on
+    std::chrono::steady_clock::time_point posted;       ///< When the compositor posted it
+    std::chrono::steady_clock::time_point presented;    ///< When it was (notionally) on screen
+};
+
+/// Returns, and forgets, the frames presented on virtual outputs so far
+auto take_virtual_output_frames() -> std::vector<VirtualOutputFrame>;
+}
+
+#endif /* MIR_TEST_FRAMEWORK_VIRTUAL_OUTPUT_PLATFORM_H_ */
@@ -196,9 +196,19 @@ struct BufferDepository
 
         vault.deposit(c);
         auto wh = vault.wire_transfer_outbound(c, done);
-        auto f = vault.withdraw();
-        lk.lock();
-        future = std::move(f);
+
+        // Usually a buffer is already back from the server, and there's no need to wait
+        if (auto next = vault.try_withdraw())
+        {
+            lk.lock();
+            current = next;
+        }
+        else
+        {
+            auto f = vault.withdraw();
+            lk.lock();
+            future = std::move(f);
+        }
         return wh;
     }
 
@@ -316,6 +326,7 @@ mcl::BufferStream::BufferStream(
             map,
             ideal_buffer_size, static_cast<MirPixelFormat>(protobuf_bs->pixel_format()), 
             protobuf_bs->buffer_usage(), nbuffers);
+        buffer_depository->vault.set_presentation_observer([this] { buffer_presented(); });
 
         egl_native_window_ = client_platform->create_egl_native_window(this);
 
@@ -346,6 +357,8 @@ mcl::BufferStream::BufferStream(
 
 mcl::BufferStream::~BufferStream()
 {
+    // Ensure no presentation feedback arrives while members are destroyed
+    buffer_depository.reset();
 }
 
 void mcl::BufferStream::process_buffer(mp::Buffer const& buffer)
@@ -463,6 +476,38 @@ std::chrono::microseconds mcl::BufferStream::microseconds_till_vblank() const
     return ret;
 }
 
+std::chrono::nanoseconds mcl::BufferStream::predicted_present_time() const
+{
+    std::shared_ptr<FrameClock> clock;
+
+    {
+        std::lock_guard<decltype(mutex)> lock(mutex);
+        clock = frame_clock;
+    }
+
+    auto const now = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+    return clock ? clock->predicted_present_after(now).nanoseconds : now.nanoseconds;
+}
+
+void mcl::BufferStream::buffer_presented()
+{
+    /*
+     * The server hands a buffer back once the next frame has replaced it on
+     * screen, so this is as close as the client gets to a presentation
+     * timestamp. It's noisy, but the frame clock filters out the jitter.
+     */
+    auto const now = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+    std::shared_ptr<FrameClock> clock;
+
+    {
+        std::lock_guard<decltype(mutex)> lock(mutex);
+        clock = frame_clock;
+    }
+
+    if (clock)
+        clock->presented(now);
+}
+
 void mcl::BufferStream::wait_for_vsync()
 {
     mir::time::PosixTimestamp last, target;
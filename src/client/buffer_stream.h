@@ -138,6 +138,7 @@ public:
 #pragma GCC diagnostic pop
 
     std::chrono::microseconds microseconds_till_vblank() const override;
+    std::chrono::nanoseconds predicted_present_time() const override;
 
 protected:
     BufferStream(BufferStream const&) = delete;
@@ -148,6 +149,7 @@ private:
     void process_buffer(protobuf::Buffer const& buffer, std::unique_lock<std::mutex>&);
     MirWaitHandle* set_server_swap_interval(int i);
     void wait_for_vsync();
+    void buffer_presented();
 
     mutable std::mutex mutex; // Protects all members of *this
 
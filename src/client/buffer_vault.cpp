@@ -179,17 +179,49 @@ std::shared_ptr<mcl::MirBuffer> mcl::BufferVault::checked_buffer_from_map(int id
 
 mcl::BufferVault::BufferMap::iterator mcl::BufferVault::available_buffer()
 {
-    auto it = std::find_if(buffers.begin(), buffers.end(),
-        [this](std::pair<int, Owner> const& entry) {
-            return ((entry.second == Owner::Self) &&
-                    (checked_buffer_from_map(entry.first)->size() == size) &&
-                    (entry.first != last_received_id)); });
+    // Prefer any correctly sized buffer other than the one we got back last
+    auto fallback = buffers.end();
+    for (auto it = buffers.begin(); it != buffers.end(); ++it)
+    {
+        if ((it->second.owner != Owner::Self) || (it->second.buffer->size() != size))
+            continue;
+
+        if (it->first != last_received_id)
+            return it;
+
+        fallback = it;
+    }
+    return fallback;
+}
+
+std::shared_ptr<mcl::MirBuffer> mcl::BufferVault::take_available_buffer(std::vector<int>& free_ids)
+{
+    //clean up incorrectly sized buffers. Buffers are only accepted from the server
+    //at the current size, so this is only needed once after each resize.
+    if (resized)
+    {
+        for (auto it = buffers.begin(); it != buffers.end();)
+        {
+            if ((it->second.owner == Owner::Self) && (it->second.buffer->size() != size))
+            {
+                current_buffer_count--;
+                free_ids.push_back(it->first);
+                it = buffers.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+        resized = false;
+    }
+
+    auto it = available_buffer();
     if (it == buffers.end())
-        it = std::find_if(buffers.begin(), buffers.end(),
-        [this](std::pair<int, Owner> const& entry) {
-            return ((entry.second == Owner::Self) &&
-                    (checked_buffer_from_map(entry.first)->size() == size)); });
-    return it;
+        return nullptr;
+
+    it->second.owner = Owner::ContentProducer;
+    return it->second.buffer;
 }
 
 mcl::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> mcl::BufferVault::withdraw()
@@ -199,29 +231,11 @@ mcl::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> mcl::BufferVault::withdraw()
     if (disconnected_)
         BOOST_THROW_EXCEPTION(std::logic_error("server_disconnected"));
 
-    //clean up incorrectly sized buffers
-    for (auto it = buffers.begin(); it != buffers.end();)
-    {
-        auto buffer = checked_buffer_from_map(it->first);
-        if ((it->second == Owner::Self) && (buffer->size() != size)) 
-        {
-            current_buffer_count--;
-            free_ids.push_back(it->first);
-            it = buffers.erase(it);
-        }
-        else
-        {
-            it++;
-        }
-    } 
-
     mcl::NoTLSPromise<std::shared_ptr<mcl::MirBuffer>> promise;
-    auto it = available_buffer();
     auto future = promise.get_future();
-    if (it != buffers.end())
+    if (auto buffer = take_available_buffer(free_ids))
     {
-        it->second = Owner::ContentProducer;
-        promise.set_value(checked_buffer_from_map(it->first));
+        promise.set_value(buffer);
         lk.unlock();
     }
     else
@@ -243,15 +257,30 @@ mcl::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> mcl::BufferVault::withdraw()
     return future;
 }
 
+std::shared_ptr<mcl::MirBuffer> mcl::BufferVault::try_withdraw()
+{
+    std::vector<int> free_ids;
+    std::unique_lock<std::mutex> lk(mutex);
+    if (disconnected_)
+        BOOST_THROW_EXCEPTION(std::logic_error("server_disconnected"));
+
+    auto buffer = take_available_buffer(free_ids);
+    lk.unlock();
+
+    for(auto& id : free_ids)
+        free_buffer(id);
+    return buffer;
+}
+
 void mcl::BufferVault::deposit(std::shared_ptr<mcl::MirBuffer> const& buffer)
 {
     std::lock_guard<std::mutex> lk(mutex);
     auto it = buffers.find(buffer->rpc_id());
-    if (it == buffers.end() || it->second != Owner::ContentProducer)
+    if (it == buffers.end() || it->second.owner != Owner::ContentProducer)
         BOOST_THROW_EXCEPTION(std::logic_error("buffer cannot be deposited"));
 
-    it->second = Owner::SelfWithContent;
-    checked_buffer_from_map(it->first)->increment_age();
+    it->second.owner = Owner::SelfWithContent;
+    it->second.buffer->increment_age();
 }
 
 MirWaitHandle* mcl::BufferVault::wire_transfer_outbound(
@@ -259,9 +288,9 @@ MirWaitHandle* mcl::BufferVault::wire_transfer_outbound(
 {
     std::unique_lock<std::mutex> lk(mutex);
     auto it = buffers.find(buffer->rpc_id());
-    if (it == buffers.end() || it->second != Owner::SelfWithContent)
+    if (it == buffers.end() || it->second.owner != Owner::SelfWithContent)
         BOOST_THROW_EXCEPTION(std::logic_error("buffer cannot be transferred"));
-    it->second = Owner::Server;
+    it->second.owner = Owner::Server;
     lk.unlock();
 
     buffer->submitted();
@@ -293,24 +322,35 @@ void mcl::BufferVault::wire_transfer_inbound(int buffer_id)
     if (being_destroyed)
         return;
 
+    auto const returned = buffers.find(buffer_id);
+    if (presentation_observer && returned != buffers.end() && returned->second.owner == Owner::Server)
+    {
+        auto const observer = presentation_observer;
+        lk.unlock();
+        observer();
+        lk.lock();
+
+        if (being_destroyed)
+            return;
+    }
+
     last_received_id = buffer_id;
-    auto buffer = checked_buffer_from_map(buffer_id);
-    auto inbound_size = buffer->size();
     auto it = buffers.find(buffer_id);
     if (it == buffers.end())
     {
-        if (inbound_size != size)
+        auto buffer = checked_buffer_from_map(buffer_id);
+        if (buffer->size() != size)
         {
             lk.unlock();
             realloc_buffer(buffer_id, size, format, usage);
             return;
         }
-        buffers[buffer_id] = Owner::Self;
+        it = buffers.emplace(buffer_id, Account{Owner::Self, buffer}).first;
     }
     else
     {
         auto should_decrease_count = (current_buffer_count > needed_buffer_count);
-        if (size != buffer->size() || should_decrease_count)
+        if (size != it->second.buffer->size() || should_decrease_count)
         {
             auto id = it->first;
             buffers.erase(it);
@@ -325,14 +365,14 @@ void mcl::BufferVault::wire_transfer_inbound(int buffer_id)
         }
         else
         {
-            it->second = Owner::Self;
+            it->second.owner = Owner::Self;
         }
     }
 
     if (!promises.empty())
     {
-        buffers[buffer_id] = Owner::ContentProducer;
-        promises.front().set_value(buffer);
+        it->second.owner = Owner::ContentProducer;
+        promises.front().set_value(it->second.buffer);
         promises.pop_front();
     }
 
@@ -372,9 +412,17 @@ void mcl::BufferVault::set_size(geom::Size new_size)
 
 void mcl::BufferVault::set_size(std::unique_lock<std::mutex> const&, geometry::Size new_size)
 {
+    if (new_size != size)
+        resized = true;
     size = new_size;
 }
 
+void mcl::BufferVault::set_presentation_observer(std::function<void()> const& observer)
+{
+    std::lock_guard<std::mutex> lk(mutex);
+    presentation_observer = observer;
+}
+
 void mcl::BufferVault::set_interval(int i)
 {
     std::unique_lock<std::mutex> lk(mutex);
@@ -396,7 +444,7 @@ void mcl::BufferVault::set_interval(int i)
         while (current_buffer_count > needed_buffer_count)
         {
             auto it = std::find_if(buffers.begin(), buffers.end(),
-                [](auto const& entry) { return entry.second == Owner::Self; });
+                [](auto const& entry) { return entry.second.owner == Owner::Self; });
             if (it == buffers.end())
                 break;
             current_buffer_count--;
@@ -27,6 +27,7 @@
 #include "no_tls_future-inl.h"
 #include <deque>
 #include <map>
+#include <vector>
 
 namespace mir
 {
@@ -66,6 +67,8 @@ public:
     ~BufferVault();
 
     NoTLSFuture<std::shared_ptr<MirBuffer>> withdraw();
+    // Takes a buffer only if one is ready, without waiting; returns nullptr otherwise
+    std::shared_ptr<MirBuffer> try_withdraw();
     void deposit(std::shared_ptr<MirBuffer> const& buffer);
     void wire_transfer_inbound(int buffer_id);
     MirWaitHandle* wire_transfer_outbound(
@@ -74,11 +77,19 @@ public:
     void disconnected();
     void set_scale(float scale);
     void set_interval(int);
+    // Called, without the vault locked, whenever the server hands back a buffer it has presented
+    void set_presentation_observer(std::function<void()> const&);
 
 private:
     enum class Owner;
-    typedef std::map<int, Owner> BufferMap;
+    struct Account
+    {
+        Owner owner;
+        std::shared_ptr<MirBuffer> buffer;
+    };
+    typedef std::map<int, Account> BufferMap;
     BufferMap::iterator available_buffer();
+    std::shared_ptr<MirBuffer> take_available_buffer(std::vector<int>& free_ids);
     void trigger_callback(std::unique_lock<std::mutex> lk);
 
     void alloc_buffer(geometry::Size size, MirPixelFormat format, int usage);
@@ -100,6 +111,7 @@ private:
     BufferMap buffers;
     std::deque<NoTLSPromise<std::shared_ptr<MirBuffer>>> promises;
     geometry::Size size;
+    bool resized{false};
     bool disconnected_;
     size_t current_buffer_count;
     size_t needed_buffer_count;
@@ -108,6 +120,7 @@ private:
     int interval = 1;
     MirWaitHandle swap_buffers_wait_handle;
     std::function<void()> deferred_cb;
+    std::function<void()> presentation_observer;
 };
 }
 }
@@ -112,6 +112,11 @@ std::chrono::microseconds mcl::ErrorStream::microseconds_till_vblank() const
     return std::chrono::microseconds::zero();
 }
 
+std::chrono::nanoseconds mcl::ErrorStream::predicted_present_time() const
+{
+    return std::chrono::nanoseconds::zero();
+}
+
 MirNativeBuffer* mcl::ErrorStream::get_current_buffer_package()
 {
     BOOST_THROW_EXCEPTION(std::runtime_error(error));
@@ -46,6 +46,7 @@ public:
     void adopted_by(MirWindow*) override;
     void unadopted_by(MirWindow*) override;
     std::chrono::microseconds microseconds_till_vblank() const override;
+    std::chrono::nanoseconds predicted_present_time() const override;
     MirNativeBuffer* get_current_buffer_package() override;
     MirPlatformType platform_type() override;
     frontend::BufferStreamId rpc_id() const override;
@@ -19,6 +19,7 @@
 #include "frame_clock.h"
 #include <stdexcept>
 #include <cassert>
+#include <cstdlib>
 
 using mir::client::FrameClock;
 using mir::time::PosixTimestamp;
@@ -26,6 +27,38 @@ using mir::time::PosixTimestamp;
 namespace
 {
 typedef std::unique_lock<std::mutex> Lock;
+
+/*
+ * Presentation feedback is noisy (it arrives over IPC and is subject to
+ * scheduling delays) so it's filtered before being trusted:
+ *   - Samples further than period/jitter_tolerance from the learnt phase
+ *     are ignored as jitter...
+ *   - ...unless relock_after of them arrive in a row, in which case the
+ *     display really has moved and we follow it.
+ *   - Accepted samples only pull the phase 1/pll_gain of the way towards
+ *     themselves, so single samples can't make the frame rate uneven.
+ */
+int const jitter_tolerance = 8;
+int const relock_after = 3;
+int const pll_gain = 4;
+int const locked_after = 3;
+
+// Wraps an offset into the range [-period/2, period/2)
+std::chrono::nanoseconds centred(std::chrono::nanoseconds offset, std::chrono::nanoseconds period)
+{
+    offset %= period;
+    if (offset >= period/2)
+        offset -= period;
+    else if (offset < -period/2)
+        offset += period;
+    return offset;
+}
+
+// Wraps an offset into the range [0, period)
+std::chrono::nanoseconds wrapped(std::chrono::nanoseconds offset, std::chrono::nanoseconds period)
+{
+    return (offset % period + period) % period;
+}
 } // namespace
 
 FrameClock::FrameClock(FrameClock::GetCurrentTime gct)
@@ -34,6 +67,9 @@ FrameClock::FrameClock(FrameClock::GetCurrentTime gct)
     , phase{0}
     , period{0}
     , resync_callback{std::bind(&FrameClock::fallback_resync_callback, this)}
+    , presentation_clock{CLOCK_MONOTONIC}
+    , presentations_in_phase{0}
+    , presentations_out_of_phase{0}
 {
 }
 
@@ -42,6 +78,10 @@ void FrameClock::set_period(std::chrono::nanoseconds ns)
     Lock lock(mutex);
     period = ns;
     config_changed = true;
+
+    // What we learnt about the phase was relative to the old period
+    presentations_in_phase = 0;
+    presentations_out_of_phase = 0;
 }
 
 void FrameClock::set_resync_callback(ResyncCallback cb)
@@ -111,11 +151,25 @@ PosixTimestamp FrameClock::next_frame_after(PosixTimestamp when) const
      */
     if (missed_frames > 1 || config_changed)
     {
-        lock.unlock();
-        auto const server_frame = resync_callback();
-        lock.lock();
+        PosixTimestamp server_frame;
 
-        phase = server_frame % period;
+        if (locked_to_presentations())
+        {
+            /*
+             * Presentation feedback already keeps us in phase, so there's
+             * no need to ask anyone. Just find the latest vblank.
+             */
+            auto const presentation_now = get_current_time(presentation_clock);
+            server_frame = presentation_now - wrapped((presentation_now % period) - phase, period);
+        }
+        else
+        {
+            lock.unlock();
+            server_frame = resync_callback();
+            lock.lock();
+
+            phase = server_frame % period;
+        }
 
         /*
          * Avoid mismatches (which will throw) and ensure we're always
@@ -162,3 +216,46 @@ PosixTimestamp FrameClock::next_frame_after(PosixTimestamp when) const
 
     return target;
 }
+
+void FrameClock::presented(PosixTimestamp when)
+{
+    Lock lock(mutex);
+    if (period == period.zero())
+        return;
+
+    auto const observed = when % period;
+    auto const error = centred(observed - phase, period);
+
+    if (presentations_in_phase > 0 &&
+        when.clock_id == presentation_clock &&
+        std::abs(error.count()) <= (period / jitter_tolerance).count())
+    {
+        phase = wrapped(phase + error / pll_gain, period);
+        presentations_out_of_phase = 0;
+        if (presentations_in_phase < locked_after)
+            ++presentations_in_phase;
+    }
+    else if (presentations_in_phase == 0 ||
+             when.clock_id != presentation_clock ||
+             ++presentations_out_of_phase >= relock_after)
+    {
+        phase = observed;
+        presentation_clock = when.clock_id;
+        presentations_in_phase = 1;
+        presentations_out_of_phase = 0;
+    }
+}
+
+PosixTimestamp FrameClock::predicted_present_after(PosixTimestamp when) const
+{
+    Lock lock(mutex);
+    if (period == period.zero())
+        return when;
+
+    return when - wrapped((when % period) - phase, period) + period;
+}
+
+bool FrameClock::locked_to_presentations() const
+{
+    return presentations_in_phase >= locked_after;
+}
@@ -57,8 +57,25 @@ public:
      */
     time::PosixTimestamp next_frame_after(time::PosixTimestamp when) const;
 
+    /**
+     * Feed back the time at which the server presented a frame. Samples
+     * that stray too far from the learnt phase are treated as jitter and
+     * ignored, unless they keep agreeing with each other. Once enough
+     * samples agree the clock stays phase-locked to them and no longer
+     * needs the resync callback.
+     */
+    void presented(time::PosixTimestamp when);
+
+    /**
+     * Return the earliest time at which a frame submitted at 'when' can be
+     * presented: the next vblank after 'when'. Unthrottled clocks just
+     * return 'when'.
+     */
+    time::PosixTimestamp predicted_present_after(time::PosixTimestamp when) const;
+
 private:
     time::PosixTimestamp fallback_resync_callback() const;
+    bool locked_to_presentations() const;
 
     GetCurrentTime const get_current_time;
 
@@ -67,6 +84,9 @@ private:
     mutable std::chrono::nanoseconds phase;
     std::chrono::nanoseconds period;
     ResyncCallback resync_callback;
+    clockid_t presentation_clock;
+    int presentations_in_phase;
+    int presentations_out_of_phase;
 };
 
 }} // namespace mir::client
@@ -38,16 +38,21 @@ logging::PerfReport::PerfReport(
 
 void logging::PerfReport::display(const char *name, long fps100,
                                   long rendertime_usec, long lag_usec,
-                                  int nbuffers) const
+                                  int nbuffers, long lag_p50_usec,
+                                  long lag_p99_usec, long missed100) const
 {
-    char msg[256];
+    char msg[384];
     snprintf(msg, sizeof msg,
-             "%s: %2ld.%02ld FPS, render time %ld.%02ldms, buffer lag %ld.%02ldms (%d buffers)",
+             "%s: %2ld.%02ld FPS, render time %ld.%02ldms, buffer lag %ld.%02ldms (%d buffers), "
+             "lag p50 %ld.%02ldms p99 %ld.%02ldms, %ld.%02ld%% frames missed",
              name,
              fps100 / 100, fps100 % 100,
              rendertime_usec / 1000, (rendertime_usec / 10) % 100,
              lag_usec / 1000, (lag_usec / 10) % 100,
-             nbuffers
+             nbuffers,
+             lag_p50_usec / 1000, (lag_p50_usec / 10) % 100,
+             lag_p99_usec / 1000, (lag_p99_usec / 10) % 100,
+             missed100 / 100, missed100 % 100
              );
 
     logger->log(ml::Severity::informational, msg, component);
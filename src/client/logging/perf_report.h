@@ -36,7 +36,8 @@ class PerfReport : public PeriodicPerfReport
 public:
     PerfReport(std::shared_ptr<mir::logging::Logger> const& logger);
     void display(const char *name, long fps100, long rendertime_usec,
-                 long lag_usec, int nbuffers) const override;
+                 long lag_usec, int nbuffers, long lag_p50_usec,
+                 long lag_p99_usec, long missed100) const override;
 private:
     std::shared_ptr<mir::logging::Logger> const logger;
 };
@@ -258,6 +258,12 @@ unsigned long mir_buffer_stream_get_microseconds_till_vblank(
     return stream->microseconds_till_vblank().count();
 }
 
+int64_t mir_buffer_stream_get_predicted_present_time(MirBufferStream const* stream)
+{
+    mir::require(stream);
+    return stream->predicted_present_time().count();
+}
+
 void mir_buffer_stream_set_size(MirBufferStream* stream, int width, int height)
 try
 {
@@ -18,8 +18,45 @@
 
 #include "periodic_perf_report.h"
 
+#include <algorithm>
+
 using namespace mir::client;
 
+namespace
+{
+template<typename Duration>
+Duration percentile(std::vector<Duration>& samples, int percent)
+{
+    if (samples.empty())
+        return Duration::zero();
+
+    auto const nth = samples.begin() + (samples.size() - 1) * percent / 100;
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+/*
+ * We don't know the display's refresh rate here, so a frame counts as
+ * missed when it took over one and a half times the typical (median)
+ * frame interval. Longer gaps count as several missed frames.
+ */
+template<typename Duration>
+int missed_frames(std::vector<Duration>& intervals)
+{
+    auto const typical = percentile(intervals, 50);
+    if (typical == Duration::zero())
+        return 0;
+
+    int missed = 0;
+    for (auto const& interval : intervals)
+    {
+        if (interval * 2 > typical * 3)
+            missed += (interval + typical / 2) / typical - 1;
+    }
+    return missed;
+}
+}
+
 PeriodicPerfReport::PeriodicPerfReport(mir::time::Duration period,
               std::shared_ptr<mir::time::Clock> const& clock)
     : clock(clock)
@@ -50,12 +87,17 @@ void PeriodicPerfReport::begin_frame(int buffer_id)
         auto buffer_queue_latency = estimated_page_flip_time -
                                     buffer_end_time[buffer_id];
         buffer_queue_latency_sum += buffer_queue_latency;
+        buffer_queue_latencies.push_back(buffer_queue_latency);
     }
 }
 
 void PeriodicPerfReport::end_frame(int buffer_id)
 {
-    auto now = buffer_end_time[buffer_id] = current_time();
+    if (have_frame_end_time)
+        frame_intervals.push_back(current_time() - frame_end_time);
+
+    auto now = frame_end_time = buffer_end_time[buffer_id] = current_time();
+    have_frame_end_time = true;
     auto render_time = now - frame_begin_time;
     render_time_sum += render_time;
     ++frame_count;
@@ -72,6 +114,11 @@ void PeriodicPerfReport::end_frame(int buffer_id)
 
         auto render_time_avg = render_time_sum / frame_count;
         auto queue_lag_avg = buffer_queue_latency_sum / frame_count;
+        auto queue_lag_p50 = percentile(buffer_queue_latencies, 50);
+        auto queue_lag_p99 = percentile(buffer_queue_latencies, 99);
+
+        int const missed = missed_frames(frame_intervals);
+        long const missed_100 = missed * 10000L / (frame_count + missed);
 
         // Save this before cleaning out the map. In production you can
         // safely measure this after the while loop. But in testing with
@@ -93,12 +140,17 @@ void PeriodicPerfReport::end_frame(int buffer_id)
         display(name.c_str(), fps_100,
                 duration_cast<microseconds>(render_time_avg).count(),
                 duration_cast<microseconds>(queue_lag_avg).count(),
-                nbuffers);
+                nbuffers,
+                duration_cast<microseconds>(queue_lag_p50).count(),
+                duration_cast<microseconds>(queue_lag_p99).count(),
+                missed_100);
 
         last_report_time = now;
         frame_count = 0;
         render_time_sum = render_time_sum.zero();
         buffer_queue_latency_sum = buffer_queue_latency_sum.zero();
+        buffer_queue_latencies.clear();
+        frame_intervals.clear();
     }
 }
 
@@ -25,6 +25,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mir
 {
@@ -39,9 +40,14 @@ public:
     void name_surface(char const*) override;
     void begin_frame(int buffer_id) override;
     void end_frame(int buffer_id) override;
+    /**
+     * lag_p50_usec and lag_p99_usec are percentiles of the buffer lag, and
+     * missed100 is the percentage (x 100) of frames that missed their slot.
+     */
     virtual void display(const char *name, long fps100,
                          long rendertime_usec, long lag_usec,
-                         int nbuffers) const = 0;
+                         int nbuffers, long lag_p50_usec,
+                         long lag_p99_usec, long missed100) const = 0;
 private:
     typedef mir::time::Duration Duration;
     typedef mir::time::Timestamp Timestamp;
@@ -55,6 +61,9 @@ private:
     Duration render_time_sum = Duration::zero();
     Duration buffer_queue_latency_sum = Duration::zero();
     int frame_count = 0;
+    bool have_frame_end_time = false;
+    std::vector<Duration> buffer_queue_latencies;
+    std::vector<Duration> frame_intervals;
     std::unordered_map<int,Timestamp> buffer_end_time;
 };
 
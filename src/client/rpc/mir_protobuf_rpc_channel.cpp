@@ -41,6 +41,7 @@
 #include "mir_protobuf_wire.pb.h"
 
 #include "mir/event_printer.h"
+#include <google/protobuf/io/coded_stream.h>
 #include <boost/bind.hpp>
 #include <boost/throw_exception.hpp>
 #include <endian.h>
@@ -55,6 +56,52 @@ namespace mclr = mir::client::rpc;
 namespace md = mir::dispatch;
 namespace mp = mir::protobuf;
 
+namespace
+{
+/*
+ * Walks an EventSequence consisting only of Event{raw} entries, calling
+ * handle_raw with the bytes of each raw event where they lie in the buffer.
+ * Returns false if the sequence carries anything else; run it with a no-op
+ * handler first to check before dispatching anything.
+ */
+template<typename Handler>
+bool for_each_raw_event(std::string const& sequence, Handler const& handle_raw)
+{
+    uint32_t const event_tag = (1 << 3) | 2;    // EventSequence.event
+    uint32_t const raw_tag = (1 << 3) | 2;      // Event.raw
+
+    google::protobuf::io::CodedInputStream input{
+        reinterpret_cast<uint8_t const*>(sequence.data()), static_cast<int>(sequence.size())};
+
+    while (auto const tag = input.ReadTag())
+    {
+        uint32_t event_size;
+        if (tag != event_tag || !input.ReadVarint32(&event_size))
+            return false;
+
+        auto const limit = input.PushLimit(event_size);
+
+        uint32_t raw_size;
+        void const* raw;
+        int available;
+        if (input.ReadTag() != raw_tag ||
+            !input.ReadVarint32(&raw_size) ||
+            !input.GetDirectBufferPointer(&raw, &available) ||
+            static_cast<uint32_t>(available) != raw_size)
+        {
+            return false;
+        }
+
+        handle_raw(raw, raw_size);
+
+        input.Skip(raw_size);
+        input.PopLimit(limit);
+    }
+
+    return input.ConsumedEntireMessage();
+}
+}
+
 mclr::MirProtobufRpcChannel::MirProtobufRpcChannel(
     std::unique_ptr<mclr::StreamTransport> transport,
     std::shared_ptr<mcl::SurfaceMap> const& surface_map,
@@ -292,6 +339,14 @@ void mclr::MirProtobufRpcChannel::send_message(
 
 void mclr::MirProtobufRpcChannel::process_event_sequence(std::string const& event)
 {
+    // Nearly every sequence the server sends is a lone raw event; decode
+    // those in place rather than copying them through an mp::EventSequence.
+    if (for_each_raw_event(event, [](void const*, size_t) {}))
+    {
+        for_each_raw_event(event, [this](void const* data, size_t size) { process_raw_event(data, size); });
+        return;
+    }
+
     mp::EventSequence seq;
 
     seq.ParseFromString(event);
@@ -404,66 +459,73 @@ void mclr::MirProtobufRpcChannel::process_event_sequence(std::string const& even
         {
             // In future, events might be compressed where possible.
             // But that's a job for later...
-            try
-            {
-                auto e = MirEvent::deserialize(event.raw());
-                if (e)
-                {
-                    rpc_report->event_parsing_succeeded(*e);
-
-                    int window_id = 0;
-                    bool is_window_event = true;
+            process_raw_event(event.raw().data(), event.raw().size());
+        }
+    }
+}
 
-                    switch (e->type())
-                    {
-                    case mir_event_type_window:
-                        window_id = e->to_surface()->id();
-                        break;
-                    case mir_event_type_resize:
-                        window_id = e->to_resize()->surface_id();
-                        break;
-                    case mir_event_type_orientation:
-                        window_id = e->to_orientation()->surface_id();
-                        break;
-                    case mir_event_type_close_window:
-                        window_id = e->to_close_window()->surface_id();
-                        break;
-                    case mir_event_type_keymap:
-                        input_report->received_event(*e);
-                        window_id = e->to_keymap()->surface_id();
-                        break;
-                    case mir_event_type_window_output:
-                        window_id = e->to_window_output()->surface_id();
-                        break;
-                    case mir_event_type_window_placement:
-                        window_id = e->to_window_placement()->id();
-                        break;
-                    case mir_event_type_input:
-                        input_report->received_event(*e);
-                        window_id = e->to_input()->window_id();
-                        break;
-                    case mir_event_type_input_device_state:
-                        input_report->received_event(*e);
-                        window_id = e->to_input_device_state()->window_id();
-                        break;
-                    default:
-                        is_window_event = false;
-                        event_sink->handle_event(*e);
-                    }
+void mclr::MirProtobufRpcChannel::process_raw_event(void const* data, size_t size)
+{
+    try
+    {
+        auto e = MirEvent::deserialize(data, size);
+        if (e)
+        {
+            rpc_report->event_parsing_succeeded(*e);
 
-                    if (is_window_event)
-                        if (auto map = surface_map.lock())
-                            if (auto surf = map->surface(mf::SurfaceId(window_id)))
-                                surf->handle_event(*e);
+            int window_id = 0;
+            bool is_window_event = true;
 
-                }
-            }
-            catch(...)
+            switch (e->type())
             {
-                rpc_report->event_parsing_failed(event);
+            case mir_event_type_window:
+                window_id = e->to_surface()->id();
+                break;
+            case mir_event_type_resize:
+                window_id = e->to_resize()->surface_id();
+                break;
+            case mir_event_type_orientation:
+                window_id = e->to_orientation()->surface_id();
+                break;
+            case mir_event_type_close_window:
+                window_id = e->to_close_window()->surface_id();
+                break;
+            case mir_event_type_keymap:
+                input_report->received_event(*e);
+                window_id = e->to_keymap()->surface_id();
+                break;
+            case mir_event_type_window_output:
+                window_id = e->to_window_output()->surface_id();
+                break;
+            case mir_event_type_window_placement:
+                window_id = e->to_window_placement()->id();
+                break;
+            case mir_event_type_input:
+                input_report->received_event(*e);
+                window_id = e->to_input()->window_id();
+                break;
+            case mir_event_type_input_device_state:
+                input_report->received_event(*e);
+                window_id = e->to_input_device_state()->window_id();
+                break;
+            default:
+                is_window_event = false;
+                event_sink->handle_event(*e);
             }
+
+            if (is_window_event)
+                if (auto map = surface_map.lock())
+                    if (auto surf = map->surface(mf::SurfaceId(window_id)))
+                        surf->handle_event(*e);
+
         }
     }
+    catch(...)
+    {
+        mp::Event event;
+        event.set_raw(data, size);
+        rpc_report->event_parsing_failed(event);
+    }
 }
 
 void mclr::MirProtobufRpcChannel::on_data_available()
@@ -131,6 +131,7 @@ private:
 
     void read_message();
     void process_event_sequence(std::string const& event);
+    void process_raw_event(void const* data, size_t size);
 
     void notify_disconnected();
 
@@ -283,6 +283,11 @@ std::chrono::microseconds mcl::ScreencastStream::microseconds_till_vblank() cons
     return std::chrono::microseconds::zero();
 }
 
+std::chrono::nanoseconds mcl::ScreencastStream::predicted_present_time() const
+{
+    return std::chrono::nanoseconds::zero();
+}
+
 void mcl::ScreencastStream::set_size(geom::Size)
 {
     BOOST_THROW_EXCEPTION(std::logic_error("Attempt to set size on screencast is invalid"));
@@ -83,6 +83,7 @@ public:
     void adopted_by(MirWindow*) override;
     void unadopted_by(MirWindow*) override;
     std::chrono::microseconds microseconds_till_vblank() const override;
+    std::chrono::nanoseconds predicted_present_time() const override;
     void set_buffer_cache_size(unsigned int) override;
 
     EGLNativeWindowType egl_native_window() override;
@@ -35,6 +35,9 @@
 #include "mir/events/surface_placement_event.h"
 
 #include <capnp/serialize.h>
+#include <kj/io.h>
+
+#include <cstring>
 
 
 namespace ml = mir::logging;
@@ -56,12 +59,32 @@ MirEvent& MirEvent::operator=(MirEvent const& e)
 
 // TODO Look at replacing the surface event serializer with a capnproto layer
 mir::EventUPtr MirEvent::deserialize(std::string const& bytes)
+{
+    return deserialize(bytes.data(), bytes.size());
+}
+
+mir::EventUPtr MirEvent::deserialize(void const* data, size_t size)
 {
     auto e = mir::EventUPtr(new MirEvent, [](MirEvent* ev) { delete ev; });
-    kj::ArrayPtr<::capnp::word const> words(reinterpret_cast<::capnp::word const*>(
-        bytes.data()), bytes.size() / sizeof(::capnp::word));
+    auto const word_count = size / sizeof(::capnp::word);
+
+    // Wire buffers are only guaranteed to be byte aligned; capnp reads words
+    kj::Array<::capnp::word> aligned_copy;
+    kj::ArrayPtr<::capnp::word const> words;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(::capnp::word) == 0)
+    {
+        words = kj::arrayPtr(reinterpret_cast<::capnp::word const*>(data), word_count);
+    }
+    else
+    {
+        aligned_copy = kj::heapArray<::capnp::word>(word_count);
+        memcpy(aligned_copy.begin(), data, word_count * sizeof(::capnp::word));
+        words = aligned_copy;
+    }
 
-    initMessageBuilderFromFlatArrayCopy(words, e->message);
+    // MirEvents are backed by a builder that accessors may modify, so this copy is needed
+    ::capnp::FlatArrayMessageReader reader{words};
+    e->message.setRoot(reader.getRoot<mir::capnp::Event>());
     e->event = e->message.getRoot<mir::capnp::Event>();
 
     return e;
@@ -69,10 +92,21 @@ mir::EventUPtr MirEvent::deserialize(std::string const& bytes)
 
 std::string MirEvent::serialize(MirEvent const* event)
 {
-    std::string output;
-    auto flat_event = ::capnp::messageToFlatArray(const_cast<MirEvent*>(event)->message);
+    std::string output(serialized_size(event), '\0');
+    serialize(event, &output[0], output.size());
+    return output;
+}
 
-    return {reinterpret_cast<char*>(flat_event.asBytes().begin()), flat_event.asBytes().size()};
+size_t MirEvent::serialized_size(MirEvent const* event)
+{
+    return ::capnp::computeSerializedSizeInWords(const_cast<MirEvent*>(event)->message) *
+        sizeof(::capnp::word);
+}
+
+void MirEvent::serialize(MirEvent const* event, void* buffer, size_t size)
+{
+    kj::ArrayOutputStream stream{kj::arrayPtr(static_cast<kj::byte*>(buffer), size)};
+    ::capnp::writeMessage(stream, const_cast<MirEvent*>(event)->message);
 }
 
 MirEventType MirEvent::type() const
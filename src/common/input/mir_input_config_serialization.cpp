@@ -27,6 +27,9 @@
 #include <capnp/message.h>
 #include <capnp/serialize.h>
 
+#include <cstdint>
+#include <cstring>
+
 namespace mi = mir::input;
 namespace mc = mir::capnp;
 
@@ -108,10 +111,23 @@ std::string mi::serialize_input_config(MirInputConfig const& config)
 
 MirInputConfig mi::deserialize_input_config(std::string const& buffer)
 {
-    ::capnp::MallocMessageBuilder message;
-    kj::ArrayPtr<::capnp::word const> words(reinterpret_cast<::capnp::word const*>(
-        buffer.data()), buffer.size() / sizeof(::capnp::word));
-    ::capnp::initMessageBuilderFromFlatArrayCopy(words, message);
+    auto const word_count = buffer.size() / sizeof(::capnp::word);
+
+    // capnp reads words, and the string's storage is only guaranteed to be byte aligned
+    kj::Array<::capnp::word> aligned_copy;
+    kj::ArrayPtr<::capnp::word const> words;
+    if (reinterpret_cast<uintptr_t>(buffer.data()) % alignof(::capnp::word) == 0)
+    {
+        words = kj::arrayPtr(reinterpret_cast<::capnp::word const*>(buffer.data()), word_count);
+    }
+    else
+    {
+        aligned_copy = kj::heapArray<::capnp::word>(word_count);
+        memcpy(aligned_copy.begin(), buffer.data(), word_count * sizeof(::capnp::word));
+        words = aligned_copy;
+    }
+
+    ::capnp::FlatArrayMessageReader message{words};
     mc::InputConfig::Reader conf_reader = message.getRoot<mc::InputConfig>();
 
     MirInputConfig ret;
@@ -20,9 +20,23 @@
 #include "mir/gl/default_program_factory.h"
 #include "mir/gl/program.h"
 #include "recently_used_cache.h"
+#include "shared_uploads.h"
 
 namespace mgl = mir::gl;
 
+mgl::DefaultProgramFactory::DefaultProgramFactory() :
+    DefaultProgramFactory{RecentlyUsedCache::default_budget_bytes}
+{
+}
+
+mgl::DefaultProgramFactory::DefaultProgramFactory(std::size_t texture_cache_budget_bytes) :
+    texture_cache_budget_bytes{texture_cache_budget_bytes},
+    shared_uploads{std::make_shared<SharedUploads>()}
+{
+}
+
+mgl::DefaultProgramFactory::~DefaultProgramFactory() = default;
+
 std::unique_ptr<mgl::Program>
 mgl::DefaultProgramFactory::create_gl_program(
     std::string const& vertex_shader,
@@ -35,5 +49,8 @@ mgl::DefaultProgramFactory::create_gl_program(
 
 std::unique_ptr<mgl::TextureCache> mgl::DefaultProgramFactory::create_texture_cache() const
 {
-    return std::make_unique<RecentlyUsedCache>();
+    return std::make_unique<RecentlyUsedCache>(
+        texture_cache_budget_bytes,
+        RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads);
 }
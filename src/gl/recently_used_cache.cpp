@@ -18,8 +18,10 @@
  */
 
 #include "recently_used_cache.h"
+#include "shared_uploads.h"
 #include "mir/graphics/buffer.h"
 #include "mir/renderer/gl/texture_source.h"
+#include "mir_toolkit/common.h"
 
 #include <stdexcept>
 #include <boost/throw_exception.hpp>
@@ -29,27 +31,109 @@ namespace mgl = mir::gl;
 namespace geom = mir::geometry;
 namespace mrgl = mir::renderer::gl;
 
+mgl::RecentlyUsedCache::RecentlyUsedCache() :
+    RecentlyUsedCache{default_budget_bytes, default_max_idle_frames}
+{
+}
+
+mgl::RecentlyUsedCache::RecentlyUsedCache(std::size_t budget_bytes, unsigned max_idle_frames) :
+    RecentlyUsedCache{budget_bytes, max_idle_frames, nullptr}
+{
+}
+
+mgl::RecentlyUsedCache::RecentlyUsedCache(
+    std::size_t budget_bytes,
+    unsigned max_idle_frames,
+    std::shared_ptr<SharedUploads> const& shared_uploads) :
+    budget_bytes{budget_bytes},
+    max_idle_frames{max_idle_frames},
+    shared_uploads{shared_uploads}
+{
+    if (shared_uploads)
+        shared_uploads->add_user();
+}
+
+mgl::RecentlyUsedCache::~RecentlyUsedCache()
+{
+    if (shared_uploads)
+        shared_uploads->remove_user();
+}
+
 std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const& renderable)
 {
     auto const& buffer = renderable.buffer();
     auto buffer_id = buffer->id();
-    auto& texture = textures[renderable.id()];
+    auto const size = buffer->size();
+    std::size_t const bytes =
+        size.width.as_uint32_t() * size.height.as_uint32_t() * MIR_BYTES_PER_PIXEL(buffer->pixel_format());
+
+    auto found = textures.find(renderable.id());
+    if (found == textures.end())
+    {
+        Entry entry;
+        entry.texture = acquire_texture(size);
+        entry.size = size;
+        lru.push_front(renderable.id());
+        entry.lru_position = lru.begin();
+        found = textures.emplace(renderable.id(), std::move(entry)).first;
+    }
+    else
+    {
+        lru.splice(lru.begin(), lru, found->second.lru_position);
+    }
+
+    auto& texture = found->second;
+    texture.size = size;
+
+    auto const needs_binding = (texture.last_bound_buffer != buffer_id) || (!texture.valid_binding);
+    std::shared_ptr<Texture> uploaded_elsewhere;
+
+    if (needs_binding && shared_uploads)
+    {
+        if ((uploaded_elsewhere = shared_uploads->find(buffer)))
+            texture.texture = uploaded_elsewhere;
+        else if (!shared_uploads->withdraw(texture.texture))
+            texture.texture = std::make_shared<Texture>();  // Another output is still drawing from it
+    }
+
     texture.texture->bind();
 
     auto const texture_source = dynamic_cast<mrgl::TextureSource*>(buffer->native_buffer_base());
     if (!texture_source)
         BOOST_THROW_EXCEPTION(std::logic_error("Buffer does not support GL rendering"));
 
-    if ((texture.last_bound_buffer != buffer_id) || (!texture.valid_binding))
+    if (needs_binding && !uploaded_elsewhere)
     {
         texture_source->bind();
         texture.resource = buffer;
         texture.last_bound_buffer = buffer_id;
+        ++stats.misses;
+        stats.uploaded_bytes += bytes;
+
+        if (shared_uploads)
+            shared_uploads->publish(buffer, texture.texture);
+    }
+    else
+    {
+        if (needs_binding)
+        {
+            texture.resource = buffer;
+            texture.last_bound_buffer = buffer_id;
+        }
+        ++stats.hits;
     }
     texture_source->secure_for_render();
 
+    // A texture uploaded by another output's cache is counted there
+    if (needs_binding)
+    {
+        auto const resident = uploaded_elsewhere ? 0 : bytes;
+        stats.resident_bytes = stats.resident_bytes - texture.bytes + resident;
+        texture.bytes = resident;
+    }
+
     texture.valid_binding = true;
-    texture.used = true;
+    texture.last_used_frame = frame;
 
     return texture.texture;
 }
@@ -67,14 +151,78 @@ void mgl::RecentlyUsedCache::drop_unused()
     {
         auto& tex = t->second;
         tex.resource.reset();
-        if (tex.used)
+        if (frame - tex.last_used_frame > max_idle_frames)
         {
-            tex.used = false;
-            ++t;
+            auto const idle = t++;
+            retire(idle);
         }
         else
         {
-            t = textures.erase(t);
+            ++t;
+        }
+    }
+
+    while (!spares.empty() && frame - spares.front().retired_frame > max_idle_frames)
+    {
+        stats.resident_bytes -= spares.front().bytes;
+        spares.pop_front();
+    }
+
+    evict_over_budget();
+    ++frame;
+}
+
+mgl::TextureCache::Statistics mgl::RecentlyUsedCache::statistics() const
+{
+    return stats;
+}
+
+auto mgl::RecentlyUsedCache::acquire_texture(geom::Size size) -> std::shared_ptr<Texture>
+{
+    // Prefer the most recently retired texture: its storage is least likely
+    // to have been reclaimed by the driver
+    for (auto spare = spares.rbegin(); spare != spares.rend(); ++spare)
+    {
+        if (spare->size == size)
+        {
+            auto const texture = std::move(spare->texture);
+            stats.resident_bytes -= spare->bytes;
+            spares.erase(std::next(spare).base());
+            return texture;
         }
     }
+
+    return std::make_shared<Texture>();
+}
+
+void mgl::RecentlyUsedCache::retire(std::unordered_map<mg::Renderable::ID, Entry>::iterator entry)
+{
+    auto& tex = entry->second;
+    spares.push_back(Spare{std::move(tex.texture), tex.size, tex.bytes, frame});
+    lru.erase(tex.lru_position);
+    textures.erase(entry);
+    ++stats.evictions;
+}
+
+void mgl::RecentlyUsedCache::evict_over_budget()
+{
+    while (stats.resident_bytes > budget_bytes && !spares.empty())
+    {
+        stats.resident_bytes -= spares.front().bytes;
+        spares.pop_front();
+    }
+
+    while (stats.resident_bytes > budget_bytes && !lru.empty())
+    {
+        auto const victim = textures.find(lru.back());
+
+        // Everything from here on is needed for the current frame
+        if (victim->second.last_used_frame == frame)
+            break;
+
+        stats.resident_bytes -= victim->second.bytes;
+        lru.pop_back();
+        textures.erase(victim);
+        ++stats.evictions;
+    }
 }
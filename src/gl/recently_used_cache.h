@@ -24,34 +24,84 @@
 #include "mir/gl/texture.h"
 #include "mir/graphics/buffer_id.h"
 #include "mir/graphics/renderable.h"
+#include "mir/geometry/size.h"
 #include <unordered_map>
+#include <list>
 
 namespace mir
 {
 namespace graphics { class Buffer; }
 namespace gl
 {
+class SharedUploads;
+
+/**
+ * A TextureCache that keeps the textures of renderables that drop out of
+ * a frame (e.g. hidden windows) for a while, so they need not be re-uploaded
+ * when they reappear.
+ *
+ * Textures unused for more than max_idle_frames are retired; the storage of
+ * retired textures is recycled for new renderables of the same size. When
+ * the estimated GPU memory exceeds budget_bytes the least recently used
+ * textures are evicted first.
+ *
+ * Caches given the same SharedUploads draw a buffer shown on several outputs
+ * from a single upload, which only the cache that uploaded it counts as
+ * resident.
+ */
 class RecentlyUsedCache : public TextureCache
 {
 public:
+    static std::size_t const default_budget_bytes = 256 * 1024 * 1024;
+    static unsigned const default_max_idle_frames = 300;
+
+    RecentlyUsedCache();
+    RecentlyUsedCache(std::size_t budget_bytes, unsigned max_idle_frames);
+    RecentlyUsedCache(
+        std::size_t budget_bytes,
+        unsigned max_idle_frames,
+        std::shared_ptr<SharedUploads> const& shared_uploads);
+    ~RecentlyUsedCache();
+
     std::shared_ptr<Texture> load(graphics::Renderable const& renderable) override;
     void invalidate() override;
     void drop_unused() override;
+    Statistics statistics() const override;
 
 private:
     struct Entry
     {
-        Entry()
-         : texture(std::make_shared<Texture>())
-        {}
         std::shared_ptr<Texture> texture;
         graphics::BufferID last_bound_buffer;
-        bool used{true};
         bool valid_binding{false};
         std::shared_ptr<graphics::Buffer> resource;
+        geometry::Size size;
+        std::size_t bytes{0};
+        unsigned long last_used_frame{0};
+        std::list<graphics::Renderable::ID>::iterator lru_position;
     };
 
+    struct Spare
+    {
+        std::shared_ptr<Texture> texture;
+        geometry::Size size;
+        std::size_t bytes;
+        unsigned long retired_frame;
+    };
+
+    auto acquire_texture(geometry::Size size) -> std::shared_ptr<Texture>;
+    void retire(std::unordered_map<graphics::Renderable::ID, Entry>::iterator entry);
+    void evict_over_budget();
+
+    std::size_t const budget_bytes;
+    unsigned const max_idle_frames;
+    std::shared_ptr<SharedUploads> const shared_uploads;
+
     std::unordered_map<graphics::Renderable::ID, Entry> textures;
+    std::list<graphics::Renderable::ID> lru;    // Most recently used first
+    std::list<Spare> spares;                    // Oldest retired first
+    unsigned long frame{0};
+    Statistics stats{0, 0, 0, 0, 0};
 };
 }
 }
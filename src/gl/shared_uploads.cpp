@@ -0,0 +1,157 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shared_uploads.h"
+#include "mir/gl/texture.h"
+#include "mir/graphics/buffer.h"
+
+#include <cstring>
+
+namespace mg = mir::graphics;
+namespace mgl = mir::gl;
+
+mgl::SharedUploads::SharedUploads() = default;
+
+mgl::SharedUploads::~SharedUploads() = default;
+
+void mgl::SharedUploads::add_user()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    ++users;
+}
+
+void mgl::SharedUploads::remove_user()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    --users;
+}
+
+auto mgl::SharedUploads::find(std::shared_ptr<mg::Buffer> const& buffer) -> std::shared_ptr<Texture>
+{
+    std::unique_lock<decltype(mutex)> lock{mutex};
+
+    auto upload = uploads.find(buffer.get());
+    if (upload == uploads.end())
+        return nullptr;
+
+    // The address may have been reused by a newer buffer
+    if (upload->second.buffer.lock() != buffer || upload->second.id != buffer->id())
+    {
+        uploads.erase(upload);
+        return nullptr;
+    }
+
+    auto texture = upload->second.texture.lock();
+    if (!texture)
+    {
+        uploads.erase(upload);
+        return nullptr;
+    }
+
+    auto const fence = upload->second.fence;
+    if (!fence)
+        return texture;
+
+    auto const display = upload->second.display;
+    lock.unlock();
+
+    // Normally long since signalled: the uploader flushed it before the
+    // other outputs got round to this buffer
+    wait_fence(display, fence.get(), 0, EGL_FOREVER_KHR);
+
+    lock.lock();
+
+    // Once signalled, later finds need not wait for it
+    upload = uploads.find(buffer.get());
+    if (upload != uploads.end() && upload->second.fence == fence)
+        upload->second.fence.reset();
+
+    return texture;
+}
+
+void mgl::SharedUploads::publish(std::shared_ptr<mg::Buffer> const& buffer, std::shared_ptr<Texture> const& texture)
+{
+    auto const display = eglGetCurrentDisplay();
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    // With a single output there's no-one to share with, so don't pay for fences
+    if (users < 2)
+        return;
+
+    for (auto upload = uploads.begin(); upload != uploads.end();)
+    {
+        if (upload->second.buffer.expired() || upload->second.texture.expired())
+            upload = uploads.erase(upload);
+        else
+            ++upload;
+    }
+
+    uploads.erase(buffer.get());
+
+    resolve_fence_functions(display);
+
+    std::shared_ptr<void> fence;
+    if (create_fence)
+    {
+        auto const created = create_fence(display, EGL_SYNC_FENCE_KHR, nullptr);
+        if (created != EGL_NO_SYNC_KHR)
+            fence = {created, [display, destroy=destroy_fence](EGLSyncKHR sync) { destroy(display, sync); }};
+    }
+
+    if (fence)
+        glFlush();
+    else
+        glFinish();
+
+    uploads.emplace(buffer.get(), Upload{buffer, buffer->id(), texture, display, fence});
+}
+
+auto mgl::SharedUploads::withdraw(std::shared_ptr<Texture> const& texture) -> bool
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    for (auto upload = uploads.begin(); upload != uploads.end();)
+    {
+        auto const offered = upload->second.texture.lock();
+        if (!offered || offered == texture)
+            upload = uploads.erase(upload);
+        else
+            ++upload;
+    }
+
+    // With the texture no longer on offer, no-one else can acquire it
+    return texture.use_count() == 1;
+}
+
+void mgl::SharedUploads::resolve_fence_functions(EGLDisplay display)
+{
+    if (fence_functions_resolved)
+        return;
+
+    fence_functions_resolved = true;
+
+    auto const extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions || !strstr(extensions, "EGL_KHR_fence_sync"))
+        return;
+
+    create_fence = reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(eglGetProcAddress("eglCreateSyncKHR"));
+    destroy_fence = reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(eglGetProcAddress("eglDestroySyncKHR"));
+    wait_fence = reinterpret_cast<PFNEGLCLIENTWAITSYNCKHRPROC>(eglGetProcAddress("eglClientWaitSyncKHR"));
+
+    if (!create_fence || !destroy_fence || !wait_fence)
+        create_fence = nullptr;
+}
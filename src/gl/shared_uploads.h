@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GL_SHARED_UPLOADS_H_
+#define MIR_GL_SHARED_UPLOADS_H_
+
+#include "mir/graphics/buffer_id.h"
+
+#define EGL_EGLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mir
+{
+namespace graphics { class Buffer; }
+namespace gl
+{
+class Texture;
+
+/**
+ * Textures loaded from client buffers, shared between the texture caches of
+ * the per-output renderers.
+ *
+ * The output contexts share a texture namespace, so a buffer shown on several
+ * outputs need only be uploaded by whichever renderer gets to it first; the
+ * others draw from the same texture. A fence published with each upload makes
+ * the contents visible to the other contexts.
+ */
+class SharedUploads
+{
+public:
+    SharedUploads();
+    ~SharedUploads();
+
+    /// Register (or unregister) a texture cache drawing from these uploads
+    void add_user();
+    void remove_user();
+
+    /**
+     * A texture another renderer has already loaded the current contents of
+     * buffer into, or null. Must be called with a current GL context.
+     */
+    auto find(std::shared_ptr<graphics::Buffer> const& buffer) -> std::shared_ptr<Texture>;
+
+    /**
+     * Offer texture, just loaded from buffer in the current GL context, to
+     * the other renderers.
+     */
+    void publish(std::shared_ptr<graphics::Buffer> const& buffer, std::shared_ptr<Texture> const& texture);
+
+    /**
+     * Stop offering texture to other renderers.
+     *   \returns
+     *       true if the caller holds the only reference to texture, so may
+     *       load new contents into it.
+     */
+    auto withdraw(std::shared_ptr<Texture> const& texture) -> bool;
+
+private:
+    SharedUploads(SharedUploads const&) = delete;
+    SharedUploads& operator=(SharedUploads const&) = delete;
+
+    struct Upload
+    {
+        std::weak_ptr<graphics::Buffer> buffer;
+        graphics::BufferID id;
+        std::weak_ptr<Texture> texture;
+        EGLDisplay display;
+        /// Shared so that it can be waited for without holding the mutex
+        std::shared_ptr<void> fence;
+    };
+
+    void resolve_fence_functions(EGLDisplay display);
+
+    std::mutex mutex;
+    std::unordered_map<graphics::Buffer const*, Upload> uploads;
+    int users{0};
+
+    bool fence_functions_resolved{false};
+    PFNEGLCREATESYNCKHRPROC create_fence{nullptr};
+    PFNEGLDESTROYSYNCKHRPROC destroy_fence{nullptr};
+    PFNEGLCLIENTWAITSYNCKHRPROC wait_fence{nullptr};
+};
+}
+}
+
+#endif /* MIR_GL_SHARED_UPLOADS_H_ */
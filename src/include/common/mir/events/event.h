@@ -73,6 +73,15 @@ struct MirEvent
     static mir::EventUPtr deserialize(std::string const& bytes);
     static std::string serialize(MirEvent const* event);
 
+    /// Decodes an event from a wire buffer without an intermediate string. The event is
+    /// copied into the new MirEvent's own (mutable) message; a buffer that isn't word
+    /// aligned is first copied to one that is.
+    static mir::EventUPtr deserialize(void const* data, size_t size);
+    /// The number of bytes serialize() will write for event
+    static size_t serialized_size(MirEvent const* event);
+    /// Serializes event into buffer, which must hold serialized_size(event) bytes
+    static void serialize(MirEvent const* event, void* buffer, size_t size);
+
 protected:
     MirEvent() = default;
 
@@ -21,14 +21,21 @@
 
 #include "program_factory.h"
 #include <mutex>
+#include <cstddef>
 
 namespace mir
 {
 namespace gl
 {
+class SharedUploads;
+
 class DefaultProgramFactory : public ProgramFactory
 {
 public:
+    DefaultProgramFactory();
+    explicit DefaultProgramFactory(std::size_t texture_cache_budget_bytes);
+    ~DefaultProgramFactory();
+
     std::unique_ptr<Program> create_gl_program(std::string const&, std::string const&) const override;
     std::unique_ptr<TextureCache> create_texture_cache() const override;
 
@@ -40,6 +47,11 @@ private:
      * have the same or shared EGL contexts.
      */
     std::mutex mutable mutex;
+
+    std::size_t const texture_cache_budget_bytes;
+
+    /// Shared by all the texture caches created, so each buffer is uploaded once
+    std::shared_ptr<SharedUploads> const shared_uploads;
 };
 }
 }
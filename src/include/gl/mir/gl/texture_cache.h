@@ -21,6 +21,7 @@
 #define MIR_GL_TEXTURE_CACHE_H_
 
 #include <memory>
+#include <cstddef>
 
 namespace mir
 {
@@ -57,6 +58,21 @@ public:
      */
     virtual void drop_unused() = 0;
 
+    struct Statistics
+    {
+        std::size_t hits;           ///< Loads that reused the existing binding
+        std::size_t misses;         ///< Loads that had to (re)bind the buffer
+        std::size_t evictions;      ///< Textures retired from the cache
+        std::size_t uploaded_bytes; ///< Estimated bytes transferred by the misses
+        std::size_t resident_bytes; ///< Estimated GPU memory currently held
+    };
+
+    /**
+     * Cumulative usage counters since the cache was created. Does not
+     * require a GL context.
+     */
+    virtual Statistics statistics() const = 0;
+
 protected:
     TextureCache() = default;
 private:
@@ -37,6 +37,11 @@ extern char const* const session_mediator_report_opt;
 extern char const* const msg_processor_report_opt;
 extern char const* const shared_library_prober_report_opt;
 extern char const* const shell_report_opt;
+extern char const* const startup_report_opt;
+extern char const* const metrics_socket_opt;
+extern char const* const frame_timeline_budget_opt;
+extern char const* const frame_timeline_history_opt;
+extern char const* const frame_timeline_path_opt;
 extern char const* const compositor_report_opt;
 extern char const* const display_report_opt;
 extern char const* const legacy_input_report_opt;
@@ -47,13 +52,18 @@ extern char const* const seat_report_opt;
 extern char const* const host_socket_opt;
 extern char const* const nested_passthrough_opt;
 extern char const* const frontend_threads_opt;
+extern char const* const client_queue_limit_opt;
+extern char const* const client_queue_overflow_opt;
 extern char const* const touchspots_opt;
 extern char const* const cursor_opt;
 extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
 extern char const* const composite_delay_opt;
+extern char const* const texture_cache_budget_opt;
 extern char const* const enable_key_repeat_opt;
+extern char const* const multi_seat_opt;
 extern char const* const x11_display_opt;
+extern char const* const x11_prespawn_delay_opt;
 extern char const* const wayland_extensions_opt;
 extern char const* const wayland_extensions_value;
 
@@ -69,6 +79,7 @@ extern char const* const lttng_opt_value;
 extern char const* const platform_graphics_lib;
 extern char const* const platform_input_lib;
 extern char const* const platform_path;
+extern char const* const platform_probe_cache_opt;
 
 extern char const* const console_provider;
 extern char const* const logind_console;
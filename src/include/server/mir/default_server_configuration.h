@@ -31,6 +31,8 @@ namespace mir
 class ServerActionQueue;
 class SharedLibrary;
 class SharedLibraryProberReport;
+class StartupPhaseTracker;
+class PlatformProbeCache;
 
 template<class Observer>
 class ObserverRegistrar;
@@ -142,6 +144,7 @@ class CursorListener;
 class TouchVisualizer;
 class CursorImages;
 class Seat;
+class Seats;
 class KeyMapper;
 }
 
@@ -159,6 +162,8 @@ class Configuration;
 namespace report
 {
 class ReportFactory;
+namespace metrics { class Registry; }
+namespace frame_timeline { class Recorder; }
 }
 
 namespace renderer
@@ -339,6 +344,8 @@ public:
     virtual std::shared_ptr<input::CursorListener> the_cursor_listener();
     virtual std::shared_ptr<input::TouchVisualizer> the_touch_visualizer();
     virtual std::shared_ptr<input::Seat> the_seat();
+    /// The default seat, and with --multi-seat those built for devices on other seats
+    virtual std::shared_ptr<input::Seats> the_seats();
     virtual std::shared_ptr<input::KeyMapper> the_key_mapper();
 
     // new input reading related parts:
@@ -358,9 +365,18 @@ public:
     virtual std::shared_ptr<ServerActionQueue> the_server_action_queue();
     virtual std::shared_ptr<SharedLibraryProberReport>  the_shared_library_prober_report();
 
+    /// The performance metrics, or null unless enabled by --metrics-socket
+    virtual std::shared_ptr<report::metrics::Registry> the_metrics_registry();
+
+    /// The recorder of frame timelines, or null unless enabled by --frame-timeline-budget
+    virtual std::shared_ptr<report::frame_timeline::Recorder> the_frame_timeline_recorder();
+
     virtual std::shared_ptr<ConsoleServices> the_console_services();
     auto default_reports() -> std::shared_ptr<void>;
 
+    /// Times the construction of the main server components
+    auto the_startup_phase_tracker() const -> std::shared_ptr<StartupPhaseTracker>;
+
 private:
     // We need to ensure the platform library is destroyed last as the
     // DisplayConfiguration can hold weak_ptrs to objects created from the library
@@ -411,6 +427,7 @@ protected:
     CachedPtr<input::CursorListener> cursor_listener;
     CachedPtr<input::TouchVisualizer> touch_visualizer;
     CachedPtr<input::Seat> seat;
+    CachedPtr<input::Seats> seats;
     CachedPtr<graphics::Platform>     graphics_platform;
     CachedPtr<graphics::GraphicBufferAllocator> buffer_allocator;
     CachedPtr<graphics::Display>      display;
@@ -458,6 +475,8 @@ protected:
     CachedPtr<shell::HostLifecycleEventListener> host_lifecycle_event_listener;
     CachedPtr<shell::PersistentSurfaceStore> persistent_surface_store;
     CachedPtr<SharedLibraryProberReport> shared_library_prober_report;
+    CachedPtr<report::metrics::Registry> metrics_registry;
+    CachedPtr<report::frame_timeline::Recorder> frame_timeline_recorder;
     CachedPtr<shell::Shell> shell;
     CachedPtr<shell::ShellReport> shell_report;
     CachedPtr<scene::ApplicationNotRespondingDetector> application_not_responding_detector;
@@ -467,6 +486,7 @@ protected:
 
 private:
     std::shared_ptr<options::Configuration> const configuration_options;
+    std::shared_ptr<StartupPhaseTracker> const startup_phase_tracker;
     std::shared_ptr<input::EventFilter> default_filter;
     CachedPtr<ObserverMultiplexer<graphics::DisplayConfigurationObserver>>
         display_configuration_observer_multiplexer;
@@ -483,6 +503,10 @@ private:
 
     std::shared_ptr<scene::BroadcastingSessionEventSink> the_broadcasting_session_event_sink();
 
+    CachedPtr<PlatformProbeCache> platform_probe_cache;
+
+    auto the_platform_probe_cache() -> std::shared_ptr<PlatformProbeCache>;
+
     auto report_factory(char const* report_opt) -> std::unique_ptr<report::ReportFactory>;
 
     CachedPtr<shell::detail::FrontendShell> frontend_shell;
@@ -39,6 +39,7 @@ class DisplayServer;
 class SocketConnection;
 class MessageProcessor;
 class ProtobufMessageSender;
+enum class QueueOverflowPolicy;
 }
 
 class ProtobufConnectionCreator : public ConnectionCreator
@@ -49,6 +50,13 @@ public:
         std::shared_ptr<SessionAuthorizer> const& session_authorizer,
         std::shared_ptr<graphics::PlatformIpcOperations> const& operations,
         std::shared_ptr<MessageProcessorReport> const& report);
+    ProtobufConnectionCreator(
+        std::shared_ptr<ProtobufIpcFactory> const& ipc_factory,
+        std::shared_ptr<SessionAuthorizer> const& session_authorizer,
+        std::shared_ptr<graphics::PlatformIpcOperations> const& operations,
+        std::shared_ptr<MessageProcessorReport> const& report,
+        size_t client_queue_limit,
+        detail::QueueOverflowPolicy client_queue_overflow_policy);
     ~ProtobufConnectionCreator() noexcept;
 
     void create_connection_for(
@@ -67,6 +75,8 @@ private:
     std::shared_ptr<SessionAuthorizer> const session_authorizer;
     std::shared_ptr<graphics::PlatformIpcOperations> const operations;
     std::shared_ptr<MessageProcessorReport> const report;
+    size_t const client_queue_limit;
+    detail::QueueOverflowPolicy const client_queue_overflow_policy;
     std::atomic<int> next_session_id;
     std::shared_ptr<detail::Connections<detail::SocketConnection>> const connections;
 };
@@ -31,6 +31,7 @@ class Option;
 class EmergencyCleanupRegistry;
 class SharedLibraryProberReport;
 class ConsoleServices;
+class PlatformProbeCache;
 
 namespace input
 {
@@ -46,6 +47,16 @@ mir::UniqueModulePtr<Platform> probe_input_platforms(
     std::shared_ptr<InputReport> const& input_report,
     SharedLibraryProberReport & prober_report);
 
+/// As above, but first tries the module \p probe_cache remembers, and remembers the module selected
+mir::UniqueModulePtr<Platform> probe_input_platforms(
+    options::Option const& options,
+    std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
+    std::shared_ptr<InputDeviceRegistry> const& device_registry,
+    std::shared_ptr<ConsoleServices> const& console,
+    std::shared_ptr<InputReport> const& input_report,
+    SharedLibraryProberReport & prober_report,
+    PlatformProbeCache const& probe_cache);
+
 /// Tries to create an input platform from the graphics module, otherwise returns a null pointer
 auto input_platform_from_graphics_module(
     graphics::Platform const& graphics_platform,
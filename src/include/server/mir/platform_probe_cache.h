@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_PLATFORM_PROBE_CACHE_H_
+#define MIR_PLATFORM_PROBE_CACHE_H_
+
+#include "mir/optional_value.h"
+
+#include <string>
+
+namespace mir
+{
+/// Remembers which platform module probing selected, so that a server restarted with the
+/// same platform modules and the same devices (DRM and input nodes) can load that module
+/// directly rather than loading and probing every module.
+///
+/// The cache is best-effort: any failure to read or write it just means probing happens.
+class PlatformProbeCache
+{
+public:
+    /// \param cache_file   where to persist the selections (if empty, nothing is cached)
+    /// \param module_path  the directory searched for platform modules
+    PlatformProbeCache(std::string const& cache_file, std::string const& module_path);
+
+    /// \return the module previously selected for \p kind, provided nothing relevant has changed
+    auto selected_module(std::string const& kind) const -> optional_value<std::string>;
+
+    /// Record that probing selected \p module for \p kind
+    void module_selected(std::string const& kind, std::string const& module) const;
+
+    /// \return the filename of the module containing \p address (e.g. one of its functions)
+    static auto module_containing(void* address) -> std::string;
+
+private:
+    std::string const cache_file;
+    std::string const fingerprint;
+};
+}
+
+#endif /* MIR_PLATFORM_PROBE_CACHE_H_ */
@@ -34,6 +34,8 @@ public:
     using BasicObservers<SurfaceObserver>::remove;
     using BasicObservers<SurfaceObserver>::for_each;
 
+    ~SurfaceObservers();
+
     void attrib_changed(Surface const* surf, MirWindowAttrib attrib, int value) override;
     void resized_to(Surface const* surf, geometry::Size const& size) override;
     void moved_to(Surface const* surf, geometry::Point const& top_left) override;
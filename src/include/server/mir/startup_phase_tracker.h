@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_STARTUP_PHASE_TRACKER_H_
+#define MIR_STARTUP_PHASE_TRACKER_H_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mir
+{
+/// Records how long each phase of server startup takes.
+/// Phases may nest (e.g. constructing the display constructs the graphics platform) and may be
+/// recorded from several threads; each completed phase is kept in the order it started.
+class StartupPhaseTracker
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Record
+    {
+        std::string name;
+        Clock::duration start;      ///< Offset from the construction of the tracker
+        Clock::duration duration;   ///< Wall time spent in the phase, including nested phases
+        int depth;                  ///< Phases already in progress on the thread that began this one
+    };
+
+    /// Marks a phase in progress. The phase ends when this is destroyed.
+    class Phase
+    {
+    public:
+        Phase(StartupPhaseTracker& tracker, std::string const& name);
+        ~Phase();
+
+    private:
+        Phase(Phase const&) = delete;
+        Phase& operator=(Phase const&) = delete;
+
+        StartupPhaseTracker& tracker;
+        Clock::time_point const started;
+        std::size_t const index;
+    };
+
+    StartupPhaseTracker();
+
+    auto phase(std::string const& name) -> std::unique_ptr<Phase>;
+
+    auto records() const -> std::vector<Record>;
+
+    /// Writes the recorded phases to the log
+    void log_report() const;
+
+private:
+    StartupPhaseTracker(StartupPhaseTracker const&) = delete;
+    StartupPhaseTracker& operator=(StartupPhaseTracker const&) = delete;
+
+    auto begin(std::string const& name, Clock::time_point started) -> std::size_t;
+    void end(std::size_t index, Clock::duration duration);
+
+    Clock::time_point const created;
+
+    std::mutex mutable mutex;
+    std::vector<Record> phases;
+
+    struct OpenPhase
+    {
+        std::size_t index;
+        std::thread::id thread;     ///< The thread the phase began on
+    };
+    std::vector<OpenPhase> open_phases;
+};
+}
+
+#endif /* MIR_STARTUP_PHASE_TRACKER_H_ */
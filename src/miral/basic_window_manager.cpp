@@ -21,6 +21,7 @@
 
 #include "miral/window_manager_tools.h"
 
+#include <mir/scene/scene_change_transaction.h>
 #include <mir/scene/session.h>
 #include <mir/scene/surface.h>
 #include <mir/scene/surface_creation_parameters.h>
@@ -42,19 +43,44 @@ int const title_bar_height = 12;
 
 struct miral::BasicWindowManager::Locker
 {
+    struct ForInput {};
+
     explicit Locker(miral::BasicWindowManager* self);
+    Locker(miral::BasicWindowManager* self, ForInput);
 
     ~Locker()
     {
         policy->advise_end();
     }
 
-    std::lock_guard<std::mutex> const lock;
+    /// Notify the scene observers of the operation's changes, once it has succeeded
+    void commit()
+    {
+        transaction.commit();
+    }
+
+    std::unique_lock<InputPriorityMutex> const lock;
     WindowManagementPolicy* const policy;
+
+    // Observers see the scene changes made by each window management operation together
+    mir::scene::SceneChangeTransaction transaction;
+
+private:
+    Locker(miral::BasicWindowManager* self, std::unique_lock<InputPriorityMutex>&& lock);
 };
 
 miral::BasicWindowManager::Locker::Locker(BasicWindowManager* self) :
-    lock{self->mutex},
+    Locker{self, std::unique_lock<InputPriorityMutex>{self->mutex}}
+{
+}
+
+miral::BasicWindowManager::Locker::Locker(BasicWindowManager* self, ForInput) :
+    Locker{self, (self->mutex.lock_for_input(), std::unique_lock<InputPriorityMutex>{self->mutex, std::adopt_lock})}
+{
+}
+
+miral::BasicWindowManager::Locker::Locker(BasicWindowManager* self, std::unique_lock<InputPriorityMutex>&& lock) :
+    lock{std::move(lock)},
     policy{self->policy.get()}
 {
     policy->advise_begin();
@@ -95,6 +121,7 @@ void miral::BasicWindowManager::add_session(std::shared_ptr<scene::Session> cons
 {
     Locker lock{this};
     policy->advise_new_app(app_info[session] = ApplicationInfo(session));
+    lock.commit();
 }
 
 void miral::BasicWindowManager::remove_session(std::shared_ptr<scene::Session> const& session)
@@ -102,6 +129,7 @@ void miral::BasicWindowManager::remove_session(std::shared_ptr<scene::Session> c
     Locker lock{this};
     policy->advise_delete_app(app_info[session]);
     app_info.erase(session);
+    lock.commit();
 }
 
 auto miral::BasicWindowManager::add_surface(
@@ -158,7 +186,7 @@ auto miral::BasicWindowManager::add_surface(
     std::shared_ptr<scene::Surface> const scene_surface = window_info.window();
     scene_surface->add_observer(std::make_shared<shell::SurfaceReadyObserver>(
         [this, &window_info](std::shared_ptr<scene::Session> const&, std::shared_ptr<scene::Surface> const&)
-            { Locker lock{this}; policy->handle_window_ready(window_info); },
+            { Locker lock{this}; policy->handle_window_ready(window_info); lock.commit(); },
         session,
         scene_surface));
 
@@ -169,6 +197,7 @@ auto miral::BasicWindowManager::add_surface(
         mir_surface->placed_relative(relative_placement);
     }
 
+    lock.commit();
     return surface_id;
 }
 
@@ -183,6 +212,7 @@ void miral::BasicWindowManager::modify_surface(
     validate_modification_request(mods, info);
     place_and_size_for_state(mods, info);
     policy->handle_modify_window(info, mods);
+    lock.commit();
 }
 
 void miral::BasicWindowManager::remove_surface(
@@ -198,6 +228,7 @@ void miral::BasicWindowManager::remove_surface(
     {
         fatal_error("Could not find surface to remove in miral::BasicWindowManager::remove_surface()");
     }
+    lock.commit();
 }
 
 void miral::BasicWindowManager::remove_window(Application const& application, miral::WindowInfo const& info)
@@ -255,16 +286,8 @@ void miral::BasicWindowManager::refocus(
                 // select_active_window() calls set_focus_to() which updates mru_active_windows and changes window
                 auto const w = window;
 
-                for (auto const& workspace : workspaces_containing(w))
-                {
-                    for (auto const& ww : workspaces_containing_window)
-                    {
-                        if (ww == workspace)
-                        {
-                            return !(new_focus = select_active_window(w));
-                        }
-                    }
-                }
+                if (in_any_workspace(w, workspaces_containing_window))
+                    return !(new_focus = select_active_window(w));
 
                 return true;
             });
@@ -319,28 +342,34 @@ void miral::BasicWindowManager::remove_display(geometry::Rectangle const& /*area
 
 bool miral::BasicWindowManager::handle_keyboard_event(MirKeyboardEvent const* event)
 {
-    Locker lock{this};
+    Locker lock{this, Locker::ForInput{}};
     update_event_timestamp(event);
-    return policy->handle_keyboard_event(event);
+    auto const consumed = policy->handle_keyboard_event(event);
+    lock.commit();
+    return consumed;
 }
 
 bool miral::BasicWindowManager::handle_touch_event(MirTouchEvent const* event)
 {
-    Locker lock{this};
+    Locker lock{this, Locker::ForInput{}};
     update_event_timestamp(event);
-    return policy->handle_touch_event(event);
+    auto const consumed = policy->handle_touch_event(event);
+    lock.commit();
+    return consumed;
 }
 
 bool miral::BasicWindowManager::handle_pointer_event(MirPointerEvent const* event)
 {
-    Locker lock{this};
+    Locker lock{this, Locker::ForInput{}};
     update_event_timestamp(event);
 
     cursor = {
         mir_pointer_event_axis_value(event, mir_pointer_axis_x),
         mir_pointer_event_axis_value(event, mir_pointer_axis_y)};
 
-    return policy->handle_pointer_event(event);
+    auto const consumed = policy->handle_pointer_event(event);
+    lock.commit();
+    return consumed;
 }
 
 void miral::BasicWindowManager::handle_raise_surface(
@@ -351,6 +380,7 @@ void miral::BasicWindowManager::handle_raise_surface(
     Locker lock{this};
     if (timestamp >= last_input_event_timestamp)
         policy->handle_raise_window(info_for(surface));
+    lock.commit();
 }
 
 void miral::BasicWindowManager::handle_request_drag_and_drop(
@@ -361,6 +391,7 @@ void miral::BasicWindowManager::handle_request_drag_and_drop(
     Locker lock{this};
     if (timestamp >= last_input_event_timestamp)
         policy->handle_request_drag_and_drop(info_for(surface));
+    lock.commit();
 }
 
 void miral::BasicWindowManager::handle_request_move(
@@ -430,6 +461,7 @@ int miral::BasicWindowManager::set_surface_attribute(
     validate_modification_request(modification, info);
     place_and_size_for_state(modification, info);
     policy->handle_modify_window(info, modification);
+    lock.commit();
 
     switch (attrib)
     {
@@ -631,6 +663,26 @@ auto miral::BasicWindowManager::workspaces_containing(Window const& window) cons
     return workspaces_containing_window;
 }
 
+auto miral::BasicWindowManager::in_any_workspace(
+    Window const& window, std::vector<std::shared_ptr<Workspace>> const& workspaces) const -> bool
+{
+    if (workspaces.empty())
+        return false;
+
+    auto const iter_pair = workspaces_to_windows.right.equal_range(window);
+
+    for (auto kv = iter_pair.first; kv != iter_pair.second; ++kv)
+    {
+        if (auto const workspace = kv->second.lock())
+        {
+            if (std::find(begin(workspaces), end(workspaces), workspace) != end(workspaces))
+                return true;
+        }
+    }
+
+    return false;
+}
+
 void miral::BasicWindowManager::focus_next_within_application()
 {
     if (auto const prev = active_window())
@@ -643,32 +695,20 @@ void miral::BasicWindowManager::focus_next_within_application()
         {
             while (++current != end(siblings))
             {
-                for (auto const& workspace : workspaces_containing(*current))
+                if (in_any_workspace(*current, workspaces_containing_window))
                 {
-                    for (auto const& ww : workspaces_containing_window)
-                    {
-                        if (ww == workspace)
-                        {
-                            if (prev != select_active_window(*current))
-                                return;
-                        }
-                    }
+                    if (prev != select_active_window(*current))
+                        return;
                 }
             }
         }
 
         for (current = begin(siblings); *current != prev; ++current)
         {
-            for (auto const& workspace : workspaces_containing(*current))
+            if (in_any_workspace(*current, workspaces_containing_window))
             {
-                for (auto const& ww : workspaces_containing_window)
-                {
-                    if (ww == workspace)
-                    {
-                        if (prev != select_active_window(*current))
-                            return;
-                    }
-                }
+                if (prev != select_active_window(*current))
+                    return;
             }
         }
 
@@ -700,32 +740,20 @@ void miral::BasicWindowManager::focus_prev_within_application()
         {
             while (++current != rend(siblings))
             {
-                for (auto const& workspace : workspaces_containing(*current))
+                if (in_any_workspace(*current, workspaces_containing_window))
                 {
-                    for (auto const& ww : workspaces_containing_window)
-                    {
-                        if (ww == workspace)
-                        {
-                            if (prev != select_active_window(*current))
-                                return;
-                        }
-                    }
+                    if (prev != select_active_window(*current))
+                        return;
                 }
             }
         }
 
         for (current = rbegin(siblings); *current != prev; ++current)
         {
-            for (auto const& workspace : workspaces_containing(*current))
+            if (in_any_workspace(*current, workspaces_containing_window))
             {
-                for (auto const& ww : workspaces_containing_window)
-                {
-                    if (ww == workspace)
-                    {
-                        if (prev != select_active_window(*current))
-                            return;
-                    }
-                }
+                if (prev != select_active_window(*current))
+                    return;
             }
         }
 
@@ -748,6 +776,7 @@ void miral::BasicWindowManager::focus_prev_within_application()
 auto miral::BasicWindowManager::window_at(geometry::Point cursor) const
 -> Window
 {
+    // Hit-testing is done by the scene, which owns the stacking order; there is no per-output index here
     auto surface_at = focus_controller->surface_at(cursor);
     return surface_at ? info_for(surface_at).window() : Window{};
 }
@@ -1228,16 +1257,8 @@ void miral::BasicWindowManager::set_state(miral::WindowInfo& window_info, MirWin
                         if (candidate == window)
                             return true;
                         auto const w = candidate;
-                        for (auto const& workspace : workspaces_containing(w))
-                        {
-                            for (auto const& ww : workspaces_containing_window)
-                            {
-                                if (ww == workspace)
-                                {
-                                    return !(select_active_window(w));
-                                }
-                            }
-                        }
+                        if (in_any_workspace(w, workspaces_containing_window))
+                            return !(select_active_window(w));
 
                         return true;
                     });
@@ -1319,6 +1340,7 @@ void miral::BasicWindowManager::invoke_under_lock(std::function<void()> const& c
 {
     Locker lock{this};
     callback();
+    lock.commit();
 }
 
 auto miral::BasicWindowManager::select_active_window(Window const& hint) -> miral::Window
@@ -1447,11 +1469,11 @@ auto miral::BasicWindowManager::can_activate_window_for_session(miral::Applicati
 {
     miral::Window new_focus;
 
-    mru_active_windows.enumerate([&](miral::Window& window)
+    mru_active_windows.enumerate(session, [&](miral::Window& window)
         {
             // select_active_window() calls set_focus_to() which updates mru_active_windows and changes window
             auto const w = window;
-            return w.application() != session || !(new_focus = select_active_window(w));
+            return !(new_focus = select_active_window(w));
         });
 
     return new_focus;
@@ -1463,22 +1485,13 @@ auto miral::BasicWindowManager::can_activate_window_for_session_in_workspace(
 {
     miral::Window new_focus;
 
-    mru_active_windows.enumerate([&](miral::Window& window)
+    mru_active_windows.enumerate(session, [&](miral::Window& window)
         {
             // select_active_window() calls set_focus_to() which updates mru_active_windows and changes window
             auto const w = window;
 
-            if (w.application() != session)
-                return true;
-
-            for (auto const& workspace : workspaces_containing(w))
-            {
-                for (auto const& ww : workspaces)
-                {
-                    if (ww == workspace)
-                        return !(new_focus = select_active_window(w));
-                }
-            }
+            if (in_any_workspace(w, workspaces))
+                return !(new_focus = select_active_window(w));
 
             return true;
         });
@@ -2201,6 +2214,24 @@ void miral::BasicWindowManager::add_display_for_testing(mir::geometry::Rectangle
     outputs.add(area);
 
     update_windows_for_outputs();
+    lock.commit();
+}
+
+void miral::BasicWindowManager::advise_output_begin()
+{
+    Locker lock{this};
+    outputs_changing = true;
+    lock.commit();
+}
+
+void miral::BasicWindowManager::advise_output_end()
+{
+    Locker lock{this};
+    outputs_changing = false;
+
+    if (outputs_need_relayout)
+        update_windows_for_outputs();
+    lock.commit();
 }
 
 void miral::BasicWindowManager::advise_output_create(miral::Output const& output)
@@ -2208,8 +2239,9 @@ void miral::BasicWindowManager::advise_output_create(miral::Output const& output
     Locker lock{this};
     outputs.add(output.extents());
 
-    update_windows_for_outputs();
+    outputs_changed();
     policy->advise_output_create(output);
+    lock.commit();
 }
 
 void miral::BasicWindowManager::advise_output_update(miral::Output const& updated, miral::Output const& original)
@@ -2218,8 +2250,9 @@ void miral::BasicWindowManager::advise_output_update(miral::Output const& update
     outputs.remove(original.extents());
     outputs.add(updated.extents());
 
-    update_windows_for_outputs();
+    outputs_changed();
     policy->advise_output_update(updated, original);
+    lock.commit();
 }
 
 void miral::BasicWindowManager::advise_output_delete(miral::Output const& output)
@@ -2227,12 +2260,37 @@ void miral::BasicWindowManager::advise_output_delete(miral::Output const& output
     Locker lock{this};
     outputs.remove(output.extents());
 
-    update_windows_for_outputs();
+    outputs_changed();
     policy->advise_output_delete(output);
+    lock.commit();
+}
+
+void miral::BasicWindowManager::outputs_changed()
+{
+    if (outputs_changing)
+        outputs_need_relayout = true;
+    else
+        update_windows_for_outputs();
 }
 
 void miral::BasicWindowManager::update_windows_for_outputs()
 {
+    outputs_need_relayout = false;
+
+    // Work out where everything goes before moving anything, so that policies
+    // see a consistent layout and each window is placed (at most) once
+    for (auto const& placement : placements_for_outputs())
+    {
+        auto& info = info_for(placement.window);
+        place_and_size(info, placement.rect.top_left, placement.rect.size);
+    }
+}
+
+auto miral::BasicWindowManager::placements_for_outputs() -> std::vector<Placement>
+{
+    std::vector<Placement> placements;
+    placements.reserve(fullscreen_surfaces.size() + maximized_surfaces.size());
+
     for (auto const& window : fullscreen_surfaces)
     {
         if (window)
@@ -2240,12 +2298,12 @@ void miral::BasicWindowManager::update_windows_for_outputs()
             auto& info = info_for(window);
             auto const rect =
                 policy->confirm_placement_on_display(info, mir_window_state_fullscreen, fullscreen_rect_for(info));
-            place_and_size(info, rect.top_left, rect.size);
+            placements.push_back({window, rect});
         }
     }
 
     if (outputs.size() == 0)
-        return;
+        return placements;
 
     auto const display_area = outputs.bounding_rectangle();
 
@@ -2261,21 +2319,21 @@ void miral::BasicWindowManager::update_windows_for_outputs()
             {
             case mir_window_state_maximized:
                 rect = policy->confirm_placement_on_display(info1, mir_window_state_maximized, display_area);
-                place_and_size(info1, rect.top_left, rect.size);
+                placements.push_back({window, rect});
                 break;
 
             case mir_window_state_horizmaximized:
                 rect.top_left.x = display_area.top_left.x;
                 rect.size.width = display_area.size.width;
                 rect = policy->confirm_placement_on_display(info1, mir_window_state_horizmaximized, rect);
-                place_and_size(info1, rect.top_left, rect.size);
+                placements.push_back({window, rect});
                 break;
 
             case mir_window_state_vertmaximized:
                 rect.top_left.y = display_area.top_left.y;
                 rect.size.height = display_area.size.height;
                 rect = policy->confirm_placement_on_display(info1, mir_window_state_vertmaximized, rect);
-                place_and_size(info1, rect.top_left, rect.size);
+                placements.push_back({window, rect});
                 break;
 
             default:
@@ -2283,4 +2341,6 @@ void miral::BasicWindowManager::update_windows_for_outputs()
             }
         }
     }
+
+    return placements;
 }
@@ -26,6 +26,7 @@
 #include "active_outputs.h"
 #include "miral/application.h"
 #include "miral/application_info.h"
+#include "input_priority_mutex.h"
 #include "mru_window_list.h"
 
 #include <mir/geometry/rectangles.h>
@@ -215,7 +216,8 @@ private:
 
     std::unique_ptr<WindowManagementPolicy> const policy;
 
-    std::mutex mutex;
+    /// Input handlers take this with lock_for_input() so they don't queue behind surface and output changes
+    InputPriorityMutex mutex;
     SessionInfoMap app_info;
     SurfaceInfoMap window_info;
     mir::geometry::Rectangles outputs;
@@ -225,12 +227,16 @@ private:
     miral::MRUWindowList mru_active_windows;
     std::set<Window> fullscreen_surfaces;
     std::set<Window> maximized_surfaces;
+    bool outputs_changing{false};
+    bool outputs_need_relayout{false};
 
     friend class Workspace;
     using wwbimap_t = boost::bimap<
         boost::bimaps::multiset_of<std::weak_ptr<Workspace>, std::owner_less<std::weak_ptr<Workspace>>>,
         boost::bimaps::multiset_of<Window>>;
 
+    /// Indexed from both sides: workspaces_containing() and for_each_window_in_workspace() look up
+    /// only the matching range, they don't walk other workspaces' windows
     wwbimap_t workspaces_to_windows;
 
     std::shared_ptr<DisplayConfigurationListeners> const display_config_monitor;
@@ -261,11 +267,25 @@ private:
     void refocus(Application const& application, Window const& parent,
                  std::vector<std::shared_ptr<Workspace>> const& workspaces_containing_window);
     auto workspaces_containing(Window const& window) const -> std::vector<std::shared_ptr<Workspace>>;
+    auto in_any_workspace(Window const& window, std::vector<std::shared_ptr<Workspace>> const& workspaces) const -> bool;
 
+    void advise_output_begin() override;
+    void advise_output_end() override;
     void advise_output_create(Output const& output) override;
     void advise_output_update(Output const& updated, Output const& original) override;
     void advise_output_delete(Output const& output) override;
+
+    /// While outputs are changing the relayout is deferred to advise_output_end()
+    void outputs_changed();
     void update_windows_for_outputs();
+
+    struct Placement
+    {
+        Window window;
+        Rectangle rect;
+    };
+
+    auto placements_for_outputs() -> std::vector<Placement>;
 };
 }
 
@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_priority_mutex.h"
+
+miral::InputPriorityMutex::InputPriorityMutex(unsigned max_input_ahead) :
+    max_input_ahead{max_input_ahead}
+{
+}
+
+void miral::InputPriorityMutex::lock()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    ++other_waiting;
+    released.wait(lock, [this] { return !locked && (input_waiting == 0 || input_ahead >= max_input_ahead); });
+    --other_waiting;
+    locked = true;
+    input_ahead = 0;
+}
+
+void miral::InputPriorityMutex::lock_for_input()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    ++input_waiting;
+    released.wait(lock, [this] { return !locked && (other_waiting == 0 || input_ahead < max_input_ahead); });
+    --input_waiting;
+    locked = true;
+    input_ahead = other_waiting ? input_ahead + 1 : 0;
+}
+
+void miral::InputPriorityMutex::unlock()
+{
+    {
+        std::lock_guard<std::mutex> const lock{mutex};
+        locked = false;
+    }
+    released.notify_all();
+}
+
+auto miral::InputPriorityMutex::waiting() -> unsigned
+{
+    std::lock_guard<std::mutex> const lock{mutex};
+    return input_waiting + other_waiting;
+}
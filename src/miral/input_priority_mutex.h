@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_INPUT_PRIORITY_MUTEX_H
+#define MIRAL_INPUT_PRIORITY_MUTEX_H
+
+#include <condition_variable>
+#include <mutex>
+
+namespace miral
+{
+/// A mutex (meeting the Lockable requirements) that grants waiting input handlers
+/// the lock ahead of any other waiting callers. So that a stream of input cannot starve
+/// the others, once input has taken the lock max_input_ahead times in succession while
+/// another caller waited, that caller goes next.
+class InputPriorityMutex
+{
+public:
+    explicit InputPriorityMutex(unsigned max_input_ahead = 8);
+
+    void lock();
+    void lock_for_input();
+    void unlock();
+
+    /// The number of callers waiting for the lock
+    auto waiting() -> unsigned;
+
+private:
+    unsigned const max_input_ahead;
+
+    std::mutex mutex;
+    std::condition_variable released;
+    bool locked{false};
+    unsigned input_waiting{0};
+    unsigned other_waiting{0};
+    unsigned input_ahead{0};
+};
+}
+
+#endif //MIRAL_INPUT_PRIORITY_MUTEX_H
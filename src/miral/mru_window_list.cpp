@@ -33,25 +33,100 @@ bool visible(miral::Window const& window)
 
 void miral::MRUWindowList::push(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
-    windows.push_back(window);
+    all.push(window);
+
+    // Remember the application a window was pushed for: it may be gone by the time it is erased
+    auto const known = application_of.find(window);
+    auto const application = known != application_of.end() ?
+        known->second : application_of.emplace(window, window.application()).first->second;
+
+    by_application[application].push(window);
 }
 
 void miral::MRUWindowList::erase(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
+    all.erase(window);
+
+    auto const known = application_of.find(window);
+    if (known == application_of.end())
+        return;
+
+    auto const ordering = by_application.find(known->second);
+    if (ordering != by_application.end())
+    {
+        ordering->second.erase(window);
+        if (ordering->second.empty())
+            by_application.erase(ordering);
+    }
+
+    application_of.erase(known);
 }
 
 auto miral::MRUWindowList::top() const -> Window
 {
-    auto const& found = std::find_if(rbegin(windows), rend(windows), visible);
-    return (found != rend(windows)) ? *found: Window{};
+    return all.top();
 }
 
 void miral::MRUWindowList::enumerate(Enumerator const& enumerator) const
 {
-    for (auto i = windows.rbegin(); i != windows.rend(); ++i)
-        if (visible(*i))
-            if (!enumerator(const_cast<Window&>(*i)))
+    all.enumerate(enumerator);
+}
+
+void miral::MRUWindowList::enumerate(Application const& application, Enumerator const& enumerator) const
+{
+    auto const ordering = by_application.find(application);
+    if (ordering != by_application.end())
+        ordering->second.enumerate(enumerator);
+}
+
+void miral::MRUWindowList::Ordering::push(Window const& window)
+{
+    auto const existing = positions.find(window);
+    if (existing != positions.end())
+    {
+        // splice() keeps the iterators held in positions valid
+        windows.splice(windows.end(), windows, existing->second);
+    }
+    else
+    {
+        positions.emplace(window, windows.insert(windows.end(), window));
+    }
+}
+
+auto miral::MRUWindowList::Ordering::erase(Window const& window) -> bool
+{
+    auto const existing = positions.find(window);
+    if (existing == positions.end())
+        return false;
+
+    windows.erase(existing->second);
+    positions.erase(existing);
+    return true;
+}
+
+auto miral::MRUWindowList::Ordering::top() const -> Window
+{
+    auto const& found = std::find_if(windows.rbegin(), windows.rend(), visible);
+    return (found != windows.rend()) ? *found: Window{};
+}
+
+void miral::MRUWindowList::Ordering::enumerate(Enumerator const& enumerator) const
+{
+    if (windows.empty())
+        return;
+
+    // The enumerator may push() the window it is given (moving it to the end)
+    // so find where to go next before calling it
+    auto i = std::prev(windows.end());
+    for (bool more = true; more;)
+    {
+        auto const current = i;
+        more = current != windows.begin();
+        if (more)
+            --i;
+
+        if (visible(*current))
+            if (!enumerator(const_cast<Window&>(*current)))
                 break;
+    }
 }
@@ -22,7 +22,9 @@
 #include <miral/window.h>
 
 #include <functional>
-#include <vector>
+#include <list>
+#include <map>
+#include <memory>
 
 namespace miral
 {
@@ -38,8 +40,31 @@ public:
 
     void enumerate(Enumerator const& enumerator) const;
 
+    /// Enumerate only the windows of application (without visiting those of other applications)
+    void enumerate(Application const& application, Enumerator const& enumerator) const;
+
 private:
-    std::vector<Window> windows;
+    /// Windows in least recently used order, indexed so they can be moved or removed without a search
+    class Ordering
+    {
+    public:
+        void push(Window const& window);
+        auto erase(Window const& window) -> bool;
+        auto empty() const -> bool { return windows.empty(); }
+
+        void enumerate(Enumerator const& enumerator) const;
+        auto top() const -> Window;
+
+    private:
+        std::list<Window> windows;
+        std::map<Window, std::list<Window>::iterator> positions;
+    };
+
+    using ApplicationKey = std::weak_ptr<mir::scene::Session>;
+
+    Ordering all;
+    std::map<ApplicationKey, Ordering, std::owner_less<ApplicationKey>> by_application;
+    std::map<Window, ApplicationKey> application_of;
 };
 }
 
@@ -37,6 +37,11 @@ void miral::X11Support::operator()(mir::Server& server) const
     server.add_configuration_option(
         mo::x11_display_opt,
         "DISPLAY socket to use for experimental X11 support (default: none).", mir::OptionType::integer);
+    server.add_configuration_option(
+        mo::x11_prespawn_delay_opt,
+        "Start the X server this many milliseconds after startup, rather than when the first X11 client "
+        "connects, so that client doesn't wait for it (default: start on first connection).",
+        mir::OptionType::integer);
 }
 
 miral::X11Support::~X11Support() = default;
@@ -897,3 +897,71 @@ xcursor_load_theme(const char *theme, int size,
 	if (inherits)
 		free(inherits);
 }
+
+/** Load a single cursor from a theme
+ *
+ * This function looks up the cursor with the given name in the theme
+ * directories (and then the inherited themes) and loads just that file,
+ * rather than every cursor in the theme. The images returned are those
+ * whose nominal size best matches the requested size. The caller is
+ * expected to destroy the result with XcursorImagesDestroy().
+ *
+ * \param theme The name of the theme to search
+ * \param name The name of the cursor to load
+ * \param size The desired nominal size of the cursor images
+ * \return The loaded images, or NULL if the cursor was not found
+ */
+XcursorImages *
+xcursor_load_cursor(const char *theme, const char *name, int size)
+{
+	char *full, *dir;
+	char *inherits = NULL;
+	const char *path, *i;
+	FILE *f;
+	XcursorImages *images = NULL;
+
+	if (!theme)
+		theme = "default";
+
+	if (!name)
+		return NULL;
+
+	for (path = XcursorLibraryPath();
+	     path && !images;
+	     path = _XcursorNextPath(path)) {
+		dir = _XcursorBuildThemeDir(path, theme);
+		if (!dir)
+			continue;
+
+		full = _XcursorBuildFullname(dir, "cursors", name);
+
+		if (full) {
+			f = fopen(full, "r");
+			if (f) {
+				images = XcursorFileLoadImages(f, size);
+				if (images)
+					XcursorImagesSetName(images, name);
+				fclose(f);
+			}
+			free(full);
+		}
+
+		if (!images && !inherits) {
+			full = _XcursorBuildFullname(dir, "", "index.theme");
+			if (full) {
+				inherits = _XcursorThemeInherits(full);
+				free(full);
+			}
+		}
+
+		free(dir);
+	}
+
+	for (i = inherits; i && !images; i = _XcursorNextPath(i))
+		images = xcursor_load_cursor(i, name, size);
+
+	if (inherits)
+		free(inherits);
+
+	return images;
+}
@@ -21,6 +21,7 @@
 #include <mir/graphics/cursor_image.h>
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 #include <string.h>
@@ -36,7 +37,6 @@ extern "C"
 }
 
 namespace mg = mir::graphics;
-namespace mi = mir::input;
 namespace geom = mir::geometry;
 
 namespace
@@ -142,22 +142,24 @@ xcursor_name_for_mir_cursor(std::string const& mir_cursor_name)
 }
 }
 
-miral::XCursorLoader::XCursorLoader()
+miral::XCursorLoader::XCursorLoader() :
+    XCursorLoader{"default"}
 {
-    load_cursor_theme("default");
 }
 
-miral::XCursorLoader::XCursorLoader(std::string const& theme)
+miral::XCursorLoader::XCursorLoader(std::string const& theme, std::size_t cache_capacity) :
+    theme{theme},
+    cache_capacity{std::max<std::size_t>(cache_capacity, 1)}
 {
-    load_cursor_theme(theme);
 }
 
-// Each XcursorImages represents images for the different sizes of a given symbolic cursor.
-void miral::XCursorLoader::load_appropriately_sized_image(_XcursorImages *images)
+auto miral::XCursorLoader::load_image(std::string const& xcursor_name, int nominal_size) const
+-> std::shared_ptr<mg::CursorImage>
 {
-    // We would rather take this lock in load_cursor_theme but the Xcursor lib style
-    // makes it difficult to use our standard 'pass the lg around to _locked members' pattern
-    std::lock_guard<std::mutex> lg(guard);
+    auto const images = xcursor_load_cursor(theme.c_str(), xcursor_name.c_str(), nominal_size);
+
+    if (!images)
+        return nullptr;
 
     // We have to save all the images as XCursor expects us to free them.
     // This contains the actual image data though, so we need to ensure they stay alive
@@ -167,49 +169,55 @@ void miral::XCursorLoader::load_appropriately_sized_image(_XcursorImages *images
             XcursorImagesDestroy(images);
         });
 
-    for (int i = 0; i < images->nimage; i++)
-    {
-        _XcursorImage *candidate = images->images[i];
-        if (candidate->width == mi::default_cursor_size.width.as_uint32_t() &&
-            candidate->height == mi::default_cursor_size.height.as_uint32_t())
-        {
-            loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(candidate, saved_xcursor_library_resource);
-            return;
-        }
-    }
+    if (images->nimage < 1)
+        return nullptr;
 
-    loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(images->images[0], saved_xcursor_library_resource);
+    // The loaded images all share the nominal size closest to that requested: any more
+    // than one are animation frames, which we don't support, so just use the first.
+    return std::make_shared<XCursorImage>(images->images[0], saved_xcursor_library_resource);
 }
 
-void miral::XCursorLoader::load_cursor_theme(std::string const& theme_name)
+auto miral::XCursorLoader::image_locked(std::string const& xcursor_name, int nominal_size)
+-> std::shared_ptr<mg::CursorImage>
 {
-    // Cursors are named by their square dimension...called the nominal size in XCursor terminology, so we just look up by width.
-    // Later we verify the actual size.
-    xcursor_load_theme(theme_name.c_str(), mi::default_cursor_size.width.as_uint32_t(),
-        [](XcursorImages* images, void *this_ptr)  -> void
-        {
-            // Can't use lambda capture as this lambda is thunked to a C function ptr
-            auto p = static_cast<miral::XCursorLoader*>(this_ptr);
-            p->load_appropriately_sized_image(images);
-        }, this);
+    CacheKey const key{xcursor_name, nominal_size};
+
+    auto const cached = loaded_images.find(key);
+    if (cached != loaded_images.end())
+    {
+        lru.splice(lru.begin(), lru, cached->second);
+        return cached->second->second;
+    }
+
+    auto const image = load_image(xcursor_name, nominal_size);
+
+    lru.emplace_front(key, image);
+    loaded_images[key] = lru.begin();
+
+    while (lru.size() > cache_capacity)
+    {
+        loaded_images.erase(lru.back().first);
+        lru.pop_back();
+    }
+
+    return image;
 }
 
 std::shared_ptr<mg::CursorImage> miral::XCursorLoader::image(
     std::string const& cursor_name,
-    geom::Size const& /*size*/)
+    geom::Size const& size)
 {
-    auto xcursor_name = xcursor_name_for_mir_cursor(cursor_name);
+    auto const xcursor_name = xcursor_name_for_mir_cursor(cursor_name);
+
+    // Cursors are named by their square dimension...called the nominal size in XCursor terminology,
+    // so we just look up by width.
+    auto const nominal_size = std::max(1, size.width.as_int());
 
     std::lock_guard<std::mutex> lg(guard);
 
-    auto it = loaded_images.find(xcursor_name);
-    if (it != loaded_images.end())
-        return it->second;
+    if (auto const image = image_locked(xcursor_name, nominal_size))
+        return image;
 
     // Fall back
-    it = loaded_images.find("arrow");
-    if (it != loaded_images.end())
-        return it->second;
-
-    return nullptr;
+    return image_locked("arrow", nominal_size);
 }
@@ -22,10 +22,12 @@
 
 #include "mir/input/cursor_images.h"
 
-#include <memory>
-#include <string>
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <tuple>
 
 // Unfortunately this library does not compile as C++ so we can not namespace it.
 extern "C"
@@ -37,12 +39,17 @@ namespace mir { namespace graphics { class CursorImage; } }
 
 namespace miral
 {
+/// Loads cursor images from an XCursor theme.
+/// Cursors are read from the theme on demand (rather than scanning the whole theme up front)
+/// and the images for each (name, size) are kept in a bounded LRU cache.
 class XCursorLoader : public mir::input::CursorImages
 {
 public:
+    static std::size_t const default_cache_capacity = 64;
+
     XCursorLoader();
 
-    explicit XCursorLoader(std::string const& theme);
+    explicit XCursorLoader(std::string const& theme, std::size_t cache_capacity = default_cache_capacity);
 
     virtual ~XCursorLoader() = default;
 
@@ -53,12 +60,23 @@ protected:
     XCursorLoader& operator=(XCursorLoader const&) = delete;
 
 private:
+    // (xcursor name, nominal size in pixels)
+    using CacheKey = std::tuple<std::string, int>;
+    using CacheEntry = std::pair<CacheKey, std::shared_ptr<mir::graphics::CursorImage>>;
+
+    std::string const theme;
+    std::size_t const cache_capacity;
+
     std::mutex guard;
 
-    std::map<std::string, std::shared_ptr<mir::graphics::CursorImage>> loaded_images;
+    // Most recently used at the front. A null image records a cursor the theme does not provide.
+    std::list<CacheEntry> lru;
+    std::map<CacheKey, std::list<CacheEntry>::iterator> loaded_images;
 
-    void load_cursor_theme(std::string const& theme_name);
-    void load_appropriately_sized_image(_XcursorImages *images);
+    auto image_locked(std::string const& xcursor_name, int nominal_size)
+        -> std::shared_ptr<mir::graphics::CursorImage>;
+    auto load_image(std::string const& xcursor_name, int nominal_size) const
+        -> std::shared_ptr<mir::graphics::CursorImage>;
 };
 }
 
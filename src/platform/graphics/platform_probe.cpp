@@ -17,86 +17,283 @@
  */
 
 #include "mir/log.h"
+#include "mir/console_services.h"
+#include "mir/fd.h"
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
 
 #include <boost/throw_exception.hpp>
 
+#include <future>
+#include <map>
+#include <mutex>
+
+#include <sys/sysmacros.h>
+
+namespace
+{
+/* Probes run concurrently, and several may want the same device (mesa-kms and eglstream both
+ * probe the DRM node). ConsoleServices implementations reject a device being acquired twice, and
+ * aren't synchronised for it, so the probes share a single acquisition of each device and their
+ * calls into the console are serialised. The lock covers only those calls, not the probes.
+ */
+class ProbeConsoleServices : public mir::ConsoleServices
+{
+public:
+    explicit ProbeConsoleServices(std::shared_ptr<mir::ConsoleServices> const& console) :
+        console{console}
+    {
+    }
+
+    void register_switch_handlers(
+        mir::graphics::EventHandlerRegister& handlers,
+        std::function<bool()> const& switch_away,
+        std::function<bool()> const& switch_back) override
+    {
+        std::lock_guard<std::mutex> lock{devices->mutex};
+        console->register_switch_handlers(handlers, switch_away, switch_back);
+    }
+
+    void restore() override
+    {
+        std::lock_guard<std::mutex> lock{devices->mutex};
+        console->restore();
+    }
+
+    std::unique_ptr<mir::VTSwitcher> create_vt_switcher() override
+    {
+        std::lock_guard<std::mutex> lock{devices->mutex};
+        return console->create_vt_switcher();
+    }
+
+    std::future<std::unique_ptr<mir::Device>> acquire_device(
+        int major, int minor,
+        std::unique_ptr<mir::Device::Observer> observer) override
+    {
+        std::shared_ptr<SharedDevice> shared;
+        {
+            std::lock_guard<std::mutex> lock{devices->mutex};
+            auto& entry = devices->acquired[makedev(major, minor)];
+
+            if (!(shared = entry.lock()))
+            {
+                shared = std::make_shared<SharedDevice>();
+                shared->device = console->acquire_device(
+                    major, minor, std::make_unique<FirstEventObserver>(*shared)).share();
+                entry = shared;
+            }
+        }
+
+        // Waits (without the lock) until the console has settled the device; rethrows its failure
+        shared->device.get();
+        shared->replay_first_event(*observer);
+
+        std::promise<std::unique_ptr<mir::Device>> handle;
+        handle.set_value(std::make_unique<DeviceHandle>(devices, std::move(shared), std::move(observer)));
+        return handle.get_future();
+    }
+
+private:
+    struct SharedDevice
+    {
+        enum class Event { none, activated, suspended, removed };
+
+        void replay_first_event(mir::Device::Observer& observer)
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            auto const event = first_event;
+            auto fd = device_fd;
+            lock.unlock();
+
+            switch (event)
+            {
+            case Event::activated: observer.activated(std::move(fd)); break;
+            case Event::suspended: observer.suspended(); break;
+            case Event::removed:   observer.removed(); break;
+            case Event::none:      break;
+            }
+        }
+
+        std::mutex mutex;
+        Event first_event{Event::none};
+        mir::Fd device_fd;
+        std::shared_future<std::unique_ptr<mir::Device>> device;
+    };
+
+    // Probes only check the device is usable, so they need only the event that settles it
+    class FirstEventObserver : public mir::Device::Observer
+    {
+    public:
+        explicit FirstEventObserver(SharedDevice& shared) : shared{shared} {}
+
+        void activated(mir::Fd&& device_fd) override
+        {
+            std::lock_guard<std::mutex> lock{shared.mutex};
+            if (shared.first_event == SharedDevice::Event::none)
+            {
+                shared.first_event = SharedDevice::Event::activated;
+                shared.device_fd = std::move(device_fd);
+            }
+        }
+
+        void suspended() override { record(SharedDevice::Event::suspended); }
+        void removed() override { record(SharedDevice::Event::removed); }
+
+    private:
+        void record(SharedDevice::Event event)
+        {
+            std::lock_guard<std::mutex> lock{shared.mutex};
+            if (shared.first_event == SharedDevice::Event::none)
+                shared.first_event = event;
+        }
+
+        SharedDevice& shared;
+    };
+
+    struct Devices
+    {
+        std::mutex mutex;
+        std::map<dev_t, std::weak_ptr<SharedDevice>> acquired;
+    };
+
+    class DeviceHandle : public mir::Device
+    {
+    public:
+        DeviceHandle(
+            std::shared_ptr<Devices> const& devices,
+            std::shared_ptr<SharedDevice> shared,
+            std::unique_ptr<mir::Device::Observer> observer) :
+            devices{devices},
+            shared{std::move(shared)},
+            observer{std::move(observer)}
+        {
+        }
+
+        ~DeviceHandle()
+        {
+            // The last handle releases the device back to the console; do that under the lock so
+            // another probe can't try to acquire it again before it is released
+            std::lock_guard<std::mutex> lock{devices->mutex};
+            shared.reset();
+        }
+
+    private:
+        std::shared_ptr<Devices> const devices;
+        std::shared_ptr<SharedDevice> shared;
+        std::unique_ptr<mir::Device::Observer> const observer;
+    };
+
+    std::shared_ptr<mir::ConsoleServices> const console;
+    std::shared_ptr<Devices> const devices{std::make_shared<Devices>()};
+};
+
+struct ProbeResult
+{
+    mir::graphics::PlatformPriority priority;
+    mir::ModuleProperties const* description;
+};
+
+auto probe_module(
+    std::shared_ptr<mir::SharedLibrary> const& module,
+    mir::options::ProgramOption const& options,
+    std::shared_ptr<mir::ConsoleServices> const& console) -> ProbeResult
+{
+    using namespace mir::graphics;
+
+    auto probe =
+        [module]() -> std::function<std::remove_pointer<PlatformProbe>::type>
+        {
+            try
+            {
+                return module->load_function<PlatformProbe>(
+                    "probe_graphics_platform",
+                    MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+            }
+            catch (std::runtime_error const&)
+            {
+                // Maybe we can load an earlier version?
+                auto obsolete_probe = module->load_function<obsolete_0_27::PlatformProbe>(
+                    "probe_graphics_platform",
+                    obsolete_0_27::symbol_version);
+
+                return [obsolete_probe](auto, auto const& options)
+                    {
+                        auto const priority = static_cast<unsigned int>(obsolete_probe(options));
+
+                        /*
+                         * Cap obsolete modules to just less than PlatformPriority::supported.
+                         * If *any* current module that will work, we want that instead.
+                         */
+                        return priority >= PlatformPriority::supported ?
+                            static_cast<PlatformPriority>(PlatformPriority::supported - 1) :
+                            static_cast<PlatformPriority>(priority);
+                    };
+            }
+        }();
+
+    auto module_priority = probe(console, options);
+
+    auto describe =
+        [module]()
+        {
+            try
+            {
+                return module->load_function<DescribeModule>(
+                    "describe_graphics_module",
+                    MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+
+            }
+            catch (std::runtime_error const&)
+            {
+                return module->load_function<DescribeModule>(
+                    "describe_graphics_module",
+                    obsolete_0_27::symbol_version);
+
+            }
+        }() ;
+
+    return {module_priority, describe()};
+}
+}
+
 std::shared_ptr<mir::SharedLibrary>
 mir::graphics::module_for_device(
     std::vector<std::shared_ptr<SharedLibrary>> const& modules,
     mir::options::ProgramOption const& options,
     std::shared_ptr<ConsoleServices> const& console)
 {
+    // Probing a module can be slow (opening devices, connecting to a host server...) and
+    // each probe is independent of the others, so run them concurrently.
+    auto const probe_console = console ? std::make_shared<ProbeConsoleServices>(console) : nullptr;
+    std::vector<std::future<ProbeResult>> probes;
+    probes.reserve(modules.size());
+
+    for (auto& module : modules)
+    {
+        probes.push_back(std::async(std::launch::async, &probe_module, module, std::cref(options), probe_console));
+    }
+
     mir::graphics::PlatformPriority best_priority_so_far = mir::graphics::unsupported;
     std::shared_ptr<mir::SharedLibrary> best_module_so_far;
-    for (auto& module : modules)
+    for (auto i = 0u; i != modules.size(); ++i)
     {
         try
         {
-            auto probe =
-                [module]() -> std::function<std::remove_pointer<PlatformProbe>::type>
-                {
-                    try
-                    {
-                        return module->load_function<PlatformProbe>(
-                            "probe_graphics_platform",
-                            MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-                    }
-                    catch (std::runtime_error const&)
-                    {
-                        // Maybe we can load an earlier version?
-                        auto obsolete_probe = module->load_function<obsolete_0_27::PlatformProbe>(
-                            "probe_graphics_platform",
-                            obsolete_0_27::symbol_version);
-
-                        return [obsolete_probe](auto, auto const& options)
-                            {
-                                auto const priority = static_cast<unsigned int>(obsolete_probe(options));
-
-                                /*
-                                 * Cap obsolete modules to just less than PlatformPriority::supported.
-                                 * If *any* current module that will work, we want that instead.
-                                 */
-                                return priority >= PlatformPriority::supported ?
-                                    static_cast<PlatformPriority>(PlatformPriority::supported - 1) :
-                                    static_cast<PlatformPriority>(priority);
-                            };
-                    }
-                }();
-
-            auto module_priority = probe(console, options);
-            if (module_priority > best_priority_so_far)
+            auto const result = probes[i].get();
+
+            if (result.priority > best_priority_so_far)
             {
-                best_priority_so_far = module_priority;
-                best_module_so_far = module;
+                best_priority_so_far = result.priority;
+                best_module_so_far = modules[i];
             }
 
-            auto describe =
-                [module]()
-                {
-                    try
-                    {
-                        return module->load_function<DescribeModule>(
-                            "describe_graphics_module",
-                            MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-
-                    }
-                    catch (std::runtime_error const&)
-                    {
-                        return module->load_function<DescribeModule>(
-                            "describe_graphics_module",
-                            obsolete_0_27::symbol_version);
-
-                    }
-                }() ;
-            auto desc = describe();
+            auto const desc = result.description;
             mir::log_info("Found graphics driver: %s (version %d.%d.%d) Support priority: %d",
                           desc->name,
                           desc->major_version,
                           desc->minor_version,
                           desc->micro_version,
-                          module_priority);
+                          result.priority);
         }
         catch (std::runtime_error const&)
         {
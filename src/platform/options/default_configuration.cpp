@@ -44,9 +44,17 @@ char const* const mo::input_report_opt            = "input-report";
 char const* const mo::seat_report_opt            = "seat-report";
 char const* const mo::shared_library_prober_report_opt = "shared-library-prober-report";
 char const* const mo::shell_report_opt            = "shell-report";
+char const* const mo::startup_report_opt          = "startup-report";
+char const* const mo::metrics_socket_opt          = "metrics-socket";
+char const* const mo::frame_timeline_budget_opt   = "frame-timeline-budget";
+char const* const mo::frame_timeline_history_opt  = "frame-timeline-history";
+char const* const mo::frame_timeline_path_opt     = "frame-timeline-path";
+char const* const mo::texture_cache_budget_opt    = "texture-cache-budget";
 char const* const mo::host_socket_opt             = "host-socket";
 char const* const mo::nested_passthrough_opt      = "nested-passthrough";
 char const* const mo::frontend_threads_opt        = "ipc-thread-pool";
+char const* const mo::client_queue_limit_opt      = "client-queue-limit";
+char const* const mo::client_queue_overflow_opt   = "client-queue-overflow";
 char const* const mo::name_opt                    = "name";
 char const* const mo::offscreen_opt               = "offscreen";
 char const* const mo::touchspots_opt              = "enable-touchspots";
@@ -55,7 +63,9 @@ char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
 char const* const mo::composite_delay_opt         = "composite-delay";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
+char const* const mo::multi_seat_opt              = "multi-seat";
 char const* const mo::x11_display_opt             = "x11-display-experimental";
+char const* const mo::x11_prespawn_delay_opt      = "x11-prespawn-delay";
 char const* const mo::wayland_extensions_opt      = "wayland-extensions";
 char const* const mo::wayland_extensions_value    = "wl_shell:xdg_wm_base:zxdg_shell_v6";
 
@@ -66,6 +76,7 @@ char const* const mo::lttng_opt_value = "lttng";
 char const* const mo::platform_graphics_lib = "platform-graphics-lib";
 char const* const mo::platform_input_lib = "platform-input-lib";
 char const* const mo::platform_path = "platform-path";
+char const* const mo::platform_probe_cache_opt = "platform-probe-cache";
 
 char const* const mo::console_provider = "console-provider";
 char const* const mo::logind_console = "logind";
@@ -167,6 +178,9 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Library to use for platform input support (default: input-stub.so)")
         (platform_path, po::value<std::string>()->default_value(MIR_SERVER_PLATFORM_PATH),
             "Directory to look for platform libraries (default: " MIR_SERVER_PLATFORM_PATH ")")
+        (platform_probe_cache_opt, po::value<std::string>(),
+            "File in which to remember the platform libraries selected by probing. A restarted server "
+            "loads these directly if the platform libraries and devices are unchanged (default: always probe)")
         (enable_input_opt, po::value<bool>()->default_value(enable_input_default),
             "Enable input.")
         (compositor_report_opt, po::value<std::string>()->default_value(off_opt_value),
@@ -191,11 +205,36 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "How to handle the SharedLibraryProber report. [{log,lttng,off}]")
         (shell_report_opt, po::value<std::string>()->default_value(off_opt_value),
          "How to handle the Shell report. [{log,off}]")
+        (startup_report_opt, po::value<std::string>()->default_value(off_opt_value),
+         "How to handle the Startup report (time taken by each startup phase). [{log,off}]")
+        (metrics_socket_opt, po::value<std::string>(),
+            "Collect performance metrics (frame times, input latency, texture "
+            "uploads...) and serve them in the Prometheus text format to "
+            "anything connecting to this UNIX socket path.")
+        (frame_timeline_budget_opt, po::value<int>(),
+            "Record the phases of every frame composited, and write the frames "
+            "of the last --frame-timeline-history seconds to a file whenever "
+            "a frame takes longer than this many milliseconds (from "
+            "snapshotting the scene to posting the frame).")
+        (frame_timeline_history_opt, po::value<int>()->default_value(5),
+            "Seconds of frame timeline written when a frame is over budget.")
+        (frame_timeline_path_opt, po::value<std::string>(),
+            "Directory to write frame timelines to [string:default=$XDG_RUNTIME_DIR or /tmp].")
         (composite_delay_opt, po::value<int>()->default_value(0),
             "Compositor frame delay in milliseconds (how long to wait for new "
             "frames from clients before compositing). Higher values result in "
             "lower latency but risk causing frame skipping. "
             "Default: A negative value means decide automatically.")
+        (texture_cache_budget_opt, po::value<int>()->default_value(256),
+            "Estimated GPU memory in MiB the compositor may use to keep client "
+            "textures for reuse (e.g. of windows that are temporarily hidden).")
+        (client_queue_limit_opt, po::value<int>()->default_value(16),
+            "Memory in MiB that may be used to queue messages for a client "
+            "that is not reading them.")
+        (client_queue_overflow_opt, po::value<std::string>()->default_value("disconnect"),
+            "What to do when a client's message queue is full: "
+            "[disconnect, drop]. \"drop\" discards further messages until "
+            "the client catches up.")
         (name_opt, po::value<std::string>(),
             "When nested, the name Mir uses when registering with the host.")
         (nested_passthrough_opt, po::value<bool>()->default_value(true),
@@ -210,6 +249,9 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Cursor (mouse pointer) to use [{auto,null,software}]")
         (enable_key_repeat_opt, po::value<bool>()->default_value(true),
              "Enable server generated key repeat")
+        (multi_seat_opt, po::value<bool>()->default_value(false),
+            "Give each seat (udev's ID_SEAT) its own input dispatch, cursor and keyboard focus."
+            " Otherwise input devices on every seat are handled as one.")
         (fatal_except_opt, "On \"fatal error\" conditions [e.g. drivers behaving "
             "in unexpected ways] throw an exception (instead of a core dump)")
         (debug_opt, "Enable extra development debugging. "
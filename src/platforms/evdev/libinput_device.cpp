@@ -430,6 +430,10 @@ void mie::LibInputDevice::update_device_info()
     }
 
     info = mi::InputDeviceInfo{name, unique_id.str(), caps};
+
+    // libinput takes the physical seat from udev's ID_SEAT (defaulting to "seat0")
+    if (auto const seat = libinput_device_get_seat(dev))
+        info.seat = libinput_seat_get_physical_name(seat);
 }
 
 libinput_device_group* mie::LibInputDevice::group()
@@ -23,6 +23,8 @@
 #include "kms_display_configuration.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/graphics/cursor_image.h"
+#include "mir/thread_name.h"
+#include "mir/log.h"
 
 #include <xf86drm.h>
 
@@ -144,15 +146,71 @@ auto mir::graphics::mesa::Cursor::GBMBOWrapper::change_orientation(MirOrientatio
     return true;
 }
 
+mgm::CursorUpdateThread::CursorUpdateThread() :
+    thread{[this] { run(); }}
+{
+}
+
+mgm::CursorUpdateThread::~CursorUpdateThread() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    work_available.notify_one();
+    thread.join();
+}
+
+void mgm::CursorUpdateThread::spawn(std::function<void()>&& work)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        work_queue.push_back(std::move(work));
+    }
+    work_available.notify_one();
+}
+
+void mgm::CursorUpdateThread::run()
+{
+    mir::set_thread_name("Mir/Cursor");
+
+    std::unique_lock<std::mutex> lock{mutex};
+    for (;;)
+    {
+        work_available.wait(lock, [this] { return stopping || !work_queue.empty(); });
+
+        // Finish any queued work before stopping: the cursor waits for it
+        if (work_queue.empty())
+            return;
+
+        auto work = std::move(work_queue.front());
+        work_queue.pop_front();
+
+        lock.unlock();
+        work();
+        work = nullptr;
+        lock.lock();
+    }
+}
+
 mgm::Cursor::Cursor(
     KMSOutputContainer& output_container,
     std::shared_ptr<CurrentConfiguration> const& current_configuration) :
+        Cursor(output_container, current_configuration, nullptr)
+{
+}
+
+mgm::Cursor::Cursor(
+    KMSOutputContainer& output_container,
+    std::shared_ptr<CurrentConfiguration> const& current_configuration,
+    std::shared_ptr<Executor> const& move_executor) :
         output_container(output_container),
         current_position(),
         last_set_failed(false),
         min_buffer_width{std::numeric_limits<uint32_t>::max()},
         min_buffer_height{std::numeric_limits<uint32_t>::max()},
-        current_configuration(current_configuration)
+        current_configuration(current_configuration),
+        move_executor(move_executor)
 {
     // Generate the buffers for the initial configuration.
     current_configuration->with_current_configuration_do(
@@ -173,6 +231,12 @@ mgm::Cursor::Cursor(
 
 mgm::Cursor::~Cursor() noexcept
 {
+    {
+        // The scheduled update refers to us
+        std::unique_lock<std::mutex> lock{move_mutex};
+        moves_applied.wait(lock, [this] { return !move_scheduled; });
+    }
+
     hide();
 }
 
@@ -312,7 +376,46 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
 
 void mgm::Cursor::move_to(geometry::Point position)
 {
-    place_cursor_at(position, UpdateState);
+    if (!move_executor)
+    {
+        place_cursor_at(position, UpdateState);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{move_mutex};
+    pending_move = position;
+
+    // A scheduled update picks up the latest position when it runs
+    if (move_scheduled)
+        return;
+
+    move_scheduled = true;
+    move_executor->spawn([this] { apply_pending_moves(); });
+}
+
+void mgm::Cursor::apply_pending_moves()
+{
+    std::unique_lock<std::mutex> lock{move_mutex};
+
+    while (pending_move)
+    {
+        auto const position = pending_move.consume();
+        lock.unlock();
+
+        try
+        {
+            place_cursor_at(position, UpdateState);
+        }
+        catch (std::exception const& error)
+        {
+            mir::log_warning("Failed to move hardware cursor: %s", error.what());
+        }
+
+        lock.lock();
+    }
+
+    move_scheduled = false;
+    moves_applied.notify_all();
 }
 
 void mir::graphics::mesa::Cursor::suspend()
@@ -21,6 +21,8 @@
 #define MIR_GRAPHICS_MESA_CURSOR_H_
 
 #include "mir/graphics/cursor.h"
+#include "mir/executor.h"
+#include "mir/optional_value.h"
 #include "mir/geometry/point.h"
 #include "mir/geometry/displacement.h"
 
@@ -29,9 +31,12 @@
 
 #include <gbm.h>
 
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 namespace mir
@@ -65,13 +70,43 @@ protected:
     CurrentConfiguration& operator=(CurrentConfiguration const&) = delete;
 };
 
+/// Runs work on a dedicated thread, in the order it is spawned
+class CursorUpdateThread : public mir::Executor
+{
+public:
+    CursorUpdateThread();
+    ~CursorUpdateThread() noexcept;
+
+    void spawn(std::function<void()>&& work) override;
+
+private:
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::deque<std::function<void()>> work_queue;
+    bool stopping{false};
+    std::thread thread;
+};
+
 class Cursor : public graphics::Cursor
 {
 public:
+    /// Moves are applied to the hardware on the thread calling move_to()
     Cursor(
         KMSOutputContainer& output_container,
         std::shared_ptr<CurrentConfiguration> const& current_configuration);
 
+    /**
+     * Moves are applied to the hardware on \a move_executor. Only the
+     * latest position matters, so moves made while one is pending replace
+     * it rather than queueing more drm calls.
+     */
+    Cursor(
+        KMSOutputContainer& output_container,
+        std::shared_ptr<CurrentConfiguration> const& current_configuration,
+        std::shared_ptr<Executor> const& move_executor);
+
     ~Cursor() noexcept;
 
     void show() override;
@@ -98,6 +133,7 @@ private:
         std::lock_guard<std::mutex> const&,
         GBMBOWrapper& buffer);
     void clear(std::lock_guard<std::mutex> const&);
+    void apply_pending_moves();
 
     GBMBOWrapper& buffer_for_output(KMSOutput const& output);
     
@@ -138,6 +174,12 @@ private:
     uint32_t min_buffer_height;
 
     std::shared_ptr<CurrentConfiguration> const current_configuration;
+
+    std::mutex move_mutex;
+    std::condition_variable moves_applied;
+    optional_value<geometry::Point> pending_move;
+    bool move_scheduled{false};
+    std::shared_ptr<Executor> const move_executor;
 };
 }
 }
@@ -53,6 +53,30 @@ namespace geom = mir::geometry;
 
 namespace
 {
+using GroupOutputs = std::vector<mg::DisplayConfigurationOutput>;
+
+auto outputs_of(mg::OverlappingOutputGroup const& group) -> GroupOutputs
+{
+    GroupOutputs outputs;
+    group.for_each_output([&outputs](mg::DisplayConfigurationOutput const& output) { outputs.push_back(output); });
+
+    std::sort(begin(outputs), end(outputs), [](auto const& a, auto const& b) { return a.id < b.id; });
+    return outputs;
+}
+
+// Whether a display buffer set up for one group of outputs can present the other unchanged
+bool present_identically(GroupOutputs const& group1, GroupOutputs const& group2)
+{
+    return std::equal(begin(group1), end(group1), begin(group2), end(group2),
+        [](mg::DisplayConfigurationOutput const& output1, mg::DisplayConfigurationOutput const& output2)
+        {
+            return output1 == output2 &&
+                   output1.power_mode == output2.power_mode &&
+                   output1.gamma.red == output2.gamma.red &&
+                   output1.gamma.green == output2.gamma.green &&
+                   output1.gamma.blue == output2.gamma.blue;
+        });
+}
 
 class GBMGLContext : public mir::renderer::gl::Context
 {
@@ -337,9 +361,12 @@ auto mgm::Display::create_hardware_cursor() -> std::shared_ptr<graphics::Cursor>
 
         try
         {
+            // Moving the cursor is a few drm ioctls per output: keep them off
+            // the input thread, which may be reporting motion at 1000Hz
             locked_cursor = std::make_shared<Cursor>(
                 *output_container,
-                std::make_shared<KMSCurrentConfiguration>(*this));
+                std::make_shared<KMSCurrentConfiguration>(*this),
+                std::make_shared<CursorUpdateThread>());
         }
         catch (std::runtime_error const&)
         {
@@ -407,6 +434,33 @@ bool mgm::Display::apply_if_configuration_preserves_display_buffers(
     return result;
 }
 
+void mgm::Display::for_each_display_sync_group_preserved_by(
+    mg::DisplayConfiguration const& conf,
+    std::function<void(graphics::DisplaySyncGroup&)> const& f)
+{
+    auto const& new_kms_conf = dynamic_cast<RealKMSDisplayConfiguration const&>(conf);
+
+    std::lock_guard<decltype(configuration_mutex)> lock{configuration_mutex};
+
+    /*
+     * Even a compatible configuration may move, rotate or change the mode of
+     * some outputs, so only groups whose outputs are entirely unchanged are preserved.
+     */
+    std::vector<GroupOutputs> new_groups;
+    OverlappingOutputGrouping{new_kms_conf}.for_each_group(
+        [&new_groups](OverlappingOutputGroup const& group) { new_groups.push_back(outputs_of(group)); });
+
+    for (size_t i = 0; i != display_buffers.size(); ++i)
+    {
+        auto const& outputs = display_buffer_outputs[i];
+        if (std::any_of(begin(new_groups), end(new_groups),
+                        [&outputs](auto const& group) { return present_identically(outputs, group); }))
+        {
+            f(*display_buffers[i]);
+        }
+    }
+}
+
 mg::Frame mgm::Display::last_frame_on(unsigned output_id) const
 {
     auto output = current_display_configuration.get_output_for(
@@ -453,9 +507,36 @@ void mgm::Display::configure_locked(
         (&kms_conf != &current_display_configuration) &&
         compatible(kms_conf, current_display_configuration)};
     std::vector<std::unique_ptr<DisplayBuffer>> display_buffers_new;
+    std::vector<GroupOutputs> display_buffer_outputs_new;
+
+    /* Set up used outputs */
+    OverlappingOutputGrouping grouping{kms_conf};
+    auto group_idx = 0;
+
+    /*
+     * Display buffers for groups of outputs that are unchanged are kept, so
+     * that they can continue to be composited while the others are replaced.
+     */
+    std::vector<bool> keep(display_buffers.size(), false);
+    std::unordered_map<int, bool> kept_outputs;
 
     if (!comp)
     {
+        grouping.for_each_group(
+            [&](OverlappingOutputGroup const& group)
+            {
+                auto const outputs = outputs_of(group);
+                for (size_t i = 0; i != display_buffers.size(); ++i)
+                {
+                    if (present_identically(display_buffer_outputs[i], outputs))
+                    {
+                        keep[i] = true;
+                        for (auto const& output : outputs)
+                            kept_outputs[output.id.as_value()] = true;
+                    }
+                }
+            });
+
         /*
          * Notice for a little while here we will have duplicate
          * DisplayBuffers attached to each output, and the display_buffers_new
@@ -464,26 +545,54 @@ void mgm::Display::configure_locked(
          * sure we wait for all pending page flips to finish before the
          * display_buffers_new are created and take control of the outputs.
          */
-        for (auto& db : display_buffers)
-            db->wait_for_page_flip();
+        for (size_t i = 0; i != display_buffers.size(); ++i)
+        {
+            if (!keep[i])
+                display_buffers[i]->wait_for_page_flip();
+        }
 
-        /* Reset the state of all outputs */
+        /* Reset the state of all outputs we are not keeping */
         kms_conf.for_each_output(
             [&](DisplayConfigurationOutput const& conf_output)
             {
+                if (kept_outputs.count(conf_output.id.as_value()))
+                    return;
+
                 auto kms_output = current_display_configuration.get_output_for(conf_output.id);
                 kms_output->clear_cursor();
                 kms_output->reset();
             });
     }
 
-    /* Set up used outputs */
-    OverlappingOutputGrouping grouping{kms_conf};
-    auto group_idx = 0;
-
     grouping.for_each_group(
         [&](OverlappingOutputGroup const& group)
         {
+            auto const outputs = outputs_of(group);
+
+            if (!comp)
+            {
+                bool kept_group = false;
+                for (size_t i = 0; i != display_buffers.size(); ++i)
+                {
+                    if (keep[i] && display_buffers[i] && present_identically(display_buffer_outputs[i], outputs))
+                    {
+                        display_buffers_new.push_back(std::move(display_buffers[i]));
+                        display_buffer_outputs_new.push_back(outputs);
+                        kept_group = true;
+                    }
+                }
+
+                if (kept_group)
+                    return;
+            }
+
+            /* A group reported as preserved may still be compositing, so is left alone */
+            if (comp && present_identically(display_buffer_outputs[group_idx], outputs))
+            {
+                ++group_idx;
+                return;
+            }
+
             auto bounding_rect = group.bounding_rectangle();
             // Each vector<KMSOutput> is a single GPU memory domain
             std::vector<std::vector<std::shared_ptr<KMSOutput>>> kms_output_groups;
@@ -513,6 +622,7 @@ void mgm::Display::configure_locked(
 
             if (comp)
             {
+                display_buffer_outputs[group_idx] = outputs;
                 display_buffers[group_idx++]->set_transformation(transformation,
                                                                  bounding_rect);
             }
@@ -557,12 +667,16 @@ void mgm::Display::configure_locked(
                         transformation);
 
                     display_buffers_new.push_back(std::move(db));
+                    display_buffer_outputs_new.push_back(outputs);
                 }
             }
         });
 
     if (!comp)
+    {
         display_buffers = std::move(display_buffers_new);
+        display_buffer_outputs = std::move(display_buffer_outputs_new);
+    }
 
     /* Store applied configuration */
     current_display_configuration = kms_conf;
@@ -80,6 +80,9 @@ public:
 
     std::unique_ptr<DisplayConfiguration> configuration() const override;
     bool apply_if_configuration_preserves_display_buffers(DisplayConfiguration const& conf) override;
+    void for_each_display_sync_group_preserved_by(
+        DisplayConfiguration const& conf,
+        std::function<void(graphics::DisplaySyncGroup&)> const& f) override;
     void configure(DisplayConfiguration const& conf) override;
 
     void register_configuration_change_handler(
@@ -113,6 +116,8 @@ private:
     mir::udev::Monitor monitor;
     helpers::EGLHelper shared_egl;
     std::vector<std::unique_ptr<DisplayBuffer>> display_buffers;
+    /// The configured outputs presented by the corresponding display_buffers entry
+    std::vector<std::vector<DisplayConfigurationOutput>> display_buffer_outputs;
     std::shared_ptr<KMSOutputContainer> const output_container;
     mutable RealKMSDisplayConfiguration current_display_configuration;
     mutable std::atomic<bool> dirty_configuration;
@@ -20,6 +20,7 @@
 
 #include "renderer.h"
 #include "mir/compositor/buffer_stream.h"
+#include "mir/compositor/compositor_report.h"
 #include "mir/gl/default_program_factory.h"
 #include "mir/graphics/renderable.h"
 #include "mir/graphics/buffer.h"
@@ -335,12 +336,21 @@ mrg::Renderer::Program::Program(GLuint program_id)
 }
 
 mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
+    : Renderer(display_buffer, mgl::DefaultProgramFactory().create_texture_cache(), nullptr)
+{
+}
+
+mrg::Renderer::Renderer(
+    graphics::DisplayBuffer& display_buffer,
+    std::unique_ptr<mgl::TextureCache> texture_cache,
+    std::shared_ptr<compositor::CompositorReport> const& report)
     : render_target(&display_buffer),
       clear_color{0.0f, 0.0f, 0.0f, 0.0f},
       default_program(family.add_program(vshader, default_fshader)),
       alpha_program(family.add_program(vshader, alpha_fshader)),
       program_factory{std::make_unique<ProgramFactory>()},
-      texture_cache(mgl::DefaultProgramFactory().create_texture_cache()),
+      texture_cache(std::move(texture_cache)),
+      report(report),
       display_transform(1)
 {
     eglBindAPI(MIR_SERVER_EGL_OPENGL_API);
@@ -425,6 +435,13 @@ void mrg::Renderer::render(mg::RenderableList const& renderables) const
     // does not affect screen contents so can happen after swap_buffers...
     texture_cache->drop_unused();
 
+    if (report)
+    {
+        auto const stats = texture_cache->statistics();
+        report->texture_cache_usage(
+            this, stats.hits, stats.misses, stats.evictions, stats.uploaded_bytes, stats.resident_bytes);
+    }
+
     while (auto const gl_error = glGetError())
         mir::log_debug("GL error: %d", gl_error);
 }
@@ -36,6 +36,7 @@
 namespace mir
 {
 namespace gl { class TextureCache; }
+namespace compositor { class CompositorReport; }
 namespace graphics { class DisplayBuffer; }
 namespace renderer
 {
@@ -60,6 +61,10 @@ class Renderer : public renderer::Renderer
 {
 public:
     Renderer(graphics::DisplayBuffer& display_buffer);
+    Renderer(
+        graphics::DisplayBuffer& display_buffer,
+        std::unique_ptr<mir::gl::TextureCache> texture_cache,
+        std::shared_ptr<compositor::CompositorReport> const& report);
     virtual ~Renderer();
 
     // These are called with a valid GL context:
@@ -131,6 +136,7 @@ private:
     class ProgramFactory;
     std::unique_ptr<ProgramFactory> const program_factory;
     std::unique_ptr<mir::gl::TextureCache> const texture_cache;
+    std::shared_ptr<compositor::CompositorReport> const report;
     geometry::Rectangle viewport;
     glm::mat4 screen_to_gl_coords;
     glm::mat4 display_transform;
@@ -19,12 +19,33 @@
 #include "renderer_factory.h"
 #include "renderer.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/gl/default_program_factory.h"
+#include "mir/gl/texture_cache.h"
 
 namespace mrg = mir::renderer::gl;
+namespace mgl = mir::gl;
+
+mrg::RendererFactory::RendererFactory() :
+    texture_cache_factory{std::make_unique<mgl::DefaultProgramFactory>()}
+{
+}
+
+mrg::RendererFactory::RendererFactory(
+    std::size_t texture_cache_budget_bytes,
+    std::shared_ptr<compositor::CompositorReport> const& report) :
+    texture_cache_factory{std::make_unique<mgl::DefaultProgramFactory>(texture_cache_budget_bytes)},
+    report{report}
+{
+}
+
+mrg::RendererFactory::~RendererFactory() = default;
 
 std::unique_ptr<mir::renderer::Renderer>
 mrg::RendererFactory::create_renderer_for(
     graphics::DisplayBuffer& display_buffer)
 {
-    return std::make_unique<Renderer>(display_buffer);
+    return std::make_unique<Renderer>(
+        display_buffer,
+        texture_cache_factory->create_texture_cache(),
+        report);
 }
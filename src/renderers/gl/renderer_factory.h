@@ -21,8 +21,12 @@
 
 #include "mir/renderer/renderer_factory.h"
 
+#include <cstddef>
+
 namespace mir
 {
+namespace gl { class ProgramFactory; }
+namespace compositor { class CompositorReport; }
 namespace renderer
 {
 namespace gl
@@ -31,8 +35,18 @@ namespace gl
 class RendererFactory : public renderer::RendererFactory
 {
 public:
+    RendererFactory();
+    RendererFactory(
+        std::size_t texture_cache_budget_bytes,
+        std::shared_ptr<compositor::CompositorReport> const& report);
+    ~RendererFactory();
+
     std::unique_ptr<renderer::Renderer> create_renderer_for(
         graphics::DisplayBuffer& display_buffer) override;
+
+private:
+    std::unique_ptr<mir::gl::ProgramFactory> const texture_cache_factory;
+    std::shared_ptr<compositor::CompositorReport> const report;
 };
 
 }
@@ -33,11 +33,12 @@ class GraphicBufferAllocator;
 }
 namespace compositor
 {
+class CompositorReport;
 
 class BufferStreamFactory : public scene::BufferStreamFactory
 {
 public:
-    BufferStreamFactory();
+    explicit BufferStreamFactory(std::shared_ptr<CompositorReport> const& report);
 
     virtual ~BufferStreamFactory() {}
 
@@ -48,6 +49,9 @@ public:
     virtual std::shared_ptr<BufferStream> create_buffer_stream(
         frontend::BufferStreamId,
         graphics::BufferProperties const&) override;
+
+private:
+    std::shared_ptr<CompositorReport> const report;
 };
 
 }
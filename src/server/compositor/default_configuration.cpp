@@ -28,8 +28,10 @@
 
 #include "mir/frontend/screencast.h"
 #include "mir/options/configuration.h"
+#include "mir/startup_phase_tracker.h"
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 
 namespace mc = mir::compositor;
 namespace ms = mir::scene;
@@ -39,9 +41,9 @@ std::shared_ptr<ms::BufferStreamFactory>
 mir::DefaultServerConfiguration::the_buffer_stream_factory()
 {
     return buffer_stream_factory(
-        []()
+        [this]()
         {
-            return std::make_shared<mc::BufferStreamFactory>();
+            return std::make_shared<mc::BufferStreamFactory>(the_compositor_report());
         });
 }
 
@@ -69,6 +71,7 @@ mir::DefaultServerConfiguration::the_compositor()
     return compositor(
         [this]()
         {
+            auto const phase = startup_phase_tracker->phase("the_compositor");
             std::chrono::milliseconds const composite_delay(
                 the_options()->get<int>(options::composite_delay_opt));
 
@@ -86,9 +89,13 @@ mir::DefaultServerConfiguration::the_compositor()
 std::shared_ptr<mir::renderer::RendererFactory> mir::DefaultServerConfiguration::the_renderer_factory()
 {
     return renderer_factory(
-        []()
+        [this]()
         {
-            return std::make_shared<mir::renderer::gl::RendererFactory>();
+            auto const budget_mib = std::max(the_options()->get<int>(options::texture_cache_budget_opt), 0);
+
+            return std::make_shared<mir::renderer::gl::RendererFactory>(
+                std::size_t(budget_mib) * 1024 * 1024,
+                the_compositor_report());
         });
 }
 
@@ -50,6 +50,7 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
 
     auto const& view_area = display_buffer.view_area();
     auto const& occlusions = mc::filter_occlusions_from(scene_elements, view_area);
+    report->filtered_occlusions(this, occlusions.size());
 
     for (auto const& element : occlusions)
         element->occluded();
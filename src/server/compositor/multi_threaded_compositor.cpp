@@ -32,6 +32,7 @@
 #include "mir/unwind_helpers.h"
 #include "mir/thread_name.h"
 
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include <condition_variable>
@@ -138,10 +139,14 @@ public:
                     for (auto& tuple : compositors)
                     {
                         auto& compositor = std::get<1>(tuple);
+                        report->began_scene_snapshot(compositor.get());
                         compositor->composite(scene->scene_elements_for(compositor.get()));
                     }
                     group.post();
 
+                    for (auto& tuple : compositors)
+                        report->posted_frame(std::get<1>(tuple).get());
+
                     /*
                      * "Predictive bypass" optimization: If the last frame was
                      * bypassed/overlayed or you simply have a fast GPU, it is
@@ -222,6 +227,11 @@ public:
         run_cv.notify_one();
     }
 
+    auto display_sync_group() const -> mg::DisplaySyncGroup const*
+    {
+        return &group;
+    }
+
     void wait_until_started()
     {
         if (started_future.wait_for(10s) != std::future_status::ready)
@@ -286,6 +296,7 @@ mc::MultiThreadedCompositor::~MultiThreadedCompositor()
 void mc::MultiThreadedCompositor::schedule_compositing(int num)
 {
     report->scheduled();
+    std::lock_guard<std::mutex> lock{threads_mutex};
     for (auto& f : thread_functors)
         f->schedule_compositing(num);
 }
@@ -293,6 +304,7 @@ void mc::MultiThreadedCompositor::schedule_compositing(int num)
 void mc::MultiThreadedCompositor::schedule_compositing(int num, geometry::Rectangle const& damage) const
 {
     report->scheduled();
+    std::lock_guard<std::mutex> lock{threads_mutex};
     for (auto& f : thread_functors)
         f->schedule_compositing(num, damage);
 }
@@ -334,7 +346,12 @@ void mc::MultiThreadedCompositor::stop()
     auto started = CompositorState::started;
 
     if (!state.compare_exchange_strong(started, CompositorState::stopping))
+    {
+        // Reconfiguring has stopped some compositing threads, and will stop the rest when it finishes
+        auto reconfiguring = CompositorState::reconfiguring;
+        state.compare_exchange_strong(reconfiguring, CompositorState::stop_requested);
         return;
+    }
 
     /* To cleanup state if any code below throws */
     auto cleanup_if_unwinding = on_unwind([this]
@@ -361,33 +378,119 @@ void mc::MultiThreadedCompositor::stop()
     state = CompositorState::stopped;
 }
 
-void mc::MultiThreadedCompositor::create_compositing_threads()
+void mc::MultiThreadedCompositor::reconfigure(
+    mg::DisplayConfiguration const& conf,
+    std::function<void()> const& apply)
 {
-    /* Start the display buffer compositing threads */
-    display->for_each_display_sync_group([this](mg::DisplaySyncGroup& group)
+    auto started = CompositorState::started;
+
+    if (!state.compare_exchange_strong(started, CompositorState::reconfiguring))
     {
+        Compositor::reconfigure(conf, apply);
+        return;
+    }
+
+    std::vector<mg::DisplaySyncGroup*> preserved;
+    display->for_each_display_sync_group_preserved_by(
+        conf,
+        [&preserved](mg::DisplaySyncGroup& group) { preserved.push_back(&group); });
+
+    /*
+     * Only the groups being replaced have their compositing threads stopped:
+     * the others keep presenting while the change is applied. Afterwards
+     * (even if applying fails) every group is composited again, unless
+     * stop() was called meanwhile.
+     */
+    auto const restart = raii::paired_calls(
+        [this, &preserved] { destroy_compositing_threads_except(preserved); },
+        [this]
+        {
+            if (state != CompositorState::stop_requested)
+            {
+                for (auto const functor : create_compositing_threads())
+                    functor->schedule_compositing(1);
+
+                auto reconfiguring = CompositorState::reconfiguring;
+                if (state.compare_exchange_strong(reconfiguring, CompositorState::started))
+                    return;
+            }
+
+            scene->remove_observer(observer);
+            destroy_compositing_threads();
+            compose_on_start = true;
+            report->stopped();
+
+            state = CompositorState::stopped;
+        });
+
+    apply();
+}
+
+auto mc::MultiThreadedCompositor::create_compositing_threads() -> std::vector<CompositingFunctor*>
+{
+    std::vector<CompositingFunctor*> created;
+
+    /* Start the display buffer compositing threads for groups without one */
+    display->for_each_display_sync_group([this, &created](mg::DisplaySyncGroup& group)
+    {
+        std::lock_guard<std::mutex> lock{threads_mutex};
+
+        for (auto const& functor : thread_functors)
+        {
+            if (functor->display_sync_group() == &group)
+                return;
+        }
+
         auto thread_functor = std::make_unique<mc::CompositingFunctor>(
             display_buffer_compositor_factory, group, scene, display_listener,
             fixed_composite_delay, report);
 
         futures.push_back(thread_pool.run(std::ref(*thread_functor), &group));
+        created.push_back(thread_functor.get());
         thread_functors.push_back(std::move(thread_functor));
     });
 
     thread_pool.shrink();
 
-    for (auto& functor : thread_functors)
+    for (auto const functor : created)
         functor->wait_until_started();
+
+    return created;
 }
 
 void mc::MultiThreadedCompositor::destroy_compositing_threads()
 {
-    for (auto& f : thread_functors)
+    destroy_compositing_threads_except({});
+}
+
+void mc::MultiThreadedCompositor::destroy_compositing_threads_except(
+    std::vector<mg::DisplaySyncGroup*> const& preserved)
+{
+    std::vector<std::unique_ptr<CompositingFunctor>> stopping_functors;
+    std::vector<std::future<void>> stopping_futures;
+
+    {
+        std::lock_guard<std::mutex> lock{threads_mutex};
+
+        for (size_t i = 0; i != thread_functors.size();)
+        {
+            auto const group = thread_functors[i]->display_sync_group();
+            if (std::find(begin(preserved), end(preserved), group) != end(preserved))
+            {
+                ++i;
+                continue;
+            }
+
+            stopping_functors.push_back(std::move(thread_functors[i]));
+            stopping_futures.push_back(std::move(futures[i]));
+            thread_functors.erase(thread_functors.begin() + i);
+            futures.erase(futures.begin() + i);
+        }
+    }
+
+    for (auto& f : stopping_functors)
         f->stop();
 
-    for (auto& f : futures)
+    for (auto& f : stopping_futures)
         f.wait();
-
-    thread_functors.clear();
-    futures.clear();
 }
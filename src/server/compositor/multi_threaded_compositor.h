@@ -35,6 +35,8 @@ namespace geometry { struct Rectangle; }
 namespace graphics
 {
 class Display;
+class DisplayConfiguration;
+class DisplaySyncGroup;
 }
 namespace scene
 {
@@ -55,7 +57,9 @@ enum class CompositorState
     started,
     stopped,
     starting,
-    stopping
+    stopping,
+    reconfiguring,
+    stop_requested  ///< stop() was called while reconfiguring
 };
 
 class MultiThreadedCompositor : public Compositor
@@ -73,10 +77,12 @@ public:
 
     void start();
     void stop();
+    void reconfigure(graphics::DisplayConfiguration const& conf, std::function<void()> const& apply) override;
 
 private:
-    void create_compositing_threads();
+    auto create_compositing_threads() -> std::vector<CompositingFunctor*>;
     void destroy_compositing_threads();
+    void destroy_compositing_threads_except(std::vector<graphics::DisplaySyncGroup*> const& preserved);
 
     std::shared_ptr<graphics::Display> const display;
     std::shared_ptr<Scene> const scene;
@@ -84,6 +90,8 @@ private:
     std::shared_ptr<DisplayListener> const display_listener;
     std::shared_ptr<CompositorReport> const report;
 
+    /// Guards thread_functors and futures, which change while reconfiguring
+    mutable std::mutex threads_mutex;
     std::vector<std::unique_ptr<CompositingFunctor>> thread_functors;
     std::vector<std::future<void>> futures;
 
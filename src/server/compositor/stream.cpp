@@ -21,6 +21,8 @@
 #include "queueing_schedule.h"
 #include "dropping_schedule.h"
 #include "mir/graphics/buffer.h"
+#include "mir/compositor/compositor_report.h"
+#include "../report/null_report_factory.h"
 #include <boost/throw_exception.hpp>
 
 namespace mc = mir::compositor;
@@ -36,9 +38,16 @@ enum class mc::Stream::ScheduleMode {
 
 mc::Stream::Stream(
     geom::Size size, MirPixelFormat pf) :
+    Stream(size, pf, mir::report::null_compositor_report())
+{
+}
+
+mc::Stream::Stream(
+    geom::Size size, MirPixelFormat pf, std::shared_ptr<CompositorReport> const& report) :
     schedule_mode(ScheduleMode::Queueing),
     schedule(std::make_shared<mc::QueueingSchedule>()),
     arbiter(std::make_shared<mc::MultiMonitorArbiter>(schedule)),
+    report(report),
     size(size),
     pf(pf),
     first_frame_posted(false),
@@ -53,6 +62,8 @@ void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
     if (!buffer)
         BOOST_THROW_EXCEPTION(std::invalid_argument("cannot submit null buffer"));
 
+    report->submitted_buffer(buffer->id());
+
     {
         std::lock_guard<decltype(mutex)> lk(mutex); 
         first_frame_posted = true;
@@ -36,10 +36,12 @@ namespace frontend { class ClientBuffers; }
 namespace compositor
 {
 class Schedule;
+class CompositorReport;
 class Stream : public BufferStream
 {
 public:
     Stream(geometry::Size sz, MirPixelFormat format);
+    Stream(geometry::Size sz, MirPixelFormat format, std::shared_ptr<CompositorReport> const& report);
     ~Stream();
 
     void submit_buffer(std::shared_ptr<graphics::Buffer> const& buffer) override;
@@ -65,6 +67,7 @@ private:
     ScheduleMode schedule_mode;
     std::shared_ptr<Schedule> schedule;
     std::shared_ptr<MultiMonitorArbiter> const arbiter;
+    std::shared_ptr<CompositorReport> const report;
     geometry::Size size; 
     MirPixelFormat pf;
     bool first_frame_posted;
@@ -44,6 +44,8 @@
 #include "mir/graphics/platform.h"
 #include "mir/scene/coordinate_translator.h"
 #include "mir/console_services.h"
+#include "mir/startup_phase_tracker.h"
+#include "mir/platform_probe_cache.h"
 
 #include <type_traits>
 
@@ -68,10 +70,17 @@ mir::DefaultServerConfiguration::DefaultServerConfiguration(int argc, char const
 }
 
 mir::DefaultServerConfiguration::DefaultServerConfiguration(std::shared_ptr<mo::Configuration> const& configuration_options) :
-    configuration_options(configuration_options)
+    configuration_options(configuration_options),
+    startup_phase_tracker(std::make_shared<StartupPhaseTracker>())
 {
 }
 
+auto mir::DefaultServerConfiguration::the_startup_phase_tracker() const
+-> std::shared_ptr<StartupPhaseTracker>
+{
+    return startup_phase_tracker;
+}
+
 auto mir::DefaultServerConfiguration::the_options() const
 ->std::shared_ptr<options::Option>
 {
@@ -167,10 +176,24 @@ std::shared_ptr<mir::MainLoop> mir::DefaultServerConfiguration::the_main_loop()
     return main_loop(
         [this]() -> std::shared_ptr<mir::MainLoop>
         {
+            auto const phase = startup_phase_tracker->phase("the_main_loop");
             return std::make_shared<mir::GLibMainLoop>(the_clock());
         });
 }
 
+auto mir::DefaultServerConfiguration::the_platform_probe_cache() -> std::shared_ptr<PlatformProbeCache>
+{
+    return platform_probe_cache(
+        [this]
+        {
+            auto const options = the_options();
+            return std::make_shared<PlatformProbeCache>(
+                options->is_set(options::platform_probe_cache_opt) ?
+                    options->get<std::string>(options::platform_probe_cache_opt) : std::string{},
+                options->get<std::string>(options::platform_path));
+        });
+}
+
 std::shared_ptr<mir::ServerActionQueue> mir::DefaultServerConfiguration::the_server_action_queue()
 {
     return the_main_loop();
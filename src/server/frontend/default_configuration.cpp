@@ -22,6 +22,7 @@
 #include "default_ipc_factory.h"
 #include "published_socket_connector.h"
 #include "session_mediator_observer_multiplexer.h"
+#include "socket_messenger.h"
 
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_ipc_operations.h"
@@ -29,22 +30,41 @@
 #include "mir/frontend/session_authorizer.h"
 #include "mir/options/configuration.h"
 #include "mir/options/option.h"
+#include "mir/startup_phase_tracker.h"
+#include "mir/abnormal_exit.h"
 
 namespace mf = mir::frontend;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
+namespace mfd = mir::frontend::detail;
 
 std::shared_ptr<mf::ConnectionCreator>
 mir::DefaultServerConfiguration::the_connection_creator()
 {
     return connection_creator([this]
         {
+            auto const queue_limit = the_options()->get<int>(options::client_queue_limit_opt);
+            auto const overflow = the_options()->get<std::string>(options::client_queue_overflow_opt);
+
+            if (queue_limit <= 0)
+                BOOST_THROW_EXCEPTION(mir::AbnormalExit("--client-queue-limit must be positive"));
+
+            mfd::QueueOverflowPolicy overflow_policy;
+            if (overflow == "disconnect")
+                overflow_policy = mfd::QueueOverflowPolicy::disconnect;
+            else if (overflow == "drop")
+                overflow_policy = mfd::QueueOverflowPolicy::drop_messages;
+            else
+                BOOST_THROW_EXCEPTION(mir::AbnormalExit("Unknown --client-queue-overflow policy: " + overflow));
+
             auto const session_authorizer = the_session_authorizer();
             return std::make_shared<mf::ProtobufConnectionCreator>(
                 new_ipc_factory(session_authorizer),
                 session_authorizer,
                 the_graphics_platform()->make_ipc_operations(),
-                the_message_processor_report());
+                the_message_processor_report(),
+                static_cast<size_t>(queue_limit) * 1024 * 1024,
+                overflow_policy);
         });
 }
 
@@ -54,6 +74,7 @@ mir::DefaultServerConfiguration::the_connector()
     return connector(
         [&,this]() -> std::shared_ptr<mf::Connector>
         {
+            auto const phase = startup_phase_tracker->phase("the_connector");
             if (the_options()->is_set(options::no_server_socket_opt))
             {
                 return std::make_shared<mf::BasicConnector>(
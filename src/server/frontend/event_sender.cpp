@@ -18,6 +18,10 @@
 
 #include "event_sender.h"
 #include "mir/events/event.h"
+#include "mir/events/input_event.h"
+#include "mir/events/pointer_event.h"
+#include "mir/events/resize_event.h"
+#include "mir/events/surface_placement_event.h"
 #include "mir/frontend/client_constants.h"
 #include "mir/graphics/display_configuration.h"
 #include "mir/variable_length_array.h"
@@ -36,11 +40,81 @@
 #include "mir_protobuf_wire.pb.h"
 #include "mir_protobuf.pb.h"
 
+#include <google/protobuf/io/coded_stream.h>
+
 namespace mg = mir::graphics;
 namespace mfd = mir::frontend::detail;
 namespace mev = mir::events;
 namespace mp = mir::protobuf;
 namespace mi = mir::input;
+namespace gpi = google::protobuf::io;
+
+namespace
+{
+// Field tags (field number << 3 | length-delimited) of the messages
+// wrapping a raw event: wire::Result.events, EventSequence.event and Event.raw
+uint8_t const result_events_tag = (3 << 3) | 2;
+uint8_t const sequence_event_tag = (1 << 3) | 2;
+uint8_t const event_raw_tag = (1 << 3) | 2;
+
+size_t field_size(size_t payload_size)
+{
+    return 1 + gpi::CodedOutputStream::VarintSize32(static_cast<uint32_t>(payload_size)) + payload_size;
+}
+
+uint8_t* write_field_header(uint8_t tag, size_t payload_size, uint8_t* target)
+{
+    *target++ = tag;
+    return gpi::CodedOutputStream::WriteVarint32ToArray(static_cast<uint32_t>(payload_size), target);
+}
+
+// Keys for messages that only matter until a newer one of the same kind
+// (and for the same window) is sent: if a slow client has not yet been sent
+// the old one, it need never be.
+enum class Superseding : uint64_t
+{
+    none,
+    pointer_motion,
+    resize,
+    window_placement,
+    ping
+};
+
+uint64_t superseding_key(Superseding kind, uint64_t id = 0)
+{
+    return (static_cast<uint64_t>(kind) << 56) | (id & 0x00ffffffffffffff);
+}
+
+uint64_t superseding_key(MirEvent const& event)
+{
+    switch (event.type())
+    {
+    case mir_event_type_input:
+    {
+        auto const input = event.to_input();
+        // Relative motion is lost with the event carrying it, so only absolute motion is superseded
+        if (input->input_type() == mir_input_event_type_pointer &&
+            input->to_pointer()->action() == mir_pointer_action_motion &&
+            input->to_pointer()->dx() == 0 && input->to_pointer()->dy() == 0)
+        {
+            auto const device = static_cast<uint64_t>(input->device_id()) << 32;
+            return superseding_key(Superseding::pointer_motion, device | static_cast<uint32_t>(input->window_id()));
+        }
+        break;
+    }
+    case mir_event_type_resize:
+        return superseding_key(Superseding::resize, static_cast<uint32_t>(event.to_resize()->surface_id()));
+
+    case mir_event_type_window_placement:
+        return superseding_key(Superseding::window_placement, static_cast<uint32_t>(event.to_window_placement()->id()));
+
+    default:
+        break;
+    }
+
+    return superseding_key(Superseding::none);
+}
+}
 
 mfd::EventSender::EventSender(
     std::shared_ptr<MessageSender> const& socket_sender,
@@ -54,11 +128,24 @@ void mfd::EventSender::handle_event(EventUPtr&& event)
 {
     // In future we might send multiple events, or insert them into messages
     // containing other responses, but for now we send them individually.
-    mp::EventSequence seq;
-    mp::Event *ev = seq.add_event();
-    ev->set_raw(MirEvent::serialize(event.get()));
+    //
+    // This is the hottest message we send, so rather than serializing the
+    // event into an mp::EventSequence and that into a wire::Result we write
+    // the (byte-identical) protobuf framing ourselves and let capnp serialize
+    // the event straight into the send buffer.
+    auto const raw_size = MirEvent::serialized_size(event.get());
+    auto const event_size = field_size(raw_size);
+    auto const sequence_size = field_size(event_size);
 
-    send_event_sequence(seq, {});
+    mir::VariableLengthArray<frontend::serialization_buffer_size> event_buffer{field_size(sequence_size)};
+
+    auto out = event_buffer.data();
+    out = write_field_header(result_events_tag, sequence_size, out);
+    out = write_field_header(sequence_event_tag, event_size, out);
+    out = write_field_header(event_raw_tag, raw_size, out);
+    MirEvent::serialize(event.get(), out, raw_size);
+
+    send_superseding(superseding_key(*event), event_buffer.data(), event_buffer.size());
 }
 
 void mfd::EventSender::handle_display_config_change(
@@ -90,7 +177,9 @@ void mfd::EventSender::send_ping(int32_t serial)
     auto protobuf_ping_event = seq.mutable_ping_event();
     protobuf_ping_event->set_serial(serial);
 
-    send_event_sequence(seq, {});
+    // A client that is behind only needs the latest ping: its answer to that
+    // is what tells the application-not-responding detector it has recovered
+    send_event_sequence(seq, superseding_key(Superseding::ping));
 }
 
 void mfd::EventSender::handle_input_config_change(MirInputConfig const& config)
@@ -102,6 +191,18 @@ void mfd::EventSender::handle_input_config_change(MirInputConfig const& config)
 }
 
 void mfd::EventSender::send_event_sequence(mp::EventSequence& seq, FdSets const& fds)
+{
+    serialize_event_sequence(seq, [&](uint8_t const* data, size_t size) { send(data, size, fds); });
+}
+
+void mfd::EventSender::send_event_sequence(mp::EventSequence& seq, uint64_t superseding_key)
+{
+    serialize_event_sequence(seq, [&](uint8_t const* data, size_t size)
+        { send_superseding(superseding_key, data, size); });
+}
+
+template<typename Send>
+void mfd::EventSender::serialize_event_sequence(mp::EventSequence& seq, Send const& send)
 {
     mir::VariableLengthArray<frontend::serialization_buffer_size>
         send_buffer{static_cast<size_t>(seq.ByteSize())};
@@ -113,9 +214,14 @@ void mfd::EventSender::send_event_sequence(mp::EventSequence& seq, FdSets const&
     send_buffer.resize(result.ByteSize());
     result.SerializeWithCachedSizesToArray(send_buffer.data());
 
+    send(send_buffer.data(), send_buffer.size());
+}
+
+void mfd::EventSender::send(uint8_t const* data, size_t size, FdSets const& fds)
+{
     try
     {
-        sender->send(reinterpret_cast<char*>(send_buffer.data()), send_buffer.size(), fds);
+        sender->send(reinterpret_cast<char const*>(data), size, fds);
     }
     catch (std::exception const& error)
     {
@@ -124,6 +230,18 @@ void mfd::EventSender::send_event_sequence(mp::EventSequence& seq, FdSets const&
     }
 }
 
+void mfd::EventSender::send_superseding(uint64_t key, uint8_t const* data, size_t size)
+{
+    try
+    {
+        sender->send_superseding(key, reinterpret_cast<char const*>(data), size);
+    }
+    catch (std::exception const& error)
+    {
+        (void) error;
+    }
+}
+
 void mfd::EventSender::add_buffer(graphics::Buffer& buffer)
 {
     mp::EventSequence seq;
@@ -56,7 +56,12 @@ public:
 
 private:
     void send_event_sequence(protobuf::EventSequence&, FdSets const&);
+    void send_event_sequence(protobuf::EventSequence&, uint64_t superseding_key);
+    template<typename Send>
+    void serialize_event_sequence(protobuf::EventSequence&, Send const& send);
     void send_buffer(protobuf::EventSequence&, graphics::Buffer&, graphics::BufferIpcMsgType);
+    void send(uint8_t const* data, size_t size, FdSets const& fds);
+    void send_superseding(uint64_t key, uint8_t const* data, size_t size);
 
     std::shared_ptr<MessageSender> const sender;
     std::shared_ptr<graphics::PlatformIpcOperations> const buffer_packer;
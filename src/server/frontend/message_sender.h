@@ -21,6 +21,7 @@
 #include "mir/frontend/fd_sets.h"
 
 #include <sys/types.h>
+#include <cstdint>
 
 namespace mir
 {
@@ -31,6 +32,17 @@ class MessageSender
 public:
     virtual void send(char const* data, size_t length, FdSets const& fds) = 0;
 
+    /**
+     * Send an event that makes obsolete any earlier message sent with the
+     * same (non-zero) key. Senders that queue messages for a slow client
+     * may drop the earlier message if it has not been sent yet, and (unlike
+     * replies) may drop events if the client falls too far behind.
+     */
+    virtual void send_superseding(uint64_t /*key*/, char const* data, size_t length)
+    {
+        send(data, length, {});
+    }
+
 protected:
     MessageSender() = default;
     virtual ~MessageSender() = default;
@@ -38,10 +38,29 @@ mf::ProtobufConnectionCreator::ProtobufConnectionCreator(
     std::shared_ptr<SessionAuthorizer> const& session_authorizer,
     std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations,
     std::shared_ptr<MessageProcessorReport> const& report)
+:   ProtobufConnectionCreator(
+        ipc_factory,
+        session_authorizer,
+        operations,
+        report,
+        mfd::SocketMessenger::default_queue_limit,
+        mfd::QueueOverflowPolicy::disconnect)
+{
+}
+
+mf::ProtobufConnectionCreator::ProtobufConnectionCreator(
+    std::shared_ptr<ProtobufIpcFactory> const& ipc_factory,
+    std::shared_ptr<SessionAuthorizer> const& session_authorizer,
+    std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations,
+    std::shared_ptr<MessageProcessorReport> const& report,
+    size_t client_queue_limit,
+    mfd::QueueOverflowPolicy client_queue_overflow_policy)
 :   ipc_factory(ipc_factory),
     session_authorizer(session_authorizer),
     operations(operations),
     report(report),
+    client_queue_limit(client_queue_limit),
+    client_queue_overflow_policy(client_queue_overflow_policy),
     next_session_id(0),
     connections(std::make_shared<mfd::Connections<mfd::SocketConnection>>())
 {
@@ -81,7 +100,10 @@ void mf::ProtobufConnectionCreator::create_connection_for(
     std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket,
     ConnectionContext const& connection_context)
 {
-    auto const messenger = std::make_shared<detail::SocketMessenger>(socket);
+    auto const messenger = std::make_shared<detail::SocketMessenger>(
+        socket,
+        client_queue_limit,
+        client_queue_overflow_policy);
     auto const creds = messenger->client_creds();
 
     if (session_authorizer->connection_is_allowed(creds))
@@ -43,6 +43,23 @@ void mf::ReorderingMessageSender::send(
     sink->send(data, length, fds);
 }
 
+void mf::ReorderingMessageSender::send_superseding(
+    uint64_t key,
+    char const* data,
+    size_t length)
+{
+    {
+        std::lock_guard<decltype(message_lock)> lock{message_lock};
+        if (corked)
+        {
+            buffered_messages.emplace_back(Message {std::vector<char>(data, data + length), FdSets{}});
+            return;
+        }
+    }
+
+    sink->send_superseding(key, data, length);
+}
+
 void mf::ReorderingMessageSender::uncork()
 {
     {
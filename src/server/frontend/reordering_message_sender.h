@@ -38,6 +38,7 @@ public:
     explicit ReorderingMessageSender(std::shared_ptr<MessageSender> const& sink);
 
     void send(char const* data, size_t length, FdSets const& fds) override;
+    void send_superseding(uint64_t key, char const* data, size_t length) override;
 
     /**
      * Stop diverting messages into the buffer.
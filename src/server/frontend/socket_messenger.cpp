@@ -1,5 +1,5 @@
 /*
- * Copyright © 2013-2014 Canonical Ltd.
+ * Copyright © 2013-2014,2019 Canonical Ltd.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License version 2 or 3 as
@@ -21,12 +21,16 @@
 #include "mir/variable_length_array.h"
 #include "mir/fd_socket_transmission.h"
 #include "mir/raii.h"
+#include "mir/log.h"
 
 #include <boost/throw_exception.hpp>
 
 #include <errno.h>
+#include <poll.h>
 #include <string.h>
 
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
 
 namespace mf = mir::frontend;
@@ -35,14 +39,24 @@ namespace bs = boost::system;
 namespace ba = boost::asio;
 
 mfd::SocketMessenger::SocketMessenger(std::shared_ptr<ba::local::stream_protocol::socket> const& socket)
+    : SocketMessenger(socket, default_queue_limit, QueueOverflowPolicy::disconnect)
+{
+}
+
+mfd::SocketMessenger::SocketMessenger(
+    std::shared_ptr<ba::local::stream_protocol::socket> const& socket,
+    size_t queue_limit,
+    QueueOverflowPolicy overflow_policy)
     : socket(socket),
-      socket_fd{IntOwnedFd{socket->native_handle()}}
+      socket_fd{IntOwnedFd{socket->native_handle()}},
+      queue_limit{queue_limit},
+      overflow_policy{overflow_policy}
 {
     // Make the socket non-blocking to avoid hanging the server when a client
-    // is unresponsive. Also increase the send buffer size to 64KiB to allow
-    // more leeway for transient client freezes.
+    // is unresponsive; anything the socket won't take is queued instead.
+    // Also increase the send buffer size to 64KiB so that the queue is only
+    // needed for more than transient client freezes.
     // See https://bugs.launchpad.net/mir/+bug/1350207
-    // TODO: Rework the messenger to support asynchronous sends
     socket->non_blocking(true);
     boost::asio::socket_base::send_buffer_size option(64*1024);
     socket->set_option(option);
@@ -73,24 +87,204 @@ mf::SessionCredentials mfd::SocketMessenger::client_creds()
 
 void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& fd_set)
 {
+    std::lock_guard<std::mutex> lg(message_lock);
+
+    // NOTE: Messages (and their fds) are written in the order they are sent,
+    // which is what mf::SessionMediator::create_surface relies on, even if
+    // they have to be queued.
+    enqueue(lg, 0, data, length, fd_set, false);
+}
+
+void mfd::SocketMessenger::send_superseding(uint64_t key, char const* data, size_t length)
+{
+    std::lock_guard<std::mutex> lg(message_lock);
+    enqueue(lg, key, data, length, {}, true);
+}
+
+auto mfd::SocketMessenger::queue_stats() -> QueueStats
+{
+    std::lock_guard<std::mutex> lg(message_lock);
+    return stats;
+}
+
+void mfd::SocketMessenger::enqueue(
+    std::lock_guard<std::mutex> const& lg,
+    uint64_t key,
+    char const* data,
+    size_t length,
+    FdSets const& fds,
+    bool droppable)
+{
+    if (broken)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to send message: client connection is broken"));
+
     static size_t const header_size{2};
-    mir::VariableLengthArray<mf::serialization_buffer_size> whole_message{header_size + length};
+    auto const message_size = header_size + length;
 
-    whole_message.data()[0] = static_cast<unsigned char>((length >> 8) & 0xff);
-    whole_message.data()[1] = static_cast<unsigned char>((length >> 0) & 0xff);
-    std::copy(data, data + length, whole_message.data() + header_size);
+    if (key)
+    {
+        auto const superseded = superseding.find(key);
+        if (superseded != superseding.end() && superseded->second->bytes_written == 0)
+        {
+            stats.queued_bytes -= superseded->second->data.size();
+            --stats.queued_messages;
+            ++stats.coalesced_messages;
+            queue.erase(superseded->second);
+            superseding.erase(superseded);
+        }
+    }
+
+    if (stats.queued_bytes + message_size > queue_limit)
+    {
+        ++stats.dropped_messages;
+
+        // A client that misses a reply or fds would wait for them forever
+        if (overflow_policy == QueueOverflowPolicy::drop_messages && droppable)
+        {
+            if (!overflowed)
+            {
+                overflowed = true;
+                mir::log_warning(
+                    "Client (pid=%d) is not reading its messages: %zu bytes queued, dropping events",
+                    client_creds().pid(), stats.queued_bytes);
+            }
+            return;
+        }
+
+        mir::log_warning(
+            "Client (pid=%d) is not reading its messages: %zu bytes queued, disconnecting",
+            client_creds().pid(), stats.queued_bytes);
+
+        discard_queue(lg);
+        broken = true;
+        bs::error_code ignored;
+        socket->shutdown(ba::local::stream_protocol::socket::shutdown_both, ignored);
+        return;
+    }
 
-    std::unique_lock<std::mutex> lg(message_lock);
+    queue.push_back(Message{std::vector<char>(message_size), fds, key, 0, 0});
+    auto& message = queue.back();
+    message.data[0] = static_cast<char>((length >> 8) & 0xff);
+    message.data[1] = static_cast<char>((length >> 0) & 0xff);
+    std::copy(data, data + length, message.data.data() + header_size);
 
-    // TODO: This should be asynchronous, but we are not making sure
-    // that a potential call to send_fds is executed _after_ this
-    // function has completed (if it would be executed asynchronously.
-    // NOTE: we rely on this synchronous behavior as per the comment in
-    // mf::SessionMediator::create_surface
-    ba::write(*socket, ba::buffer(whole_message.data(), whole_message.size()));
+    if (key)
+        superseding[key] = std::prev(queue.end());
 
-    for (auto const& fds : fd_set)
-        mir::send_fds(socket_fd, fds);
+    stats.queued_bytes += message_size;
+    ++stats.queued_messages;
+    stats.peak_queued_bytes = std::max(stats.peak_queued_bytes, stats.queued_bytes);
+
+    // If we are already waiting for the socket the message goes out after
+    // the ones ahead of it
+    if (waiting_for_writable)
+        return;
+
+    try
+    {
+        if (!write_queued(lg))
+            wait_for_writable(lg);
+    }
+    catch (...)
+    {
+        discard_queue(lg);
+        broken = true;
+        throw;
+    }
+}
+
+bool mfd::SocketMessenger::write_queued(std::lock_guard<std::mutex> const&)
+{
+    while (!queue.empty())
+    {
+        auto& message = queue.front();
+
+        while (message.bytes_written < message.data.size())
+        {
+            bs::error_code error;
+            message.bytes_written += socket->write_some(
+                ba::buffer(message.data.data() + message.bytes_written, message.data.size() - message.bytes_written),
+                error);
+
+            if (error == ba::error::would_block || error == ba::error::try_again)
+                return false;
+            if (error)
+                BOOST_THROW_EXCEPTION(bs::system_error(error));
+        }
+
+        while (message.fd_sets_written < message.fds.size())
+        {
+            // send_fds() writes a byte along with the fds: only try when
+            // that won't block
+            pollfd writable{socket_fd, POLLOUT, 0};
+            if (poll(&writable, 1, 0) != 1)
+                return false;
+
+            mir::send_fds(socket_fd, message.fds[message.fd_sets_written]);
+            ++message.fd_sets_written;
+        }
+
+        if (message.key)
+        {
+            auto const entry = superseding.find(message.key);
+            if (entry != superseding.end() && entry->second == queue.begin())
+                superseding.erase(entry);
+        }
+
+        stats.queued_bytes -= message.data.size();
+        --stats.queued_messages;
+        queue.pop_front();
+    }
+
+    overflowed = false;
+    return true;
+}
+
+void mfd::SocketMessenger::discard_queue(std::lock_guard<std::mutex> const&)
+{
+    queue.clear();
+    superseding.clear();
+    stats.queued_bytes = 0;
+    stats.queued_messages = 0;
+}
+
+void mfd::SocketMessenger::wait_for_writable(std::lock_guard<std::mutex> const&)
+{
+    waiting_for_writable = true;
+
+    std::weak_ptr<SocketMessenger> const weak_self{shared_from_this()};
+    socket->async_write_some(
+        ba::null_buffers(),
+        [weak_self](bs::error_code const& error, size_t)
+        {
+            if (auto const self = weak_self.lock())
+                self->on_writable(error);
+        });
+}
+
+void mfd::SocketMessenger::on_writable(bs::error_code const& error)
+{
+    std::lock_guard<std::mutex> lg(message_lock);
+    waiting_for_writable = false;
+
+    if (broken)
+        return;
+
+    try
+    {
+        if (error)
+            BOOST_THROW_EXCEPTION(bs::system_error(error));
+
+        if (!write_queued(lg))
+            wait_for_writable(lg);
+    }
+    catch (std::exception const&)
+    {
+        // The connection will notice on its next read; nothing more can be
+        // sent to this client
+        discard_queue(lg);
+        broken = true;
+    }
 }
 
 void mfd::SocketMessenger::async_receive_msg(
@@ -1,5 +1,5 @@
 /*
- * Copyright © 2013-2014 Canonical Ltd.
+ * Copyright © 2013-2014,2019 Canonical Ltd.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License version 2 or 3 as
@@ -21,7 +21,13 @@
 #include "message_sender.h"
 #include "message_receiver.h"
 #include "mir/frontend/session_credentials.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace mir
 {
@@ -29,13 +35,45 @@ namespace frontend
 {
 namespace detail
 {
+/// What to do when a client stops reading and its outbound queue reaches the limit
+enum class QueueOverflowPolicy
+{
+    disconnect,     ///< Shut down the client's socket
+    drop_messages   ///< Discard new events until the client catches up (replies and fds still disconnect it)
+};
+
+/**
+ * Messages that cannot be written without blocking are queued and written
+ * when the socket becomes writable, so a slow client never stalls the
+ * thread sending to it. Queued messages that are superseded by a newer one
+ * with the same key are discarded. The queue is bounded by queue_limit bytes.
+ */
 class SocketMessenger : public MessageSender,
-                        public MessageReceiver
+                        public MessageReceiver,
+                        public std::enable_shared_from_this<SocketMessenger>
 {
 public:
+    struct QueueStats
+    {
+        size_t queued_bytes;
+        size_t queued_messages;
+        size_t peak_queued_bytes;
+        uint64_t coalesced_messages;
+        uint64_t dropped_messages;
+    };
+
+    static size_t const default_queue_limit = 16*1024*1024;
+
     SocketMessenger(std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket);
+    SocketMessenger(
+        std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket,
+        size_t queue_limit,
+        QueueOverflowPolicy overflow_policy);
 
     void send(char const* data, size_t length, FdSets const& fds) override;
+    void send_superseding(uint64_t key, char const* data, size_t length) override;
+
+    QueueStats queue_stats();
 
     void async_receive_msg(MirReadHandler const& handler, boost::asio::mutable_buffers_1 const& buffer) override;
     boost::system::error_code receive_msg(boost::asio::mutable_buffers_1 const& buffer) override;
@@ -48,10 +86,39 @@ private:
     void update_session_creds();
     SessionCredentials creator_creds() const;
 
+    struct Message
+    {
+        std::vector<char> data;
+        FdSets fds;
+        uint64_t key;
+        size_t bytes_written;
+        size_t fd_sets_written;
+    };
+
+    void enqueue(
+        std::lock_guard<std::mutex> const&,
+        uint64_t key,
+        char const* data,
+        size_t length,
+        FdSets const& fds,
+        bool droppable);
+    bool write_queued(std::lock_guard<std::mutex> const&);
+    void discard_queue(std::lock_guard<std::mutex> const&);
+    void wait_for_writable(std::lock_guard<std::mutex> const&);
+    void on_writable(boost::system::error_code const& error);
+
     std::shared_ptr<boost::asio::local::stream_protocol::socket> socket;
     mir::Fd socket_fd;
+    size_t const queue_limit;
+    QueueOverflowPolicy const overflow_policy;
 
     std::mutex message_lock;
+    std::list<Message> queue;
+    std::unordered_map<uint64_t, std::list<Message>::iterator> superseding;
+    bool waiting_for_writable{false};
+    bool overflowed{false};
+    bool broken{false};
+    QueueStats stats{0, 0, 0, 0, 0};
     SessionCredentials session_creds{0, 0, 0};
 };
 }
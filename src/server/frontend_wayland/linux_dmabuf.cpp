@@ -0,0 +1,620 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "linux_dmabuf.h"
+
+#include "linux-dmabuf-unstable-v1_wrapper.h"
+#include "wayland_wrapper.h"
+
+#include "mir/graphics/egl_error.h"
+#include "mir/graphics/egl_extensions.h"
+
+#define MIR_LOG_COMPONENT "linux-dmabuf"
+#include <mir/log.h>
+
+#include <boost/throw_exception.hpp>
+
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <experimental/optional>
+#include <system_error>
+
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+namespace mw = mir::wayland;
+namespace geom = mir::geometry;
+
+namespace mir
+{
+namespace wayland
+{
+extern struct wl_interface const wl_buffer_interface_data;
+}
+}
+
+namespace
+{
+constexpr uint32_t fourcc_code(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 |
+           static_cast<uint32_t>(c) << 16 | static_cast<uint32_t>(d) << 24;
+}
+
+// From drm_fourcc.h, which the frontend has no other need of
+uint32_t const drm_format_argb8888 = fourcc_code('A', 'R', '2', '4');
+uint32_t const drm_format_xrgb8888 = fourcc_code('X', 'R', '2', '4');
+uint32_t const drm_format_abgr8888 = fourcc_code('A', 'B', '2', '4');
+uint32_t const drm_format_xbgr8888 = fourcc_code('X', 'B', '2', '4');
+uint64_t const drm_format_mod_linear = 0;
+uint64_t const drm_format_mod_invalid = 0x00ffffffffffffffull;
+
+/* Only single-plane RGB formats: the renderer samples buffers through a plain
+ * GL_TEXTURE_2D, and YUV images would need an external sampler.
+ */
+struct
+{
+    uint32_t drm_format;
+    MirPixelFormat mir_format;
+} const supported_formats[] = {
+    {drm_format_argb8888, mir_pixel_format_argb_8888},
+    {drm_format_xrgb8888, mir_pixel_format_xrgb_8888},
+    {drm_format_abgr8888, mir_pixel_format_abgr_8888},
+    {drm_format_xbgr8888, mir_pixel_format_xbgr_8888},
+};
+
+// Implicit (driver chosen) layouts, and linear ones which can be mapped if they can't be imported
+uint64_t const supported_modifiers[] = {drm_format_mod_invalid, drm_format_mod_linear};
+
+uint32_t const max_planes = 4;
+
+auto mir_format_for(uint32_t drm_format) -> MirPixelFormat
+{
+    for (auto const& format : supported_formats)
+    {
+        if (format.drm_format == drm_format)
+            return format.mir_format;
+    }
+    return mir_pixel_format_invalid;
+}
+
+auto gl_format_for(MirPixelFormat format) -> GLenum
+{
+    switch (format)
+    {
+    case mir_pixel_format_argb_8888:
+    case mir_pixel_format_xrgb_8888:
+        return GL_BGRA_EXT;
+    case mir_pixel_format_abgr_8888:
+    case mir_pixel_format_xbgr_8888:
+        return GL_RGBA;
+    default:
+        return GL_INVALID_ENUM;
+    }
+}
+
+bool has_extension(char const* extensions, char const* extension)
+{
+    if (!extensions)
+        return false;
+
+    auto const length = strlen(extension);
+    for (auto found = strstr(extensions, extension); found; found = strstr(found + length, extension))
+    {
+        if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+bool is_linear(mf::DmaBufAttributes const& attributes)
+{
+    return attributes.planes.size() == 1 &&
+        (attributes.planes[0].modifier == drm_format_mod_linear ||
+         attributes.planes[0].modifier == drm_format_mod_invalid);
+}
+
+void sync_for_cpu_access(int fd, uint64_t flags)
+{
+    dma_buf_sync sync{};
+    sync.flags = flags | DMA_BUF_SYNC_READ;
+
+    // memfds and other plain memory don't need (or support) synchronisation
+    while (ioctl(fd, DMA_BUF_IOCTL_SYNC, &sync) == -1 && errno == EINTR)
+        ;
+}
+
+class WlDmaBuffer : public mw::Buffer
+{
+public:
+    WlDmaBuffer(wl_resource* new_resource, std::shared_ptr<mf::DmaBufImage> const& image) :
+        Buffer{new_resource},
+        image{image}
+    {
+    }
+
+    std::shared_ptr<mf::DmaBufImage> const image;
+
+private:
+    void destroy() override
+    {
+        destroy_wayland_object();
+    }
+};
+
+class LinuxBufferParams : public mw::LinuxBufferParamsV1
+{
+public:
+    LinuxBufferParams(wl_resource* new_resource) :
+        LinuxBufferParamsV1{new_resource}
+    {
+    }
+
+private:
+    void destroy() override
+    {
+        destroy_wayland_object();
+    }
+
+    void add(
+        mir::Fd fd,
+        uint32_t plane_idx,
+        uint32_t offset,
+        uint32_t stride,
+        uint32_t modifier_hi,
+        uint32_t modifier_lo) override
+    {
+        if (used)
+        {
+            wl_resource_post_error(resource, Error::already_used, "Params were already used to create a buffer");
+            return;
+        }
+
+        if (plane_idx >= max_planes)
+        {
+            wl_resource_post_error(resource, Error::plane_idx, "Plane index %u is out of bounds", plane_idx);
+            return;
+        }
+
+        if (planes[plane_idx])
+        {
+            wl_resource_post_error(resource, Error::plane_set, "Plane %u was already set", plane_idx);
+            return;
+        }
+
+        planes[plane_idx] = mf::DmaBufPlane{fd, offset, stride, uint64_t{modifier_hi} << 32 | modifier_lo};
+    }
+
+    void create(int32_t width, int32_t height, uint32_t format, uint32_t flags) override
+    {
+        if (auto const image = image_for(width, height, format, flags))
+        {
+            auto const buffer = wl_resource_create(client, &mw::wl_buffer_interface_data, 1, 0);
+            if (!buffer)
+            {
+                wl_client_post_no_memory(client);
+                return;
+            }
+
+            new WlDmaBuffer{buffer, image};
+            send_created_event(buffer);
+        }
+    }
+
+    void create_immed(wl_resource* buffer_id, int32_t width, int32_t height, uint32_t format, uint32_t flags) override
+    {
+        if (auto const image = image_for(width, height, format, flags))
+            new WlDmaBuffer{buffer_id, image};
+    }
+
+    /* The dmabufs are imported lazily, when they're first composited, as the frontend
+     * has no EGL context of its own. So only the attributes are checked here, and
+     * any error is fatal to the client.
+     */
+    auto image_for(int32_t width, int32_t height, uint32_t format, uint32_t flags)
+        -> std::shared_ptr<mf::DmaBufImage>
+    {
+        if (used)
+        {
+            wl_resource_post_error(resource, Error::already_used, "Params were already used to create a buffer");
+            return nullptr;
+        }
+        used = true;
+
+        if (mir_format_for(format) == mir_pixel_format_invalid)
+        {
+            wl_resource_post_error(resource, Error::invalid_format, "Format 0x%08x is not supported", format);
+            return nullptr;
+        }
+
+        if (!planes[0] || std::any_of(begin(planes) + 1, end(planes), [](auto const& plane) { return !!plane; }))
+        {
+            wl_resource_post_error(resource, Error::incomplete, "Format 0x%08x has exactly one plane", format);
+            return nullptr;
+        }
+
+        if (width <= 0 || height <= 0)
+        {
+            wl_resource_post_error(resource, Error::invalid_dimensions, "Invalid size %dx%d", width, height);
+            return nullptr;
+        }
+
+        auto const& plane = *planes[0];
+        if (plane.modifier != drm_format_mod_linear && plane.modifier != drm_format_mod_invalid)
+        {
+            wl_resource_post_error(
+                resource, Error::invalid_format, "Modifier 0x%016" PRIx64 " is not supported", plane.modifier);
+            return nullptr;
+        }
+
+        if (plane.stride < uint64_t{static_cast<uint32_t>(width)} * MIR_BYTES_PER_PIXEL(mir_format_for(format)))
+        {
+            wl_resource_post_error(
+                resource, Error::out_of_bounds,
+                "Stride (%u) is less than width × bytes per pixel", plane.stride);
+            return nullptr;
+        }
+
+        // Not every dmabuf exporter reports a size. (The file offset is shared with the client, so don't seek.)
+        struct stat dmabuf_status;
+        if (fstat(plane.fd, &dmabuf_status) == 0 && dmabuf_status.st_size > 0)
+        {
+            if (plane.offset + uint64_t{plane.stride} * height > static_cast<uint64_t>(dmabuf_status.st_size))
+            {
+                wl_resource_post_error(
+                    resource, Error::out_of_bounds, "Offset + stride × height exceeds the dmabuf size");
+                return nullptr;
+            }
+        }
+
+        return std::make_shared<mf::DmaBufImage>(
+            mf::DmaBufAttributes{geom::Size{width, height}, format, flags, {plane}});
+    }
+
+    bool used{false};
+    std::array<std::experimental::optional<mf::DmaBufPlane>, max_planes> planes;
+};
+}
+
+namespace mir
+{
+namespace frontend
+{
+class LinuxDmaBufUnstableV1 : public wayland::LinuxDmabufV1::Global
+{
+public:
+    LinuxDmaBufUnstableV1(struct wl_display* display);
+
+private:
+    class Instance : public wayland::LinuxDmabufV1
+    {
+    public:
+        Instance(wl_resource* new_resource);
+
+    private:
+        void destroy() override;
+        void create_params(wl_resource* params_id) override;
+    };
+
+    void bind(wl_resource* new_resource) override;
+};
+}
+}
+
+auto mf::create_linux_dmabuf_unstable_v1(struct wl_display* display)
+    -> std::shared_ptr<LinuxDmaBufUnstableV1>
+{
+    return std::make_shared<LinuxDmaBufUnstableV1>(display);
+}
+
+mf::LinuxDmaBufUnstableV1::LinuxDmaBufUnstableV1(struct wl_display* display)
+    : Global(display, wayland::LinuxDmabufV1::interface_version)
+{
+}
+
+void mf::LinuxDmaBufUnstableV1::bind(wl_resource* new_resource)
+{
+    new Instance{new_resource};
+}
+
+mf::LinuxDmaBufUnstableV1::Instance::Instance(wl_resource* new_resource)
+    : LinuxDmabufV1{new_resource}
+{
+    for (auto const& format : supported_formats)
+    {
+        if (version_supports_modifier())
+        {
+            for (auto const modifier : supported_modifiers)
+                send_modifier_event(format.drm_format, modifier >> 32, modifier & 0xffffffff);
+        }
+        else
+        {
+            send_format_event(format.drm_format);
+        }
+    }
+}
+
+void mf::LinuxDmaBufUnstableV1::Instance::destroy()
+{
+    destroy_wayland_object();
+}
+
+void mf::LinuxDmaBufUnstableV1::Instance::create_params(wl_resource* params_id)
+{
+    new LinuxBufferParams{params_id};
+}
+
+auto mf::linux_dmabuf_image(wl_resource* buffer) -> std::shared_ptr<DmaBufImage>
+{
+    if (!mw::Buffer::is_instance(buffer))
+        return nullptr;
+
+    if (auto const dmabuf = dynamic_cast<WlDmaBuffer*>(mw::Buffer::from(buffer)))
+        return dmabuf->image;
+
+    return nullptr;
+}
+
+struct mf::DmaBufImage::EGLImport
+{
+    EGLImport(EGLDisplay display, EGLint const* image_attrs) :
+        display{display},
+        image{extensions.eglCreateImageKHR(
+            display,
+            EGL_NO_CONTEXT,
+            EGL_LINUX_DMA_BUF_EXT,
+            static_cast<EGLClientBuffer>(nullptr),
+            image_attrs)}
+    {
+        if (image == EGL_NO_IMAGE_KHR)
+            BOOST_THROW_EXCEPTION(mg::egl_error("Failed to create EGLImage"));
+    }
+
+    ~EGLImport()
+    {
+        extensions.eglDestroyImageKHR(display, image);
+    }
+
+    mg::EGLExtensions const extensions;
+    EGLDisplay const display;
+    EGLImageKHR const image;
+};
+
+struct mf::DmaBufImage::Mapping
+{
+    Mapping(int fd, size_t length) :
+        fd{fd},
+        length{length},
+        data{mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0)}
+    {
+        if (data == MAP_FAILED)
+            BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to map dmabuf"}));
+    }
+
+    ~Mapping()
+    {
+        munmap(data, length);
+    }
+
+    int const fd;
+    size_t const length;
+    void* const data;
+};
+
+mf::DmaBufImage::DmaBufImage(DmaBufAttributes&& attributes) :
+    attributes{std::move(attributes)},
+    pixel_format{mir_format_for(this->attributes.format)}
+{
+}
+
+mf::DmaBufImage::~DmaBufImage() = default;
+
+void mf::DmaBufImage::bind_to_texture()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (!egl_import && !egl_import_failed)
+    {
+        auto const display = eglGetCurrentDisplay();
+        auto const extensions = eglQueryString(display, EGL_EXTENSIONS);
+        bool const with_modifiers = has_extension(extensions, "EGL_EXT_image_dma_buf_import_modifiers");
+        auto const modifier = attributes.planes[0].modifier;
+        bool const send_modifier = with_modifiers && modifier != drm_format_mod_invalid;
+
+        // Without the modifiers extension a linear layout is described by its pitch alone
+        bool const describable =
+            with_modifiers || modifier == drm_format_mod_invalid || modifier == drm_format_mod_linear;
+
+        if (has_extension(extensions, "EGL_EXT_image_dma_buf_import") && describable)
+        {
+            auto const& plane = attributes.planes[0];
+            std::vector<EGLint> image_attrs{
+                EGL_WIDTH, attributes.size.width.as_int(),
+                EGL_HEIGHT, attributes.size.height.as_int(),
+                EGL_LINUX_DRM_FOURCC_EXT, static_cast<EGLint>(attributes.format),
+                EGL_DMA_BUF_PLANE0_FD_EXT, plane.fd,
+                EGL_DMA_BUF_PLANE0_OFFSET_EXT, static_cast<EGLint>(plane.offset),
+                EGL_DMA_BUF_PLANE0_PITCH_EXT, static_cast<EGLint>(plane.stride)};
+
+            if (send_modifier)
+            {
+                image_attrs.insert(end(image_attrs), {
+                    EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, static_cast<EGLint>(plane.modifier & 0xffffffff),
+                    EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT, static_cast<EGLint>(plane.modifier >> 32)});
+            }
+            image_attrs.push_back(EGL_NONE);
+
+            try
+            {
+                egl_import = std::make_unique<EGLImport>(display, image_attrs.data());
+            }
+            catch (std::runtime_error const& error)
+            {
+                log_debug("%s", error.what());
+            }
+        }
+
+        egl_import_failed = !egl_import;
+        if (egl_import_failed)
+        {
+            log_debug(
+                "Could not import a %dx%d dmabuf, %s",
+                attributes.size.width.as_int(), attributes.size.height.as_int(),
+                is_linear(attributes) ? "mapping it instead" : "it will not be drawn");
+        }
+    }
+
+    if (egl_import)
+    {
+        egl_import->extensions.glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, egl_import->image);
+    }
+    else if (is_linear(attributes))
+    {
+        auto const& mapping = map();
+        auto const& plane = attributes.planes[0];
+        auto const format = gl_format_for(pixel_format);
+        auto const width = attributes.size.width.as_int();
+        auto const height = attributes.size.height.as_int();
+        auto const pixels = static_cast<unsigned char const*>(mapping.data) + plane.offset;
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        sync_for_cpu_access(mapping.fd, DMA_BUF_SYNC_START);
+        if (plane.stride == static_cast<uint32_t>(width) * MIR_BYTES_PER_PIXEL(pixel_format))
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+        }
+        else
+        {
+            // GLES2 has no GL_UNPACK_ROW_LENGTH, so padded rows are uploaded one at a time
+            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+            for (int row = 0; row != height; ++row)
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, width, 1, format, GL_UNSIGNED_BYTE, pixels + row * plane.stride);
+        }
+        sync_for_cpu_access(mapping.fd, DMA_BUF_SYNC_END);
+    }
+}
+
+void mf::DmaBufImage::read(std::function<void(unsigned char const*)> const& do_with_pixels)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (!is_linear(attributes))
+    {
+        log_warning("Attempt to read from a dmabuf with a device specific layout");
+        return;
+    }
+
+    auto const& mapping = map();
+    sync_for_cpu_access(mapping.fd, DMA_BUF_SYNC_START);
+    do_with_pixels(static_cast<unsigned char const*>(mapping.data) + attributes.planes[0].offset);
+    sync_for_cpu_access(mapping.fd, DMA_BUF_SYNC_END);
+}
+
+auto mf::DmaBufImage::map() -> Mapping const&
+{
+    if (!mapping)
+    {
+        auto const& plane = attributes.planes[0];
+        mapping = std::make_unique<Mapping>(
+            plane.fd, plane.offset + size_t{plane.stride} * attributes.size.height.as_int());
+    }
+
+    return *mapping;
+}
+
+mf::DmaBufBuffer::DmaBufBuffer(
+    std::shared_ptr<DmaBufImage> const& image,
+    std::function<void()>&& on_consumed,
+    std::function<void()>&& on_release) :
+    image{image},
+    on_consumed{std::move(on_consumed)},
+    on_release{std::move(on_release)}
+{
+}
+
+mf::DmaBufBuffer::~DmaBufBuffer()
+{
+    on_release();
+}
+
+std::shared_ptr<mg::NativeBuffer> mf::DmaBufBuffer::native_buffer_handle() const
+{
+    return nullptr;
+}
+
+geom::Size mf::DmaBufBuffer::size() const
+{
+    return image->attributes.size;
+}
+
+MirPixelFormat mf::DmaBufBuffer::pixel_format() const
+{
+    return image->pixel_format;
+}
+
+mg::NativeBufferBase* mf::DmaBufBuffer::native_buffer_base()
+{
+    return this;
+}
+
+void mf::DmaBufBuffer::gl_bind_to_texture()
+{
+    bind();
+}
+
+void mf::DmaBufBuffer::bind()
+{
+    image->bind_to_texture();
+    consume();
+}
+
+void mf::DmaBufBuffer::secure_for_render()
+{
+}
+
+void mf::DmaBufBuffer::write(unsigned char const*, size_t)
+{
+    BOOST_THROW_EXCEPTION((std::logic_error{"Client dmabufs are not writable by the compositor"}));
+}
+
+void mf::DmaBufBuffer::read(std::function<void(unsigned char const*)> const& do_with_pixels)
+{
+    image->read(do_with_pixels);
+    consume();
+}
+
+geom::Stride mf::DmaBufBuffer::stride() const
+{
+    return geom::Stride{image->attributes.planes[0].stride};
+}
+
+void mf::DmaBufBuffer::consume()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (on_consumed)
+    {
+        on_consumed();
+        on_consumed = nullptr;
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_LINUX_DMABUF_H_
+#define MIR_FRONTEND_LINUX_DMABUF_H_
+
+#include "mir/fd.h"
+#include "mir/geometry/size.h"
+
+#include <mir/graphics/buffer_basic.h>
+#include <mir/renderer/gl/texture_source.h>
+#include <mir/renderer/sw/pixel_source.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct wl_display;
+struct wl_resource;
+
+namespace mir
+{
+namespace frontend
+{
+class LinuxDmaBufUnstableV1;
+
+auto create_linux_dmabuf_unstable_v1(struct wl_display* display)
+    -> std::shared_ptr<LinuxDmaBufUnstableV1>;
+
+struct DmaBufPlane
+{
+    mir::Fd fd;
+    uint32_t offset;
+    uint32_t stride;
+    uint64_t modifier;
+};
+
+/// The dmabufs a client has shared as a wl_buffer, and how to interpret them
+struct DmaBufAttributes
+{
+    geometry::Size size;
+    uint32_t format;    ///< DRM_FORMAT code
+    uint32_t flags;     ///< zwp_linux_buffer_params_v1 flags
+    std::vector<DmaBufPlane> planes;
+};
+
+/**
+ * The client memory behind a zwp_linux_dmabuf_v1 wl_buffer.
+ *
+ * This is imported once, as an EGLImage, the first time it is bound to a texture; every buffer
+ * committed from the wl_buffer then samples the client's memory directly. Linear buffers that
+ * the EGL implementation can't import (such as memfd or udmabuf backed ones on a system
+ * without a GPU) are mapped instead.
+ */
+class DmaBufImage
+{
+public:
+    explicit DmaBufImage(DmaBufAttributes&& attributes);
+    ~DmaBufImage();
+
+    DmaBufAttributes const attributes;
+    MirPixelFormat const pixel_format;
+
+    /// Must be called with an EGL context current
+    void bind_to_texture();
+
+    void read(std::function<void(unsigned char const*)> const& do_with_pixels);
+
+private:
+    struct EGLImport;
+    struct Mapping;
+
+    auto map() -> Mapping const&;
+
+    std::mutex mutex;
+    std::unique_ptr<EGLImport> egl_import;
+    bool egl_import_failed{false};
+    std::unique_ptr<Mapping> mapping;
+};
+
+/// The image behind a wl_buffer created through zwp_linux_dmabuf_v1, or nullptr for any other wl_buffer
+auto linux_dmabuf_image(wl_resource* buffer) -> std::shared_ptr<DmaBufImage>;
+
+class DmaBufBuffer :
+    public graphics::BufferBasic,
+    public graphics::NativeBufferBase,
+    public renderer::gl::TextureSource,
+    public renderer::software::PixelSource
+{
+public:
+    DmaBufBuffer(
+        std::shared_ptr<DmaBufImage> const& image,
+        std::function<void()>&& on_consumed,
+        std::function<void()>&& on_release);
+    ~DmaBufBuffer();
+
+    std::shared_ptr<graphics::NativeBuffer> native_buffer_handle() const override;
+
+    geometry::Size size() const override;
+
+    MirPixelFormat pixel_format() const override;
+
+    graphics::NativeBufferBase* native_buffer_base() override;
+
+    void gl_bind_to_texture() override;
+
+    void bind() override;
+
+    void secure_for_render() override;
+
+    void write(unsigned char const* pixels, size_t size) override;
+
+    void read(std::function<void(unsigned char const*)> const& do_with_pixels) override;
+
+    geometry::Stride stride() const override;
+
+private:
+    void consume();
+
+    std::shared_ptr<DmaBufImage> const image;
+
+    std::mutex mutex;
+    std::function<void()> on_consumed;
+    std::function<void()> const on_release;
+};
+}
+}
+
+#endif // MIR_FRONTEND_LINUX_DMABUF_H_
@@ -24,6 +24,7 @@
 #include "xdg_shell_stable.h"
 #include "xdg_output_v1.h"
 #include "layer_shell_v1.h"
+#include "linux_dmabuf.h"
 #include "xwayland_wm_shell.h"
 #include "mir_display.h"
 #include "wl_seat.h"
@@ -31,6 +32,7 @@
 #include "mir/graphics/platform.h"
 #include "mir/options/default_configuration.h"
 #include "mir/scene/session.h"
+#include "mir/startup_phase_tracker.h"
 
 namespace mf = mir::frontend;
 namespace mo = mir::options;
@@ -42,6 +44,7 @@ auto const xdg_shell      = "xdg_wm_base";
 auto const xdg_shell_v6   = "zxdg_shell_v6";
 auto const layer_shell_v1 = "zwlr_layer_shell_v1";
 auto const xdg_output_v1  = "zxdg_output_v1";
+auto const linux_dmabuf_v1 = "zwp_linux_dmabuf_v1";
 
 auto configure_wayland_extensions(std::string extensions,
     bool x11_enabled,
@@ -83,6 +86,9 @@ auto configure_wayland_extensions(std::string extensions,
                     create_xdg_output_manager_v1(display, output_manager));
             }
 
+            if (extension.find(linux_dmabuf_v1) != extension.end())
+                add_extension(linux_dmabuf_v1, mf::create_linux_dmabuf_unstable_v1(display));
+
             std::function<void(std::function<void()>&& work)> run_on_wayland_mainloop = [seat](std::function<void()>&& work)
                 {
                     seat->spawn(std::move(work));
@@ -121,6 +127,7 @@ std::shared_ptr<mf::Connector>
     return wayland_connector(
         [this]() -> std::shared_ptr<mf::Connector>
         {
+            auto const phase = startup_phase_tracker->phase("the_wayland_connector");
             auto options = the_options();
             bool const arw_socket = options->is_set(options::arw_server_socket_opt);
 
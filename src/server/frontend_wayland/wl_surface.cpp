@@ -23,6 +23,7 @@
 #include "wl_subcompositor.h"
 #include "wl_region.h"
 #include "wlshmbuffer.h"
+#include "linux_dmabuf.h"
 #include "deleted_for_resource.h"
 
 #include "wayland_wrapper.h"
@@ -349,10 +350,20 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                             [buffer](){ wl_resource_queue_event(buffer, wayland::Buffer::Opcode::release); }));
                     };
 
-                mir_buffer = allocator->buffer_from_resource(
-                    buffer,
-                    std::move(executor_send_frame_callbacks),
-                    std::move(release_buffer));
+                if (auto const dmabuf = linux_dmabuf_image(buffer))
+                {
+                    mir_buffer = std::make_shared<DmaBufBuffer>(
+                        dmabuf,
+                        std::move(executor_send_frame_callbacks),
+                        std::move(release_buffer));
+                }
+                else
+                {
+                    mir_buffer = allocator->buffer_from_resource(
+                        buffer,
+                        std::move(executor_send_frame_callbacks),
+                        std::move(release_buffer));
+                }
                 tracepoint(
                     mir_server_wayland,
                     hw_buffer_committed,
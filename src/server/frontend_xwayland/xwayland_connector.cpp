@@ -22,18 +22,33 @@
 
 #include "mir/optional_value.h"
 #include "mir/terminate_with_current_exception.h"
+#include "mir/time/alarm.h"
+#include "mir/time/alarm_factory.h"
 #include "wayland_connector.h"
 #include "xwayland_server.h"
 
 namespace mf = mir::frontend;
 
 mf::XWaylandConnector::XWaylandConnector(const int xdisplay, std::shared_ptr<mf::WaylandConnector> wc)
-    : enabled(!!wc->get_extension("x11-support"))
+    : XWaylandConnector(xdisplay, wc, nullptr, {})
+{
+}
+
+mf::XWaylandConnector::XWaylandConnector(
+    const int xdisplay,
+    std::shared_ptr<mf::WaylandConnector> wc,
+    std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+    optional_value<std::chrono::milliseconds> prespawn_delay)
+    : enabled(!!wc->get_extension("x11-support")),
+      alarm_factory{alarm_factory},
+      prespawn_delay{prespawn_delay}
 {
     if (enabled)
         xwayland_server = std::make_shared<mf::XWaylandServer>(xdisplay, wc);
 }
 
+mf::XWaylandConnector::~XWaylandConnector() = default;
+
 void mf::XWaylandConnector::start()
 {
     if (!enabled)
@@ -50,12 +65,26 @@ void mf::XWaylandConnector::start()
     xserver_thread = std::make_unique<mir::dispatch::ThreadedDispatcher>(
         "Mir/X11 Reader", xwayland_server->get_dispatcher(), []() { mir::terminate_with_current_exception(); });
     mir::log_info("XWayland loop started");
+
+    // Alarms only fire once the main loop is running, so the delay counts
+    // from the end of startup rather than competing with it
+    if (alarm_factory && prespawn_delay.is_set())
+    {
+        std::weak_ptr<XWaylandServer> const server{xwayland_server};
+        prespawn_alarm = alarm_factory->create_alarm([server]
+            {
+                if (auto const live_server = server.lock())
+                    live_server->prespawn_xserver();
+            });
+        prespawn_alarm->reschedule_in(prespawn_delay.value());
+    }
 }
 void mf::XWaylandConnector::stop()
 {
     if (!enabled)
         return;
 
+    prespawn_alarm.reset();
     xwayland_server.reset();
     xserver_thread.reset();
 }
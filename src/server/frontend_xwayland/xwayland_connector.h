@@ -20,6 +20,8 @@
 
 #include "mir/dispatch/threaded_dispatcher.h"
 #include "mir/frontend/connector.h"
+#include "mir/optional_value.h"
+#include <chrono>
 #include <thread>
 
 namespace mir
@@ -28,6 +30,11 @@ namespace dispatch
 {
 class ThreadedDispatcher;
 } /* dispatch */
+namespace time
+{
+class Alarm;
+class AlarmFactory;
+} /* time */
 namespace frontend
 {
 class WaylandConnector;
@@ -36,6 +43,13 @@ class XWaylandConnector : public Connector
 {
 public:
     XWaylandConnector(const int xdisplay, std::shared_ptr<WaylandConnector> wc);
+    /// Starts Xwayland prespawn_delay after start() instead of waiting for the first X11 client
+    XWaylandConnector(
+        const int xdisplay,
+        std::shared_ptr<WaylandConnector> wc,
+        std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+        optional_value<std::chrono::milliseconds> prespawn_delay);
+    ~XWaylandConnector();
     void start() override;
     void stop() override;
 
@@ -48,6 +62,9 @@ private:
     bool enabled;
     std::shared_ptr<XWaylandServer> xwayland_server;
     std::unique_ptr<dispatch::ThreadedDispatcher> xserver_thread;
+    std::shared_ptr<time::AlarmFactory> const alarm_factory;
+    optional_value<std::chrono::milliseconds> const prespawn_delay;
+    std::unique_ptr<time::Alarm> prespawn_alarm;
 };
 } /* frontend */
 } /* mir */
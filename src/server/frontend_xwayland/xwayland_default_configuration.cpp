@@ -17,6 +17,8 @@
 
 #include "mir/default_server_configuration.h"
 #include "mir/log.h"
+#include "mir/main_loop.h"
+#include "mir/startup_phase_tracker.h"
 #include "wayland_connector.h"
 #include "xwayland_connector.h"
 
@@ -60,13 +62,20 @@ std::shared_ptr<mf::Connector> mir::DefaultServerConfiguration::the_xwayland_con
 {
     return xwayland_connector([this]() -> std::shared_ptr<mf::Connector> {
 
+        auto const phase = startup_phase_tracker->phase("the_xwayland_connector");
         auto options = the_options();
         if (options->is_set(mo::x11_display_opt))
         {
             try
             {
                 auto wc = std::static_pointer_cast<mf::WaylandConnector>(the_wayland_connector());
-                return std::make_shared<mf::XWaylandConnector>(options->get<int>(mo::x11_display_opt), wc);
+
+                mir::optional_value<std::chrono::milliseconds> prespawn_delay;
+                if (options->is_set(mo::x11_prespawn_delay_opt))
+                    prespawn_delay = std::chrono::milliseconds{options->get<int>(mo::x11_prespawn_delay_opt)};
+
+                return std::make_shared<mf::XWaylandConnector>(
+                    options->get<int>(mo::x11_display_opt), wc, the_main_loop(), prespawn_delay);
             }
             catch (...)
             {
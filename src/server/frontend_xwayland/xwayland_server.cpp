@@ -29,6 +29,7 @@
 #include <csignal>
 #include <fcntl.h>
 #include <memory>
+#include <poll.h>
 #include <sstream>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -43,7 +44,11 @@
 namespace mf = mir::frontend;
 namespace md = mir::dispatch;
 
-bool mf::XWaylandServer::xserver_ready = false;
+namespace
+{
+// How long Xwayland has to report it is ready before we give up on it
+auto const xserver_startup_timeout = std::chrono::seconds{2};
+}
 
 mf::XWaylandServer::XWaylandServer(const int xdisplay, std::shared_ptr<mf::WaylandConnector> wc)
     : wm(std::make_shared<XWaylandWM>(wc)),
@@ -70,9 +75,11 @@ mf::XWaylandServer::~XWaylandServer()
           if (kill(pid, 0) == 0)    // ...if Xwayland is still running...
             kill(pid, SIGKILL);     // ...then kill it!
       }
-      spawn_thread->join();
     }
 
+    if (spawn_thread && spawn_thread->joinable())
+      spawn_thread->join();
+
     if (lazy)
       return;
 
@@ -88,9 +95,9 @@ mf::XWaylandServer::~XWaylandServer()
 void mf::XWaylandServer::spawn()
 {
     int fd;
-    int wl_client_fd[2], wm_fd[2];
+    int wl_client_fd[2], wm_fd[2], ready_fd[2];
     int status;
-    std::string fd_str, abs_fd_str, wm_fd_str;
+    std::string fd_str, abs_fd_str, wm_fd_str, ready_fd_str;
 
     xserver_status = STARTING;
 
@@ -114,19 +121,17 @@ void mf::XWaylandServer::spawn()
         return;
     }
 
+    // Xwayland writes its display number to this once it accepts connections
+    if (pipe2(ready_fd, O_CLOEXEC) < 0)
+    {
+        mir::log_error("Xwayland readiness pipe failed");
+        return;
+    }
+
     std::ostringstream _dsp_str;
     _dsp_str << ":" << xdisplay;
     auto dsp_str = _dsp_str.str();
 
-    // This is not pretty! but SIGUSR1 is the only way we know the xserver
-    // is ready to accept connections to the wm fd
-    // If not it will have a race condition on start that might end
-    // up in a never ending wait
-    std::signal(SIGUSR1, [](int) {
-        xserver_ready = true;
-        mir::log_info("Xwayland running");
-    });
-
     mir::log_info("Starting Xwayland");
     pid = fork();
     switch (pid)
@@ -156,8 +161,10 @@ void mf::XWaylandServer::spawn()
             mir::log_error("Failed to duplicate xwayland wm FD");
         wm_fd_str = std::to_string(fd);
 
-        // forward SIGUSR1 to parent thread (us)
-        signal(SIGUSR1, SIG_IGN);
+        fd = dup(ready_fd[1]);
+        if (fd < 0)
+            mir::log_error("Failed to duplicate xwayland ready FD");
+        ready_fd_str = std::to_string(fd);
 
         // Last second abort
         if (terminate) return;
@@ -170,6 +177,7 @@ void mf::XWaylandServer::spawn()
                   "-listen", abs_fd_str.c_str(),
                   "-listen", fd_str.c_str(),
                   "-wm", wm_fd_str.c_str(),
+                  "-displayfd", ready_fd_str.c_str(),
                   NULL);
         else
             execl("/usr/bin/Xwayland",
@@ -179,6 +187,7 @@ void mf::XWaylandServer::spawn()
                 "-listen", abs_fd_str.c_str(),
                 "-listen", fd_str.c_str(),
                 "-wm", wm_fd_str.c_str(),
+                "-displayfd", ready_fd_str.c_str(),
                 "-terminate",
                 NULL);
         break;
@@ -188,25 +197,26 @@ void mf::XWaylandServer::spawn()
     default:
         close(wl_client_fd[1]);
         close(wm_fd[1]);
+        close(ready_fd[1]);
         auto wlclient = wl_client_create(wlc->get_wl_display(), wl_client_fd[0]);
 
-        // More ugliness
-        int tries = 0;
-        while (!xserver_ready)
-        {
-          // Last second abort
-          if (terminate) return;
-
-          // Check for stalled startup
-          if (waitpid(pid, NULL, WNOHANG) != 0 || tries > 200) {
-            xserver_status = FAILED;
-            mir::log_info("Stalled start of Xserver, trying to start again!");
-            spawn();
-            return;
-          }
+        auto const ready = wait_for_xserver_ready(ready_fd[0]);
+        close(ready_fd[0]);
+
+        // Last second abort
+        if (terminate) return;
 
-          std::this_thread::sleep_for(std::chrono::milliseconds(10));
-          tries++;
+        // Check for stalled startup
+        if (!ready) {
+          if (waitpid(pid, NULL, WNOHANG) == 0) {
+            kill(pid, SIGKILL);
+            waitpid(pid, NULL, 0);
+          }
+          close(wm_fd[0]);
+          xserver_status = FAILED;
+          mir::log_info("Stalled start of Xserver, trying to start again!");
+          spawn();
+          return;
         }
 
         // Last second abort
@@ -230,7 +240,6 @@ void mf::XWaylandServer::spawn()
 
         if (terminate) return;
         wm->destroy();
-        xserver_ready = false;
 
         if (xserver_status == FAILED) {
           mir::log_info("Trying to start Xwayland again!");
@@ -245,6 +254,38 @@ void mf::XWaylandServer::spawn()
     }
 }
 
+bool mf::XWaylandServer::wait_for_xserver_ready(int ready_fd)
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto const deadline = start + xserver_startup_timeout;
+
+    // Xwayland exiting (including us killing it on shutdown) closes its end
+    // of the pipe, so there is no need to wake up and check on it.
+    pollfd ready{ready_fd, POLLIN, 0};
+    for (auto now = start; now < deadline; now = std::chrono::steady_clock::now())
+    {
+        auto const timeout = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        auto const result = poll(&ready, 1, timeout.count() + 1);
+
+        if (result < 0 && errno == EINTR)
+            continue;
+
+        if (result <= 0)
+            break;
+
+        char display[16];
+        if (read(ready_fd, display, sizeof display) <= 0)
+            break;
+
+        auto const startup_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        mir::log_info("Xwayland running (ready after %lld ms)", static_cast<long long>(startup_time.count()));
+        return true;
+    }
+
+    return false;
+}
+
 bool mf::XWaylandServer::set_cloexec(int fd, bool cloexec) {
       	int flags = fcntl(fd, F_GETFD);
       	if (flags == -1) {
@@ -402,19 +443,36 @@ void mf::XWaylandServer::new_spawn_thread() {
   if (xserver_status > 0) return;
   xserver_status = STARTING;
 
+  // A previous server's thread has finished (or is just returning) by now
+  if (spawn_thread && spawn_thread->joinable() && spawn_thread->get_id() != std::this_thread::get_id())
+    spawn_thread->join();
+  else if (spawn_thread && spawn_thread->joinable())
+    spawn_thread->detach();
+
   spawn_thread = std::make_unique<std::thread>(&mf::XWaylandServer::spawn, this);
 }
 
+void mf::XWaylandServer::spawn_on_demand()
+{
+    std::lock_guard<decltype(spawn_mutex)> lock{spawn_mutex};
+
+    // Either the first client or a prespawn got here first
+    if (!afd_dispatcher)
+        return;
+
+    dispatcher->remove_watch(afd_dispatcher);
+    dispatcher->remove_watch(fd_dispatcher);
+    afd_dispatcher.reset();
+    fd_dispatcher.reset();
+
+    new_spawn_thread();
+}
+
 void mf::XWaylandServer::spawn_xserver_on_event_loop()
 {
-    auto func = [this]() {
-      dispatcher->remove_watch(afd_dispatcher);
-      dispatcher->remove_watch(fd_dispatcher);
-      afd_dispatcher.reset();
-      fd_dispatcher.reset();
+    std::lock_guard<decltype(spawn_mutex)> lock{spawn_mutex};
 
-      new_spawn_thread();
-    };
+    auto func = [this]() { spawn_on_demand(); };
 
     afd_dispatcher = std::make_shared<md::ReadableFd>(mir::Fd{mir::IntOwnedFd{abstract_socket_fd}}, func);
     fd_dispatcher = std::make_shared<md::ReadableFd>(mir::Fd{mir::IntOwnedFd{socket_fd}}, func);
@@ -422,6 +480,12 @@ void mf::XWaylandServer::spawn_xserver_on_event_loop()
     dispatcher->add_watch(fd_dispatcher);
 }
 
+void mf::XWaylandServer::prespawn_xserver()
+{
+    mir::log_info("Starting Xwayland ahead of the first X11 client");
+    spawn_on_demand();
+}
+
 void mf::XWaylandServer::spawn_lazy_xserver()
 {
     lazy = true;
@@ -19,6 +19,7 @@
 #define MIR_FRONTEND_XWAYLAND_SERVER_H
 
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -50,16 +51,17 @@ public:
     void setup_socket();
     void spawn_xserver_on_event_loop();
     void spawn_lazy_xserver();
+    /// Starts the Xserver now rather than when the first X11 client connects
+    void prespawn_xserver();
     std::shared_ptr<dispatch::MultiplexingDispatchable> const get_dispatcher()
     {
         return dispatcher;
     }
 
-    // Ugh, this is ugly!
-    static bool xserver_ready;
-
 private:
     void spawn();
+    bool wait_for_xserver_ready(int ready_fd);
+    void spawn_on_demand();
     void new_spawn_thread();
     int create_lockfile();
     int create_socket(struct sockaddr_un *addr, size_t path_size);
@@ -72,6 +74,7 @@ private:
     std::shared_ptr<dispatch::MultiplexingDispatchable> dispatcher;
     std::shared_ptr<dispatch::ReadableFd> afd_dispatcher;
     std::shared_ptr<dispatch::ReadableFd> fd_dispatcher;
+    std::mutex spawn_mutex;
     std::unique_ptr<std::thread> spawn_thread;
     int socket_fd;
     int abstract_socket_fd;
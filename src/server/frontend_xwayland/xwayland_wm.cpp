@@ -334,25 +334,49 @@ void mf::XWaylandWM::handle_events()
         count++;
     }
 
+    complete_map_requests();
+
     if (count > 0)
     {
         xcb_flush(xcb_connection);
     }
 }
 
+void mf::XWaylandWM::complete_map_requests()
+{
+    // The property requests for every window mapped in this batch are
+    // already in flight, so these replies arrive back to back rather than
+    // costing a round trip per window.
+    auto const requests = std::move(pending_map_requests);
+    pending_map_requests.clear();
+
+    for (auto const window : requests)
+    {
+        auto const surface = surfaces.find(window);
+        if (surface == surfaces.end())
+            continue;
+
+        surface->second->read_properties();
+        surface->second->set_wm_state(XWaylandWMSurface::NormalState);
+        surface->second->set_net_wm_state();
+        surface->second->set_workspace(0);
+        xcb_map_window(xcb_connection, window);
+    }
+}
+
 void mf::XWaylandWM::handle_property_notify(xcb_property_notify_event_t *event)
 {
     mir::log_verbose("XCB_PROPERTY_NOTIFY (window %d)", event->window);
 
-    auto surface = surfaces[event->window];
-    if (!surface)
+    auto const surface = surfaces.find(event->window);
+    if (surface == surfaces.end())
         return;
 
-    surface->dirty_properties();
+    surface->second->dirty_property(event->atom);
 
     if (event->state == XCB_PROPERTY_DELETE)
         mir::log_verbose("XCB_PROPERTY_NOTIFY: deleted");
-    else
+    else if (verbose_log_enabled())
         read_and_dump_property(event->window, event->atom);
 }
 
@@ -392,12 +416,10 @@ void mf::XWaylandWM::handle_map_request(xcb_map_request_event_t *event)
 
     mir::log_verbose("XCB_MAP_REQUEST (window %d)", event->window);
 
-    surface->read_properties();
-    surface->set_wm_state(XWaylandWMSurface::NormalState);
-    surface->set_net_wm_state();
-    surface->set_workspace(0);
-    xcb_map_window(xcb_connection, event->window);
-    xcb_flush(xcb_connection);
+    // Send the property requests now, but only wait for them once the rest
+    // of the queued events have had the chance to send theirs
+    surface->fetch_properties();
+    pending_map_requests.push_back(event->window);
 }
 
 void mf::XWaylandWM::handle_unmap_notify(xcb_unmap_notify_event_t *event)
@@ -720,6 +742,7 @@ void mf::XWaylandWM::wm_get_resources()
     {
         reply = xcb_intern_atom_reply(xcb_connection, cookies[i], NULL);
         *(xcb_atom_t *)((char *)&xcb_atom + atoms[i].offset) = reply->atom;
+        atom_names[reply->atom] = atoms[i].name;
         free(reply);
     }
 
@@ -774,6 +797,9 @@ void mf::XWaylandWM::dump_property(xcb_atom_t property, xcb_get_property_reply_t
     int len;
     uint32_t i;
 
+    if (!verbose_log_enabled())
+        return;
+
     mir::log_verbose("prop name %s: ", get_atom_name(property));
     if (reply == NULL)
     {
@@ -818,26 +844,31 @@ const char *mf::XWaylandWM::get_atom_name(xcb_atom_t atom)
     xcb_get_atom_name_cookie_t cookie;
     xcb_get_atom_name_reply_t *reply;
     xcb_generic_error_t *e;
-    static char buffer[64];
+    char buffer[64];
 
     if (atom == XCB_ATOM_NONE)
         return "None";
 
+    // Atom names never change for the life of the connection
+    auto const cached = atom_names.find(atom);
+    if (cached != atom_names.end())
+        return cached->second.c_str();
+
     cookie = xcb_get_atom_name(xcb_connection, atom);
     reply = xcb_get_atom_name_reply(xcb_connection, cookie, &e);
 
     if (reply)
     {
         snprintf(buffer, sizeof buffer, "%.*s", xcb_get_atom_name_name_length(reply), xcb_get_atom_name_name(reply));
-    }
-    else
-    {
-        snprintf(buffer, sizeof buffer, "(atom %u)", atom);
+        free(reply);
+        return (atom_names[atom] = buffer).c_str();
     }
 
-    free(reply);
+    free(e);
 
-    return buffer;
+    static char unknown[64];
+    snprintf(unknown, sizeof unknown, "(atom %u)", atom);
+    return unknown;
 }
 
 void mf::XWaylandWM::setup_visual_and_colormap()
@@ -19,7 +19,9 @@
 #define MIR_FRONTEND_XWAYLAND_WM_H
 
 #include <map>
+#include <string>
 #include <thread>
+#include <vector>
 #include <wayland-server-core.h>
 
 #include "mir/dispatch/threaded_dispatcher.h"
@@ -166,6 +168,7 @@ private:
 
     // Event handeling
     void handle_events();
+    void complete_map_requests();
     void run_event_loop();
 
     // Events
@@ -193,6 +196,8 @@ private:
     xcb_screen_t *xcb_screen;
     xcb_window_t xcb_window;
     std::map<xcb_window_t, std::shared_ptr<XWaylandWMSurface>> surfaces;
+    std::vector<xcb_window_t> pending_map_requests;
+    std::map<xcb_atom_t, std::string> atom_names;
     std::shared_ptr<dispatch::ReadableFd> wm_dispatcher;
     int xcb_cursor;
     std::vector<xcb_cursor_t> xcb_cursors;
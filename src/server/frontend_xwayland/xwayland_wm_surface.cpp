@@ -29,34 +29,80 @@
 #include <string.h>
 
 #include <map>
+#include <string>
+#include <vector>
 
 namespace mf = mir::frontend;
 
+namespace
+{
+auto tracked_properties(mf::XWaylandWM *xwm) -> std::map<xcb_atom_t, xcb_atom_t>
+{
+    return {
+        {XCB_ATOM_WM_CLASS, XCB_ATOM_STRING},
+        {XCB_ATOM_WM_NAME, XCB_ATOM_STRING},
+        {XCB_ATOM_WM_TRANSIENT_FOR, XCB_ATOM_WINDOW},
+        {xwm->xcb_atom.wm_protocols, TYPE_WM_PROTOCOLS},
+        {xwm->xcb_atom.wm_normal_hints, TYPE_WM_NORMAL_HINTS},
+        {xwm->xcb_atom.net_wm_state, TYPE_NET_WM_STATE},
+        {xwm->xcb_atom.net_wm_window_type, XCB_ATOM_ATOM},
+        {xwm->xcb_atom.net_wm_name, XCB_ATOM_STRING},
+        {xwm->xcb_atom.motif_wm_hints, TYPE_MOTIF_WM_HINTS}};
+}
+
+// The atoms in a property, or none if the reply isn't in the 32-bit format atoms use
+auto atoms_in(xcb_get_property_reply_t* reply) -> std::vector<xcb_atom_t>
+{
+    if (reply->format != 32)
+        return {};
+
+    auto const atoms = static_cast<xcb_atom_t const*>(xcb_get_property_value(reply));
+    auto const count = xcb_get_property_value_length(reply) / sizeof(xcb_atom_t);
+    return {atoms, atoms + count};
+}
+}
+
 mf::XWaylandWMSurface::XWaylandWMSurface(XWaylandWM *wm, xcb_window_t window)
-    : xwm(wm), window(window), props_dirty(true)
+    : xwm(wm),
+      window(window),
+      property_types(tracked_properties(wm)),
+      geometry_pending(true)
 {
+    for (auto const& prop : property_types)
+        dirty_props.insert(prop.first);
+
     uint32_t values[1];
-    xcb_get_geometry_cookie_t geometry_cookie;
-    xcb_get_geometry_reply_t *geometry_reply;
 
+    // Don't wait for the reply here: the WM thread would stall on a round trip
+    // for every window created. It's collected along with the properties.
     geometry_cookie = xcb_get_geometry(xwm->get_xcb_connection(), window);
 
     values[0] = XCB_EVENT_MASK_PROPERTY_CHANGE | XCB_EVENT_MASK_FOCUS_CHANGE;
     xcb_change_window_attributes(xwm->get_xcb_connection(), window, XCB_CW_EVENT_MASK, values);
-
-    geometry_reply = xcb_get_geometry_reply(xwm->get_xcb_connection(), geometry_cookie, NULL);
-    if (geometry_reply == NULL)
-        mir::log_error("xcb gemom reply faled");
 }
 
 mf::XWaylandWMSurface::~XWaylandWMSurface()
 {
     destroyed = true;
+
+    // Let xcb drop any replies we never got around to reading
+    auto const connection = xwm->get_xcb_connection();
+    if (geometry_pending)
+        xcb_discard_reply(connection, geometry_cookie.sequence);
+    for (auto const& pending : pending_props)
+        xcb_discard_reply(connection, pending.second.sequence);
 }
 
 void mf::XWaylandWMSurface::dirty_properties()
 {
-    props_dirty = true;
+    for (auto const& prop : property_types)
+        dirty_props.insert(prop.first);
+}
+
+void mf::XWaylandWMSurface::dirty_property(xcb_atom_t property)
+{
+    if (property_types.find(property) != property_types.end())
+        dirty_props.insert(property);
 }
 
 void mf::XWaylandWMSurface::set_surface_id(uint32_t id)
@@ -123,32 +169,42 @@ void mf::XWaylandWMSurface::set_net_wm_state()
     xcb_flush(xwm->get_xcb_connection());
 }
 
+void mf::XWaylandWMSurface::fetch_properties()
+{
+    std::set<xcb_atom_t> still_dirty;
+
+    for (auto const atom : dirty_props)
+    {
+        // A change notified while a request is in flight may or may not be
+        // reflected in its reply, so keep it dirty to be fetched again
+        if (pending_props.find(atom) != pending_props.end())
+        {
+            still_dirty.insert(atom);
+            continue;
+        }
+
+        pending_props[atom] =
+            xcb_get_property(xwm->get_xcb_connection(), 0, window, atom, XCB_ATOM_ANY, 0, 2048);
+    }
+
+    dirty_props = std::move(still_dirty);
+}
+
 void mf::XWaylandWMSurface::read_properties()
 {
-    if (!props_dirty)
-        return;
-    props_dirty = false;
-
-    std::map<xcb_atom_t, xcb_atom_t> props;
-    props[XCB_ATOM_WM_CLASS] = XCB_ATOM_STRING;
-    props[XCB_ATOM_WM_NAME] = XCB_ATOM_STRING;
-    props[XCB_ATOM_WM_TRANSIENT_FOR] = XCB_ATOM_WINDOW;
-    props[xwm->xcb_atom.wm_protocols] = TYPE_WM_PROTOCOLS;
-    props[xwm->xcb_atom.wm_normal_hints] = TYPE_WM_NORMAL_HINTS;
-    props[xwm->xcb_atom.net_wm_state] = TYPE_NET_WM_STATE;
-    props[xwm->xcb_atom.net_wm_window_type] = XCB_ATOM_ATOM;
-    props[xwm->xcb_atom.net_wm_name] = XCB_ATOM_STRING;
-    props[xwm->xcb_atom.motif_wm_hints] = TYPE_MOTIF_WM_HINTS;
-
-    std::map<xcb_atom_t, xcb_get_property_cookie_t> cookies;
-    for (const auto &atom : props)
+    fetch_properties();
+
+    if (geometry_pending)
     {
-        xcb_get_property_cookie_t cookie =
-            xcb_get_property(xwm->get_xcb_connection(), 0, window, atom.first, XCB_ATOM_ANY, 0, 2048);
-        cookies[atom.first] = cookie;
+        geometry_pending = false;
+        auto const geometry_reply = xcb_get_geometry_reply(xwm->get_xcb_connection(), geometry_cookie, nullptr);
+        if (geometry_reply == nullptr)
+            mir::log_error("xcb gemom reply faled");
+        free(geometry_reply);
     }
 
-    properties.deleteWindow = 0;
+    if (pending_props.empty())
+        return;
 
     if (overrideRedirect)
     {
@@ -157,98 +213,102 @@ void mf::XWaylandWMSurface::read_properties()
 
     mir::log_verbose("Properties:");
 
-    for (const auto &atom_ptr : props)
+    auto const pending = std::move(pending_props);
+    pending_props.clear();
+
+    for (const auto &cookie : pending)
     {
-        xcb_atom_t atom = atom_ptr.first;
-        xcb_get_property_reply_t *reply = xcb_get_property_reply(xwm->get_xcb_connection(), cookies[atom], nullptr);
+        xcb_atom_t atom = cookie.first;
+        xcb_get_property_reply_t *reply = xcb_get_property_reply(xwm->get_xcb_connection(), cookie.second, nullptr);
         if (!reply)
         {
             mir::log_verbose("read_properties: Bad window, usually");
             continue;
         }
 
-        if (reply->type == XCB_ATOM_NONE)
-        {
-            mir::log_verbose("read_properties: No such info");
-            free(reply);
-            continue;
-        }
+        apply_property(atom, reply);
 
-        xwm->dump_property(atom, reply);
+        free(reply);
+    }
+}
 
-        switch (props[atom])
-        {
-        case XCB_ATOM_STRING:
-        {
-            char *p = strndup(reinterpret_cast<char *>(xcb_get_property_value(reply)),
-                              xcb_get_property_value_length(reply));
-            if (atom == XCB_ATOM_WM_CLASS) {
-                properties.appId = std::string(p);
-            } else if (atom == XCB_ATOM_WM_NAME || xwm->xcb_atom.net_wm_name) {
-                properties.title = std::string(p);
-            } else {
-                free(p);
-            }
-            mir::log_verbose("XCB_ATOM_STRING");
-            break;
-        }
-        case XCB_ATOM_WINDOW:
-        {
-            mir::log_verbose("XCB_ATOM_WINDOW");
-            break;
-        }
-        case XCB_ATOM_ATOM:
-        {
-            if (atom == xwm->xcb_atom.net_wm_window_type)
-            {
-                mir::log_verbose("XCB_ATOM_ATOM net_wm_window_type");
-            }
-            break;
-        }
-        case TYPE_WM_PROTOCOLS:
-        {
-            mir::log_verbose("TYPE_WM_PROTOCOLS");
-            xcb_atom_t *atoms = reinterpret_cast<xcb_atom_t *>(xcb_get_property_value(reply));
-            for (uint32_t i = 0; i < reply->value_len; ++i)
-                if (atoms[i] == xwm->xcb_atom.wm_delete_window)
-                    properties.deleteWindow = 1;
-            break;
+void mf::XWaylandWMSurface::apply_property(xcb_atom_t atom, xcb_get_property_reply_t *reply)
+{
+    if (atom == xwm->xcb_atom.wm_protocols)
+        properties.deleteWindow = 0;
+
+    if (reply->type == XCB_ATOM_NONE)
+    {
+        mir::log_verbose("read_properties: No such info");
+        return;
+    }
+
+    xwm->dump_property(atom, reply);
+
+    switch (property_types.at(atom))
+    {
+    case XCB_ATOM_STRING:
+    {
+        auto const value = static_cast<char const*>(xcb_get_property_value(reply));
+        auto const length = static_cast<size_t>(xcb_get_property_value_length(reply));
+        // WM_CLASS holds two NUL-terminated strings; like the others, only the first is used
+        std::string const text{value, strnlen(value, length)};
+        if (atom == XCB_ATOM_WM_CLASS) {
+            properties.appId = text;
+        } else if (atom == XCB_ATOM_WM_NAME || atom == xwm->xcb_atom.net_wm_name) {
+            properties.title = text;
         }
-        case TYPE_WM_NORMAL_HINTS:
+        mir::log_verbose("XCB_ATOM_STRING");
+        break;
+    }
+    case XCB_ATOM_WINDOW:
+    {
+        mir::log_verbose("XCB_ATOM_WINDOW");
+        break;
+    }
+    case XCB_ATOM_ATOM:
+    {
+        if (atom == xwm->xcb_atom.net_wm_window_type)
         {
-            mir::log_verbose("TYPE_WM_NORMAL_HINTS");
-            break;
+            mir::log_verbose("XCB_ATOM_ATOM net_wm_window_type");
         }
-        case TYPE_NET_WM_STATE:
+        break;
+    }
+    case TYPE_WM_PROTOCOLS:
+    {
+        mir::log_verbose("TYPE_WM_PROTOCOLS");
+        for (auto const protocol : atoms_in(reply))
+            if (protocol == xwm->xcb_atom.wm_delete_window)
+                properties.deleteWindow = 1;
+        break;
+    }
+    case TYPE_WM_NORMAL_HINTS:
+    {
+        mir::log_verbose("TYPE_WM_NORMAL_HINTS");
+        break;
+    }
+    case TYPE_NET_WM_STATE:
+    {
+        mir::log_verbose("TYPE_NET_WM_STATE");
+        for (auto const state : atoms_in(reply))
         {
-            mir::log_verbose("TYPE_NET_WM_STATE");
-            xcb_atom_t *value = reinterpret_cast<xcb_atom_t *>(xcb_get_property_value(reply));
-            uint32_t i;
-            for (i = 0; i < reply->value_len; i++)
+            if (state == xwm->xcb_atom.net_wm_state_fullscreen)
             {
-                if (value[i] == xwm->xcb_atom.net_wm_state_fullscreen && !fullscreen)
-                {
-                    fullscreen = true;
-                }
-            }
-            if (value[i] == xwm->xcb_atom.net_wm_state_maximized_horz && !maximized)
-            {
-                maximized = true;
+                fullscreen = true;
             }
-            if (value[i] == xwm->xcb_atom.net_wm_state_maximized_vert && !maximized)
+            if (state == xwm->xcb_atom.net_wm_state_maximized_horz ||
+                state == xwm->xcb_atom.net_wm_state_maximized_vert)
             {
                 maximized = true;
             }
-            break;
         }
-        case TYPE_MOTIF_WM_HINTS:
-            mir::log_verbose("TYPE_MOTIF_WM_HINTS");
-            break;
-        default:
-            break;
-        }
-
-        free(reply);
+        break;
+    }
+    case TYPE_MOTIF_WM_HINTS:
+        mir::log_verbose("TYPE_MOTIF_WM_HINTS");
+        break;
+    default:
+        break;
     }
 }
 
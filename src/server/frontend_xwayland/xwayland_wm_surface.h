@@ -21,6 +21,9 @@
 #include "wl_surface.h"
 #include "xwayland_wm.h"
 
+#include <map>
+#include <set>
+
 extern "C" {
 #include <xcb/xcb.h>
 }
@@ -130,6 +133,10 @@ public:
     XWaylandWMSurface(XWaylandWM *wm, xcb_window_t window);
     ~XWaylandWMSurface();
     void dirty_properties();
+    void dirty_property(xcb_atom_t property);
+    /// Sends requests for any properties that have changed since they were last read
+    void fetch_properties();
+    /// Collects the replies to fetch_properties(), fetching first if needed
     void read_properties();
     void set_surface_id(uint32_t surface_id);
     void set_surface(WlSurface *wls);
@@ -153,7 +160,11 @@ private:
     xcb_window_t window;
     WlSurface *wlsurface;
     std::shared_ptr<XWaylandWMShellSurface> shell_surface;
-    bool props_dirty;
+    std::map<xcb_atom_t, xcb_atom_t> const property_types;
+    std::set<xcb_atom_t> dirty_props;
+    std::map<xcb_atom_t, xcb_get_property_cookie_t> pending_props;
+    bool geometry_pending;
+    xcb_get_geometry_cookie_t geometry_cookie;
     uint32_t surface_id;
     bool maximized;
     bool fullscreen;
@@ -171,6 +182,8 @@ private:
     } properties;
 
     bool decorate;
+
+    void apply_property(xcb_atom_t atom, xcb_get_property_reply_t *reply);
 };
 } /* frontend */
 } /* mir */
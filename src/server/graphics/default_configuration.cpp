@@ -38,6 +38,8 @@
 
 #include "mir/shared_library.h"
 #include "mir/shared_library_prober.h"
+#include "mir/startup_phase_tracker.h"
+#include "mir/platform_probe_cache.h"
 #include "mir/abnormal_exit.h"
 #include "mir/emergency_cleanup.h"
 #include "mir/log.h"
@@ -78,6 +80,7 @@ std::shared_ptr<mg::Platform> mir::DefaultServerConfiguration::the_graphics_plat
     return graphics_platform(
         [this]()->std::shared_ptr<mg::Platform>
         {
+            auto const phase = startup_phase_tracker->phase("the_graphics_platform");
             std::shared_ptr<mir::SharedLibrary> platform_library;
             std::stringstream error_report;
             try
@@ -103,14 +106,48 @@ std::shared_ptr<mg::Platform> mir::DefaultServerConfiguration::the_graphics_plat
                 }
                 else
                 {
-                    auto const& path = the_options()->get<std::string>(options::platform_path);
-                    auto platforms = mir::libraries_for_path(path, *the_shared_library_prober_report());
-                    if (platforms.empty())
+                    auto const& options = dynamic_cast<mir::options::ProgramOption&>(*the_options());
+                    auto const probe_cache = the_platform_probe_cache();
+
+                    if (auto const cached = probe_cache->selected_module("graphics"))
+                    {
+                        try
+                        {
+                            // Check the module still supports this system, but without loading and probing the others
+                            auto const probe_phase = startup_phase_tracker->phase("probe cached graphics platform");
+                            platform_library = mir::graphics::module_for_device(
+                                {std::make_shared<mir::SharedLibrary>(cached.value())}, options, the_console_services());
+                        }
+                        catch (std::runtime_error const&)
+                        {
+                            mir::log_info("Cached graphics platform no longer suitable: %s", cached.value().c_str());
+                        }
+                    }
+
+                    if (!platform_library)
                     {
-                        auto msg = "Failed to find any platform plugins in: " + path;
-                        throw std::runtime_error(msg.c_str());
+                        auto const& path = the_options()->get<std::string>(options::platform_path);
+                        auto platforms = mir::libraries_for_path(path, *the_shared_library_prober_report());
+                        if (platforms.empty())
+                        {
+                            auto msg = "Failed to find any platform plugins in: " + path;
+                            throw std::runtime_error(msg.c_str());
+                        }
+                        auto const probe_phase = startup_phase_tracker->phase("probe graphics platforms");
+                        platform_library = mir::graphics::module_for_device(platforms, options, the_console_services());
+
+                        try
+                        {
+                            auto const probe = platform_library->load_function<mg::PlatformProbe>("probe_graphics_platform");
+                            probe_cache->module_selected(
+                                "graphics",
+                                PlatformProbeCache::module_containing(reinterpret_cast<void*>(probe)));
+                        }
+                        catch (std::runtime_error const&)
+                        {
+                            // Not worth failing over: we'll probe again next time
+                        }
                     }
-                    platform_library = mir::graphics::module_for_device(platforms, dynamic_cast<mir::options::ProgramOption&>(*the_options()), the_console_services());
                 }
                 auto create_host_platform =
                     [platform_library]() -> std::function<std::remove_pointer<mg::CreateHostPlatform>::type>
@@ -179,6 +216,7 @@ mir::DefaultServerConfiguration::the_buffer_allocator()
     return buffer_allocator(
         [&]()
         {
+            auto const phase = startup_phase_tracker->phase("the_buffer_allocator");
             return the_graphics_platform()->create_buffer_allocator(*the_display());
         });
 }
@@ -189,6 +227,7 @@ mir::DefaultServerConfiguration::the_display()
     return display(
         [this]() -> std::shared_ptr<mg::Display>
         {
+            auto const phase = startup_phase_tracker->phase("the_display");
             if (the_options()->is_set(options::offscreen_opt))
             {
                 if (auto egl_access = dynamic_cast<mir::renderer::gl::EGLPlatform*>(
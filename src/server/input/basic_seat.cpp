@@ -183,6 +183,19 @@ mi::BasicSeat::BasicSeat(std::shared_ptr<mi::InputDispatcher> const& dispatcher,
     registrar->register_interest(output_tracker);
 }
 
+mi::BasicSeat::BasicSeat(std::shared_ptr<mi::InputDispatcher> const& dispatcher,
+                         std::shared_ptr<mi::TouchVisualizer> const& touch_visualizer,
+                         std::shared_ptr<mi::CursorListener> const& cursor_listener,
+                         std::shared_ptr<Registrar> const& registrar,
+                         std::shared_ptr<mi::KeyMapper> const& key_mapper,
+                         std::shared_ptr<time::Clock> const& clock,
+                         std::shared_ptr<mi::SeatObserver> const& observer,
+                         mg::DisplayConfiguration const& current_configuration) :
+    BasicSeat{dispatcher, touch_visualizer, cursor_listener, registrar, key_mapper, clock, observer}
+{
+    output_tracker->update_outputs(current_configuration);
+}
+
 void mi::BasicSeat::add_device(input::Device const& device)
 {
     input_state_tracker.add_device(device.id());
@@ -35,6 +35,7 @@ class Clock;
 }
 namespace graphics
 {
+class DisplayConfiguration;
 class DisplayConfigurationObserver;
 }
 namespace input
@@ -56,6 +57,15 @@ public:
               std::shared_ptr<KeyMapper> const& key_mapper,
               std::shared_ptr<time::Clock> const& clock,
               std::shared_ptr<SeatObserver> const& observer);
+    /// For seats added after startup, which miss the initial_configuration() notification
+    BasicSeat(std::shared_ptr<InputDispatcher> const& dispatcher,
+              std::shared_ptr<TouchVisualizer> const& touch_visualizer,
+              std::shared_ptr<CursorListener> const& cursor_listener,
+              std::shared_ptr<Registrar> const& registrar,
+              std::shared_ptr<KeyMapper> const& key_mapper,
+              std::shared_ptr<time::Clock> const& clock,
+              std::shared_ptr<SeatObserver> const& observer,
+              graphics::DisplayConfiguration const& current_configuration);
     // Seat methods:
     void add_device(Device const& device) override;
     void remove_device(Device const& device) override;
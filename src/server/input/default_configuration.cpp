@@ -31,7 +31,10 @@
 #include "default_input_manager.h"
 #include "surface_input_dispatcher.h"
 #include "basic_seat.h"
+#include "seats.h"
+#include "threaded_input_dispatcher.h"
 #include "seat_observer_multiplexer.h"
+#include "../graphics/software_cursor.h"
 #include "../graphics/nested/input_platform.h"
 
 #include "mir/input/touch_visualizer.h"
@@ -43,11 +46,14 @@
 #include "mir/options/option.h"
 #include "mir/dispatch/multiplexing_dispatchable.h"
 #include "mir/compositor/scene.h"
+#include "mir/graphics/display.h"
+#include "mir/graphics/display_configuration.h"
 #include "mir/emergency_cleanup.h"
 #include "mir/main_loop.h"
 #include "mir/abnormal_exit.h"
 #include "mir/glib_main_loop.h"
 #include "mir/log.h"
+#include "mir/startup_phase_tracker.h"
 #include "mir/shared_library.h"
 #include "mir/dispatch/action_queue.h"
 #include "mir/console_services.h"
@@ -216,6 +222,7 @@ mir::DefaultServerConfiguration::the_input_manager()
     return input_manager(
         [this]() -> std::shared_ptr<mi::InputManager>
         {
+            auto const phase = startup_phase_tracker->phase("the_input_manager");
             auto const options = the_options();
             bool input_opt = options->get<bool>(options::enable_input_opt);
 
@@ -252,13 +259,15 @@ mir::DefaultServerConfiguration::the_input_manager()
                 // otherwise (usually) we probe for it
                 if (!platform)
                 {
+                    auto const probe_phase = startup_phase_tracker->phase("probe input platforms");
                     platform = probe_input_platforms(
                         *options,
                         emergency_cleanup,
                         device_registry,
                         the_console_services(),
                         input_report,
-                        *the_shared_library_prober_report());
+                        *the_shared_library_prober_report(),
+                        *the_platform_probe_cache());
                 }
 
                 return std::make_shared<mi::DefaultInputManager>(the_input_reading_multiplexer(), std::move(platform));
@@ -294,6 +303,79 @@ std::shared_ptr<mi::Seat> mir::DefaultServerConfiguration::the_seat()
         });
 }
 
+std::shared_ptr<mi::Seats> mir::DefaultServerConfiguration::the_seats()
+{
+    return seats(
+        [this]()
+        {
+            std::string const default_seat_name{"seat0"};
+
+            if (!the_options()->get<bool>(options::multi_seat_opt))
+                return std::make_shared<mi::Seats>(the_seat());
+
+            // Each other seat gets its own keyboard focus (following clicks and touches),
+            // cursor and key state, and dispatches to surfaces on a thread of its own. Its
+            // devices' events are still tracked (BasicSeat::dispatch_event()) on the thread
+            // reading them, and the shell's event filters and input targeter remain those
+            // of the default seat.
+            //
+            // Seats are built on the input thread as devices are hotplugged, so everything
+            // they need from this configuration is fetched here, where it is safe to.
+            auto const input_scene = the_input_scene();
+            auto const main_loop = the_main_loop();
+            auto const cookie_authority = the_cookie_authority();
+            auto const enable_key_repeat = the_options()->get<bool>(options::enable_key_repeat_opt);
+            auto const buffer_allocator = the_buffer_allocator();
+            auto const default_cursor_image = the_default_cursor_image();
+            auto const enable_touchspots = the_options()->is_set(options::touchspots_opt);
+            auto const registrar = the_display_configuration_observer_registrar();
+            auto const clock = the_clock();
+            auto const seat_observer = the_seat_observer();
+            auto const display = the_display();
+
+            auto const build_seat =
+                [=](std::string const& name, std::shared_ptr<mi::InputDeviceHub> const& hub)
+                -> std::shared_ptr<mi::Seat>
+                {
+                    std::chrono::milliseconds const key_repeat_timeout{500};
+                    std::chrono::milliseconds const key_repeat_delay{50};
+
+                    auto const key_repeater = std::make_shared<mi::KeyRepeatDispatcher>(
+                        std::make_shared<mi::SurfaceInputDispatcher>(input_scene, true),
+                        main_loop, cookie_authority, enable_key_repeat,
+                        key_repeat_timeout, key_repeat_delay, false);
+                    if (hub)
+                        key_repeater->set_input_device_hub(hub);
+
+                    auto const dispatcher = std::make_shared<mi::ThreadedInputDispatcher>(
+                        "Mir/Input/" + name, key_repeater);
+
+                    auto const cursor = std::make_shared<mg::SoftwareCursor>(buffer_allocator, input_scene);
+                    cursor->show(*default_cursor_image);
+
+                    auto const touch_visualizer = std::make_shared<mi::TouchspotController>(
+                        buffer_allocator, input_scene);
+                    if (enable_touchspots)
+                        touch_visualizer->enable();
+
+                    auto const seat = std::make_shared<mi::BasicSeat>(
+                        dispatcher,
+                        touch_visualizer,
+                        std::make_shared<mi::CursorController>(input_scene, cursor, default_cursor_image),
+                        registrar,
+                        std::make_shared<mi::receiver::XKBMapper>(),
+                        clock,
+                        seat_observer,
+                        *display->configuration());
+
+                    dispatcher->start();
+                    return seat;
+                };
+
+            return std::make_shared<mi::Seats>(default_seat_name, the_seat(), build_seat);
+        });
+}
+
 std::shared_ptr<mi::InputDeviceRegistry> mir::DefaultServerConfiguration::the_input_device_registry()
 {
     return the_default_input_device_hub();
@@ -316,12 +398,14 @@ std::shared_ptr<mi::DefaultInputDeviceHub> mir::DefaultServerConfiguration::the_
        {
            auto input_dispatcher = the_input_dispatcher();
            auto key_repeater = std::dynamic_pointer_cast<mi::KeyRepeatDispatcher>(input_dispatcher);
+           auto seats = the_seats();
            auto hub = std::make_shared<mi::DefaultInputDeviceHub>(
-               the_seat(),
+               seats,
                the_input_reading_multiplexer(),
                the_cookie_authority(),
                the_key_mapper(),
                the_server_status_listener());
+           seats->set_input_device_hub(hub);
 
            // lp:1675357: KeyRepeatDispatcher must be informed about removed input devices, otherwise
            // pressed keys get repeated indefinitely
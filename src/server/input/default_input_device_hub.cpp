@@ -18,6 +18,7 @@
 
 #include "default_input_device_hub.h"
 #include "default_device.h"
+#include "seats.h"
 
 #include "mir/input/input_device.h"
 #include "mir/input/input_device_observer.h"
@@ -175,7 +176,22 @@ mi::DefaultInputDeviceHub::DefaultInputDeviceHub(
     std::shared_ptr<mir::cookie::Authority> const& cookie_authority,
     std::shared_ptr<mi::KeyMapper> const& key_mapper,
     std::shared_ptr<mir::ServerStatusListener> const& server_status_listener)
-    : seat{seat},
+    : DefaultInputDeviceHub{
+          std::make_shared<mi::Seats>(seat),
+          input_multiplexer,
+          cookie_authority,
+          key_mapper,
+          server_status_listener}
+{
+}
+
+mi::DefaultInputDeviceHub::DefaultInputDeviceHub(
+    std::shared_ptr<mi::Seats> const& seats,
+    std::shared_ptr<dispatch::MultiplexingDispatchable> const& input_multiplexer,
+    std::shared_ptr<mir::cookie::Authority> const& cookie_authority,
+    std::shared_ptr<mi::KeyMapper> const& key_mapper,
+    std::shared_ptr<mir::ServerStatusListener> const& server_status_listener)
+    : seats{seats},
       input_dispatchable{input_multiplexer},
       device_queue(std::make_shared<dispatch::ActionQueue>()),
       cookie_authority(cookie_authority),
@@ -209,6 +225,7 @@ void mi::DefaultInputDeviceHub::add_device(std::shared_ptr<InputDevice> const& d
         auto const& dev = devices.back();
         add_device_handle(handle);
 
+        auto const seat = seats->seat_for(device->get_device_info().seat);
         seat->add_device(*handle);
         dev->start(seat, input_dispatchable);
     }
@@ -58,6 +58,7 @@ class InputSink;
 class InputDeviceObserver;
 class DefaultDevice;
 class Seat;
+class Seats;
 class KeyMapper;
 class DefaultInputDeviceHub;
 
@@ -89,6 +90,13 @@ public:
                           std::shared_ptr<KeyMapper> const& key_mapper,
                           std::shared_ptr<ServerStatusListener> const& server_status_listener);
 
+    /// Devices are added to the seat named by their InputDeviceInfo
+    DefaultInputDeviceHub(std::shared_ptr<Seats> const& seats,
+                          std::shared_ptr<dispatch::MultiplexingDispatchable> const& input_multiplexer,
+                          std::shared_ptr<cookie::Authority> const& cookie_authority,
+                          std::shared_ptr<KeyMapper> const& key_mapper,
+                          std::shared_ptr<ServerStatusListener> const& server_status_listener);
+
     // InputDeviceRegistry - calls from mi::Platform
     void add_device(std::shared_ptr<InputDevice> const& device) override;
     void remove_device(std::shared_ptr<InputDevice> const& device) override;
@@ -109,7 +117,7 @@ private:
                                                             std::shared_ptr<dispatch::ActionQueue> const& queue);
     mir::optional_value<MirInputDevice> get_stored_device_config(std::string const& id);
 
-    std::shared_ptr<Seat> const seat;
+    std::shared_ptr<Seats> const seats;
     std::shared_ptr<dispatch::MultiplexingDispatchable> const input_dispatchable;
     std::mutex mutable handles_guard;
     std::shared_ptr<dispatch::ActionQueue> const device_queue;
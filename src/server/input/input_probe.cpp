@@ -22,6 +22,7 @@
 #include "mir/options/configuration.h"
 #include "mir/options/option.h"
 
+#include "mir/platform_probe_cache.h"
 #include "mir/shared_library_prober.h"
 #include "mir/shared_library.h"
 #include "mir/log.h"
@@ -61,10 +62,25 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
     std::shared_ptr<mir::ConsoleServices> const& console,
     std::shared_ptr<mi::InputReport> const& input_report,
     mir::SharedLibraryProberReport& prober_report)
+{
+    return probe_input_platforms(
+        options, emergency_cleanup, device_registry, console, input_report, prober_report,
+        mir::PlatformProbeCache{{}, {}});
+}
+
+mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
+    mo::Option const& options,
+    std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
+    std::shared_ptr<mi::InputDeviceRegistry> const& device_registry,
+    std::shared_ptr<mir::ConsoleServices> const& console,
+    std::shared_ptr<mi::InputReport> const& input_report,
+    mir::SharedLibraryProberReport& prober_report,
+    mir::PlatformProbeCache const& probe_cache)
 {
     auto reject_platform_priority = mi::PlatformPriority::dummy;
 
     std::shared_ptr<mir::SharedLibrary> platform_module;
+    std::string platform_module_name;
     std::vector<std::string> module_names;
 
     auto const module_selector = [&](std::shared_ptr<mir::SharedLibrary> const& module)
@@ -77,6 +93,7 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
                 if (probe(options, *console) > reject_platform_priority)
                 {
                     platform_module = module;
+                    platform_module_name = mir::PlatformProbeCache::module_containing(reinterpret_cast<void*>(probe));
 
                     return Selection::quit;
                 }
@@ -96,7 +113,25 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
     }
     else
     {
-        select_libraries_for_path(options.get<std::string>(mo::platform_path), module_selector, prober_report);
+        if (auto const cached = probe_cache.selected_module("input"))
+        {
+            try
+            {
+                module_selector(std::make_shared<mir::SharedLibrary>(cached.value()));
+            }
+            catch (std::runtime_error const&)
+            {
+                // The module can't be loaded any more, so fall back to probing them all
+            }
+        }
+
+        if (!platform_module)
+        {
+            select_libraries_for_path(options.get<std::string>(mo::platform_path), module_selector, prober_report);
+
+            if (platform_module)
+                probe_cache.module_selected("input", platform_module_name);
+        }
     }
 
     if (!platform_module)
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "seats.h"
+
+#include "mir/input/seat.h"
+#define MIR_LOG_COMPONENT "Input"
+#include "mir/log.h"
+
+namespace mi = mir::input;
+
+mi::Seats::Seats(std::shared_ptr<Seat> const& seat) :
+    Seats{"", seat, nullptr}
+{
+}
+
+mi::Seats::Seats(
+    std::string const& default_seat_name,
+    std::shared_ptr<Seat> const& default_seat,
+    SeatBuilder const& build_seat) :
+    default_seat_name{default_seat_name},
+    default_seat{default_seat},
+    build_seat{build_seat}
+{
+    seats[default_seat_name] = default_seat;
+}
+
+void mi::Seats::set_input_device_hub(std::shared_ptr<InputDeviceHub> const& hub)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    this->hub = hub;
+}
+
+auto mi::Seats::seat_for(std::string const& seat_name) -> std::shared_ptr<Seat>
+{
+    if (!build_seat)
+        return default_seat;
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const existing = seats.find(seat_name);
+    if (existing != end(seats))
+        return existing->second;
+
+    try
+    {
+        auto const seat = build_seat(seat_name, hub.lock());
+        seats[seat_name] = seat;
+        mir::log_info("Added input seat \"%s\"", seat_name.c_str());
+        return seat;
+    }
+    catch (std::exception const& error)
+    {
+        mir::log_error(
+            "Failed to add input seat \"%s\", using \"%s\" instead: %s",
+            seat_name.c_str(), default_seat_name.c_str(), error.what());
+        return default_seat;
+    }
+}
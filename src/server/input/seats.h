@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_SEATS_H_
+#define MIR_INPUT_SEATS_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mir
+{
+namespace input
+{
+class InputDeviceHub;
+class Seat;
+
+/**
+ * The seats input devices are assigned to, by the seat name in their InputDeviceInfo.
+ * A seat is built when the first of its devices is added, and thereafter each seat
+ * dispatches its devices' input without reference to the others.
+ */
+class Seats
+{
+public:
+    /// Called on the thread adding the seat's first device, with the hub if it has been set
+    using SeatBuilder = std::function<std::shared_ptr<Seat>(
+        std::string const& seat_name, std::shared_ptr<InputDeviceHub> const& hub)>;
+
+    /// Every device is assigned to the one seat
+    explicit Seats(std::shared_ptr<Seat> const& seat);
+
+    Seats(std::string const& default_seat_name,
+          std::shared_ptr<Seat> const& default_seat,
+          SeatBuilder const& build_seat);
+
+    /// The hub is built from the seats, so seats built later are given it here
+    void set_input_device_hub(std::shared_ptr<InputDeviceHub> const& hub);
+
+    auto seat_for(std::string const& seat_name) -> std::shared_ptr<Seat>;
+
+private:
+    std::string const default_seat_name;
+    std::shared_ptr<Seat> const default_seat;
+    SeatBuilder const build_seat;
+
+    std::mutex mutex;
+    std::weak_ptr<InputDeviceHub> hub;
+    std::map<std::string, std::shared_ptr<Seat>> seats;
+};
+
+}
+}
+
+#endif // MIR_INPUT_SEATS_H_
@@ -217,7 +217,13 @@ void deliver(
 }
 
 mi::SurfaceInputDispatcher::SurfaceInputDispatcher(std::shared_ptr<mi::Scene> const& scene)
+    : SurfaceInputDispatcher(scene, false)
+{
+}
+
+mi::SurfaceInputDispatcher::SurfaceInputDispatcher(std::shared_ptr<mi::Scene> const& scene, bool focus_on_press)
     : scene(scene),
+      focus_on_press(focus_on_press),
       started(false)
 {
     scene_observer = std::make_shared<InputDispatcherSceneObserver>(
@@ -630,6 +636,8 @@ bool mi::SurfaceInputDispatcher::dispatch_pointer(MirInputDeviceId id, std::shar
         if (action == mir_pointer_action_button_down)
         {
             pointer_state.gesture_owner = target;
+            if (focus_on_press)
+                set_focus_locked(lg, target);
         }
 
         if (sent_ev)
@@ -691,6 +699,8 @@ bool mi::SurfaceInputDispatcher::dispatch_touch(MirInputDeviceId id, MirEvent co
                                   mir_touch_event_axis_value(tev, 0, mir_touch_axis_y) };
 
         gesture_owner = find_target_surface(event_x_y);
+        if (focus_on_press && gesture_owner)
+            set_focus_locked(lg, gesture_owner);
     }
 
     if (gesture_owner)
@@ -44,6 +44,8 @@ class SurfaceInputDispatcher : public mir::input::InputDispatcher, public shell:
 {
 public:
     SurfaceInputDispatcher(std::shared_ptr<input::Scene> const& scene);
+    /// With focus_on_press set, a pointer button or touch going down focuses the surface under it
+    SurfaceInputDispatcher(std::shared_ptr<input::Scene> const& scene, bool focus_on_press);
     ~SurfaceInputDispatcher();
 
     // mir::input::InputDispatcher
@@ -93,6 +95,7 @@ private:
     TouchInputState& ensure_touch_state(MirInputDeviceId id);
     
     std::shared_ptr<input::Scene> const scene;
+    bool const focus_on_press;
 
     std::shared_ptr<scene::Observer> scene_observer;
 
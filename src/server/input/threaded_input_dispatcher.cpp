@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "threaded_input_dispatcher.h"
+
+#include "mir/dispatch/action_queue.h"
+#include "mir/dispatch/threaded_dispatcher.h"
+#include "mir/terminate_with_current_exception.h"
+
+namespace mi = mir::input;
+namespace md = mir::dispatch;
+
+mi::ThreadedInputDispatcher::ThreadedInputDispatcher(
+    std::string const& thread_name,
+    std::shared_ptr<InputDispatcher> const& next_dispatcher) :
+    thread_name{thread_name},
+    next_dispatcher{next_dispatcher},
+    queue{std::make_shared<md::ActionQueue>()}
+{
+}
+
+mi::ThreadedInputDispatcher::~ThreadedInputDispatcher()
+{
+    stop();
+}
+
+bool mi::ThreadedInputDispatcher::dispatch(std::shared_ptr<MirEvent const> const& event)
+{
+    queue->enqueue([next_dispatcher = next_dispatcher, event] { next_dispatcher->dispatch(event); });
+    return true;
+}
+
+void mi::ThreadedInputDispatcher::start()
+{
+    std::lock_guard<std::mutex> lock{thread_mutex};
+
+    if (thread)
+        return;
+
+    next_dispatcher->start();
+    thread = std::make_unique<md::ThreadedDispatcher>(
+        thread_name,
+        queue,
+        [] { mir::terminate_with_current_exception(); });
+}
+
+void mi::ThreadedInputDispatcher::stop()
+{
+    std::lock_guard<std::mutex> lock{thread_mutex};
+
+    if (!thread)
+        return;
+
+    // Events already queued are dispatched when the thread is restarted
+    thread.reset();
+    next_dispatcher->stop();
+}
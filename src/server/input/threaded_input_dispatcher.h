@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_THREADED_INPUT_DISPATCHER_H_
+#define MIR_INPUT_THREADED_INPUT_DISPATCHER_H_
+
+#include "mir/input/input_dispatcher.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mir
+{
+namespace dispatch
+{
+class ActionQueue;
+class ThreadedDispatcher;
+}
+namespace input
+{
+
+/// Hands events on to the next dispatcher on a thread of its own, so that a seat's
+/// dispatch doesn't hold up the thread reading input devices (or other seats)
+class ThreadedInputDispatcher : public InputDispatcher
+{
+public:
+    ThreadedInputDispatcher(std::string const& thread_name, std::shared_ptr<InputDispatcher> const& next_dispatcher);
+    ~ThreadedInputDispatcher();
+
+    bool dispatch(std::shared_ptr<MirEvent const> const& event) override;
+    void start() override;
+    void stop() override;
+
+private:
+    std::string const thread_name;
+    std::shared_ptr<InputDispatcher> const next_dispatcher;
+    std::shared_ptr<dispatch::ActionQueue> const queue;
+
+    std::mutex thread_mutex;
+    std::unique_ptr<dispatch::ThreadedDispatcher> thread;
+};
+
+}
+}
+
+#endif // MIR_INPUT_THREADED_INPUT_DISPATCHER_H_
@@ -0,0 +1,182 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/platform_probe_cache.h"
+#include "mir/libname.h"
+#include "mir/log.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+auto const cache_version = "mir-platform-probe-cache-1";
+
+auto sorted_entries(fs::path const& dir) -> std::vector<fs::path>
+{
+    std::vector<fs::path> result;
+
+    boost::system::error_code ec;
+    for (fs::directory_iterator i{dir, ec}, end; !ec && i != end; i.increment(ec))
+        result.push_back(i->path());
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// The modules that probing would consider, and their versions (as best we can tell)
+void describe_modules(std::ostream& out, std::string const& module_path)
+{
+    for (auto const& module : sorted_entries(module_path))
+    {
+        struct stat info;
+        if (stat(module.c_str(), &info) == 0)
+        {
+            out << "module " << module.string()
+                << ' ' << info.st_size
+                << ' ' << info.st_mtim.tv_sec << '.' << info.st_mtim.tv_nsec << '\n';
+        }
+    }
+}
+
+// The device nodes platforms probe for, and the hardware behind each of them
+void describe_devices(std::ostream& out, fs::path const& dir, std::string const& prefix)
+{
+    for (auto const& node : sorted_entries(dir))
+    {
+        if (node.filename().string().compare(0, prefix.size(), prefix) != 0)
+            continue;
+
+        struct stat info;
+        if (stat(node.c_str(), &info) != 0 || !S_ISCHR(info.st_mode))
+            continue;
+
+        std::ostringstream sys_path;
+        sys_path << "/sys/dev/char/" << major(info.st_rdev) << ':' << minor(info.st_rdev);
+
+        boost::system::error_code ec;
+        auto const hardware = fs::canonical(sys_path.str(), ec);
+
+        out << "device " << node.string() << ' ' << info.st_rdev << ' ' << (ec ? "" : hardware.string()) << '\n';
+    }
+}
+
+auto fingerprint_for(std::string const& cache_file, std::string const& module_path) -> std::string
+{
+    if (cache_file.empty())
+        return {};
+
+    std::ostringstream description;
+    describe_modules(description, module_path);
+    describe_devices(description, "/dev/dri", "");
+    describe_devices(description, "/dev/input", "event");
+
+    std::ostringstream result;
+    result << std::hex << std::hash<std::string>{}(description.str());
+    return result.str();
+}
+
+// kind -> (fingerprint, module)
+using Selections = std::map<std::string, std::pair<std::string, std::string>>;
+
+auto read_selections(std::string const& cache_file) -> Selections
+{
+    Selections result;
+
+    std::ifstream in{cache_file};
+    std::string version;
+
+    if (!std::getline(in, version) || version != cache_version)
+        return result;
+
+    std::string kind;
+    std::string fingerprint;
+    std::string module;
+    while (in >> kind >> fingerprint && std::getline(in >> std::ws, module))
+        result[kind] = {fingerprint, module};
+
+    return result;
+}
+}
+
+mir::PlatformProbeCache::PlatformProbeCache(std::string const& cache_file, std::string const& module_path) :
+    cache_file{cache_file},
+    fingerprint{fingerprint_for(cache_file, module_path)}
+{
+}
+
+auto mir::PlatformProbeCache::selected_module(std::string const& kind) const -> optional_value<std::string>
+{
+    if (cache_file.empty())
+        return {};
+
+    auto const selections = read_selections(cache_file);
+    auto const selection = selections.find(kind);
+
+    if (selection == selections.end() || selection->second.first != fingerprint)
+        return {};
+
+    boost::system::error_code ec;
+    if (!fs::is_regular_file(selection->second.second, ec))
+        return {};
+
+    return selection->second.second;
+}
+
+void mir::PlatformProbeCache::module_selected(std::string const& kind, std::string const& module) const
+{
+    if (cache_file.empty())
+        return;
+
+    auto selections = read_selections(cache_file);
+    selections[kind] = {fingerprint, module};
+
+    // Write a new file and rename it over the old one so that a crash can't leave a partial cache
+    auto const temp_file = cache_file + ".new";
+    {
+        std::ofstream out{temp_file, std::ios::trunc};
+        out << cache_version << '\n';
+
+        for (auto const& selection : selections)
+            out << selection.first << ' ' << selection.second.first << ' ' << selection.second.second << '\n';
+
+        if (!out.flush())
+        {
+            log_warning("Failed to write platform probe cache: %s", temp_file.c_str());
+            return;
+        }
+    }
+
+    if (rename(temp_file.c_str(), cache_file.c_str()) != 0)
+        log_warning("Failed to update platform probe cache: %s", cache_file.c_str());
+}
+
+auto mir::PlatformProbeCache::module_containing(void* address) -> std::string
+{
+    auto const name = detail::libname_impl(address);
+    return name ? name : "";
+}
@@ -23,8 +23,16 @@
 #include "lttng_report_factory.h"
 #include "logging_report_factory.h"
 #include "null_report_factory.h"
+#include "metrics_report_factory.h"
+#include "metrics/metrics.h"
+#include "frame_timeline_report_factory.h"
+#include "frame_timeline/recorder.h"
 
 #include "mir/abnormal_exit.h"
+#include "mir/main_loop.h"
+
+#include <algorithm>
+#include <cstdlib>
 
 namespace mg = mir::graphics;
 namespace mf = mir::frontend;
@@ -36,17 +44,19 @@ std::unique_ptr<mir::report::ReportFactory> mir::DefaultServerConfiguration::rep
 {
     auto opt = the_options()->get<std::string>(report_opt);
 
+    std::unique_ptr<report::ReportFactory> factory;
+
     if (opt == options::log_opt_value)
     {
-        return std::make_unique<report::LoggingReportFactory>(the_logger(), the_clock());
+        factory = std::make_unique<report::LoggingReportFactory>(the_logger(), the_clock());
     }
     else if (opt == options::lttng_opt_value)
     {
-        return std::make_unique<report::LttngReportFactory>();
+        factory = std::make_unique<report::LttngReportFactory>();
     }
     else if (opt == options::off_opt_value)
     {
-        return std::make_unique<report::NullReportFactory>();
+        factory = std::make_unique<report::NullReportFactory>();
     }
     else
     {
@@ -54,6 +64,55 @@ std::unique_ptr<mir::report::ReportFactory> mir::DefaultServerConfiguration::rep
             options::off_opt_value + "\" and \"" + options::log_opt_value +
                            "\" and \"" + options::lttng_opt_value + "\")");
     }
+
+    if (auto const recorder = the_frame_timeline_recorder())
+    {
+        factory = std::make_unique<report::FrameTimelineReportFactory>(std::move(factory), recorder);
+    }
+
+    if (auto const registry = the_metrics_registry())
+    {
+        factory = std::make_unique<report::MetricsReportFactory>(std::move(factory), registry);
+    }
+
+    return factory;
+}
+
+auto mir::DefaultServerConfiguration::the_metrics_registry() -> std::shared_ptr<report::metrics::Registry>
+{
+    return metrics_registry(
+        [this]()->std::shared_ptr<report::metrics::Registry>
+        {
+            if (!the_options()->is_set(options::metrics_socket_opt))
+                return {};
+
+            return std::make_shared<report::metrics::Registry>();
+        });
+}
+
+auto mir::DefaultServerConfiguration::the_frame_timeline_recorder()
+    -> std::shared_ptr<report::frame_timeline::Recorder>
+{
+    return frame_timeline_recorder(
+        [this]()->std::shared_ptr<report::frame_timeline::Recorder>
+        {
+            if (!the_options()->is_set(options::frame_timeline_budget_opt))
+                return {};
+
+            auto const history_s = std::max(the_options()->get<int>(options::frame_timeline_history_opt), 0);
+
+            std::string directory{"/tmp"};
+            if (the_options()->is_set(options::frame_timeline_path_opt))
+                directory = the_options()->get<std::string>(options::frame_timeline_path_opt);
+            else if (auto const runtime_dir = getenv("XDG_RUNTIME_DIR"))
+                directory = runtime_dir;
+
+            return std::make_shared<report::frame_timeline::Recorder>(
+                std::chrono::milliseconds{the_options()->get<int>(options::frame_timeline_budget_opt)},
+                std::chrono::seconds{history_s},
+                directory,
+                the_main_loop());
+        });
 }
 
 std::shared_ptr<void> mir::DefaultServerConfiguration::default_reports()
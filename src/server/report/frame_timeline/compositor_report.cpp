@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compositor_report.h"
+#include "recorder.h"
+
+namespace mrf = mir::report::frame_timeline;
+namespace geom = mir::geometry;
+
+mrf::CompositorReport::CompositorReport(
+    std::shared_ptr<compositor::CompositorReport> const& wrapped,
+    std::shared_ptr<Recorder> const& recorder) :
+    wrapped{wrapped},
+    recorder{recorder}
+{
+}
+
+void mrf::CompositorReport::added_display(int width, int height, int x, int y, SubCompositorId id)
+{
+    recorder->added_output(id, geom::Rectangle{{x, y}, {width, height}});
+    wrapped->added_display(width, height, x, y, id);
+}
+
+void mrf::CompositorReport::began_scene_snapshot(SubCompositorId id)
+{
+    recorder->began_scene_snapshot(id);
+    wrapped->began_scene_snapshot(id);
+}
+
+void mrf::CompositorReport::began_frame(SubCompositorId id)
+{
+    recorder->began_frame(id);
+    wrapped->began_frame(id);
+}
+
+void mrf::CompositorReport::filtered_occlusions(SubCompositorId id, std::size_t occluded)
+{
+    recorder->filtered_occlusions(id, occluded);
+    wrapped->filtered_occlusions(id, occluded);
+}
+
+void mrf::CompositorReport::renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables)
+{
+    recorder->renderables_in_frame(id, renderables);
+    wrapped->renderables_in_frame(id, renderables);
+}
+
+void mrf::CompositorReport::rendered_frame(SubCompositorId id)
+{
+    recorder->rendered_frame(id);
+    wrapped->rendered_frame(id);
+}
+
+void mrf::CompositorReport::finished_frame(SubCompositorId id)
+{
+    recorder->finished_frame(id);
+    wrapped->finished_frame(id);
+}
+
+void mrf::CompositorReport::posted_frame(SubCompositorId id)
+{
+    recorder->posted_frame(id);
+    wrapped->posted_frame(id);
+}
+
+void mrf::CompositorReport::submitted_buffer(graphics::BufferID buffer)
+{
+    recorder->submitted_buffer(buffer);
+    wrapped->submitted_buffer(buffer);
+}
+
+void mrf::CompositorReport::texture_cache_usage(
+    SubCompositorId id,
+    std::size_t hits,
+    std::size_t misses,
+    std::size_t evictions,
+    std::size_t uploaded_bytes,
+    std::size_t resident_bytes)
+{
+    recorder->uploaded_textures(uploaded_bytes);
+    wrapped->texture_cache_usage(id, hits, misses, evictions, uploaded_bytes, resident_bytes);
+}
+
+void mrf::CompositorReport::started()
+{
+    wrapped->started();
+}
+
+void mrf::CompositorReport::stopped()
+{
+    wrapped->stopped();
+}
+
+void mrf::CompositorReport::scheduled()
+{
+    wrapped->scheduled();
+}
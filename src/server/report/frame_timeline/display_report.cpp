@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "display_report.h"
+#include "recorder.h"
+
+namespace mrf = mir::report::frame_timeline;
+
+mrf::DisplayReport::DisplayReport(
+    std::shared_ptr<graphics::DisplayReport> const& wrapped,
+    std::shared_ptr<Recorder> const& recorder) :
+    wrapped{wrapped},
+    recorder{recorder}
+{
+}
+
+void mrf::DisplayReport::report_successful_setup_of_native_resources()
+{
+    wrapped->report_successful_setup_of_native_resources();
+}
+
+void mrf::DisplayReport::report_successful_egl_make_current_on_construction()
+{
+    wrapped->report_successful_egl_make_current_on_construction();
+}
+
+void mrf::DisplayReport::report_successful_egl_buffer_swap_on_construction()
+{
+    wrapped->report_successful_egl_buffer_swap_on_construction();
+}
+
+void mrf::DisplayReport::report_successful_display_construction()
+{
+    wrapped->report_successful_display_construction();
+}
+
+void mrf::DisplayReport::report_egl_configuration(EGLDisplay disp, EGLConfig cfg)
+{
+    wrapped->report_egl_configuration(disp, cfg);
+}
+
+void mrf::DisplayReport::report_vsync(unsigned int output_id, graphics::Frame const& frame)
+{
+    recorder->flipped(output_id, frame);
+    wrapped->report_vsync(output_id, frame);
+}
+
+void mrf::DisplayReport::report_successful_drm_mode_set_crtc_on_construction()
+{
+    wrapped->report_successful_drm_mode_set_crtc_on_construction();
+}
+
+void mrf::DisplayReport::report_drm_master_failure(int error)
+{
+    wrapped->report_drm_master_failure(error);
+}
+
+void mrf::DisplayReport::report_vt_switch_away_failure()
+{
+    wrapped->report_vt_switch_away_failure();
+}
+
+void mrf::DisplayReport::report_vt_switch_back_failure()
+{
+    wrapped->report_vt_switch_back_failure();
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../frame_timeline_report_factory.h"
+
+#include "compositor_report.h"
+#include "display_report.h"
+
+#include "mir/frontend/connector_report.h"
+#include "mir/frontend/message_processor_report.h"
+#include "mir/frontend/session_mediator_observer.h"
+#include "mir/input/input_report.h"
+#include "mir/input/seat_observer.h"
+#include "mir/scene/scene_report.h"
+#include "mir/shared_library_prober_report.h"
+#include "mir/shell/shell_report.h"
+
+namespace mrf = mir::report::frame_timeline;
+
+mir::report::FrameTimelineReportFactory::FrameTimelineReportFactory(
+    std::unique_ptr<ReportFactory> wrapped,
+    std::shared_ptr<frame_timeline::Recorder> const& recorder) :
+    wrapped{std::move(wrapped)},
+    recorder{recorder}
+{
+}
+
+std::shared_ptr<mir::compositor::CompositorReport> mir::report::FrameTimelineReportFactory::create_compositor_report()
+{
+    return std::make_shared<mrf::CompositorReport>(wrapped->create_compositor_report(), recorder);
+}
+
+std::shared_ptr<mir::graphics::DisplayReport> mir::report::FrameTimelineReportFactory::create_display_report()
+{
+    return std::make_shared<mrf::DisplayReport>(wrapped->create_display_report(), recorder);
+}
+
+std::shared_ptr<mir::scene::SceneReport> mir::report::FrameTimelineReportFactory::create_scene_report()
+{
+    return wrapped->create_scene_report();
+}
+
+std::shared_ptr<mir::frontend::ConnectorReport> mir::report::FrameTimelineReportFactory::create_connector_report()
+{
+    return wrapped->create_connector_report();
+}
+
+std::shared_ptr<mir::frontend::SessionMediatorObserver> mir::report::FrameTimelineReportFactory::create_session_mediator_report()
+{
+    return wrapped->create_session_mediator_report();
+}
+
+std::shared_ptr<mir::frontend::MessageProcessorReport> mir::report::FrameTimelineReportFactory::create_message_processor_report()
+{
+    return wrapped->create_message_processor_report();
+}
+
+std::shared_ptr<mir::input::InputReport> mir::report::FrameTimelineReportFactory::create_input_report()
+{
+    return wrapped->create_input_report();
+}
+
+std::shared_ptr<mir::input::SeatObserver> mir::report::FrameTimelineReportFactory::create_seat_report()
+{
+    return wrapped->create_seat_report();
+}
+
+std::shared_ptr<mir::SharedLibraryProberReport> mir::report::FrameTimelineReportFactory::create_shared_library_prober_report()
+{
+    return wrapped->create_shared_library_prober_report();
+}
+
+std::shared_ptr<mir::shell::ShellReport> mir::report::FrameTimelineReportFactory::create_shell_report()
+{
+    return wrapped->create_shell_report();
+}
@@ -0,0 +1,385 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "recorder.h"
+
+#include "mir/graphics/buffer.h"
+#include "mir/graphics/frame.h"
+#include "mir/server_action_queue.h"
+#include "mir/fd.h"
+#include "mir/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace mrf = mir::report::frame_timeline;
+
+using namespace std::chrono;
+
+namespace
+{
+// The output whose frame is being composited on this thread, for texture uploads
+thread_local mrf::Recorder::OutputId compositing_output{nullptr};
+
+// Buffers that never reach the screen (e.g. dropped by the client's stream) are forgotten
+std::size_t const max_pending_submissions{1024};
+
+auto us(mrf::Recorder::Clock::time_point t) -> long long
+{
+    return duration_cast<microseconds>(t.time_since_epoch()).count();
+}
+
+auto us(mrf::Recorder::Clock::duration d) -> long long
+{
+    return duration_cast<microseconds>(d).count();
+}
+
+// What the timeline shows of an output, copied so that it can be formatted without the recorder's lock
+struct OutputTimeline
+{
+    mrf::Recorder::OutputId id;
+    mir::geometry::Rectangle area;
+    std::vector<mrf::Recorder::FrameRecord> frames;
+};
+
+void write_frame(
+    std::ostream& out,
+    mrf::Recorder::FrameRecord const& frame,
+    std::vector<mrf::Recorder::Flip> const& flips)
+{
+    out << "{\"snapshot_began_us\": " << us(frame.snapshot_began)
+        << ", \"snapshot_us\": " << us(frame.snapshot_taken - frame.snapshot_began)
+        << ", \"occlusion_us\": " << us(frame.occlusions_filtered - frame.snapshot_taken)
+        << ", \"render_us\": " << us(frame.rendered - frame.occlusions_filtered)
+        << ", \"post_us\": " << us(frame.posted - frame.finished)
+        << ", \"total_us\": " << us(frame.posted - frame.snapshot_began)
+        << ", \"renderables\": " << frame.renderables
+        << ", \"occluded\": " << frame.occluded
+        << ", \"uploaded_bytes\": " << frame.uploaded_bytes
+        << ", \"bypassed\": " << (frame.bypassed ? "true" : "false");
+
+    out << ", \"submissions\": [";
+    char const* separator = "";
+    for (auto const& submission : frame.shown)
+    {
+        out << separator << "{\"buffer\": " << submission.buffer.as_value()
+            << ", \"submitted_us\": " << us(submission.submitted)
+            << ", \"to_screen_us\": " << us(frame.posted - submission.submitted) << "}";
+        separator = ", ";
+    }
+
+    // The flips the post waited for (possibly with those of other outputs completing meanwhile)
+    out << "], \"flips\": [";
+    separator = "";
+    for (auto const& flip : flips)
+    {
+        if (flip.reported < frame.finished || flip.reported > frame.posted)
+            continue;
+
+        out << separator << "{\"output\": " << flip.output_id
+            << ", \"msc\": " << flip.msc
+            << ", \"ust_us\": " << duration_cast<microseconds>(flip.ust).count() << "}";
+        separator = ", ";
+    }
+    out << "]}";
+}
+
+auto format_timeline(
+    milliseconds frame_budget,
+    mrf::Recorder::OutputId janky_output,
+    mrf::Recorder::Clock::duration janky_frame_time,
+    std::vector<OutputTimeline> const& outputs,
+    std::vector<mrf::Recorder::Flip> const& flips) -> std::string
+{
+    std::ostringstream timeline;
+    timeline << "{\"budget_us\": " << us(frame_budget)
+             << ", \"janky_output\": \"" << janky_output << "\""
+             << ", \"janky_frame_us\": " << us(janky_frame_time)
+             << ", \"outputs\": [";
+
+    char const* output_separator = "";
+    for (auto const& output : outputs)
+    {
+        auto const& area = output.area;
+        timeline << output_separator << "\n {\"id\": \"" << output.id << "\""
+                 << ", \"area\": \"" << area.size.width << "x" << area.size.height
+                 << (area.top_left.x.as_int() < 0 ? "" : "+") << area.top_left.x
+                 << (area.top_left.y.as_int() < 0 ? "" : "+") << area.top_left.y << "\""
+                 << ", \"frames\": [";
+
+        char const* frame_separator = "";
+        for (auto const& frame : output.frames)
+        {
+            timeline << frame_separator << "\n  ";
+            write_frame(timeline, frame, flips);
+            frame_separator = ",";
+        }
+        timeline << "]}";
+        output_separator = ",";
+    }
+    timeline << "]}\n";
+
+    return timeline.str();
+}
+
+// Only ever creates a new file of our own: the name is predictable, so don't follow or reuse what is there
+auto write_new_file(std::string const& path, std::string const& text) -> bool
+{
+    mir::Fd const file{open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR)};
+    if (file == mir::Fd::invalid)
+        return false;
+
+    for (auto remaining = text.data(), end = text.data() + text.size(); remaining != end;)
+    {
+        auto const written = write(file, remaining, end - remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        remaining += written;
+    }
+
+    return true;
+}
+}
+
+mrf::Recorder::Recorder(
+    milliseconds frame_budget,
+    seconds history,
+    std::string const& directory,
+    std::shared_ptr<ServerActionQueue> const& action_queue) :
+    frame_budget{frame_budget},
+    history{history},
+    directory{directory},
+    action_queue{action_queue}
+{
+}
+
+void mrf::Recorder::added_output(OutputId id, geometry::Rectangle const& area)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    // The id may be the address of a destroyed compositor, so start afresh
+    auto& output = outputs[id];
+    output = Output{};
+    output.area = area;
+}
+
+void mrf::Recorder::began_scene_snapshot(OutputId id)
+{
+    auto const now = Clock::now();
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto& frame = outputs[id].in_progress;
+    frame = FrameRecord{};
+    frame.snapshot_began = now;
+}
+
+void mrf::Recorder::began_frame(OutputId id)
+{
+    auto const now = Clock::now();
+    compositing_output = id;
+    std::lock_guard<std::mutex> lock{mutex};
+
+    outputs[id].in_progress.snapshot_taken = now;
+}
+
+void mrf::Recorder::filtered_occlusions(OutputId id, std::size_t occluded)
+{
+    auto const now = Clock::now();
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto& frame = outputs[id].in_progress;
+    frame.occlusions_filtered = now;
+    frame.occluded = occluded;
+}
+
+void mrf::Recorder::renderables_in_frame(OutputId id, graphics::RenderableList const& renderables)
+{
+    std::vector<Submission> shown;
+    {
+        std::lock_guard<std::mutex> lock{submissions_mutex};
+
+        for (auto const& renderable : renderables)
+        {
+            auto const buffer = renderable->buffer();
+            if (!buffer)
+                continue;
+
+            auto const submission = pending_submissions.find(buffer->id());
+            if (submission != pending_submissions.end())
+            {
+                shown.push_back({submission->first, submission->second});
+                pending_submissions.erase(submission);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto& frame = outputs[id].in_progress;
+    frame.renderables = renderables.size();
+    frame.shown.insert(frame.shown.end(), shown.begin(), shown.end());
+}
+
+void mrf::Recorder::rendered_frame(OutputId id)
+{
+    auto const now = Clock::now();
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto& frame = outputs[id].in_progress;
+    frame.rendered = now;
+    frame.bypassed = false;
+}
+
+void mrf::Recorder::finished_frame(OutputId id)
+{
+    auto const now = Clock::now();
+    compositing_output = nullptr;
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto& frame = outputs[id].in_progress;
+    frame.finished = now;
+    if (frame.bypassed)
+        frame.rendered = now;
+}
+
+void mrf::Recorder::posted_frame(OutputId id)
+{
+    auto const now = Clock::now();
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto& output = outputs[id];
+    if (output.in_progress.snapshot_began == Clock::time_point{})
+        return;
+
+    output.in_progress.posted = now;
+    output.frames.push_back(std::move(output.in_progress));
+    output.in_progress = FrameRecord{};
+
+    while (now - output.frames.front().posted > history)
+        output.frames.pop_front();
+
+    auto const& frame = output.frames.back();
+    if (frame.posted - frame.snapshot_began > frame_budget &&
+        (timelines_written == 0 || now - last_written >= history))
+    {
+        last_written = now;
+        write_timeline(id, frame, lock);
+    }
+}
+
+void mrf::Recorder::uploaded_textures(std::size_t uploaded_bytes)
+{
+    if (!compositing_output)
+        return;
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    // Each output has its own renderer, whose total restarts with the output
+    auto& output = outputs[compositing_output];
+    if (uploaded_bytes >= output.uploaded_total)
+        output.in_progress.uploaded_bytes += uploaded_bytes - output.uploaded_total;
+    output.uploaded_total = uploaded_bytes;
+}
+
+void mrf::Recorder::submitted_buffer(graphics::BufferID buffer)
+{
+    auto const now = Clock::now();
+    std::lock_guard<std::mutex> lock{submissions_mutex};
+
+    if (pending_submissions.size() >= max_pending_submissions)
+        forget_old_submissions(now, lock);
+
+    pending_submissions[buffer] = now;
+}
+
+void mrf::Recorder::flipped(unsigned int output_id, graphics::Frame const& frame)
+{
+    auto const now = Clock::now();
+    std::lock_guard<std::mutex> lock{mutex};
+
+    flips.push_back({output_id, frame.msc, frame.ust.nanoseconds, now});
+
+    while (now - flips.front().reported > history)
+        flips.pop_front();
+}
+
+void mrf::Recorder::forget_old_submissions(Clock::time_point now, std::lock_guard<std::mutex> const&)
+{
+    for (auto i = pending_submissions.begin(); i != pending_submissions.end();)
+    {
+        if (now - i->second > history)
+            i = pending_submissions.erase(i);
+        else
+            ++i;
+    }
+
+    if (pending_submissions.size() >= max_pending_submissions)
+        pending_submissions.clear();
+}
+
+void mrf::Recorder::write_timeline(
+    OutputId janky_output,
+    FrameRecord const& janky_frame,
+    std::lock_guard<std::mutex> const&)
+{
+    // Copy what the timeline shows while it is consistent, but leave formatting and file I/O to the
+    // server's main loop, so that compositing and clients submitting buffers are not held up meanwhile
+    auto const since = janky_frame.posted - history;
+
+    std::vector<OutputTimeline> recent_outputs;
+    for (auto const& output : outputs)
+    {
+        if (output.second.frames.empty() || output.second.frames.back().posted < since)
+            continue;
+
+        auto const& frames = output.second.frames;
+        auto const first = std::find_if(
+            frames.begin(), frames.end(), [since](FrameRecord const& frame) { return frame.posted >= since; });
+        recent_outputs.push_back({output.first, output.second.area, {first, frames.end()}});
+    }
+
+    std::vector<Flip> recent_flips{flips.begin(), flips.end()};
+
+    auto const path = directory + "/mir-frame-timeline-" + std::to_string(getpid()) + "-" +
+        std::to_string(++timelines_written) + ".json";
+
+    auto const janky_frame_time = janky_frame.posted - janky_frame.snapshot_began;
+
+    action_queue->enqueue(
+        this,
+        [path, janky_output, janky_frame_time, frame_budget = frame_budget,
+            outputs = std::move(recent_outputs), flips = std::move(recent_flips)]
+        {
+            auto const text = format_timeline(frame_budget, janky_output, janky_frame_time, outputs, flips);
+            auto const janky_ms = us(janky_frame_time) / 1000;
+
+            if (write_new_file(path, text))
+                mir::log_warning("A frame took %lld ms: wrote the frame timeline to %s", janky_ms, path.c_str());
+            else
+                mir::log_warning(
+                    "A frame took %lld ms, but writing the frame timeline to %s failed: %s",
+                    janky_ms, path.c_str(), std::strerror(errno));
+        });
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_FRAME_TIMELINE_RECORDER_H_
+#define MIR_REPORT_FRAME_TIMELINE_RECORDER_H_
+
+#include "mir/geometry/rectangle.h"
+#include "mir/graphics/buffer_id.h"
+#include "mir/graphics/renderable.h"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+class ServerActionQueue;
+namespace graphics
+{
+struct Frame;
+}
+namespace report
+{
+namespace frame_timeline
+{
+/**
+ * A flight recorder of the phases of every frame composited for each output
+ * (display buffer compositor), with the client buffer submissions each frame
+ * put on screen for the first time. Whenever a frame takes longer than the
+ * budget, the timeline of the last history period is written to a file so
+ * that jank can be analysed after the event.
+ */
+class Recorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using OutputId = void const*;
+
+    struct Submission
+    {
+        graphics::BufferID buffer;
+        Clock::time_point submitted;
+    };
+
+    struct Flip
+    {
+        unsigned int output_id;
+        int64_t msc;
+        std::chrono::nanoseconds ust;
+        Clock::time_point reported;
+    };
+
+    /// The end of each phase of a frame, starting from the scene snapshot
+    struct FrameRecord
+    {
+        Clock::time_point snapshot_began;
+        Clock::time_point snapshot_taken;
+        Clock::time_point occlusions_filtered;
+        Clock::time_point rendered;
+        Clock::time_point finished;
+        Clock::time_point posted;
+        std::size_t renderables{0};
+        std::size_t occluded{0};
+        std::size_t uploaded_bytes{0};
+        bool bypassed{true};
+        std::vector<Submission> shown;
+    };
+
+    Recorder(
+        std::chrono::milliseconds frame_budget,
+        std::chrono::seconds history,
+        std::string const& directory,
+        std::shared_ptr<ServerActionQueue> const& action_queue);
+
+    void added_output(OutputId id, geometry::Rectangle const& area);
+    void began_scene_snapshot(OutputId id);
+    void began_frame(OutputId id);
+    void filtered_occlusions(OutputId id, std::size_t occluded);
+    void renderables_in_frame(OutputId id, graphics::RenderableList const& renderables);
+    void rendered_frame(OutputId id);
+    void finished_frame(OutputId id);
+    void posted_frame(OutputId id);
+    /// The renderer's running total, attributed to the frame being composited on the calling thread
+    void uploaded_textures(std::size_t uploaded_bytes);
+    void submitted_buffer(graphics::BufferID buffer);
+    void flipped(unsigned int output_id, graphics::Frame const& frame);
+
+private:
+    struct Output
+    {
+        geometry::Rectangle area;
+        FrameRecord in_progress;
+        std::size_t uploaded_total{0};
+        std::deque<FrameRecord> frames;
+    };
+
+    void write_timeline(OutputId janky_output, FrameRecord const& janky_frame, std::lock_guard<std::mutex> const&);
+    void forget_old_submissions(Clock::time_point now, std::lock_guard<std::mutex> const& submissions_lock);
+
+    std::chrono::milliseconds const frame_budget;
+    Clock::duration const history;
+    std::string const directory;
+    std::shared_ptr<ServerActionQueue> const action_queue;
+
+    /// Guards the frames; a timeline is copied under it, but formatted and written without it
+    std::mutex mutex;
+    std::unordered_map<OutputId, Output> outputs;
+    std::deque<Flip> flips;
+    Clock::time_point last_written;
+    unsigned int timelines_written{0};
+
+    /// Client submissions only contend with the frames they are shown in, not with every phase
+    std::mutex submissions_mutex;
+    std::unordered_map<graphics::BufferID, Clock::time_point> pending_submissions;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_FRAME_TIMELINE_RECORDER_H_ */
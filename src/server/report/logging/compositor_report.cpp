@@ -51,6 +51,10 @@ void mrl::CompositorReport::added_display(int width, int height, int x, int y, S
     logger->log(ml::Severity::informational, msg, component);
 }
 
+void mrl::CompositorReport::began_scene_snapshot(SubCompositorId)
+{
+}
+
 void mrl::CompositorReport::began_frame(SubCompositorId id)
 {
     std::lock_guard<std::mutex> lock(mutex);
@@ -62,6 +66,10 @@ void mrl::CompositorReport::began_frame(SubCompositorId id)
     inst.bypassed = true;
 }
 
+void mrl::CompositorReport::filtered_occlusions(SubCompositorId, std::size_t)
+{
+}
+
 void mrl::CompositorReport::renderables_in_frame(SubCompositorId, mir::graphics::RenderableList const&)
 {
 }
@@ -154,6 +162,9 @@ void mrl::CompositorReport::finished_frame(SubCompositorId id)
 
         for (auto& i : instance)
             i.second.log(*logger, i.first);
+
+        for (auto& c : texture_cache)
+            c.second.log(*logger, c.first);
     }
 
     if (inst.bypassed != inst.prev_bypassed || inst.nframes == 1)
@@ -166,6 +177,58 @@ void mrl::CompositorReport::finished_frame(SubCompositorId id)
     inst.prev_bypassed = inst.bypassed;
 }
 
+void mrl::CompositorReport::posted_frame(SubCompositorId)
+{
+}
+
+void mrl::CompositorReport::submitted_buffer(mir::graphics::BufferID)
+{
+}
+
+void mrl::CompositorReport::texture_cache_usage(
+    SubCompositorId id,
+    std::size_t hits,
+    std::size_t misses,
+    std::size_t evictions,
+    std::size_t uploaded_bytes,
+    std::size_t resident_bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& usage = texture_cache[id];
+    usage.hits = hits;
+    usage.misses = misses;
+    usage.evictions = evictions;
+    usage.uploaded_bytes = uploaded_bytes;
+    usage.resident_bytes = resident_bytes;
+}
+
+void mrl::CompositorReport::TextureCacheUsage::log(ml::Logger& logger, SubCompositorId id)
+{
+    auto const dh = hits - last_reported_hits;
+    auto const dm = misses - last_reported_misses;
+    auto const de = evictions - last_reported_evictions;
+    auto const du = uploaded_bytes - last_reported_uploaded_bytes;
+    auto const hit_percent = (dh + dm) ? dh * 100 / (dh + dm) : 100;
+
+    char msg[128];
+    snprintf(msg, sizeof msg, "Texture cache %p: %zu%% hits, "
+             "%zu uploads (%zu KiB), "
+             "%zu evictions, "
+             "%zu KiB resident",
+             id,
+             hit_percent,
+             dm,
+             du / 1024,
+             de,
+             resident_bytes / 1024);
+    logger.log(ml::Severity::informational, msg, component);
+
+    last_reported_hits = hits;
+    last_reported_misses = misses;
+    last_reported_evictions = evictions;
+    last_reported_uploaded_bytes = uploaded_bytes;
+}
+
 void mrl::CompositorReport::started()
 {
     logger->log(ml::Severity::informational, "Started", component);
@@ -177,6 +240,7 @@ void mrl::CompositorReport::stopped()
 
     std::lock_guard<std::mutex> lock(mutex);
     instance.clear();
+    texture_cache.clear();
 }
 
 void mrl::CompositorReport::scheduled()
@@ -43,10 +43,21 @@ public:
     CompositorReport(std::shared_ptr<mir::logging::Logger> const& logger,
                      std::shared_ptr<time::Clock> const& clock);
     void added_display(int width, int height, int x, int y, SubCompositorId id) override;
+    void began_scene_snapshot(SubCompositorId id) override;
     void began_frame(SubCompositorId id) override;
+    void filtered_occlusions(SubCompositorId id, std::size_t occluded) override;
     void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) override;
     void rendered_frame(SubCompositorId id) override;
     void finished_frame(SubCompositorId id) override;
+    void posted_frame(SubCompositorId id) override;
+    void submitted_buffer(graphics::BufferID buffer) override;
+    void texture_cache_usage(
+        SubCompositorId id,
+        std::size_t hits,
+        std::size_t misses,
+        std::size_t evictions,
+        std::size_t uploaded_bytes,
+        std::size_t resident_bytes) override;
     void started() override;
     void stopped() override;
     void scheduled() override;
@@ -79,8 +90,25 @@ private:
         void log(mir::logging::Logger& logger, SubCompositorId id);
     };
 
+    struct TextureCacheUsage
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+        std::size_t uploaded_bytes = 0;
+        std::size_t resident_bytes = 0;
+
+        std::size_t last_reported_hits = 0;
+        std::size_t last_reported_misses = 0;
+        std::size_t last_reported_evictions = 0;
+        std::size_t last_reported_uploaded_bytes = 0;
+
+        void log(mir::logging::Logger& logger, SubCompositorId id);
+    };
+
     std::mutex mutex; // Protects the following...
     std::unordered_map<SubCompositorId, Instance> instance;
+    std::unordered_map<SubCompositorId, TextureCacheUsage> texture_cache;
     TimePoint last_scheduled;
     TimePoint last_report;
 };
@@ -38,11 +38,21 @@ void mir::report::lttng::CompositorReport::added_display(int width, int height,
     mir_tracepoint(mir_server_compositor, added_display, width, height, x, y, id);
 }
 
+void mir::report::lttng::CompositorReport::began_scene_snapshot(SubCompositorId id)
+{
+    mir_tracepoint(mir_server_compositor, began_scene_snapshot, id);
+}
+
 void mir::report::lttng::CompositorReport::began_frame(SubCompositorId id)
 {
     mir_tracepoint(mir_server_compositor, began_frame, id);
 }
 
+void mir::report::lttng::CompositorReport::filtered_occlusions(SubCompositorId id, std::size_t occluded)
+{
+    mir_tracepoint(mir_server_compositor, filtered_occlusions, id, occluded);
+}
+
 void mir::report::lttng::CompositorReport::renderables_in_frame(
     SubCompositorId id, graphics::RenderableList const& list)
 {
@@ -62,3 +72,24 @@ void mir::report::lttng::CompositorReport::finished_frame(SubCompositorId id)
 {
     mir_tracepoint(mir_server_compositor, finished_frame, id);
 }
+
+void mir::report::lttng::CompositorReport::posted_frame(SubCompositorId id)
+{
+    mir_tracepoint(mir_server_compositor, posted_frame, id);
+}
+
+void mir::report::lttng::CompositorReport::submitted_buffer(graphics::BufferID buffer)
+{
+    mir_tracepoint(mir_server_compositor, submitted_buffer, buffer.as_value());
+}
+
+void mir::report::lttng::CompositorReport::texture_cache_usage(
+    SubCompositorId id,
+    std::size_t hits,
+    std::size_t misses,
+    std::size_t evictions,
+    std::size_t uploaded_bytes,
+    std::size_t resident_bytes)
+{
+    mir_tracepoint(mir_server_compositor, texture_cache_usage, id, hits, misses, evictions, uploaded_bytes, resident_bytes);
+}
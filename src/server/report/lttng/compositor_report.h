@@ -36,10 +36,21 @@ public:
     CompositorReport() = default;
     virtual ~CompositorReport() = default;
     void added_display(int width, int height, int x, int y, SubCompositorId id) override;
+    void began_scene_snapshot(SubCompositorId id) override;
     void began_frame(SubCompositorId id) override;
+    void filtered_occlusions(SubCompositorId id, std::size_t occluded) override;
     void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) override;
     void rendered_frame(SubCompositorId id) override;
     void finished_frame(SubCompositorId id) override;
+    void posted_frame(SubCompositorId id) override;
+    void submitted_buffer(graphics::BufferID buffer) override;
+    void texture_cache_usage(
+        SubCompositorId id,
+        std::size_t hits,
+        std::size_t misses,
+        std::size_t evictions,
+        std::size_t uploaded_bytes,
+        std::size_t resident_bytes) override;
     void started() override;
     void stopped() override;
     void scheduled() override;
@@ -59,6 +59,13 @@ TRACEPOINT_EVENT_CLASS(
     )
 )
 
+TRACEPOINT_EVENT_INSTANCE(
+    mir_server_compositor,
+    subcompositor_event,
+    began_scene_snapshot,
+    TP_ARGS(void const*, id)
+)
+
 TRACEPOINT_EVENT_INSTANCE(
     mir_server_compositor,
     subcompositor_event,
@@ -80,6 +87,32 @@ TRACEPOINT_EVENT_INSTANCE(
     TP_ARGS(void const*, id)
 )
 
+TRACEPOINT_EVENT_INSTANCE(
+    mir_server_compositor,
+    subcompositor_event,
+    posted_frame,
+    TP_ARGS(void const*, id)
+)
+
+TRACEPOINT_EVENT(
+    mir_server_compositor,
+    filtered_occlusions,
+    TP_ARGS(void const*, id, size_t, occluded),
+    TP_FIELDS(
+        ctf_integer_hex(uintptr_t, id, (uintptr_t)(id))
+        ctf_integer(size_t, occluded, occluded)
+    )
+)
+
+TRACEPOINT_EVENT(
+    mir_server_compositor,
+    submitted_buffer,
+    TP_ARGS(uint32_t, buffer_id),
+    TP_FIELDS(
+        ctf_integer(uint32_t, buffer_id, buffer_id)
+    )
+)
+
 TRACEPOINT_EVENT(
     mir_server_compositor,
     buffers_in_frame,
@@ -90,6 +123,20 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    mir_server_compositor,
+    texture_cache_usage,
+    TP_ARGS(void const*, id, size_t, hits, size_t, misses, size_t, evictions, size_t, uploaded_bytes, size_t, resident_bytes),
+    TP_FIELDS(
+        ctf_integer_hex(uintptr_t, id, (uintptr_t)(id))
+        ctf_integer(size_t, hits, hits)
+        ctf_integer(size_t, misses, misses)
+        ctf_integer(size_t, evictions, evictions)
+        ctf_integer(size_t, uploaded_bytes, uploaded_bytes)
+        ctf_integer(size_t, resident_bytes, resident_bytes)
+    )
+)
+
 #endif /* MIR_LTTNG_COMPOSITOR_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compositor_report.h"
+#include "metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+
+namespace mrm = mir::report::metrics;
+
+using namespace std::chrono;
+
+namespace
+{
+/* Each compositing thread composites its display buffers one after the
+ * other, and their renderers report texture cache usage from the same
+ * thread, so the state of a frame in flight needs no locking.
+ */
+struct FrameInFlight
+{
+    steady_clock::time_point start;
+    bool rendered{false};
+};
+
+struct TextureCacheTotals
+{
+    std::size_t misses{0};
+    std::size_t uploaded_bytes{0};
+    std::size_t resident_bytes{0};
+};
+
+/* The last totals reported by each renderer of a compositing thread. These
+ * are forgotten once the compositor has stopped (and the renderers with it).
+ */
+struct RendererTotals
+{
+    unsigned int generation{0};
+    std::unordered_map<mir::compositor::CompositorReport::SubCompositorId, TextureCacheTotals> by_renderer;
+};
+
+thread_local FrameInFlight frame_in_flight;
+thread_local RendererTotals renderer_totals;
+std::atomic<unsigned int> compositor_generation{0};
+
+// The report's totals are cumulative, but restart when a renderer is replaced
+auto increase(std::size_t previous, std::size_t current) -> std::size_t
+{
+    return current >= previous ? current - previous : current;
+}
+}
+
+mrm::CompositorReport::CompositorReport(
+    std::shared_ptr<compositor::CompositorReport> const& wrapped,
+    std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    wrapped{wrapped},
+    frames{registry->counter("mir_compositor_frames_total", "Frames composited by all display buffers")},
+    bypassed_frames{registry->counter(
+        "mir_compositor_bypassed_frames_total", "Frames that bypassed compositing (fullscreen client buffer)")},
+    frame_time{registry->histogram(
+        "mir_compositor_frame_time_us", "Time from starting to finishing the composition of a frame")},
+    renderables{registry->histogram("mir_compositor_renderables", "Renderables considered for each frame")},
+    texture_uploads{registry->counter("mir_texture_uploads_total", "Client buffers uploaded to textures")},
+    texture_uploaded_bytes{registry->counter(
+        "mir_texture_uploaded_bytes_total", "Estimated bytes of client buffers uploaded to textures")},
+    texture_resident_bytes{registry->gauge(
+        "mir_texture_resident_bytes", "Estimated GPU memory held by the texture caches")}
+{
+}
+
+void mrm::CompositorReport::added_display(int width, int height, int x, int y, SubCompositorId id)
+{
+    wrapped->added_display(width, height, x, y, id);
+}
+
+void mrm::CompositorReport::began_scene_snapshot(SubCompositorId id)
+{
+    wrapped->began_scene_snapshot(id);
+}
+
+void mrm::CompositorReport::began_frame(SubCompositorId id)
+{
+    frame_in_flight.start = steady_clock::now();
+    frame_in_flight.rendered = false;
+    wrapped->began_frame(id);
+}
+
+void mrm::CompositorReport::filtered_occlusions(SubCompositorId id, std::size_t occluded)
+{
+    wrapped->filtered_occlusions(id, occluded);
+}
+
+void mrm::CompositorReport::renderables_in_frame(SubCompositorId id, graphics::RenderableList const& list)
+{
+    renderables.record(list.size());
+    wrapped->renderables_in_frame(id, list);
+}
+
+void mrm::CompositorReport::rendered_frame(SubCompositorId id)
+{
+    frame_in_flight.rendered = true;
+    wrapped->rendered_frame(id);
+}
+
+void mrm::CompositorReport::finished_frame(SubCompositorId id)
+{
+    frame_time.record(duration_cast<microseconds>(steady_clock::now() - frame_in_flight.start).count());
+    frames.increment();
+    if (!frame_in_flight.rendered)
+        bypassed_frames.increment();
+
+    wrapped->finished_frame(id);
+}
+
+void mrm::CompositorReport::posted_frame(SubCompositorId id)
+{
+    wrapped->posted_frame(id);
+}
+
+void mrm::CompositorReport::submitted_buffer(graphics::BufferID buffer)
+{
+    wrapped->submitted_buffer(buffer);
+}
+
+void mrm::CompositorReport::texture_cache_usage(
+    SubCompositorId id,
+    std::size_t hits,
+    std::size_t misses,
+    std::size_t evictions,
+    std::size_t uploaded_bytes,
+    std::size_t resident_bytes)
+{
+    auto const generation = compositor_generation.load(std::memory_order_relaxed);
+    if (renderer_totals.generation != generation)
+    {
+        renderer_totals.by_renderer.clear();
+        renderer_totals.generation = generation;
+    }
+
+    auto& totals = renderer_totals.by_renderer[id];
+    texture_uploads.increment(increase(totals.misses, misses));
+    texture_uploaded_bytes.increment(increase(totals.uploaded_bytes, uploaded_bytes));
+    texture_resident_bytes.add(static_cast<int64_t>(resident_bytes) - static_cast<int64_t>(totals.resident_bytes));
+    totals = {misses, uploaded_bytes, resident_bytes};
+
+    wrapped->texture_cache_usage(id, hits, misses, evictions, uploaded_bytes, resident_bytes);
+}
+
+void mrm::CompositorReport::started()
+{
+    wrapped->started();
+}
+
+void mrm::CompositorReport::stopped()
+{
+    // Stopping the compositor destroys the renderers, and their texture caches
+    compositor_generation.fetch_add(1, std::memory_order_relaxed);
+    texture_resident_bytes.set(0);
+    wrapped->stopped();
+}
+
+void mrm::CompositorReport::scheduled()
+{
+    wrapped->scheduled();
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_
+#define MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_
+
+#include "mir/compositor/compositor_report.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Gauge;
+class Histogram;
+
+/// Feeds the frame and texture cache metrics, then forwards to the configured report
+class CompositorReport : public compositor::CompositorReport
+{
+public:
+    CompositorReport(
+        std::shared_ptr<compositor::CompositorReport> const& wrapped,
+        std::shared_ptr<Registry> const& registry);
+
+    void added_display(int width, int height, int x, int y, SubCompositorId id) override;
+    void began_scene_snapshot(SubCompositorId id) override;
+    void began_frame(SubCompositorId id) override;
+    void filtered_occlusions(SubCompositorId id, std::size_t occluded) override;
+    void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) override;
+    void rendered_frame(SubCompositorId id) override;
+    void finished_frame(SubCompositorId id) override;
+    void posted_frame(SubCompositorId id) override;
+    void submitted_buffer(graphics::BufferID buffer) override;
+    void texture_cache_usage(
+        SubCompositorId id,
+        std::size_t hits,
+        std::size_t misses,
+        std::size_t evictions,
+        std::size_t uploaded_bytes,
+        std::size_t resident_bytes) override;
+    void started() override;
+    void stopped() override;
+    void scheduled() override;
+
+private:
+    std::shared_ptr<Registry> const registry;
+    std::shared_ptr<compositor::CompositorReport> const wrapped;
+
+    Counter& frames;
+    Counter& bypassed_frames;
+    Histogram& frame_time;
+    Histogram& renderables;
+    Counter& texture_uploads;
+    Counter& texture_uploaded_bytes;
+    Gauge& texture_resident_bytes;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_ */
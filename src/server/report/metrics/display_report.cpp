@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "display_report.h"
+#include "metrics.h"
+
+#include "mir/graphics/frame.h"
+#include "mir/log.h"
+
+namespace mrm = mir::report::metrics;
+
+using namespace std::chrono;
+
+mrm::DisplayReport::DisplayReport(
+    std::shared_ptr<graphics::DisplayReport> const& wrapped,
+    std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    wrapped{wrapped},
+    flips{registry->counter("mir_display_flips_total", "Frames presented by all outputs")},
+    skipped_vblanks{registry->counter(
+        "mir_display_skipped_vblanks_total",
+        "Vblanks at which an output did not present a new frame (missed, or nothing to draw)")},
+    flip_interval{registry->histogram(
+        "mir_display_flip_interval_us", "Time between consecutive frames presented by an output")}
+{
+}
+
+void mrm::DisplayReport::report_successful_setup_of_native_resources()
+{
+    wrapped->report_successful_setup_of_native_resources();
+}
+
+void mrm::DisplayReport::report_successful_egl_make_current_on_construction()
+{
+    wrapped->report_successful_egl_make_current_on_construction();
+}
+
+void mrm::DisplayReport::report_successful_egl_buffer_swap_on_construction()
+{
+    wrapped->report_successful_egl_buffer_swap_on_construction();
+}
+
+void mrm::DisplayReport::report_successful_display_construction()
+{
+    wrapped->report_successful_display_construction();
+}
+
+void mrm::DisplayReport::report_egl_configuration(EGLDisplay disp, EGLConfig cfg)
+{
+    wrapped->report_egl_configuration(disp, cfg);
+}
+
+void mrm::DisplayReport::report_vsync(unsigned int output_id, graphics::Frame const& frame)
+{
+    flips.increment();
+
+    auto const ust_us = duration_cast<microseconds>(frame.ust.nanoseconds).count();
+
+    // Outputs are few, and found in the same slot every frame, so a linear probe will do
+    bool found{false};
+    for (auto& output : outputs)
+    {
+        auto id = output.id_plus_one.load();
+        if (id == 0 && output.id_plus_one.compare_exchange_strong(id, output_id + 1))
+        {
+            output.msc = frame.msc;
+            output.ust_us = ust_us;
+            found = true;
+            break;
+        }
+        if (id == output_id + 1)
+        {
+            auto const last_msc = output.msc.exchange(frame.msc);
+            auto const last_ust_us = output.ust_us.exchange(ust_us);
+            if (frame.msc > last_msc + 1)
+                skipped_vblanks.increment(frame.msc - last_msc - 1);
+            if (ust_us > last_ust_us)
+                flip_interval.record(ust_us - last_ust_us);
+            found = true;
+            break;
+        }
+    }
+
+    if (!found && !reported_too_many_outputs.exchange(true))
+    {
+        mir::log_warning(
+            "Output %u is beyond the first %zu outputs: its skipped vblanks and flip intervals are not recorded",
+            output_id, outputs.size());
+    }
+
+    wrapped->report_vsync(output_id, frame);
+}
+
+void mrm::DisplayReport::report_successful_drm_mode_set_crtc_on_construction()
+{
+    wrapped->report_successful_drm_mode_set_crtc_on_construction();
+}
+
+void mrm::DisplayReport::report_drm_master_failure(int error)
+{
+    wrapped->report_drm_master_failure(error);
+}
+
+void mrm::DisplayReport::report_vt_switch_away_failure()
+{
+    wrapped->report_vt_switch_away_failure();
+}
+
+void mrm::DisplayReport::report_vt_switch_back_failure()
+{
+    wrapped->report_vt_switch_back_failure();
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_DISPLAY_REPORT_H_
+#define MIR_REPORT_METRICS_DISPLAY_REPORT_H_
+
+#include "mir/graphics/display_report.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Histogram;
+
+/// Feeds the page flip metrics, then forwards to the configured report
+class DisplayReport : public graphics::DisplayReport
+{
+public:
+    DisplayReport(
+        std::shared_ptr<graphics::DisplayReport> const& wrapped,
+        std::shared_ptr<Registry> const& registry);
+
+    void report_successful_setup_of_native_resources() override;
+    void report_successful_egl_make_current_on_construction() override;
+    void report_successful_egl_buffer_swap_on_construction() override;
+    void report_successful_display_construction() override;
+    void report_egl_configuration(EGLDisplay disp, EGLConfig cfg) override;
+    void report_vsync(unsigned int output_id, graphics::Frame const& frame) override;
+    void report_successful_drm_mode_set_crtc_on_construction() override;
+    void report_drm_master_failure(int error) override;
+    void report_vt_switch_away_failure() override;
+    void report_vt_switch_back_failure() override;
+
+private:
+    std::shared_ptr<Registry> const registry;
+    std::shared_ptr<graphics::DisplayReport> const wrapped;
+
+    Counter& flips;
+    Counter& skipped_vblanks;
+    Histogram& flip_interval;
+
+    /// The last flip of each output, claimed by the output's first flip
+    struct Output
+    {
+        std::atomic<unsigned int> id_plus_one{0};
+        std::atomic<int64_t> msc{0};
+        std::atomic<int64_t> ust_us{0};
+    };
+    std::array<Output, 16> outputs;
+    std::atomic<bool> reported_too_many_outputs{false};
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_DISPLAY_REPORT_H_ */
@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_report.h"
+#include "metrics.h"
+
+namespace mrm = mir::report::metrics;
+
+mrm::InputReport::InputReport(
+    std::shared_ptr<input::InputReport> const& wrapped,
+    std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    wrapped{wrapped},
+    received_events{registry->counter(
+        "mir_input_events_received_total", "Events read from input devices, before filtering and dispatch")},
+    opened_devices{registry->counter("mir_input_devices_opened_total", "Input devices opened")}
+{
+}
+
+void mrm::InputReport::received_event_from_kernel(int64_t when, int type, int code, int value)
+{
+    received_events.increment();
+    wrapped->received_event_from_kernel(when, type, code, value);
+}
+
+void mrm::InputReport::published_key_event(int dest_fd, uint32_t seq_id, int64_t event_time)
+{
+    wrapped->published_key_event(dest_fd, seq_id, event_time);
+}
+
+void mrm::InputReport::published_motion_event(int dest_fd, uint32_t seq_id, int64_t event_time)
+{
+    wrapped->published_motion_event(dest_fd, seq_id, event_time);
+}
+
+void mrm::InputReport::opened_input_device(char const* device_name, char const* input_platform)
+{
+    opened_devices.increment();
+    wrapped->opened_input_device(device_name, input_platform);
+}
+
+void mrm::InputReport::failed_to_open_input_device(char const* device_name, char const* input_platform)
+{
+    wrapped->failed_to_open_input_device(device_name, input_platform);
+}
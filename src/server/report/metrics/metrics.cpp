@@ -0,0 +1,224 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "metrics.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+char const* const counter_type = "counter";
+char const* const gauge_type = "gauge";
+char const* const summary_type = "summary";
+
+double const quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+auto escaped(std::string const& label_value) -> std::string
+{
+    std::string result;
+    for (auto const c : label_value)
+    {
+        switch (c)
+        {
+        case '\\': result += "\\\\"; break;
+        case '"':  result += "\\\""; break;
+        case '\n': result += "\\n"; break;
+        default:   result += c; break;
+        }
+    }
+    return result;
+}
+}
+
+struct mrm::Registry::Family
+{
+    std::string help;
+    char const* type;
+    std::string label;
+
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+    std::map<std::string, std::unique_ptr<Counter>> series;
+};
+
+auto mrm::Histogram::bucket_for(uint64_t value) noexcept -> int
+{
+    if (value < sub_buckets)
+        return static_cast<int>(value);
+
+    // The first sub_buckets values have a bucket each, then each power of two is split sub_buckets ways
+    int const magnitude = 63 - __builtin_clzll(value);
+    int const shift = magnitude - 3;
+    return (magnitude - 2) * sub_buckets + static_cast<int>((value >> shift) & (sub_buckets - 1));
+}
+
+auto mrm::Histogram::upper_bound_of(int bucket) noexcept -> uint64_t
+{
+    if (bucket < sub_buckets)
+        return bucket;
+
+    int const magnitude = bucket / sub_buckets + 2;
+    int const shift = magnitude - 3;
+    uint64_t const lower = static_cast<uint64_t>(sub_buckets + bucket % sub_buckets) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void mrm::Histogram::record(uint64_t value) noexcept
+{
+    buckets[bucket_for(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+}
+
+auto mrm::Histogram::count() const noexcept -> uint64_t
+{
+    uint64_t result{0};
+    for (auto const& bucket : buckets)
+        result += bucket.load(std::memory_order_relaxed);
+    return result;
+}
+
+auto mrm::Histogram::sum() const noexcept -> uint64_t
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+auto mrm::Histogram::quantile(double q) const noexcept -> uint64_t
+{
+    std::array<uint64_t, bucket_count> snapshot;
+    uint64_t samples{0};
+    for (int i = 0; i != bucket_count; ++i)
+        samples += (snapshot[i] = buckets[i].load(std::memory_order_relaxed));
+
+    if (samples == 0)
+        return 0;
+
+    auto const rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * samples)));
+    uint64_t seen{0};
+    for (int i = 0; i != bucket_count; ++i)
+    {
+        if ((seen += snapshot[i]) >= rank)
+            return upper_bound_of(i);
+    }
+    return upper_bound_of(bucket_count - 1);
+}
+
+mrm::Registry::Registry() = default;
+mrm::Registry::~Registry() = default;
+
+auto mrm::Registry::family(std::string const& name, std::string const& help, char const* type) -> Family&
+{
+    auto& family = families[name];
+    if (!family)
+    {
+        family = std::make_unique<Family>();
+        family->help = help;
+        family->type = type;
+    }
+    else if (family->type != type)
+    {
+        BOOST_THROW_EXCEPTION(std::logic_error{"Metric \"" + name + "\" already registered as a " + family->type});
+    }
+    return *family;
+}
+
+auto mrm::Registry::counter(std::string const& name, std::string const& help) -> Counter&
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& f = family(name, help, counter_type);
+    if (!f.counter)
+        f.counter = std::make_unique<Counter>();
+    return *f.counter;
+}
+
+auto mrm::Registry::gauge(std::string const& name, std::string const& help) -> Gauge&
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& f = family(name, help, gauge_type);
+    if (!f.gauge)
+        f.gauge = std::make_unique<Gauge>();
+    return *f.gauge;
+}
+
+auto mrm::Registry::histogram(std::string const& name, std::string const& help) -> Histogram&
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& f = family(name, help, summary_type);
+    if (!f.histogram)
+        f.histogram = std::make_unique<Histogram>();
+    return *f.histogram;
+}
+
+auto mrm::Registry::labelled_counter(
+    std::string const& name,
+    std::string const& help,
+    std::string const& label,
+    std::string const& value) -> Counter&
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& f = family(name, help, counter_type);
+    f.label = label;
+    auto& series = f.series[value];
+    if (!series)
+        series = std::make_unique<Counter>();
+    return *series;
+}
+
+void mrm::Registry::remove_labelled_counter(std::string const& name, std::string const& value)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto const f = families.find(name);
+    if (f != families.end())
+        f->second->series.erase(value);
+}
+
+void mrm::Registry::write_prometheus(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    for (auto const& entry : families)
+    {
+        auto const& name = entry.first;
+        auto const& f = *entry.second;
+
+        out << "# HELP " << name << ' ' << f.help << '\n'
+            << "# TYPE " << name << ' ' << f.type << '\n';
+
+        if (f.counter)
+            out << name << ' ' << f.counter->value() << '\n';
+
+        for (auto const& series : f.series)
+            out << name << '{' << f.label << "=\"" << escaped(series.first) << "\"} " << series.second->value() << '\n';
+
+        if (f.gauge)
+            out << name << ' ' << f.gauge->value() << '\n';
+
+        if (f.histogram)
+        {
+            for (auto const q : quantiles)
+                out << name << "{quantile=\"" << q << "\"} " << f.histogram->quantile(q) << '\n';
+            out << name << "_sum " << f.histogram->sum() << '\n'
+                << name << "_count " << f.histogram->count() << '\n';
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_METRICS_H_
+#define MIR_REPORT_METRICS_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+/// A monotonically increasing count. Updates are lock-free.
+class Counter
+{
+public:
+    void increment(uint64_t by = 1) noexcept { count.fetch_add(by, std::memory_order_relaxed); }
+    auto value() const noexcept -> uint64_t { return count.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> count{0};
+};
+
+/// A value that can go up and down. Updates are lock-free.
+class Gauge
+{
+public:
+    void set(int64_t value) noexcept { current.store(value, std::memory_order_relaxed); }
+    void add(int64_t delta) noexcept { current.fetch_add(delta, std::memory_order_relaxed); }
+    auto value() const noexcept -> int64_t { return current.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> current{0};
+};
+
+/**
+ * A distribution of non-negative values, such as frame times in microseconds.
+ * Like an HDR histogram, every power of two is split into sub_buckets linear
+ * buckets, so any quantile is reported to within 1/sub_buckets of its value
+ * at a fixed memory cost. Recording is lock-free.
+ */
+class Histogram
+{
+public:
+    static int const sub_buckets{8};
+
+    void record(uint64_t value) noexcept;
+
+    auto count() const noexcept -> uint64_t;
+    auto sum() const noexcept -> uint64_t;
+    /// The upper bound of the bucket holding the q'th quantile (0 <= q <= 1), or 0 if empty
+    auto quantile(double q) const noexcept -> uint64_t;
+
+private:
+    static int const bucket_count{(64 - 2) * sub_buckets};
+    static auto bucket_for(uint64_t value) noexcept -> int;
+    static auto upper_bound_of(int bucket) noexcept -> uint64_t;
+
+    std::array<std::atomic<uint64_t>, bucket_count> buckets{};
+    std::atomic<uint64_t> total{0};
+};
+
+/**
+ * The named metrics of a server, which can be read in the Prometheus text
+ * exposition format. Creating a metric takes a lock, so hot paths should
+ * create theirs up front and keep the reference, which stays valid for the
+ * lifetime of the registry.
+ */
+class Registry
+{
+public:
+    Registry();
+    ~Registry();
+
+    auto counter(std::string const& name, std::string const& help) -> Counter&;
+    auto gauge(std::string const& name, std::string const& help) -> Gauge&;
+    auto histogram(std::string const& name, std::string const& help) -> Histogram&;
+
+    /// The counter of a family whose series are distinguished by a label value (e.g. client="foo")
+    auto labelled_counter(
+        std::string const& name,
+        std::string const& help,
+        std::string const& label,
+        std::string const& value) -> Counter&;
+
+    /// Drops a series of a labelled family, which must no longer be in use
+    void remove_labelled_counter(std::string const& name, std::string const& value);
+
+    void write_prometheus(std::ostream& out) const;
+
+private:
+    struct Family;
+
+    auto family(std::string const& name, std::string const& help, char const* type) -> Family&;
+
+    std::mutex mutable mutex;
+    std::map<std::string, std::unique_ptr<Family>> families;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_METRICS_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../metrics_report_factory.h"
+
+#include "compositor_report.h"
+#include "display_report.h"
+#include "input_report.h"
+#include "scene_report.h"
+
+#include "mir/frontend/connector_report.h"
+#include "mir/frontend/message_processor_report.h"
+#include "mir/frontend/session_mediator_observer.h"
+#include "mir/input/seat_observer.h"
+#include "mir/shared_library_prober_report.h"
+#include "mir/shell/shell_report.h"
+
+namespace mrm = mir::report::metrics;
+
+mir::report::MetricsReportFactory::MetricsReportFactory(
+    std::unique_ptr<ReportFactory> wrapped,
+    std::shared_ptr<metrics::Registry> const& registry) :
+    wrapped{std::move(wrapped)},
+    registry{registry}
+{
+}
+
+std::shared_ptr<mir::compositor::CompositorReport> mir::report::MetricsReportFactory::create_compositor_report()
+{
+    return std::make_shared<mrm::CompositorReport>(wrapped->create_compositor_report(), registry);
+}
+
+std::shared_ptr<mir::graphics::DisplayReport> mir::report::MetricsReportFactory::create_display_report()
+{
+    return std::make_shared<mrm::DisplayReport>(wrapped->create_display_report(), registry);
+}
+
+std::shared_ptr<mir::scene::SceneReport> mir::report::MetricsReportFactory::create_scene_report()
+{
+    return std::make_shared<mrm::SceneReport>(wrapped->create_scene_report(), registry);
+}
+
+std::shared_ptr<mir::frontend::ConnectorReport> mir::report::MetricsReportFactory::create_connector_report()
+{
+    return wrapped->create_connector_report();
+}
+
+// The seat and session mediator metrics are separate observers (see Reports)
+std::shared_ptr<mir::frontend::SessionMediatorObserver> mir::report::MetricsReportFactory::create_session_mediator_report()
+{
+    return wrapped->create_session_mediator_report();
+}
+
+std::shared_ptr<mir::frontend::MessageProcessorReport> mir::report::MetricsReportFactory::create_message_processor_report()
+{
+    return wrapped->create_message_processor_report();
+}
+
+std::shared_ptr<mir::input::InputReport> mir::report::MetricsReportFactory::create_input_report()
+{
+    return std::make_shared<mrm::InputReport>(wrapped->create_input_report(), registry);
+}
+
+std::shared_ptr<mir::input::SeatObserver> mir::report::MetricsReportFactory::create_seat_report()
+{
+    return wrapped->create_seat_report();
+}
+
+std::shared_ptr<mir::SharedLibraryProberReport> mir::report::MetricsReportFactory::create_shared_library_prober_report()
+{
+    return wrapped->create_shared_library_prober_report();
+}
+
+std::shared_ptr<mir::shell::ShellReport> mir::report::MetricsReportFactory::create_shell_report()
+{
+    return wrapped->create_shell_report();
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "metrics_socket.h"
+#include "metrics.h"
+
+#include "mir/graphics/event_handler_register.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cerrno>
+#include <sstream>
+#include <system_error>
+
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+auto is_socket(std::string const& path) -> bool
+{
+    struct stat status;
+    return lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode);
+}
+
+// Replace the socket of a previous server that did not exit cleanly, but nothing else that is in the way
+void remove_stale_socket(std::string const& path)
+{
+    struct stat status;
+    if (lstat(path.c_str(), &status) < 0)
+    {
+        if (errno == ENOENT)
+            return;
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to stat metrics socket " + path}));
+    }
+
+    if (!S_ISSOCK(status.st_mode))
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Metrics socket path exists and is not a socket: " + path});
+
+    if (unlink(path.c_str()) < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to remove stale metrics socket " + path}));
+}
+
+auto listen_on(std::string const& path) -> mir::Fd
+{
+    sockaddr_un address;
+    if (path.size() >= sizeof address.sun_path)
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Metrics socket path is too long: " + path});
+
+    mir::Fd socket{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0)};
+    if (socket < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create metrics socket"}));
+
+    memset(&address, 0, sizeof address);
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof address.sun_path - 1);
+
+    remove_stale_socket(path);
+
+    // The metrics reveal which clients are running, so only the server's user may ever connect
+    auto const previous_umask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
+    auto const bound = bind(socket, reinterpret_cast<sockaddr*>(&address), sizeof address);
+    auto const bind_error = errno;
+    umask(previous_umask);
+
+    if (bound < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{bind_error, std::system_category(), "Failed to bind metrics socket " + path}));
+
+    if (listen(socket, SOMAXCONN) < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to listen on metrics socket"}));
+
+    return socket;
+}
+}
+
+mrm::MetricsSocket::MetricsSocket(
+    std::string const& path,
+    std::shared_ptr<Registry> const& registry,
+    std::shared_ptr<graphics::EventHandlerRegister> const& main_loop) :
+    path{path},
+    registry{registry},
+    main_loop{main_loop},
+    listener{listen_on(path)}
+{
+    main_loop->register_fd_handler({listener}, this, [this](int) { serve_connection(); });
+}
+
+mrm::MetricsSocket::~MetricsSocket()
+{
+    main_loop->unregister_fd_handler(this);
+
+    if (is_socket(path))
+        unlink(path.c_str());
+}
+
+void mrm::MetricsSocket::serve_connection()
+{
+    Fd const connection{accept4(listener, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)};
+    if (connection < 0)
+        return;
+
+    std::ostringstream text;
+    registry->write_prometheus(text);
+    auto const page = text.str();
+
+    /* The page is well within a socket buffer, so this does not wait on the
+     * reader: a reader that doesn't keep up just gets a truncated page.
+     */
+    size_t sent{0};
+    while (sent < page.size())
+    {
+        auto const result = send(connection, page.data() + sent, page.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (result <= 0)
+            break;
+        sent += result;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_METRICS_SOCKET_H_
+#define MIR_REPORT_METRICS_METRICS_SOCKET_H_
+
+#include "mir/fd.h"
+
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace graphics
+{
+class EventHandlerRegister;
+}
+namespace report
+{
+namespace metrics
+{
+class Registry;
+
+/**
+ * A UNIX socket from which the metrics can be read: each connection is sent
+ * the current values in the Prometheus text format and then closed, so
+ * "socat - UNIX-CONNECT:<path>" prints them.
+ */
+class MetricsSocket
+{
+public:
+    MetricsSocket(
+        std::string const& path,
+        std::shared_ptr<Registry> const& registry,
+        std::shared_ptr<graphics::EventHandlerRegister> const& main_loop);
+    ~MetricsSocket();
+
+private:
+    void serve_connection();
+
+    std::string const path;
+    std::shared_ptr<Registry> const registry;
+    std::shared_ptr<graphics::EventHandlerRegister> const main_loop;
+    Fd const listener;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_METRICS_SOCKET_H_ */
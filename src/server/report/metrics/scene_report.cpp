@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scene_report.h"
+#include "metrics.h"
+
+namespace mrm = mir::report::metrics;
+
+mrm::SceneReport::SceneReport(
+    std::shared_ptr<scene::SceneReport> const& wrapped,
+    std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    wrapped{wrapped},
+    created_surfaces{registry->counter("mir_scene_surfaces_created_total", "Surfaces created")},
+    surfaces{registry->gauge("mir_scene_surfaces", "Surfaces in the scene")}
+{
+}
+
+void mrm::SceneReport::surface_created(BasicSurfaceId id, std::string const& name)
+{
+    created_surfaces.increment();
+    wrapped->surface_created(id, name);
+}
+
+void mrm::SceneReport::surface_added(BasicSurfaceId id, std::string const& name)
+{
+    surfaces.add(1);
+    wrapped->surface_added(id, name);
+}
+
+void mrm::SceneReport::surface_removed(BasicSurfaceId id, std::string const& name)
+{
+    surfaces.add(-1);
+    wrapped->surface_removed(id, name);
+}
+
+void mrm::SceneReport::surface_deleted(BasicSurfaceId id, std::string const& name)
+{
+    wrapped->surface_deleted(id, name);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "seat_report.h"
+#include "metrics.h"
+
+#include "mir_toolkit/events/event.h"
+#include "mir_toolkit/events/input/input_event.h"
+
+#include <chrono>
+
+namespace mrm = mir::report::metrics;
+
+using namespace std::chrono;
+
+mrm::SeatReport::SeatReport(std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    dispatched_events{registry->counter("mir_input_events_dispatched_total", "Input events dispatched by the seat")},
+    dispatch_latency{registry->histogram(
+        "mir_input_dispatch_latency_us",
+        "Time from an input event's timestamp until the seat dispatches it (includes any queueing)")}
+{
+}
+
+void mrm::SeatReport::seat_add_device(uint64_t)
+{
+}
+
+void mrm::SeatReport::seat_remove_device(uint64_t)
+{
+}
+
+void mrm::SeatReport::seat_dispatch_event(std::shared_ptr<MirEvent const> const& event)
+{
+    dispatched_events.increment();
+
+    if (mir_event_get_type(event.get()) != mir_event_type_input)
+        return;
+
+    // Input event times are taken from CLOCK_MONOTONIC, as is steady_clock
+    nanoseconds const event_time{mir_input_event_get_event_time(mir_event_get_input_event(event.get()))};
+    auto const latency = steady_clock::now().time_since_epoch() - event_time;
+    if (latency > nanoseconds::zero())
+        dispatch_latency.record(duration_cast<microseconds>(latency).count());
+}
+
+void mrm::SeatReport::seat_set_key_state(uint64_t, std::vector<uint32_t> const&)
+{
+}
+
+void mrm::SeatReport::seat_set_pointer_state(uint64_t, unsigned)
+{
+}
+
+void mrm::SeatReport::seat_set_cursor_position(float, float)
+{
+}
+
+void mrm::SeatReport::seat_set_confinement_region_called(geometry::Rectangles const&)
+{
+}
+
+void mrm::SeatReport::seat_reset_confinement_regions()
+{
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "session_mediator_report.h"
+#include "metrics.h"
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+char const* const commits_name = "mir_client_commits_total";
+char const* const commits_help = "Buffers submitted by each connected client";
+}
+
+mrm::SessionMediatorReport::SessionMediatorReport(std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    errors{registry->counter("mir_client_request_errors_total", "Client requests that failed")}
+{
+}
+
+void mrm::SessionMediatorReport::session_connect_called(std::string const& app_name)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& client = clients[app_name];
+    if (client.connections++ == 0)
+        client.commits = &registry->labelled_counter(commits_name, commits_help, "client", app_name);
+}
+
+void mrm::SessionMediatorReport::session_submit_buffer_called(std::string const& app_name)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto const client = clients.find(app_name);
+    if (client != clients.end())
+        client->second.commits->increment();
+}
+
+void mrm::SessionMediatorReport::session_disconnect_called(std::string const& app_name)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto const client = clients.find(app_name);
+    if (client != clients.end() && --client->second.connections == 0)
+    {
+        // Don't let the series of clients that come and go accumulate
+        registry->remove_labelled_counter(commits_name, app_name);
+        clients.erase(client);
+    }
+}
+
+void mrm::SessionMediatorReport::session_error(std::string const&, char const*, std::string const&)
+{
+    errors.increment();
+}
+
+void mrm::SessionMediatorReport::session_create_surface_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_allocate_buffers_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_release_buffers_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_release_surface_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_configure_surface_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_configure_surface_cursor_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_configure_display_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_set_base_display_configuration_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_preview_base_display_configuration_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_confirm_base_display_configuration_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_start_prompt_session_called(std::string const&, pid_t)
+{
+}
+
+void mrm::SessionMediatorReport::session_stop_prompt_session_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_create_buffer_stream_called(std::string const&)
+{
+}
+
+void mrm::SessionMediatorReport::session_release_buffer_stream_called(std::string const&)
+{
+}
@@ -24,10 +24,18 @@ void mrn::CompositorReport::added_display(int, int, int, int, SubCompositorId)
 {
 }
 
+void mrn::CompositorReport::began_scene_snapshot(SubCompositorId)
+{
+}
+
 void mrn::CompositorReport::began_frame(SubCompositorId)
 {
 }
 
+void mrn::CompositorReport::filtered_occlusions(SubCompositorId, std::size_t)
+{
+}
+
 void mrn::CompositorReport::renderables_in_frame(SubCompositorId, mir::graphics::RenderableList const&)
 {
 }
@@ -40,6 +48,19 @@ void mrn::CompositorReport::finished_frame(SubCompositorId)
 {
 }
 
+void mrn::CompositorReport::posted_frame(SubCompositorId)
+{
+}
+
+void mrn::CompositorReport::submitted_buffer(mir::graphics::BufferID)
+{
+}
+
+void mrn::CompositorReport::texture_cache_usage(
+    SubCompositorId, std::size_t, std::size_t, std::size_t, std::size_t, std::size_t)
+{
+}
+
 void mrn::CompositorReport::started()
 {
 }
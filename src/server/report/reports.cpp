@@ -24,11 +24,16 @@
 #include "mir/observer_multiplexer.h"
 #include "mir/options/configuration.h"
 #include "mir/abnormal_exit.h"
+#include "mir/main_loop.h"
 
 #include "report_factory.h"
 #include "lttng_report_factory.h"
 #include "logging_report_factory.h"
 #include "null_report_factory.h"
+#include "metrics/metrics.h"
+#include "metrics/metrics_socket.h"
+#include "metrics/seat_report.h"
+#include "metrics/session_mediator_report.h"
 
 #include <string>
 
@@ -135,9 +140,26 @@ mir::report::Reports::Reports(
           create_session_mediator_reports(
               server,
               options.get<std::string>(mo::session_mediator_report_opt))},
-      session_mediator_observer_multiplexer{server.the_session_mediator_observer_registrar()}
+      session_mediator_observer_multiplexer{server.the_session_mediator_observer_registrar()},
+      metrics_registry{server.the_metrics_registry()},
+      seat_metrics{metrics_registry ? std::make_shared<metrics::SeatReport>(metrics_registry) : nullptr},
+      session_mediator_metrics{
+          metrics_registry ? std::make_shared<metrics::SessionMediatorReport>(metrics_registry) : nullptr},
+      metrics_socket{
+          metrics_registry ?
+              std::make_unique<metrics::MetricsSocket>(
+                  options.get<std::string>(mo::metrics_socket_opt), metrics_registry, server.the_main_loop()) :
+              nullptr}
 {
     display_configuration_multiplexer->register_interest(display_configuration_report);
     seat_observer_multiplexer->register_interest(seat_report);
     session_mediator_observer_multiplexer->register_interest(session_mediator_report);
+
+    if (metrics_registry)
+    {
+        seat_observer_multiplexer->register_interest(seat_metrics);
+        session_mediator_observer_multiplexer->register_interest(session_mediator_metrics);
+    }
 }
+
+mir::report::Reports::~Reports() = default;
@@ -52,6 +52,11 @@ namespace logging
 {
 class DisplayConfigurationReport;
 }
+namespace metrics
+{
+class Registry;
+class MetricsSocket;
+}
 
 class ReportFactory;
 
@@ -59,6 +64,7 @@ class Reports
 {
 public:
     Reports(DefaultServerConfiguration& server, options::Option const& options);
+    ~Reports();
 
 private:
     std::shared_ptr<logging::DisplayConfigurationReport> const display_configuration_report;
@@ -68,6 +74,10 @@ private:
     std::shared_ptr<frontend::SessionMediatorObserver> const session_mediator_report;
     std::shared_ptr<ObserverRegistrar<frontend::SessionMediatorObserver>> const
         session_mediator_observer_multiplexer;
+    std::shared_ptr<metrics::Registry> const metrics_registry;
+    std::shared_ptr<input::SeatObserver> const seat_metrics;
+    std::shared_ptr<frontend::SessionMediatorObserver> const session_mediator_metrics;
+    std::unique_ptr<metrics::MetricsSocket> const metrics_socket;
 };
 }
 }
@@ -30,6 +30,7 @@
 
 #include "mir/scene/scene_report.h"
 #include "mir/scene/null_surface_observer.h"
+#include "deferred_scene_changes.h"
 
 #include <boost/throw_exception.hpp>
 
@@ -47,68 +48,114 @@ namespace mf = mir::frontend;
 namespace geom = mir::geometry;
 namespace mrs = mir::renderer::software;
 
+namespace
+{
+/// Within a SceneChangeTransaction, notify a surface's held back geometry ahead of any
+/// other change to it, so observers (e.g. clients being sent a configure) see the two in order.
+void notify_pending_geometry(ms::SurfaceObservers& observers, ms::Surface const* surf)
+{
+    mir::optional_value<geom::Size> size;
+    mir::optional_value<geom::Point> top_left;
+
+    if (!ms::deferred_scene_changes::take_pending_geometry(&observers, surf, size, top_left))
+        return;
+
+    if (size.is_set())
+    {
+        observers.for_each([&](std::shared_ptr<ms::SurfaceObserver> const& observer)
+            { observer->resized_to(surf, size.value()); });
+    }
+
+    if (top_left.is_set())
+    {
+        observers.for_each([&](std::shared_ptr<ms::SurfaceObserver> const& observer)
+            { observer->moved_to(surf, top_left.value()); });
+    }
+}
+}
+
 void ms::SurfaceObservers::attrib_changed(Surface const* surf, MirWindowAttrib attrib, int value)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->attrib_changed(surf, attrib, value); });
 }
 
+ms::SurfaceObservers::~SurfaceObservers()
+{
+    deferred_scene_changes::discard(this);
+}
+
 void ms::SurfaceObservers::resized_to(Surface const* surf, geometry::Size const& size)
 {
+    if (deferred_scene_changes::defer_resize(this, surf, size))
+        return;
+
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->resized_to(surf, size); });
 }
 
 void ms::SurfaceObservers::moved_to(Surface const* surf, geometry::Point const& top_left)
 {
+    if (deferred_scene_changes::defer_move(this, surf, top_left))
+        return;
+
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->moved_to(surf, top_left); });
 }
 
 void ms::SurfaceObservers::hidden_set_to(Surface const* surf, bool hide)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->hidden_set_to(surf, hide); });
 }
 
 void ms::SurfaceObservers::frame_posted(Surface const* surf, int frames_available, geometry::Size const& size)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->frame_posted(surf, frames_available, size); });
 }
 
 void ms::SurfaceObservers::alpha_set_to(Surface const* surf, float alpha)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->alpha_set_to(surf, alpha); });
 }
 
 void ms::SurfaceObservers::orientation_set_to(Surface const* surf, MirOrientation orientation)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->orientation_set_to(surf, orientation); });
 }
 
 void ms::SurfaceObservers::transformation_set_to(Surface const* surf, glm::mat4 const& t)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->transformation_set_to(surf, t); });
 }
 
 void ms::SurfaceObservers::cursor_image_set_to(Surface const* surf, graphics::CursorImage const& image)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->cursor_image_set_to(surf, image); });
 }
 
 void ms::SurfaceObservers::reception_mode_set_to(Surface const* surf, input::InputReceptionMode mode)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->reception_mode_set_to(surf, mode); });
 }
 
 void ms::SurfaceObservers::client_surface_close_requested(Surface const* surf)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&surf](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->client_surface_close_requested(surf); });
 }
@@ -119,36 +166,42 @@ void ms::SurfaceObservers::keymap_changed(
     std::string const& variant,
     std::string const& options)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->keymap_changed(surf, id, model, layout, variant, options); });
 }
 
 void ms::SurfaceObservers::renamed(Surface const* surf, char const* name)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&surf, name](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->renamed(surf, name); });
 }
 
 void ms::SurfaceObservers::cursor_image_removed(Surface const* surf)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&surf](std::shared_ptr<SurfaceObserver> const& observer)
         { observer->cursor_image_removed(surf); });
 }
 
 void ms::SurfaceObservers::placed_relative(Surface const* surf, geometry::Rectangle const& placement)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
                  { observer->placed_relative(surf, placement); });
 }
 
 void ms::SurfaceObservers::input_consumed(Surface const* surf, MirEvent const* event)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
                  { observer->input_consumed(surf, event); });
 }
 
 void ms::SurfaceObservers::start_drag_and_drop(Surface const* surf, std::vector<uint8_t> const& handle)
 {
+    notify_pending_geometry(*this, surf);
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
                  { observer->start_drag_and_drop(surf, handle); });
 }
@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_DEFERRED_SCENE_CHANGES_H_
+#define MIR_SCENE_DEFERRED_SCENE_CHANGES_H_
+
+#include "mir/geometry/point.h"
+#include "mir/geometry/size.h"
+#include "mir/optional_value.h"
+
+namespace mir
+{
+namespace scene
+{
+class Observers;
+class Surface;
+class SurfaceObservers;
+
+/// Notifications held back by an open SceneChangeTransaction.
+/// The defer_*() functions return false if there is no transaction open on the calling
+/// thread, in which case the caller should notify immediately.
+namespace deferred_scene_changes
+{
+bool defer_move(SurfaceObservers* observers, Surface const* surface, geometry::Point const& top_left);
+bool defer_resize(SurfaceObservers* observers, Surface const* surface, geometry::Size const& size);
+bool defer_reorder(Observers* observers);
+bool defer_scene_change(Observers* observers);
+
+/// Take the geometry held back for surface, so it can be notified ahead of some other
+/// change to the surface. Returns false if there is none.
+bool take_pending_geometry(
+    SurfaceObservers* observers,
+    Surface const* surface,
+    optional_value<geometry::Size>& size,
+    optional_value<geometry::Point>& top_left);
+
+/// Drop anything pending for observers that are going away
+void discard(SurfaceObservers* observers);
+void discard(Observers* observers);
+}
+}
+}
+
+#endif /* MIR_SCENE_DEFERRED_SCENE_CHANGES_H_ */
@@ -0,0 +1,248 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/scene/scene_change_transaction.h"
+#include "mir/scene/surface_observers.h"
+#include "mir/optional_value.h"
+
+#include "deferred_scene_changes.h"
+#include "surface_stack.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+
+namespace
+{
+struct PendingGeometry
+{
+    mir::optional_value<geom::Point> top_left;
+    mir::optional_value<geom::Size> size;
+};
+
+using SurfaceKey = std::pair<ms::SurfaceObservers*, ms::Surface const*>;
+
+struct Changes
+{
+    std::map<SurfaceKey, PendingGeometry> surfaces;
+    std::vector<ms::Observers*> reordered;
+    std::vector<ms::Observers*> changed;
+};
+
+class Pending;
+
+// The pending changes of every thread that has used a transaction, so that observers
+// destroyed on one thread are discarded from all. Only touched when a thread starts or
+// finishes using transactions, and when observers are destroyed.
+std::mutex threads_mutex;
+std::set<Pending*> threads;
+
+// The changes held back by the calling thread's open transaction
+class Pending
+{
+public:
+    Pending()
+    {
+        std::lock_guard<std::mutex> lock{threads_mutex};
+        threads.insert(this);
+    }
+
+    ~Pending()
+    {
+        std::lock_guard<std::mutex> lock{threads_mutex};
+        threads.erase(this);
+    }
+
+    // Only contended by observers being destroyed on other threads
+    std::mutex mutex;
+    Changes changes;
+};
+
+thread_local int transaction_depth{0};
+
+// Constructed on first use, so threads that never open a transaction aren't registered
+auto pending() -> Pending&
+{
+    thread_local Pending pending;
+    return pending;
+}
+
+auto take_changes() -> Changes
+{
+    auto& mine = pending();
+    std::lock_guard<std::mutex> lock{mine.mutex};
+
+    Changes changes;
+    std::swap(changes, mine.changes);
+    return changes;
+}
+
+void add_once(std::vector<ms::Observers*>& pending, ms::Observers* observers)
+{
+    if (std::find(begin(pending), end(pending), observers) == end(pending))
+        pending.push_back(observers);
+}
+
+void remove(std::vector<ms::Observers*>& pending, ms::Observers* observers)
+{
+    pending.erase(std::remove(begin(pending), end(pending), observers), end(pending));
+}
+}
+
+ms::SceneChangeTransaction::SceneChangeTransaction()
+{
+    ++transaction_depth;
+}
+
+ms::SceneChangeTransaction::~SceneChangeTransaction()
+{
+    if (committed || --transaction_depth != 0)
+        return;
+
+    // Abandoned, most likely by an exception: the changes stand, but there's no notifying from here
+    take_changes();
+}
+
+void ms::SceneChangeTransaction::commit()
+{
+    if (committed)
+        return;
+
+    committed = true;
+    if (--transaction_depth != 0)
+        return;
+
+    auto const changes = take_changes();
+
+    for (auto const& change : changes.surfaces)
+    {
+        auto const observers = change.first.first;
+        auto const surface = change.first.second;
+
+        if (change.second.size.is_set())
+            observers->resized_to(surface, change.second.size.value());
+
+        if (change.second.top_left.is_set())
+            observers->moved_to(surface, change.second.top_left.value());
+    }
+
+    for (auto const observers : changes.reordered)
+        observers->surfaces_reordered();
+
+    for (auto const observers : changes.changed)
+        observers->scene_changed();
+}
+
+bool ms::deferred_scene_changes::defer_move(
+    SurfaceObservers* observers, Surface const* surface, geometry::Point const& top_left)
+{
+    if (!transaction_depth)
+        return false;
+
+    auto& mine = pending();
+    std::lock_guard<std::mutex> lock{mine.mutex};
+    mine.changes.surfaces[{observers, surface}].top_left = top_left;
+    return true;
+}
+
+bool ms::deferred_scene_changes::defer_resize(
+    SurfaceObservers* observers, Surface const* surface, geometry::Size const& size)
+{
+    if (!transaction_depth)
+        return false;
+
+    auto& mine = pending();
+    std::lock_guard<std::mutex> lock{mine.mutex};
+    mine.changes.surfaces[{observers, surface}].size = size;
+    return true;
+}
+
+bool ms::deferred_scene_changes::defer_reorder(Observers* observers)
+{
+    if (!transaction_depth)
+        return false;
+
+    auto& mine = pending();
+    std::lock_guard<std::mutex> lock{mine.mutex};
+    add_once(mine.changes.reordered, observers);
+    return true;
+}
+
+bool ms::deferred_scene_changes::defer_scene_change(Observers* observers)
+{
+    if (!transaction_depth)
+        return false;
+
+    auto& mine = pending();
+    std::lock_guard<std::mutex> lock{mine.mutex};
+    add_once(mine.changes.changed, observers);
+    return true;
+}
+
+bool ms::deferred_scene_changes::take_pending_geometry(
+    SurfaceObservers* observers,
+    Surface const* surface,
+    optional_value<geometry::Size>& size,
+    optional_value<geometry::Point>& top_left)
+{
+    if (!transaction_depth)
+        return false;
+
+    auto& mine = pending();
+    std::lock_guard<std::mutex> lock{mine.mutex};
+    auto const existing = mine.changes.surfaces.find({observers, surface});
+    if (existing == mine.changes.surfaces.end())
+        return false;
+
+    size = existing->second.size;
+    top_left = existing->second.top_left;
+    mine.changes.surfaces.erase(existing);
+    return true;
+}
+
+void ms::deferred_scene_changes::discard(SurfaceObservers* observers)
+{
+    std::lock_guard<std::mutex> lock{threads_mutex};
+
+    for (auto const thread : threads)
+    {
+        std::lock_guard<std::mutex> thread_lock{thread->mutex};
+        auto& surfaces = thread->changes.surfaces;
+
+        // Keyed by observers first, so their surfaces are together
+        auto i = surfaces.lower_bound({observers, nullptr});
+        while (i != surfaces.end() && i->first.first == observers)
+            i = surfaces.erase(i);
+    }
+}
+
+void ms::deferred_scene_changes::discard(Observers* observers)
+{
+    std::lock_guard<std::mutex> lock{threads_mutex};
+
+    for (auto const thread : threads)
+    {
+        std::lock_guard<std::mutex> thread_lock{thread->mutex};
+        remove(thread->changes.reordered, observers);
+        remove(thread->changes.changed, observers);
+    }
+}
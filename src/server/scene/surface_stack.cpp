@@ -20,6 +20,7 @@
 
 #include "surface_stack.h"
 #include "rendering_tracker.h"
+#include "deferred_scene_changes.h"
 #include "mir/scene/surface.h"
 #include "mir/scene/scene_report.h"
 #include "mir/compositor/scene_element.h"
@@ -398,14 +399,25 @@ void ms::Observers::surface_removed(ms::Surface* surface)
         { observer->surface_removed(surface); });
 }
 
+ms::Observers::~Observers()
+{
+    deferred_scene_changes::discard(this);
+}
+
 void ms::Observers::surfaces_reordered()
 {
+    if (deferred_scene_changes::defer_reorder(this))
+        return;
+
     for_each([&](std::shared_ptr<Observer> const& observer)
         { observer->surfaces_reordered(); });
 }
 
 void ms::Observers::scene_changed()
 {
+    if (deferred_scene_changes::defer_scene_change(this))
+        return;
+
    for_each([&](std::shared_ptr<Observer> const& observer)
         { observer->scene_changed(); });
 }
@@ -52,6 +52,8 @@ class RenderingTracker;
 class Observers : public Observer, BasicObservers<Observer>
 {
 public:
+   ~Observers();
+
    // ms::Observer
    void surface_added(Surface* surface) override;
    void surface_removed(Surface* surface) override;
@@ -33,6 +33,7 @@
 #include "mir/main_loop.h"
 #include "mir/report_exception.h"
 #include "mir/run_mir.h"
+#include "mir/startup_phase_tracker.h"
 #include "mir/cookie/authority.h"
 
 // TODO these are used to frig a stub renderer when running headless
@@ -409,10 +410,29 @@ void mir::Server::run()
 
         self->pre_init_callback();
 
+        auto const startup_phases = self->server_config->the_startup_phase_tracker();
+        auto construct_phase = startup_phases->phase("construct display server");
+        std::unique_ptr<StartupPhaseTracker::Phase> start_phase;
+
         run_mir(
             *self->server_config,
             [&](DisplayServer&)
-                { self->init_callback(); self->init_callback = []{}; },
+                {
+                    construct_phase.reset();
+                    self->init_callback(); self->init_callback = []{};
+
+                    // The main loop only dispatches once every subsystem has been started
+                    start_phase = startup_phases->phase("start display server");
+                    auto const report = self->server_config->the_options()->get<std::string>(
+                        options::startup_report_opt) == options::log_opt_value;
+                    self->server_config->the_main_loop()->enqueue(
+                        this,
+                        [startup_phases, report, &start_phase]
+                        {
+                            start_phase.reset();
+                            if (report) startup_phases->log_report();
+                        });
+                },
             self->terminator);
 
         self->exit_status = true;
@@ -22,6 +22,7 @@
 
 #include "mir/input/composite_event_filter.h"
 #include "mir/shell/abstract_shell.h"
+#include "mir/startup_phase_tracker.h"
 #include "default_persistent_surface_store.h"
 #include "frontend_shell.h"
 #include "graphics_display_layout.h"
@@ -35,6 +36,7 @@ auto mir::DefaultServerConfiguration::the_shell() -> std::shared_ptr<msh::Shell>
 {
     return shell([this]
         {
+            auto const phase = startup_phase_tracker->phase("the_shell");
             auto const result = wrap_shell(std::make_shared<msh::AbstractShell>(
                 the_input_targeter(),
                 the_surface_stack(),
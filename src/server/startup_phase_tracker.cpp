@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_phase_tracker.h"
+
+#define MIR_LOG_COMPONENT "startup"
+#include "mir/log.h"
+
+#include <algorithm>
+
+namespace
+{
+auto as_ms(std::chrono::steady_clock::duration duration) -> double
+{
+    return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(duration).count();
+}
+}
+
+mir::StartupPhaseTracker::Phase::Phase(StartupPhaseTracker& tracker, std::string const& name) :
+    tracker{tracker},
+    started{Clock::now()},
+    index{tracker.begin(name, started)}
+{
+}
+
+mir::StartupPhaseTracker::Phase::~Phase()
+{
+    tracker.end(index, Clock::now() - started);
+}
+
+mir::StartupPhaseTracker::StartupPhaseTracker() :
+    created{Clock::now()}
+{
+}
+
+auto mir::StartupPhaseTracker::phase(std::string const& name) -> std::unique_ptr<Phase>
+{
+    return std::make_unique<Phase>(*this, name);
+}
+
+auto mir::StartupPhaseTracker::begin(std::string const& name, Clock::time_point started) -> std::size_t
+{
+    auto const thread = std::this_thread::get_id();
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    auto const depth = std::count_if(
+        open_phases.begin(), open_phases.end(), [thread](auto const& open) { return open.thread == thread; });
+
+    phases.push_back(Record{name, started - created, Clock::duration::zero(), static_cast<int>(depth)});
+    open_phases.push_back(OpenPhase{phases.size() - 1, thread});
+    return phases.size() - 1;
+}
+
+void mir::StartupPhaseTracker::end(std::size_t index, Clock::duration duration)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    phases[index].duration = duration;
+
+    // The phase may end on a different thread from the one it began on
+    open_phases.erase(
+        std::remove_if(
+            open_phases.begin(), open_phases.end(), [index](auto const& open) { return open.index == index; }),
+        open_phases.end());
+}
+
+auto mir::StartupPhaseTracker::records() const -> std::vector<Record>
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    return phases;
+}
+
+void mir::StartupPhaseTracker::log_report() const
+{
+    auto const phases = records();
+
+    log_info("Startup phases (%.3fms since configuration):", as_ms(Clock::now() - created));
+
+    for (auto const& phase : phases)
+    {
+        log_info(
+            "%*s%s: %.3fms (at +%.3fms)",
+            2*phase.depth, "",
+            phase.name.c_str(),
+            as_ms(phase.duration),
+            as_ms(phase.start));
+    }
+}
@@ -35,14 +35,25 @@ public:
     MOCK_METHOD5(added_display,
                  void(int,int,int,int,
                       compositor::CompositorReport::SubCompositorId));
+    MOCK_METHOD1(began_scene_snapshot,
+                 void(compositor::CompositorReport::SubCompositorId));
     MOCK_METHOD1(began_frame,
                  void(compositor::CompositorReport::SubCompositorId));
+    MOCK_METHOD2(filtered_occlusions,
+                 void(compositor::CompositorReport::SubCompositorId, std::size_t));
     MOCK_METHOD2(renderables_in_frame,
                  void(compositor::CompositorReport::SubCompositorId, graphics::RenderableList const&));
     MOCK_METHOD1(rendered_frame,
                  void(compositor::CompositorReport::SubCompositorId));
     MOCK_METHOD1(finished_frame,
                  void(compositor::CompositorReport::SubCompositorId));
+    MOCK_METHOD1(posted_frame,
+                 void(compositor::CompositorReport::SubCompositorId));
+    MOCK_METHOD1(submitted_buffer,
+                 void(graphics::BufferID));
+    MOCK_METHOD6(texture_cache_usage,
+                 void(compositor::CompositorReport::SubCompositorId,
+                      std::size_t, std::size_t, std::size_t, std::size_t, std::size_t));
     MOCK_METHOD0(started, void());
     MOCK_METHOD0(stopped, void());
     MOCK_METHOD0(scheduled, void());
@@ -48,6 +48,7 @@ struct MockMirBufferStream : public MirBufferStream
     MOCK_METHOD1(adopted_by, void(MirWindow*));
     MOCK_METHOD1(unadopted_by, void(MirWindow*));
     MOCK_CONST_METHOD0(microseconds_till_vblank, std::chrono::microseconds());
+    MOCK_CONST_METHOD0(predicted_present_time, std::chrono::nanoseconds());
     MOCK_METHOD0(platform_type, MirPlatformType(void));
     MOCK_METHOD0(get_current_buffer_package, MirNativeBuffer*(void));
     MOCK_METHOD0(get_create_wait_handle, MirWaitHandle*(void));
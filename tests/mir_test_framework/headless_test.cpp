@@ -19,6 +19,7 @@
 #include "mir_test_framework/headless_test.h"
 #include "mir_test_framework/stub_server_platform_factory.h"
 #include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "mir_test_framework/virtual_output_platform.h"
 
 #include "mir/shared_library.h"
 #include "mir/geometry/rectangle.h"
@@ -52,3 +53,13 @@ void mtf::HeadlessTest::initial_display_layout(std::vector<geom::Rectangle> cons
 {
     mtf::set_next_display_rects(std::unique_ptr<std::vector<geom::Rectangle>>(new std::vector<geom::Rectangle>(display_rects)));
 }
+
+void mtf::HeadlessTest::use_virtual_outputs(VirtualOutputs const& outputs)
+{
+    add_to_environment("MIR_SERVER_PLATFORM_GRAPHICS_LIB", mtf::server_platform("graphics-virtual.so").c_str());
+    add_to_environment("MIR_SERVER_VIRTUAL_OUTPUTS", outputs.sizes.c_str());
+    add_to_environment("MIR_SERVER_VIRTUAL_OUTPUT_REFRESH_RATE", std::to_string(outputs.refresh_rate_hz).c_str());
+    add_to_environment("MIR_SERVER_VIRTUAL_OUTPUT_FLIP_LATENCY", std::to_string(outputs.flip_latency.count()).c_str());
+    add_to_environment("MIR_SERVER_VIRTUAL_OUTPUT_FLIP_JITTER", std::to_string(outputs.flip_jitter.count()).c_str());
+    add_to_environment("MIR_SERVER_VIRTUAL_OUTPUT_MODESET_TIME", std::to_string(outputs.modeset_time.count()).c_str());
+}
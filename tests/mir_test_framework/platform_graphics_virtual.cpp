@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "virtual_output_graphics_platform.h"
+
+#include "mir/assert_module_entry_point.h"
+#include "mir/options/option.h"
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/value_semantic.hpp>
+
+namespace mg = mir::graphics;
+namespace mo = mir::options;
+namespace mtf = mir_test_framework;
+namespace po = boost::program_options;
+
+namespace
+{
+char const* const outputs_option{"virtual-outputs"};
+char const* const refresh_rate_option{"virtual-output-refresh-rate"};
+char const* const flip_latency_option{"virtual-output-flip-latency"};
+char const* const flip_jitter_option{"virtual-output-flip-jitter"};
+char const* const modeset_time_option{"virtual-output-modeset-time"};
+
+// Outlives any platform so that frames can be collected after the server stops
+auto const frame_log = std::make_shared<mtf::VirtualOutputFrameLog>();
+}
+
+mir::UniqueModulePtr<mg::Platform> create_host_platform(
+    std::shared_ptr<mo::Option> const& options,
+    std::shared_ptr<mir::EmergencyCleanupRegistry> const&,
+    std::shared_ptr<mir::ConsoleServices> const&,
+    std::shared_ptr<mg::DisplayReport> const&,
+    std::shared_ptr<mir::logging::Logger> const&)
+{
+    mir::assert_entry_point_signature<mg::CreateHostPlatform>(&create_host_platform);
+
+    mtf::VirtualOutputs outputs;
+    outputs.sizes = options->get<std::string>(outputs_option);
+    outputs.refresh_rate_hz = options->get<double>(refresh_rate_option);
+    outputs.flip_latency = std::chrono::microseconds{options->get<int>(flip_latency_option)};
+    outputs.flip_jitter = std::chrono::microseconds{options->get<int>(flip_jitter_option)};
+    outputs.modeset_time = std::chrono::milliseconds{options->get<int>(modeset_time_option)};
+
+    if (outputs.refresh_rate_hz <= 0)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Virtual output refresh rate must be positive"));
+
+    return mir::make_module_ptr<mtf::VirtualOutputPlatform>(outputs, frame_log);
+}
+
+void add_graphics_platform_options(po::options_description& config)
+{
+    mir::assert_entry_point_signature<mg::AddPlatformOptions>(&add_graphics_platform_options);
+
+    mtf::VirtualOutputs const defaults;
+
+    config.add_options()
+        (outputs_option,
+         po::value<std::string>()->default_value(defaults.sizes),
+         "[platform-specific] Comma separated sizes of the virtual outputs (e.g. 1920x1080,1280x720).")
+        (refresh_rate_option,
+         po::value<double>()->default_value(defaults.refresh_rate_hz),
+         "[platform-specific] Refresh rate of the virtual outputs in Hz.")
+        (flip_latency_option,
+         po::value<int>()->default_value(defaults.flip_latency.count()),
+         "[platform-specific] Minimum time in microseconds from posting a frame to it being presented.")
+        (flip_jitter_option,
+         po::value<int>()->default_value(defaults.flip_jitter.count()),
+         "[platform-specific] Maximum random variation in microseconds of presentation times.")
+        (modeset_time_option,
+         po::value<int>()->default_value(defaults.modeset_time.count()),
+         "[platform-specific] Time in milliseconds a reconfiguration that changes any output takes.");
+}
+
+#if defined(__clang__)
+#pragma clang diagnostic push
+// This function is given "C" linkage to avoid name-mangling, not for C compatibility.
+#pragma clang diagnostic ignored "-Wreturn-type-c-linkage"
+#endif
+extern "C" auto take_virtual_output_frames() -> std::vector<mtf::VirtualOutputFrame>
+{
+    return frame_log->take();
+}
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#endif
@@ -24,6 +24,7 @@
 #include "mir_test_framework/executable_path.h"
 #include "mir_test_framework/stub_server_platform_factory.h"
 #include "mir_test_framework/fake_input_device.h"
+#include "mir_test_framework/virtual_output_platform.h"
 
 #include <vector>
 
@@ -37,6 +38,7 @@ namespace
 //       issues around global destructor ordering.
 mir::SharedLibrary* platform_graphics_lib{nullptr};
 mir::SharedLibrary* platform_input_lib{nullptr};
+mir::SharedLibrary* platform_virtual_lib{nullptr};
 
 void ensure_platform_library()
 {
@@ -94,3 +96,16 @@ mir::UniqueModulePtr<mtf::FakeInputDevice> mtf::add_fake_input_device(mir::input
 
     return add_device(info);
 }
+
+auto mtf::take_virtual_output_frames() -> std::vector<VirtualOutputFrame>
+{
+    if (!platform_virtual_lib)
+    {
+        platform_virtual_lib = new mir::SharedLibrary{mtf::server_platform("graphics-virtual.so")};
+    }
+
+    auto take_frames = platform_virtual_lib->load_function<std::vector<VirtualOutputFrame>(*)()>(
+        "take_virtual_output_frames");
+
+    return take_frames();
+}
@@ -0,0 +1,371 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "virtual_output_graphics_platform.h"
+
+#include "mir_test_framework/stub_platform_helpers.h"
+#include "mir_test_framework/stub_platform_native_buffer.h"
+
+#include "mir/graphics/buffer_ipc_message.h"
+#include "mir/graphics/display_configuration.h"
+#include "mir/graphics/platform_ipc_package.h"
+#include "mir/test/doubles/null_display.h"
+#include "mir/test/doubles/stub_buffer_allocator.h"
+#include "mir/test/doubles/stub_display_buffer.h"
+#include "mir/test/doubles/stub_display_configuration.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace geom = mir::geometry;
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono;
+
+namespace
+{
+/// A single output, presenting each posted frame on a simulated vblank
+class VirtualOutputSyncGroup : public mg::DisplaySyncGroup
+{
+public:
+    VirtualOutputSyncGroup(
+        unsigned int output_id,
+        geom::Rectangle const& view_area,
+        mtf::VirtualOutputs const& params,
+        std::shared_ptr<mtf::VirtualOutputFrameLog> const& frame_log) :
+        output_id{output_id},
+        view_area{view_area},
+        period{static_cast<nanoseconds::rep>(1e9 / params.refresh_rate_hz)},
+        flip_latency{params.flip_latency},
+        flip_jitter{params.flip_jitter},
+        frame_log{frame_log},
+        jitter_source{output_id},
+        epoch{steady_clock::now()},
+        buffer{view_area}
+    {
+    }
+
+    void for_each_display_buffer(std::function<void(mg::DisplayBuffer&)> const& f) override
+    {
+        f(buffer);
+    }
+
+    void post() override
+    {
+        auto const posted = steady_clock::now();
+
+        // The frame is flipped on the first vblank after the flip latency...
+        auto const ready = duration_cast<nanoseconds>(posted + flip_latency - epoch);
+        auto vblank = (ready.count() + period.count() - 1) / period.count();
+        if (vblank <= msc)
+            vblank = msc + 1;
+
+        // ...but the time it is reported as presented wobbles a little
+        auto presented = epoch + vblank * period;
+        if (flip_jitter.count() > 0)
+        {
+            std::uniform_int_distribution<microseconds::rep> jitter{-flip_jitter.count(), flip_jitter.count()};
+            presented += microseconds{jitter(jitter_source)};
+        }
+
+        std::this_thread::sleep_until(presented);
+
+        std::lock_guard<std::mutex> lock{mutex};
+        msc = vblank;
+        last_presented = presented;
+        frame_log->record({output_id, msc, posted, presented});
+    }
+
+    milliseconds recommended_sleep() const override
+    {
+        return milliseconds::zero();
+    }
+
+    auto last_frame() const -> mg::Frame
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+
+        mg::Frame frame;
+        frame.msc = msc;
+        frame.ust = mir::time::PosixTimestamp{CLOCK_MONOTONIC, duration_cast<nanoseconds>(last_presented.time_since_epoch())};
+        return frame;
+    }
+
+    unsigned int const output_id;
+    geom::Rectangle const view_area;
+
+private:
+    nanoseconds const period;
+    microseconds const flip_latency;
+    microseconds const flip_jitter;
+    std::shared_ptr<mtf::VirtualOutputFrameLog> const frame_log;
+    std::minstd_rand jitter_source;
+    steady_clock::time_point const epoch;
+    mtd::StubDisplayBuffer buffer;
+
+    std::mutex mutable mutex;
+    int64_t msc{0};
+    steady_clock::time_point last_presented;
+};
+
+class VirtualOutputDisplay : public mtd::NullDisplay
+{
+public:
+    VirtualOutputDisplay(
+        mtf::VirtualOutputs const& params,
+        std::shared_ptr<mtf::VirtualOutputFrameLog> const& frame_log) :
+        params{params},
+        frame_log{frame_log},
+        config{std::make_shared<mtd::StubDisplayConfig>(mtf::virtual_output_rects(params.sizes))}
+    {
+        for (auto& output : config->outputs)
+        {
+            for (auto& mode : output.modes)
+                mode.vrefresh_hz = params.refresh_rate_hz;
+        }
+
+        create_groups();
+    }
+
+    void for_each_display_sync_group(std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        std::lock_guard<std::mutex> lock{configuration_mutex};
+        for (auto& group : groups)
+            f(*group);
+    }
+
+    std::unique_ptr<mg::DisplayConfiguration> configuration() const override
+    {
+        std::lock_guard<std::mutex> lock{configuration_mutex};
+        return std::make_unique<mtd::StubDisplayConfig>(*config);
+    }
+
+    bool apply_if_configuration_preserves_display_buffers(mg::DisplayConfiguration const&) override
+    {
+        return false;
+    }
+
+    void for_each_display_sync_group_preserved_by(
+        mg::DisplayConfiguration const& new_config,
+        std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        std::lock_guard<std::mutex> lock{configuration_mutex};
+        for (auto& group : groups)
+        {
+            if (is_preserved_by(new_config, *group))
+                f(*group);
+        }
+    }
+
+    void configure(mg::DisplayConfiguration const& new_config) override
+    {
+        // The simulated modeset doesn't hold up the outputs left unchanged
+        if (changes_outputs(new_config))
+            std::this_thread::sleep_for(params.modeset_time);
+
+        std::lock_guard<std::mutex> lock{configuration_mutex};
+        config = std::make_shared<mtd::StubDisplayConfig>(new_config);
+        create_groups();
+    }
+
+    mg::Frame last_frame_on(unsigned output_id) const override
+    {
+        std::lock_guard<std::mutex> lock{configuration_mutex};
+        for (auto const& group : groups)
+        {
+            if (group->output_id == output_id)
+                return group->last_frame();
+        }
+        return {};
+    }
+
+private:
+    static bool is_preserved_by(mg::DisplayConfiguration const& new_config, VirtualOutputSyncGroup const& group)
+    {
+        bool preserved{false};
+        new_config.for_each_output([&](mg::DisplayConfigurationOutput const& output)
+            {
+                if (static_cast<unsigned int>(output.id.as_value()) == group.output_id)
+                    preserved = output.connected && output.used && output.extents() == group.view_area;
+            });
+        return preserved;
+    }
+
+    bool changes_outputs(mg::DisplayConfiguration const& new_config) const
+    {
+        std::lock_guard<std::mutex> lock{configuration_mutex};
+
+        size_t used_outputs{0};
+        new_config.for_each_output([&](mg::DisplayConfigurationOutput const& output)
+            {
+                if (output.connected && output.used)
+                    ++used_outputs;
+            });
+
+        return used_outputs != groups.size() ||
+            std::any_of(begin(groups), end(groups), [&](std::unique_ptr<VirtualOutputSyncGroup> const& group)
+                { return !is_preserved_by(new_config, *group); });
+    }
+
+    // Outputs that are unchanged keep their group, as compositing may not have stopped on it
+    void create_groups()
+    {
+        std::vector<std::unique_ptr<VirtualOutputSyncGroup>> previous;
+        swap(previous, groups);
+
+        config->for_each_output([&](mg::DisplayConfigurationOutput const& output)
+            {
+                if (!output.connected || !output.used)
+                    return;
+
+                auto const existing = std::find_if(begin(previous), end(previous),
+                    [&](std::unique_ptr<VirtualOutputSyncGroup> const& group)
+                    {
+                        return group && group->output_id == static_cast<unsigned int>(output.id.as_value()) &&
+                            group->view_area == output.extents();
+                    });
+
+                if (existing != end(previous))
+                {
+                    groups.push_back(std::move(*existing));
+                }
+                else
+                {
+                    groups.push_back(std::make_unique<VirtualOutputSyncGroup>(
+                        output.id.as_value(), output.extents(), params, frame_log));
+                }
+            });
+    }
+
+    mtf::VirtualOutputs const params;
+    std::shared_ptr<mtf::VirtualOutputFrameLog> const frame_log;
+
+    std::mutex mutable configuration_mutex;
+    std::shared_ptr<mtd::StubDisplayConfig> config;
+    std::vector<std::unique_ptr<VirtualOutputSyncGroup>> groups;
+};
+
+class VirtualOutputIpcOps : public mg::PlatformIpcOperations
+{
+    void pack_buffer(
+        mg::BufferIpcMessage& message,
+        mg::Buffer const& buffer,
+        mg::BufferIpcMsgType msg_type) const override
+    {
+        if (msg_type == mg::BufferIpcMsgType::full_msg)
+        {
+            auto native_handle = std::dynamic_pointer_cast<mtf::NativeBuffer>(buffer.native_buffer_handle());
+            if (!native_handle)
+                BOOST_THROW_EXCEPTION(std::invalid_argument("could not convert NativeBuffer"));
+            message.pack_data(static_cast<int>(native_handle->properties.usage));
+            message.pack_data(native_handle->data);
+            message.pack_fd(native_handle->fd);
+            message.pack_stride(
+                geom::Stride{buffer.size().width.as_int() * MIR_BYTES_PER_PIXEL(buffer.pixel_format())});
+            message.pack_size(buffer.size());
+        }
+    }
+
+    void unpack_buffer(mg::BufferIpcMessage&, mg::Buffer const&) const override
+    {
+    }
+
+    std::shared_ptr<mg::PlatformIPCPackage> connection_ipc_package() override
+    {
+        // Clients see the same package as from the stub platform, so use the stub client platform
+        auto package = std::make_shared<mg::PlatformIPCPackage>(describe_graphics_module());
+        mtf::pack_stub_ipc_package(*package);
+        return package;
+    }
+
+    mg::PlatformOperationMessage platform_operation(
+         unsigned int const, mg::PlatformOperationMessage const&) override
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Invalid platform operation"));
+    }
+};
+}
+
+void mtf::VirtualOutputFrameLog::record(VirtualOutputFrame const& frame)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    frames.push_back(frame);
+}
+
+auto mtf::VirtualOutputFrameLog::take() -> std::vector<VirtualOutputFrame>
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    std::vector<VirtualOutputFrame> result;
+    swap(result, frames);
+    return result;
+}
+
+auto mtf::virtual_output_rects(std::string const& sizes) -> std::vector<geom::Rectangle>
+{
+    std::vector<geom::Rectangle> rects;
+    std::istringstream in{sizes};
+    std::string size;
+    int left = 0;
+
+    while (std::getline(in, size, ','))
+    {
+        int width, height;
+        char x, extra;
+        std::istringstream size_in{size};
+        if (!(size_in >> width >> x >> height) || x != 'x' || size_in >> extra || width <= 0 || height <= 0)
+            BOOST_THROW_EXCEPTION(std::runtime_error("Invalid virtual output size: \"" + size + "\""));
+
+        rects.push_back({{left, 0}, {width, height}});
+        left += width;
+    }
+
+    if (rects.empty())
+        BOOST_THROW_EXCEPTION(std::runtime_error("No virtual outputs specified"));
+
+    return rects;
+}
+
+mtf::VirtualOutputPlatform::VirtualOutputPlatform(
+    VirtualOutputs const& outputs,
+    std::shared_ptr<VirtualOutputFrameLog> const& frame_log) :
+    outputs{outputs},
+    frame_log{frame_log}
+{
+}
+
+mir::UniqueModulePtr<mg::GraphicBufferAllocator> mtf::VirtualOutputPlatform::create_buffer_allocator(
+    mg::Display const&)
+{
+    return mir::make_module_ptr<mtd::StubBufferAllocator>();
+}
+
+mir::UniqueModulePtr<mg::PlatformIpcOperations> mtf::VirtualOutputPlatform::make_ipc_operations() const
+{
+    return mir::make_module_ptr<VirtualOutputIpcOps>();
+}
+
+mir::UniqueModulePtr<mg::Display> mtf::VirtualOutputPlatform::create_display(
+    std::shared_ptr<mg::DisplayConfigurationPolicy> const&,
+    std::shared_ptr<mg::GLConfig> const&)
+{
+    return mir::make_module_ptr<VirtualOutputDisplay>(outputs, frame_log);
+}
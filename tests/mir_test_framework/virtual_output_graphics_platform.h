@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_FRAMEWORK_VIRTUAL_OUTPUT_GRAPHICS_PLATFORM_H_
+#define MIR_TEST_FRAMEWORK_VIRTUAL_OUTPUT_GRAPHICS_PLATFORM_H_
+
+#include "mir_test_framework/virtual_output_platform.h"
+#include "mir/test/doubles/null_platform.h"
+#include "mir/geometry/rectangle.h"
+
+#include <mutex>
+
+namespace mir_test_framework
+{
+/// Collects the frames presented on all virtual outputs
+class VirtualOutputFrameLog
+{
+public:
+    void record(VirtualOutputFrame const& frame);
+    auto take() -> std::vector<VirtualOutputFrame>;
+
+private:
+    std::mutex mutex;
+    std::vector<VirtualOutputFrame> frames;
+};
+
+/// Parses VirtualOutputs::sizes, throwing std::runtime_error if it is malformed
+auto virtual_output_rects(std::string const& sizes) -> std::vector<mir::geometry::Rectangle>;
+
+class VirtualOutputPlatform : public mir::test::doubles::NullPlatform
+{
+public:
+    VirtualOutputPlatform(VirtualOutputs const& outputs, std::shared_ptr<VirtualOutputFrameLog> const& frame_log);
+
+    mir::UniqueModulePtr<mir::graphics::GraphicBufferAllocator> create_buffer_allocator(
+        mir::graphics::Display const& output) override;
+
+    mir::UniqueModulePtr<mir::graphics::PlatformIpcOperations> make_ipc_operations() const override;
+
+    mir::UniqueModulePtr<mir::graphics::Display> create_display(
+        std::shared_ptr<mir::graphics::DisplayConfigurationPolicy> const&,
+        std::shared_ptr<mir::graphics::GLConfig> const&) override;
+
+private:
+    VirtualOutputs const outputs;
+    std::shared_ptr<VirtualOutputFrameLog> const frame_log;
+};
+}
+
+#endif /* MIR_TEST_FRAMEWORK_VIRTUAL_OUTPUT_GRAPHICS_PLATFORM_H_ */
@@ -18,10 +18,13 @@
 
 #include "test_window_manager_tools.h"
 #include <mir/event_printer.h>
+#include <mir/graphics/display_configuration_observer.h>
+#include <mir/test/doubles/stub_display_configuration.h>
 
 using namespace miral;
 using namespace testing;
 namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
 using mir::operator<<;
 
 namespace
@@ -47,11 +50,16 @@ struct DisplayConfiguration : TestWindowManagerTools
     }
 
     void create_fullscreen_window()
+    {
+        create_window(mir_window_state_fullscreen);
+    }
+
+    void create_window(MirWindowState state)
     {
         mir::scene::SurfaceCreationParameters creation_parameters;
         creation_parameters.type = mir_window_type_normal;
         creation_parameters.size = initial_window_size;
-        creation_parameters.state = mir_window_state_fullscreen;
+        creation_parameters.state = state;
         creation_parameters.output_id = mir::graphics::DisplayConfigurationOutputId{0};
 
         EXPECT_CALL(*window_manager_policy, advise_new_window(_))
@@ -85,3 +93,21 @@ TEST_F(DisplayConfiguration, given_fullscreen_windows_reconfiguring_displays_doe
     basic_window_manager.add_display_for_testing(new_display);
     basic_window_manager.remove_display(new_display);
 }
+
+TEST_F(DisplayConfiguration, when_several_outputs_are_added_together_a_maximized_window_is_resized_once)
+{
+    create_window(mir_window_state_maximized);
+
+    Rectangle const second_display{display_area.top_left+as_displacement({display_width, Height{0}}), display_area.size};
+    Rectangle const third_display{second_display.top_left+as_displacement({display_width, Height{0}}), display_area.size};
+
+    EXPECT_CALL(*window_manager_policy, advise_resize(_, Size{3*display_width, display_height})).Times(1);
+    EXPECT_CALL(*window_manager_policy, advise_resize(_, Size{2*display_width, display_height})).Times(0);
+
+    auto const observer = display_configuration_observer.observer.lock();
+    ASSERT_THAT(observer, NotNull());
+    observer->configuration_applied(
+        std::make_shared<mtd::StubDisplayConfig>(std::vector<Rectangle>{second_display, third_display}));
+
+    EXPECT_THAT(window.size(), Eq(Size{3*display_width, display_height}));
+}
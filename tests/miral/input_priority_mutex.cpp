@@ -0,0 +1,146 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_priority_mutex.h"
+
+#include <mir/test/signal.h>
+#include <mir/test/spin_wait.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace testing;
+using namespace std::chrono;
+namespace mt = mir::test;
+
+namespace
+{
+struct InputPriorityMutex : Test
+{
+    void TearDown() override
+    {
+        for (auto& thread : threads)
+            if (thread.joinable())
+                thread.join();
+    }
+
+    // Starts a thread that takes the lock (using take_lock) and records who it was taken for
+    template<typename TakeLock>
+    void start_waiting(std::string const& name, TakeLock const& take_lock)
+    {
+        threads.emplace_back([this, name, take_lock]
+            {
+                take_lock();
+                {
+                    std::lock_guard<std::mutex> const lock{order_mutex};
+                    order.push_back(name);
+                }
+                mutex.unlock();
+            });
+    }
+
+    // Waits until the threads started are all waiting on the mutex
+    void wait_for_waiters(unsigned count)
+    {
+        EXPECT_TRUE(mt::spin_wait_for_condition_or_timeout(
+            [&] { return mutex.waiting() == count; }, seconds{5}, milliseconds{1}));
+    }
+
+    auto lock_order() -> std::vector<std::string>
+    {
+        for (auto& thread : threads)
+            thread.join();
+
+        std::lock_guard<std::mutex> const lock{order_mutex};
+        return order;
+    }
+
+    unsigned const max_input_ahead{3};
+    miral::InputPriorityMutex mutex{max_input_ahead};
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+
+    std::vector<std::thread> threads;
+};
+}
+
+TEST_F(InputPriorityMutex, input_waits_for_the_current_holder)
+{
+    mt::Signal input_locked;
+
+    mutex.lock();
+
+    std::thread input{[&]
+        {
+            mutex.lock_for_input();
+            input_locked.raise();
+            mutex.unlock();
+        }};
+
+    wait_for_waiters(1);
+    EXPECT_FALSE(input_locked.raised());
+
+    mutex.unlock();
+
+    EXPECT_TRUE(input_locked.wait_for(seconds{5}));
+    input.join();
+}
+
+TEST_F(InputPriorityMutex, waiting_input_takes_the_lock_ahead_of_other_waiting_callers)
+{
+    mutex.lock();
+
+    start_waiting("surface change", [this] { mutex.lock(); });
+    wait_for_waiters(1);
+    start_waiting("input", [this] { mutex.lock_for_input(); });
+    wait_for_waiters(2);
+
+    mutex.unlock();
+
+    EXPECT_THAT(lock_order(), ElementsAre("input", "surface change"));
+}
+
+TEST_F(InputPriorityMutex, other_callers_are_not_blocked_when_no_input_is_waiting)
+{
+    mutex.lock_for_input();
+    mutex.unlock();
+
+    start_waiting("surface change", [this] { mutex.lock(); });
+
+    EXPECT_THAT(lock_order(), ElementsAre("surface change"));
+}
+
+TEST_F(InputPriorityMutex, a_waiting_caller_gets_the_lock_after_a_bounded_run_of_input)
+{
+    mutex.lock();
+
+    start_waiting("surface change", [this] { mutex.lock(); });
+    for (unsigned i = 0; i != max_input_ahead + 2; ++i)
+        start_waiting("input", [this] { mutex.lock_for_input(); });
+    wait_for_waiters(max_input_ahead + 3);
+
+    mutex.unlock();
+
+    std::vector<std::string> expected(max_input_ahead, "input");
+    expected.push_back("surface change");
+    expected.insert(expected.end(), 2, "input");
+    EXPECT_THAT(lock_order(), ContainerEq(expected));
+}
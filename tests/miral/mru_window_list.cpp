@@ -32,10 +32,12 @@ struct StubSurface : mir::test::doubles::StubSurface
 {
     MirWindowState state() const override
     {
+        ++state_queries;
         return visible_ ? mir::test::doubles::StubSurface::state() : mir_window_state_hidden;
     }
 
     bool visible_ = true;
+    mutable int state_queries = 0;
 };
 
 struct StubSession : mir::test::doubles::StubSession
@@ -194,3 +196,83 @@ TEST_F(MRUWindowList, hiding_then_showing_windows_retains_order)
     EXPECT_THAT(as_enumerated, ElementsAre(window_c, window_b, window_a));
 }
 
+
+TEST_F(MRUWindowList, enumerating_an_application_visits_only_its_windows_in_mru_order)
+{
+    auto const other_session = std::make_shared<StubSession>(2);
+    miral::Application const other_app{other_session};
+    miral::Window const window_x{other_app, other_session->surface(mir::frontend::SurfaceId{0})};
+    miral::Window const window_y{other_app, other_session->surface(mir::frontend::SurfaceId{1})};
+
+    mru_list.push(window_a);
+    mru_list.push(window_x);
+    mru_list.push(window_b);
+    mru_list.push(window_y);
+    mru_list.push(window_a);
+
+    std::vector<miral::Window> as_enumerated;
+
+    mru_list.enumerate(app, [&](miral::Window& window)
+       { as_enumerated.push_back(window); return true; });
+
+    EXPECT_THAT(as_enumerated, ElementsAre(window_a, window_b));
+
+    as_enumerated.clear();
+
+    mru_list.enumerate(other_app, [&](miral::Window& window)
+       { as_enumerated.push_back(window); return true; });
+
+    EXPECT_THAT(as_enumerated, ElementsAre(window_y, window_x));
+}
+
+TEST_F(MRUWindowList, an_erased_window_is_not_enumerated_for_its_application)
+{
+    mru_list.push(window_a);
+    mru_list.push(window_b);
+    mru_list.erase(window_a);
+
+    std::vector<miral::Window> as_enumerated;
+
+    mru_list.enumerate(app, [&](miral::Window& window)
+       { as_enumerated.push_back(window); return true; });
+
+    EXPECT_THAT(as_enumerated, ElementsAre(window_b));
+}
+
+TEST_F(MRUWindowList, pushing_the_enumerated_window_during_enumeration_visits_each_window_once)
+{
+    mru_list.push(window_a);
+    mru_list.push(window_b);
+    mru_list.push(window_c);
+
+    std::vector<miral::Window> as_enumerated;
+
+    mru_list.enumerate([&](miral::Window& window)
+       { as_enumerated.push_back(window); mru_list.push(window); return true; });
+
+    EXPECT_THAT(as_enumerated, ElementsAre(window_c, window_b, window_a));
+    EXPECT_THAT(mru_list.top(), Eq(window_a));
+}
+
+TEST_F(MRUWindowList, enumerating_an_application_does_not_examine_the_windows_of_others)
+{
+    auto const other_windows = 100;
+    auto const other_session = std::make_shared<StubSession>(other_windows);
+    miral::Application const other_app{other_session};
+
+    mru_list.push(window_a);
+    for (auto i = 0; i != other_windows; ++i)
+        mru_list.push(miral::Window{other_app, other_session->surface(mir::frontend::SurfaceId{i})});
+
+    auto visited = 0;
+
+    mru_list.enumerate(app, [&](miral::Window&) { ++visited; return true; });
+
+    EXPECT_THAT(visited, Eq(1));
+
+    auto other_windows_examined = 0;
+    for (auto const& surface : other_session->surfaces)
+        other_windows_examined += surface->state_queries;
+
+    EXPECT_THAT(other_windows_examined, Eq(0));
+}
@@ -158,11 +158,15 @@ struct MockWindowManagerPolicy : miral::CanonicalWindowManagerPolicy
 
 struct StubDisplayConfigurationObserver : mir::ObserverRegistrar<mir::graphics::DisplayConfigurationObserver>
 {
-    void register_interest(std::weak_ptr<mir::graphics::DisplayConfigurationObserver> const&) override {}
+    void register_interest(std::weak_ptr<mir::graphics::DisplayConfigurationObserver> const& observer) override
+        { this->observer = observer; }
 
-    void register_interest(std::weak_ptr<mir::graphics::DisplayConfigurationObserver> const&, mir::Executor&) override {}
+    void register_interest(std::weak_ptr<mir::graphics::DisplayConfigurationObserver> const& observer, mir::Executor&) override
+        { this->observer = observer; }
 
     void unregister_interest(mir::graphics::DisplayConfigurationObserver const&) override {}
+
+    std::weak_ptr<mir::graphics::DisplayConfigurationObserver> observer;
 };
 
 struct TestWindowManagerTools : testing::Test
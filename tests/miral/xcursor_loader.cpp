@@ -0,0 +1,189 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xcursor_loader.h"
+
+#include <mir/graphics/cursor_image.h>
+#include <mir_test_framework/executable_path.h>
+
+#include <boost/filesystem.hpp>
+
+#include <system_error>
+
+#include <stdlib.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+namespace fs = boost::filesystem;
+namespace geom = mir::geometry;
+
+namespace
+{
+// XCursor reads XCURSOR_PATH once per process, so every test's theme goes in the same directory
+struct CursorPath
+{
+    CursorPath()
+    {
+        char tmp_name[] = "/tmp/mir_xcursor_loader_XXXXXX";
+        if (mkdtemp(tmp_name) == NULL)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        path = tmp_name;
+        setenv("XCURSOR_PATH", path.c_str(), true);
+    }
+
+    ~CursorPath()
+    {
+        fs::remove_all(path);
+    }
+
+    std::string path;
+};
+
+auto cursor_path() -> std::string const&
+{
+    static CursorPath const instance;
+    return instance.path;
+}
+
+geom::Size const cursor_size{24, 24};
+
+// The fixture theme's cursors (arrow, red, green and blue) are copied into a theme of our own, so
+// tests can add and remove cursors without affecting each other
+struct XCursorLoader : Test
+{
+    XCursorLoader()
+    {
+        auto const test = UnitTest::GetInstance()->current_test_info();
+        theme = std::string{test->test_case_name()} + "." + test->name();
+        cursors = cursor_path() + "/" + theme + "/cursors";
+        fs::create_directories(cursors);
+    }
+
+    ~XCursorLoader()
+    {
+        fs::remove_all(cursor_path() + "/" + theme);
+    }
+
+    void install(std::string const& name)
+    {
+        fs::copy_file(
+            mir_test_framework::test_data_path() + "/testing-cursor-theme/default/cursors/" + name,
+            cursors + "/" + name);
+    }
+
+    void uninstall(std::string const& name)
+    {
+        fs::remove(cursors + "/" + name);
+    }
+
+    std::string theme;
+    std::string cursors;
+};
+}
+
+TEST_F(XCursorLoader, loads_a_cursor_installed_after_construction)
+{
+    miral::XCursorLoader loader{theme};
+
+    install("red");
+
+    auto const image = loader.image("red", cursor_size);
+
+    ASSERT_THAT(image, NotNull());
+    EXPECT_THAT(image->size(), Eq(cursor_size));
+}
+
+TEST_F(XCursorLoader, unknown_cursor_falls_back_to_arrow)
+{
+    install("arrow");
+    miral::XCursorLoader loader{theme};
+
+    EXPECT_THAT(loader.image("no-such-cursor", cursor_size), Eq(loader.image("arrow", cursor_size)));
+}
+
+TEST_F(XCursorLoader, without_cursor_or_arrow_there_is_no_image)
+{
+    miral::XCursorLoader loader{theme};
+
+    EXPECT_THAT(loader.image("red", cursor_size), IsNull());
+}
+
+TEST_F(XCursorLoader, repeated_request_is_served_from_the_cache)
+{
+    install("red");
+    miral::XCursorLoader loader{theme};
+
+    auto const first = loader.image("red", cursor_size);
+    uninstall("red");
+    auto const second = loader.image("red", cursor_size);
+
+    ASSERT_THAT(first, NotNull());
+    EXPECT_THAT(second, Eq(first));
+}
+
+TEST_F(XCursorLoader, requests_for_different_sizes_are_cached_separately)
+{
+    install("red");
+    miral::XCursorLoader loader{theme};
+
+    auto const small = loader.image("red", cursor_size);
+    auto const large = loader.image("red", geom::Size{48, 48});
+
+    ASSERT_THAT(small, NotNull());
+    ASSERT_THAT(large, NotNull());
+    EXPECT_THAT(large, Ne(small));
+    EXPECT_THAT(loader.image("red", cursor_size), Eq(small));
+}
+
+TEST_F(XCursorLoader, evicts_the_least_recently_used_cursor)
+{
+    install("red");
+    install("green");
+    install("blue");
+    miral::XCursorLoader loader{theme, 2};
+
+    auto const red = loader.image("red", cursor_size);
+    auto const green = loader.image("green", cursor_size);
+    loader.image("red", cursor_size);       // green is now the least recently used...
+    loader.image("blue", cursor_size);      // ...so is evicted to make room for blue
+
+    uninstall("red");
+    uninstall("green");
+
+    EXPECT_THAT(loader.image("red", cursor_size), Eq(red));
+    EXPECT_THAT(loader.image("green", cursor_size), IsNull());
+}
+
+TEST_F(XCursorLoader, a_missing_cursor_is_cached_until_evicted)
+{
+    install("arrow");
+    miral::XCursorLoader loader{theme, 2};
+
+    auto const arrow = loader.image("red", cursor_size);
+    install("red");
+
+    EXPECT_THAT(loader.image("red", cursor_size), Eq(arrow));
+
+    loader.image("green", cursor_size);     // Evicts the entry recording red as missing
+
+    auto const red = loader.image("red", cursor_size);
+    ASSERT_THAT(red, NotNull());
+    EXPECT_THAT(red, Ne(arrow));
+}
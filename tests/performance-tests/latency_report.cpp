@@ -0,0 +1,211 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency_report.h"
+#include "mir_test_framework/executable_path.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono;
+
+namespace
+{
+struct Percentile
+{
+    char const* key;
+    double p;
+};
+
+Percentile const percentiles[] = {{"p50_us", 50}, {"p90_us", 90}, {"p99_us", 99}, {"max_us", 100}};
+
+auto directory_from_env(char const* name, std::string const& fallback) -> std::string
+{
+    auto const value = getenv(name);
+    return value ? value : fallback;
+}
+}
+
+void mt::LatencyHistogram::record(microseconds latency)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    samples.push_back(latency);
+}
+
+void mt::LatencyHistogram::clear()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    samples.clear();
+}
+
+auto mt::LatencyHistogram::count() const -> size_t
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return samples.size();
+}
+
+auto mt::LatencyHistogram::percentile(double p) const -> microseconds
+{
+    auto const sorted = sorted_samples();
+    if (sorted.empty())
+        return microseconds::zero();
+
+    auto const index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+auto mt::LatencyHistogram::max() const -> microseconds
+{
+    return percentile(100);
+}
+
+auto mt::LatencyHistogram::sorted_samples() const -> std::vector<microseconds>
+{
+    std::vector<microseconds> result;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        result = samples;
+    }
+    std::sort(begin(result), end(result));
+    return result;
+}
+
+void mt::LatencyHistogram::write_json(std::ostream& out) const
+{
+    auto const sorted = sorted_samples();
+
+    out << "{\"count\": " << sorted.size();
+    for (auto const& percentile : percentiles)
+        out << ", \"" << percentile.key << "\": " << this->percentile(percentile.p).count();
+
+    // Each bucket counts the samples up to "le_us", and above the previous bucket
+    out << ", \"buckets\": [";
+    microseconds::rep bound{1};
+    auto sample = begin(sorted);
+    bool first{true};
+    while (sample != end(sorted))
+    {
+        auto const next = std::upper_bound(sample, end(sorted), microseconds{bound});
+        if (next != sample)
+        {
+            out << (first ? "" : ", ") << "{\"le_us\": " << bound << ", \"count\": " << (next - sample) << "}";
+            first = false;
+        }
+        sample = next;
+        bound *= 2;
+    }
+    out << "]}";
+}
+
+mt::LatencyReport::LatencyReport(std::string const& benchmark) :
+    benchmark{benchmark}
+{
+}
+
+auto mt::LatencyReport::metric(std::string const& name) -> LatencyHistogram&
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return metrics[name];
+}
+
+void mt::LatencyReport::write() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const write_to = [this](std::ostream& out)
+        {
+            out << "{\"benchmark\": \"" << benchmark << "\", \"metrics\": {";
+            bool first{true};
+            for (auto const& metric : metrics)
+            {
+                out << (first ? "\n  " : ",\n  ") << '"' << metric.first << "\": ";
+                metric.second.write_json(out);
+                first = false;
+            }
+            out << "\n}}" << std::endl;
+        };
+
+    auto const results_dir = directory_from_env("MIR_PERFORMANCE_RESULTS_DIR", "");
+    if (results_dir.empty())
+    {
+        write_to(std::cout);
+    }
+    else
+    {
+        std::ofstream out{results_dir + "/" + benchmark + ".json"};
+        write_to(out);
+    }
+
+    for (auto const& metric : metrics)
+    {
+        std::cout << metric.first << ": " << metric.second.count() << " samples, p50="
+                  << metric.second.percentile(50).count() << "us p99="
+                  << metric.second.percentile(99).count() << "us max="
+                  << metric.second.max().count() << "us" << std::endl;
+    }
+}
+
+void mt::LatencyReport::expect_within_baseline() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const baseline_file = directory_from_env(
+        "MIR_PERFORMANCE_BASELINE_DIR", mtf::test_data_path() + "/performance-baselines") + "/" + benchmark + ".json";
+
+    if (!boost::filesystem::exists(baseline_file))
+    {
+        std::cout << "No baseline for " << benchmark << " (" << baseline_file << ")" << std::endl;
+        return;
+    }
+
+    boost::property_tree::ptree baseline;
+    boost::property_tree::read_json(baseline_file, baseline);
+
+    auto const default_regression = baseline.get<double>("max_regression", 0.5);
+
+    for (auto const& metric : metrics)
+    {
+        auto const expected = baseline.get_child_optional("metrics." + metric.first);
+        if (!expected)
+            continue;
+
+        auto const max_regression = expected->get<double>("max_regression", default_regression);
+
+        for (auto const& percentile : percentiles)
+        {
+            if (auto const baseline_us = expected->get_optional<double>(percentile.key))
+            {
+                auto const limit = *baseline_us * (1.0 + max_regression);
+                auto const measured = metric.second.percentile(percentile.p).count();
+
+                EXPECT_LE(measured, limit)
+                    << metric.first << " " << percentile.key << " regressed: baseline is " << *baseline_us
+                    << "us, allowing " << max_regression * 100 << "% regression";
+            }
+        }
+    }
+}
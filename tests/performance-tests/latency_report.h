@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_LATENCY_REPORT_H_
+#define MIR_TEST_LATENCY_REPORT_H_
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mir { namespace test {
+
+/// Latency samples, which may be recorded from any thread
+class LatencyHistogram
+{
+public:
+    void record(std::chrono::microseconds latency);
+    void clear();
+
+    auto count() const -> size_t;
+    auto percentile(double p) const -> std::chrono::microseconds;
+    auto max() const -> std::chrono::microseconds;
+
+    /// Writes a JSON object of the percentiles and of the samples bucketed by powers of two microseconds
+    void write_json(std::ostream& out) const;
+
+private:
+    auto sorted_samples() const -> std::vector<std::chrono::microseconds>;
+
+    std::mutex mutable mutex;
+    std::vector<std::chrono::microseconds> samples;
+};
+
+/** The latency histograms measured by a benchmark.
+ *  Results are written as "<benchmark>.json" in $MIR_PERFORMANCE_RESULTS_DIR (or to stdout)
+ *  and are compared with "<benchmark>.json" in $MIR_PERFORMANCE_BASELINE_DIR (by default
+ *  the "performance-baselines" test data).
+ */
+class LatencyReport
+{
+public:
+    explicit LatencyReport(std::string const& benchmark);
+
+    /// The histogram for a metric, created on first use (from any thread)
+    auto metric(std::string const& name) -> LatencyHistogram&;
+
+    void write() const;
+
+    /// Adds a test failure for every percentile that has regressed beyond the baseline's threshold
+    void expect_within_baseline() const;
+
+private:
+    std::string const benchmark;
+    std::mutex mutable mutex;
+    std::map<std::string, LatencyHistogram> metrics;
+};
+} } // namespace mir::test
+
+#endif // MIR_TEST_LATENCY_REPORT_H_
@@ -30,13 +30,8 @@ using namespace testing;
 
 namespace
 {
-struct ClientStartupPerformance : testing::Test, mtf::AsyncServerRunner
+struct ServerStartupPerformance : testing::Test, mtf::AsyncServerRunner
 {
-    void SetUp() override
-    {
-        start_server();
-    }
-
     void TearDown() override
     {
         stop_server();
@@ -55,6 +50,14 @@ struct ClientStartupPerformance : testing::Test, mtf::AsyncServerRunner
     }
 };
 
+struct ClientStartupPerformance : ServerStartupPerformance
+{
+    void SetUp() override
+    {
+        start_server();
+    }
+};
+
 MirPixelFormat find_pixel_format(MirConnection* connection)
 {
     MirPixelFormat pixel_format = mir_pixel_format_invalid;
@@ -86,15 +89,9 @@ MirWindow* make_surface(MirConnection* connection)
     }
     return window;
 }
-}
 
-TEST_F(ClientStartupPerformance, create_surface_and_swap)
+void swap_first_frame(MirWindow* window)
 {
-    using namespace std::chrono_literals;
-    auto start = std::chrono::steady_clock::now();
-
-    auto conn = create_connection();
-    auto window = make_surface(conn);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     auto stream  = mir_window_get_buffer_stream(window);
@@ -107,6 +104,17 @@ TEST_F(ClientStartupPerformance, create_surface_and_swap)
     }
 
     mir_buffer_stream_swap_buffers_sync(stream);
+}
+}
+
+TEST_F(ClientStartupPerformance, create_surface_and_swap)
+{
+    using namespace std::chrono_literals;
+    auto start = std::chrono::steady_clock::now();
+
+    auto conn = create_connection();
+    auto window = make_surface(conn);
+    swap_first_frame(window);
 
     auto end = std::chrono::steady_clock::now();
     auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(end-start);
@@ -119,3 +127,29 @@ TEST_F(ClientStartupPerformance, create_surface_and_swap)
     mir_connection_release(conn);
 }
 
+TEST_F(ServerStartupPerformance, server_start_to_first_client_frame)
+{
+    using namespace std::chrono_literals;
+    auto const start = std::chrono::steady_clock::now();
+
+    start_server();
+    auto const server_started = std::chrono::steady_clock::now();
+
+    auto conn = create_connection();
+    auto window = make_surface(conn);
+    swap_first_frame(window);
+
+    auto const end = std::chrono::steady_clock::now();
+    auto const startup = std::chrono::duration_cast<std::chrono::milliseconds>(server_started-start);
+    auto const first_frame = std::chrono::duration_cast<std::chrono::milliseconds>(end-start);
+
+    RecordProperty("server_startup_ms", startup.count());
+    RecordProperty("time_to_first_frame_ms", first_frame.count());
+
+    //NOTE: Ideally, the expected number should vary according to platform
+    auto max_expected_time = 500ms;
+    EXPECT_THAT(first_frame.count(), Lt(max_expected_time.count()));
+
+    mir_window_release_sync(window);
+    mir_connection_release(conn);
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency_report.h"
+
+#include "mir_toolkit/mir_client_library.h"
+#include "mir_test_framework/connected_client_with_a_window.h"
+#include "mir_test_framework/fake_input_device.h"
+#include "mir_test_framework/input_device_faker.h"
+#include "mir_test_framework/virtual_output_platform.h"
+#include "mir/input/input_device_info.h"
+#include "mir/scene/surface.h"
+#include "mir/shell/shell.h"
+#include "mir/test/event_factory.h"
+#include "mir/test/signal.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <linux/input.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace mi = mir::input;
+namespace mis = mir::input::synthesis;
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+int const input_events{500};
+int const frames{300};
+auto const input_interval = milliseconds{2};
+auto const timeout = seconds{60};
+
+auto since_event(MirInputEvent const* event) -> microseconds
+{
+    auto const event_time = steady_clock::time_point{nanoseconds{mir_input_event_get_event_time(event)}};
+    return duration_cast<microseconds>(steady_clock::now() - event_time);
+}
+
+/* Replaces benchmarks/{key,touch}_event_latency.py: those need uinput and a real display,
+ * whereas this runs against fake input devices and the virtual outputs of graphics-virtual.so,
+ * so can run anywhere the tests do. It also measures commit-to-present on those outputs;
+ * benchmarks/commit_to_present.py remains for analysing LTTng traces from real sessions.
+ */
+struct EndToEndLatency : mtf::ConnectedClientWithAWindow, mtf::InputDeviceFaker
+{
+    EndToEndLatency()
+    {
+        mtf::VirtualOutputs outputs;
+        outputs.refresh_rate_hz = 60;
+        outputs.flip_latency = microseconds{1000};
+        use_virtual_outputs(outputs);
+    }
+
+    void SetUp() override
+    {
+        mtf::ConnectedClientWithAWindow::SetUp();
+        wait_for_input_devices_added_to(server);
+        mir_window_set_event_handler(window, &handle_event, this);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        stream = mir_window_get_buffer_stream(window);
+#pragma GCC diagnostic pop
+        mir_buffer_stream_swap_buffers_sync(stream);
+
+        ASSERT_TRUE(have_focus.wait_for(timeout));
+
+        auto const surface = server.the_shell()->focused_surface();
+        ASSERT_THAT(surface, NotNull());
+        touch_position = surface->top_left() + geom::Displacement{10, 10};
+    }
+
+    void TearDown() override
+    {
+        mir_window_set_event_handler(window, nullptr, nullptr);
+        mtf::ConnectedClientWithAWindow::TearDown();
+    }
+
+    static void handle_event(MirWindow*, MirEvent const* event, void* context)
+    {
+        auto const self = static_cast<EndToEndLatency*>(context);
+
+        switch (mir_event_get_type(event))
+        {
+        case mir_event_type_window:
+        {
+            auto const window_event = mir_event_get_window_event(event);
+            if (mir_window_event_get_attribute(window_event) == mir_window_attrib_focus &&
+                mir_window_event_get_attribute_value(window_event))
+                self->have_focus.raise();
+            break;
+        }
+        case mir_event_type_input:
+        {
+            auto const input_event = mir_event_get_input_event(event);
+            switch (mir_input_event_get_type(input_event))
+            {
+            case mir_input_event_type_key:
+                self->report.metric("key_input_to_client").record(since_event(input_event));
+                if (++self->keys_received == input_events)
+                    self->all_keys_received.raise();
+                break;
+            case mir_input_event_type_touch:
+            {
+                self->report.metric("touch_input_to_client").record(since_event(input_event));
+                auto const touch_event = mir_input_event_get_touch_event(input_event);
+                if (mir_touch_event_action(touch_event, 0) == mir_touch_action_up)
+                    self->touch_released.raise();
+                break;
+            }
+            default:
+                break;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    std::unique_ptr<mtf::FakeInputDevice> const fake_keyboard{
+        add_fake_input_device(mi::InputDeviceInfo{"keyboard", "keyboard-uid", mi::DeviceCapability::keyboard})};
+    std::unique_ptr<mtf::FakeInputDevice> const fake_touch_screen{
+        add_fake_input_device(mi::InputDeviceInfo{"touch", "touch-uid", mi::DeviceCapability::touchscreen})};
+
+    MirBufferStream* stream{nullptr};
+    geom::Point touch_position;
+
+    mt::Signal have_focus;
+    mt::Signal all_keys_received;
+    mt::Signal touch_released;
+    std::atomic<int> keys_received{0};
+
+    mt::LatencyReport report{"end_to_end_latency"};
+};
+}
+
+TEST_F(EndToEndLatency, input_commit_composite_and_present)
+{
+    for (int i = 0; i != input_events; ++i)
+    {
+        fake_keyboard->emit_event(
+            i % 2 ? mis::a_key_up_event().of_scancode(KEY_M) : mis::a_key_down_event().of_scancode(KEY_M));
+        std::this_thread::sleep_for(input_interval);
+    }
+
+    fake_touch_screen->emit_event(
+        mis::a_touch_event().with_action(mis::TouchParameters::Action::Tap).at_position(touch_position));
+    std::this_thread::sleep_for(input_interval);
+    for (int i = 1; i != input_events - 1; ++i)
+    {
+        // The client may coalesce touch motion, so not every one of these is delivered
+        fake_touch_screen->emit_event(
+            mis::a_touch_event().with_action(mis::TouchParameters::Action::Move)
+                .at_position(touch_position + geom::Displacement{i % 100, i % 100}));
+        std::this_thread::sleep_for(input_interval);
+    }
+    fake_touch_screen->emit_event(
+        mis::a_touch_event().with_action(mis::TouchParameters::Action::Release).at_position(touch_position));
+
+    ASSERT_TRUE(all_keys_received.wait_for(timeout));
+    ASSERT_TRUE(touch_released.wait_for(timeout));
+
+    mtf::take_virtual_output_frames();
+
+    std::vector<steady_clock::time_point> commits;
+    for (int i = 0; i != frames; ++i)
+    {
+        commits.push_back(steady_clock::now());
+        mir_buffer_stream_swap_buffers_sync(stream);
+    }
+
+    auto const composited = mtf::take_virtual_output_frames();
+    ASSERT_THAT(composited, Not(IsEmpty()));
+
+    // A commit is composited into the first frame the compositor posts after it
+    auto frame = begin(composited);
+    for (auto const& commit : commits)
+    {
+        frame = std::find_if(frame, end(composited), [&](auto const& f) { return f.posted >= commit; });
+        if (frame == end(composited))
+            break;
+        report.metric("commit_to_composite").record(duration_cast<microseconds>(frame->posted - commit));
+    }
+
+    for (auto const& f : composited)
+        report.metric("composite_to_present").record(duration_cast<microseconds>(f.presented - f.posted));
+
+    report.write();
+
+    EXPECT_THAT(report.metric("key_input_to_client").count(), Eq(static_cast<size_t>(input_events)));
+    EXPECT_THAT(report.metric("touch_input_to_client").count(), Gt(0u));
+    EXPECT_THAT(report.metric("commit_to_composite").count(), Gt(0u));
+
+    report.expect_within_baseline();
+}
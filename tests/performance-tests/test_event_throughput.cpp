@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_toolkit/mir_client_library.h"
+#include "mir_test_framework/connected_client_with_a_window.h"
+#include "mir/events/event_builders.h"
+#include "mir/scene/surface.h"
+#include "mir/shell/shell.h"
+#include "mir/test/signal.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <linux/input.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+namespace mev = mir::events;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+int const events_to_send = 100000;
+auto const timeout = 60s;
+
+struct EventThroughput : mtf::ConnectedClientWithAWindow
+{
+    void SetUp() override
+    {
+        mtf::ConnectedClientWithAWindow::SetUp();
+        mir_window_set_event_handler(window, &handle_event, this);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        mir_buffer_stream_swap_buffers_sync(mir_window_get_buffer_stream(window));
+#pragma GCC diagnostic pop
+
+        ASSERT_TRUE(have_focus.wait_for(timeout));
+    }
+
+    void TearDown() override
+    {
+        mir_window_set_event_handler(window, nullptr, nullptr);
+        mtf::ConnectedClientWithAWindow::TearDown();
+    }
+
+    static void handle_event(MirWindow*, MirEvent const* event, void* context)
+    {
+        auto const self = static_cast<EventThroughput*>(context);
+
+        switch (mir_event_get_type(event))
+        {
+        case mir_event_type_window:
+        {
+            auto const window_event = mir_event_get_window_event(event);
+            if (mir_window_event_get_attribute(window_event) == mir_window_attrib_focus &&
+                mir_window_event_get_attribute_value(window_event))
+                self->have_focus.raise();
+            break;
+        }
+        case mir_event_type_input:
+            if (++self->keys_received == events_to_send)
+                self->all_received.raise();
+            break;
+        default:
+            break;
+        }
+    }
+
+    mt::Signal have_focus;
+    mt::Signal all_received;
+    std::atomic<int> keys_received{0};
+};
+}
+
+TEST_F(EventThroughput, key_events_per_second)
+{
+    auto const surface = server.the_shell()->focused_surface();
+    ASSERT_THAT(surface, NotNull());
+
+    auto const start = steady_clock::now();
+
+    for (int i = 0; i != events_to_send; ++i)
+    {
+        auto const key = mev::make_event(
+            MirInputDeviceId{0}, steady_clock::now().time_since_epoch(), std::vector<uint8_t>{},
+            i % 2 ? mir_keyboard_action_up : mir_keyboard_action_down, 0, KEY_M,
+            mir_input_event_modifier_none);
+
+        surface->consume(key.get());
+    }
+
+    ASSERT_TRUE(all_received.wait_for(timeout));
+
+    auto const elapsed = duration_cast<duration<double>>(steady_clock::now() - start);
+    auto const events_per_second = events_to_send / elapsed.count();
+
+    RecordProperty("events_per_second", static_cast<int>(events_per_second));
+    std::cout << "Delivered " << events_to_send << " key events in " << elapsed.count()
+              << "s (" << events_per_second << " events/s)" << std::endl;
+}
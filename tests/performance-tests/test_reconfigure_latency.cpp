@@ -0,0 +1,178 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_test_framework/connected_client_with_a_window.h"
+#include "mir_test_framework/virtual_output_platform.h"
+
+#include "mir/graphics/display.h"
+#include "mir/graphics/display_configuration.h"
+#include "mir/shell/display_configuration_controller.h"
+#include "mir_toolkit/mir_client_library.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <set>
+#include <thread>
+
+namespace mg = mir::graphics;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+// Roughly what a modeset on a newly connected output costs
+auto const modeset_time = milliseconds{100};
+int const reconfigurations{6};
+auto const timeout = seconds{10};
+
+// Hotplugs a "projector" (the last output) while a client animates on the others
+struct ReconfigureLatency : mtf::ConnectedClientWithAWindow
+{
+    ReconfigureLatency()
+    {
+        mtf::VirtualOutputs outputs;
+        outputs.sizes = "1920x1080,1920x1080,1280x720";
+        outputs.refresh_rate_hz = 60;
+        outputs.modeset_time = modeset_time;
+        use_virtual_outputs(outputs);
+    }
+
+    void SetUp() override
+    {
+        mtf::ConnectedClientWithAWindow::SetUp();
+
+        server.the_display()->configuration()->for_each_output(
+            [this](mg::DisplayConfigurationOutput const& output)
+            {
+                projector = output.id;
+                outputs.insert(output.id.as_value());
+            });
+        outputs.erase(projector.as_value());
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        auto const stream = mir_window_get_buffer_stream(window);
+#pragma GCC diagnostic pop
+        animation = std::thread{[this, stream]
+            {
+                while (!stopping)
+                    mir_buffer_stream_swap_buffers_sync(stream);
+            }};
+    }
+
+    void TearDown() override
+    {
+        stopping = true;
+        animation.join();
+        mtf::ConnectedClientWithAWindow::TearDown();
+    }
+
+    auto projector_enabled() -> bool
+    {
+        bool enabled{false};
+        server.the_display()->configuration()->for_each_output(
+            [&](mg::DisplayConfigurationOutput const& output)
+            {
+                if (output.id == projector)
+                    enabled = output.used;
+            });
+        return enabled;
+    }
+
+    // Returns how long the change took to be applied
+    auto set_projector_enabled(bool enabled) -> microseconds
+    {
+        std::shared_ptr<mg::DisplayConfiguration> conf = server.the_display()->configuration();
+        conf->for_each_output(
+            [&](mg::UserDisplayConfigurationOutput& output)
+            {
+                if (output.id == projector)
+                    output.used = enabled;
+            });
+
+        auto const start = steady_clock::now();
+        server.the_display_configuration_controller()->set_base_configuration(conf);
+
+        while (projector_enabled() != enabled && steady_clock::now() < start + timeout)
+            std::this_thread::sleep_for(milliseconds{1});
+
+        EXPECT_THAT(projector_enabled(), Eq(enabled));
+        return duration_cast<microseconds>(steady_clock::now() - start);
+    }
+
+    // The longest any output other than the projector went without presenting a frame
+    auto longest_gap_on_unchanged_outputs(std::vector<mtf::VirtualOutputFrame> const& frames) -> microseconds
+    {
+        std::map<unsigned int, steady_clock::time_point> last_presented;
+        microseconds result{0};
+
+        for (auto const& frame : frames)
+        {
+            if (outputs.count(frame.output_id) == 0)
+                continue;
+
+            auto const last = last_presented.find(frame.output_id);
+            if (last != last_presented.end())
+                result = std::max(result, duration_cast<microseconds>(frame.presented - last->second));
+
+            last_presented[frame.output_id] = frame.presented;
+        }
+
+        EXPECT_THAT(last_presented.size(), Eq(outputs.size()));
+        return result;
+    }
+
+    mg::DisplayConfigurationOutputId projector;
+    std::set<unsigned int> outputs;
+
+    std::atomic<bool> stopping{false};
+    std::thread animation;
+};
+}
+
+TEST_F(ReconfigureLatency, unchanged_outputs_keep_presenting_through_a_hotplug)
+{
+    std::vector<microseconds> latencies;
+    mtf::take_virtual_output_frames();
+
+    for (int i = 0; i != reconfigurations; ++i)
+    {
+        // Let every output present a few frames between hotplugs
+        std::this_thread::sleep_for(milliseconds{200});
+        latencies.push_back(set_projector_enabled(i % 2 != 0));
+    }
+    std::this_thread::sleep_for(milliseconds{200});
+
+    auto const longest_gap = longest_gap_on_unchanged_outputs(mtf::take_virtual_output_frames());
+
+    std::sort(begin(latencies), end(latencies));
+    auto const median = latencies[latencies.size() / 2].count();
+
+    RecordProperty("reconfigure_p50_us", static_cast<int>(median));
+    RecordProperty("unchanged_output_max_gap_us", static_cast<int>(longest_gap.count()));
+
+    std::cout << "Reconfigure latency: p50=" << median
+              << "us, longest frame gap on unchanged outputs=" << longest_gap.count() << "us" << std::endl;
+
+    EXPECT_THAT(longest_gap, Lt(modeset_time));
+}
@@ -0,0 +1,656 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency_report.h"
+
+#include "mir_toolkit/mir_client_library.h"
+#include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "mir_test_framework/headless_in_process_server.h"
+#include "mir_test_framework/virtual_output_platform.h"
+#include "mir/anonymous_shm_file.h"
+#include "mir/compositor/display_buffer_compositor.h"
+#include "mir/compositor/display_buffer_compositor_factory.h"
+#include "mir/fd.h"
+#include "mir/scene/null_session_listener.h"
+#include "mir/scene/surface.h"
+#include "mir/test/signal.h"
+#include "mir/thread_name.h"
+
+#include <wayland-client.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <boost/throw_exception.hpp>
+
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace ms = mir::scene;
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+auto const warm_up = seconds{1};
+auto const measurement = seconds{5};
+auto const sample_interval = milliseconds{50};
+auto const timeout = seconds{60};
+int const surface_width{64};
+int const surface_height{64};
+
+char const* const client_thread_name{"Stress client"};
+// mirclient does its IPC on this thread, so its CPU is charged to the client too
+char const* const mirclient_thread_name{"RPC Thread"};
+
+struct StressParameters
+{
+    int wayland_clients;
+    int mir_clients;
+    int surfaces_per_client;
+    double commit_rate_hz;
+};
+
+void PrintTo(StressParameters const& p, std::ostream* out)
+{
+    *out << p.wayland_clients << " Wayland + " << p.mir_clients << " mirclient sessions x "
+         << p.surfaces_per_client << " surfaces at " << p.commit_rate_hz << "Hz";
+}
+
+/// A client session on its own thread, committing to each of its surfaces at a fixed rate
+class StressClient
+{
+public:
+    StressClient(int surfaces, double commit_rate_hz) :
+        surfaces{surfaces},
+        period{duration_cast<steady_clock::duration>(duration<double>{1.0 / commit_rate_hz})}
+    {
+    }
+
+    virtual ~StressClient() = default;
+
+    void start()
+    {
+        thread = std::thread{[this]
+            {
+                mir::set_thread_name(client_thread_name);
+                try
+                {
+                    run();
+                }
+                catch (std::exception const& error)
+                {
+                    failure = error.what();
+                    ready.raise();
+                }
+            }};
+    }
+
+    void stop()
+    {
+        stopping = true;
+        if (thread.joinable())
+            thread.join();
+    }
+
+    /// Frames completed across all of the client's surfaces
+    auto frames() const -> int { return frames_completed; }
+
+    mt::Signal ready;
+    std::string failure;
+
+protected:
+    virtual void run() = 0;
+
+    /// The next commit is due a period after the last, but a client that falls behind doesn't burst
+    auto next_commit(steady_clock::time_point last) const -> steady_clock::time_point
+    {
+        return std::max(last + period, steady_clock::now());
+    }
+
+    int const surfaces;
+    steady_clock::duration const period;
+    std::atomic<bool> stopping{false};
+    std::atomic<int> frames_completed{0};
+
+private:
+    std::thread thread;
+};
+
+class MirStressClient : public StressClient
+{
+public:
+    MirStressClient(std::string const& connect_string, int surfaces, double commit_rate_hz) :
+        StressClient{surfaces, commit_rate_hz},
+        connect_string{connect_string}
+    {
+    }
+
+private:
+    void run() override
+    {
+        auto const connection = mir_connect_sync(connect_string.c_str(), "mir stress client");
+        if (!mir_connection_is_valid(connection))
+            BOOST_THROW_EXCEPTION(std::runtime_error{mir_connection_get_error_message(connection)});
+
+        std::vector<MirWindow*> windows;
+        std::vector<MirBufferStream*> streams;
+        for (int i = 0; i != surfaces; ++i)
+        {
+            auto const spec = mir_create_normal_window_spec(connection, surface_width, surface_height);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+            mir_window_spec_set_pixel_format(spec, mir_pixel_format_abgr_8888);
+            windows.push_back(mir_create_window_sync(spec));
+            streams.push_back(mir_window_get_buffer_stream(windows.back()));
+#pragma GCC diagnostic pop
+            mir_window_spec_release(spec);
+        }
+
+        ready.raise();
+
+        for (auto commit = steady_clock::now(); !stopping; commit = next_commit(commit))
+        {
+            std::this_thread::sleep_until(commit);
+            for (auto const stream : streams)
+            {
+                mir_buffer_stream_swap_buffers_sync(stream);
+                ++frames_completed;
+            }
+        }
+
+        for (auto const window : windows)
+            mir_window_release_sync(window);
+        mir_connection_release(connection);
+    }
+
+    std::string const connect_string;
+};
+
+class WaylandStressClient : public StressClient
+{
+public:
+    WaylandStressClient(mir::Fd const& fd, int surfaces, double commit_rate_hz) :
+        StressClient{surfaces, commit_rate_hz},
+        fd{fd}
+    {
+    }
+
+private:
+    struct Buffer
+    {
+        wl_buffer* buffer;
+        bool busy;
+    };
+
+    struct Surface
+    {
+        WaylandStressClient* client;
+        wl_surface* surface;
+        wl_shell_surface* shell_surface;
+        wl_callback* frame_callback;
+        Buffer buffers[2];
+    };
+
+    void run() override
+    {
+        display = wl_display_connect_to_fd(dup(fd));
+        if (!display)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Failed to connect Wayland client"});
+
+        auto const registry = wl_display_get_registry(display);
+        wl_registry_add_listener(registry, &registry_listener, this);
+        wl_display_roundtrip(display);
+
+        if (!compositor || !shm || !shell)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Missing Wayland globals"});
+
+        int const stride = surface_width * 4;
+        int const buffer_size = stride * surface_height;
+        mir::AnonymousShmFile shm_file{static_cast<size_t>(2 * surfaces * buffer_size)};
+        auto const pool = wl_shm_create_pool(shm, shm_file.fd(), 2 * surfaces * buffer_size);
+
+        std::vector<Surface> surface_list(surfaces);
+        int offset = 0;
+        for (auto& s : surface_list)
+        {
+            s.client = this;
+            s.surface = wl_compositor_create_surface(compositor);
+            s.shell_surface = wl_shell_get_shell_surface(shell, s.surface);
+            wl_shell_surface_add_listener(s.shell_surface, &shell_surface_listener, nullptr);
+            wl_shell_surface_set_toplevel(s.shell_surface);
+            s.frame_callback = nullptr;
+            for (auto& b : s.buffers)
+            {
+                b.buffer = wl_shm_pool_create_buffer(
+                    pool, offset, surface_width, surface_height, stride, WL_SHM_FORMAT_ARGB8888);
+                b.busy = false;
+                wl_buffer_add_listener(b.buffer, &buffer_listener, &b);
+                offset += buffer_size;
+            }
+        }
+        wl_display_roundtrip(display);
+
+        ready.raise();
+
+        auto commit = steady_clock::now();
+        while (!stopping)
+        {
+            if (steady_clock::now() >= commit)
+            {
+                // Like a real client, only draw a surface once its last frame has been shown
+                for (auto& s : surface_list)
+                {
+                    if (!s.frame_callback)
+                        draw(s);
+                }
+                commit = next_commit(commit);
+            }
+
+            dispatch_until(commit);
+        }
+
+        for (auto& s : surface_list)
+        {
+            if (s.frame_callback)
+                wl_callback_destroy(s.frame_callback);
+            for (auto& b : s.buffers)
+                wl_buffer_destroy(b.buffer);
+            wl_shell_surface_destroy(s.shell_surface);
+            wl_surface_destroy(s.surface);
+        }
+        wl_shm_pool_destroy(pool);
+        wl_shell_destroy(shell);
+        wl_shm_destroy(shm);
+        wl_compositor_destroy(compositor);
+        wl_registry_destroy(registry);
+        wl_display_roundtrip(display);
+        wl_display_disconnect(display);
+    }
+
+    void draw(Surface& s)
+    {
+        auto const free_buffer = std::find_if(std::begin(s.buffers), std::end(s.buffers),
+            [](Buffer const& b) { return !b.busy; });
+        if (free_buffer == std::end(s.buffers))
+            return;
+
+        free_buffer->busy = true;
+        wl_surface_attach(s.surface, free_buffer->buffer, 0, 0);
+        wl_surface_damage(s.surface, 0, 0, surface_width, surface_height);
+        s.frame_callback = wl_surface_frame(s.surface);
+        wl_callback_add_listener(s.frame_callback, &frame_listener, &s);
+        wl_surface_commit(s.surface);
+    }
+
+    void dispatch_until(steady_clock::time_point deadline)
+    {
+        while (wl_display_prepare_read(display) != 0)
+            wl_display_dispatch_pending(display);
+        wl_display_flush(display);
+
+        auto const wait = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+        pollfd readable{wl_display_get_fd(display), POLLIN, 0};
+        if (poll(&readable, 1, std::max<int>(wait, 0)) > 0)
+            wl_display_read_events(display);
+        else
+            wl_display_cancel_read(display);
+
+        wl_display_dispatch_pending(display);
+    }
+
+    static void new_global(void* data, wl_registry* registry, uint32_t id, char const* interface, uint32_t)
+    {
+        auto const self = static_cast<WaylandStressClient*>(data);
+        std::string const name{interface};
+
+        if (name == "wl_compositor")
+            self->compositor = static_cast<wl_compositor*>(wl_registry_bind(registry, id, &wl_compositor_interface, 1));
+        else if (name == "wl_shm")
+            self->shm = static_cast<wl_shm*>(wl_registry_bind(registry, id, &wl_shm_interface, 1));
+        else if (name == "wl_shell")
+            self->shell = static_cast<wl_shell*>(wl_registry_bind(registry, id, &wl_shell_interface, 1));
+    }
+
+    static void global_remove(void*, wl_registry*, uint32_t) {}
+
+    static void frame_done(void* data, wl_callback* callback, uint32_t)
+    {
+        auto const s = static_cast<Surface*>(data);
+        wl_callback_destroy(callback);
+        s->frame_callback = nullptr;
+        ++s->client->frames_completed;
+    }
+
+    static void buffer_release(void* data, wl_buffer*)
+    {
+        static_cast<Buffer*>(data)->busy = false;
+    }
+
+    static void ping(void*, wl_shell_surface* shell_surface, uint32_t serial)
+    {
+        wl_shell_surface_pong(shell_surface, serial);
+    }
+
+    static void configure(void*, wl_shell_surface*, uint32_t, int32_t, int32_t) {}
+    static void popup_done(void*, wl_shell_surface*) {}
+
+    static wl_registry_listener const registry_listener;
+    static wl_callback_listener const frame_listener;
+    static wl_buffer_listener const buffer_listener;
+    static wl_shell_surface_listener const shell_surface_listener;
+
+    mir::Fd const fd;
+    wl_display* display{nullptr};
+    wl_compositor* compositor{nullptr};
+    wl_shm* shm{nullptr};
+    wl_shell* shell{nullptr};
+};
+
+wl_registry_listener const WaylandStressClient::registry_listener{new_global, global_remove};
+wl_callback_listener const WaylandStressClient::frame_listener{frame_done};
+wl_buffer_listener const WaylandStressClient::buffer_listener{buffer_release};
+wl_shell_surface_listener const WaylandStressClient::shell_surface_listener{ping, configure, popup_done};
+
+/// Times each composite, and remembers the compositor IDs for sampling surfaces' buffer queues
+struct TimedCompositorFactory : mc::DisplayBufferCompositorFactory
+{
+    struct TimedCompositor : mc::DisplayBufferCompositor
+    {
+        TimedCompositor(std::unique_ptr<mc::DisplayBufferCompositor> wrapped, mt::LatencyHistogram& composite_time) :
+            wrapped{std::move(wrapped)}, composite_time{composite_time} {}
+
+        void composite(mc::SceneElementSequence&& elements) override
+        {
+            auto const start = steady_clock::now();
+            wrapped->composite(std::move(elements));
+            composite_time.record(duration_cast<microseconds>(steady_clock::now() - start));
+        }
+
+        std::unique_ptr<mc::DisplayBufferCompositor> const wrapped;
+        mt::LatencyHistogram& composite_time;
+    };
+
+    std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(mg::DisplayBuffer& buffer) override
+    {
+        std::unique_ptr<mc::DisplayBufferCompositor> result =
+            std::make_unique<TimedCompositor>(headless.create_compositor_for(buffer), composite_time);
+        std::lock_guard<std::mutex> lock{mutex};
+        compositor_ids.insert(result.get());
+        return result;
+    }
+
+    auto ids() const -> std::set<void const*>
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return compositor_ids;
+    }
+
+    mtf::HeadlessDisplayBufferCompositorFactory headless;
+    mt::LatencyHistogram composite_time;
+
+    std::mutex mutable mutex;
+    std::set<void const*> compositor_ids;
+};
+
+struct SurfaceTracker : ms::NullSessionListener
+{
+    void surface_created(ms::Session&, std::shared_ptr<ms::Surface> const& surface) override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        surfaces.push_back(surface);
+    }
+
+    auto live_surfaces() const -> std::vector<std::shared_ptr<ms::Surface>>
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        std::vector<std::shared_ptr<ms::Surface>> result;
+        for (auto const& surface : surfaces)
+        {
+            if (auto const live = surface.lock())
+                result.push_back(live);
+        }
+        return result;
+    }
+
+    std::mutex mutable mutex;
+    std::vector<std::weak_ptr<ms::Surface>> surfaces;
+};
+
+auto resident_set_kb() -> long
+{
+    std::ifstream status{"/proc/self/status"};
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            return std::stol(line.substr(6));
+    }
+    return 0;
+}
+
+/// CPU time of the whole process, and of the threads belonging to the stress clients
+struct CpuTimes
+{
+    nanoseconds process;
+    nanoseconds clients;
+
+    static auto now() -> CpuTimes
+    {
+        timespec process_time;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &process_time);
+
+        auto const tick = nanoseconds{seconds{1}} / sysconf(_SC_CLK_TCK);
+        nanoseconds clients{0};
+
+        if (auto const tasks = opendir("/proc/self/task"))
+        {
+            while (auto const task = readdir(tasks))
+            {
+                if (task->d_name[0] == '.')
+                    continue;
+
+                std::ifstream stat_file{std::string{"/proc/self/task/"} + task->d_name + "/stat"};
+                std::string stat;
+                std::getline(stat_file, stat);
+
+                auto const comm_start = stat.find('(');
+                auto const comm_end = stat.rfind(')');
+                if (comm_start == std::string::npos || comm_end == std::string::npos)
+                    continue;
+
+                auto const comm = stat.substr(comm_start + 1, comm_end - comm_start - 1);
+                if (comm != client_thread_name && comm != mirclient_thread_name)
+                    continue;
+
+                // Fields after the command are state, ..., utime (the 12th) and stime (the 13th)
+                std::istringstream fields{stat.substr(comm_end + 2)};
+                std::string field;
+                for (int i = 0; i != 11; ++i)
+                    fields >> field;
+                long utime{0}, stime{0};
+                fields >> utime >> stime;
+                clients += (utime + stime) * tick;
+            }
+            closedir(tasks);
+        }
+
+        return {seconds{process_time.tv_sec} + nanoseconds{process_time.tv_nsec}, clients};
+    }
+};
+
+/* Unlike benchmarks/cpu and benchmarks/memory (which profile demo clients under valgrind)
+ * this gives numbers that show how the server scales with sessions and surfaces.
+ */
+struct Scalability : mtf::HeadlessInProcessServer, WithParamInterface<StressParameters>
+{
+    Scalability()
+    {
+        use_virtual_outputs(mtf::VirtualOutputs{});
+        server.override_the_display_buffer_compositor_factory([this] { return compositor_factory; });
+        server.override_the_session_listener([this] { return surface_tracker; });
+    }
+
+    void SetUp() override
+    {
+        mtf::HeadlessInProcessServer::SetUp();
+
+        auto const& p = GetParam();
+        for (int i = 0; i != p.wayland_clients; ++i)
+        {
+            clients.push_back(std::make_unique<WaylandStressClient>(
+                server.open_wayland_client_socket(), p.surfaces_per_client, p.commit_rate_hz));
+        }
+        for (int i = 0; i != p.mir_clients; ++i)
+        {
+            clients.push_back(std::make_unique<MirStressClient>(
+                new_connection(), p.surfaces_per_client, p.commit_rate_hz));
+        }
+    }
+
+    void TearDown() override
+    {
+        for (auto const& client : clients)
+            client->stop();
+        clients.clear();
+
+        mtf::HeadlessInProcessServer::TearDown();
+    }
+
+    std::shared_ptr<TimedCompositorFactory> const compositor_factory{std::make_shared<TimedCompositorFactory>()};
+    std::shared_ptr<SurfaceTracker> const surface_tracker{std::make_shared<SurfaceTracker>()};
+    std::vector<std::unique_ptr<StressClient>> clients;
+};
+
+void report(std::string const& name, double value)
+{
+    ::testing::Test::RecordProperty(name, std::to_string(value));
+    std::cout << "  " << name << ": " << value << std::endl;
+}
+}
+
+TEST_P(Scalability, sessions_committing_to_many_surfaces)
+{
+    auto const& p = GetParam();
+    auto const surfaces = static_cast<int>(clients.size()) * p.surfaces_per_client;
+
+    auto const rss_before_clients = resident_set_kb();
+
+    for (auto const& client : clients)
+        client->start();
+    for (auto const& client : clients)
+    {
+        ASSERT_TRUE(client->ready.wait_for(timeout));
+        ASSERT_THAT(client->failure, IsEmpty());
+    }
+
+    std::this_thread::sleep_for(warm_up);
+
+    auto const rss_at_start = resident_set_kb();
+    auto const cpu_at_start = CpuTimes::now();
+    std::vector<int> frames_at_start;
+    for (auto const& client : clients)
+        frames_at_start.push_back(client->frames());
+    mtf::take_virtual_output_frames();
+    compositor_factory->composite_time.clear();
+
+    // Sample the compositor's view of each surface's buffer queue as the clients run
+    std::vector<int> queue_depths;
+    auto const start = steady_clock::now();
+    while (steady_clock::now() < start + measurement)
+    {
+        auto const compositor_ids = compositor_factory->ids();
+        for (auto const& surface : surface_tracker->live_surfaces())
+        {
+            for (auto const id : compositor_ids)
+                queue_depths.push_back(surface->buffers_ready_for_compositor(id));
+        }
+        std::this_thread::sleep_for(sample_interval);
+    }
+    auto const elapsed = duration<double>{steady_clock::now() - start}.count();
+
+    auto const cpu_at_end = CpuTimes::now();
+    auto const composited_frames = mtf::take_virtual_output_frames().size();
+    auto const rss_at_end = resident_set_kb();
+
+    std::vector<double> client_fps;
+    for (auto i = 0u; i != clients.size(); ++i)
+    {
+        auto const frames = clients[i]->frames() - frames_at_start[i];
+        client_fps.push_back(frames / (elapsed * p.surfaces_per_client));
+    }
+
+    auto const server_cpu = (cpu_at_end.process - cpu_at_start.process) - (cpu_at_end.clients - cpu_at_start.clients);
+
+    double sum_fps{0}, sum_squared_fps{0};
+    for (auto const fps : client_fps)
+    {
+        sum_fps += fps;
+        sum_squared_fps += fps * fps;
+    }
+    // Jain's index: 1 when every client gets the same frame rate, 1/n when one gets it all
+    auto const fairness = sum_squared_fps > 0 ? sum_fps * sum_fps / (client_fps.size() * sum_squared_fps) : 0;
+
+    double sum_depth{0};
+    for (auto const depth : queue_depths)
+        sum_depth += depth;
+
+    auto const& composite_time = compositor_factory->composite_time;
+
+    std::cout << ::testing::PrintToString(p) << ":" << std::endl;
+    report("sessions", clients.size());
+    report("surfaces", surfaces);
+    report("composited_fps", composited_frames / elapsed);
+    report("server_cpu_per_frame_us",
+        composited_frames ? duration_cast<microseconds>(server_cpu).count() / double(composited_frames) : 0);
+    report("server_cpu_percent", 100 * duration<double>{server_cpu}.count() / elapsed);
+    report("rss_per_surface_kb", double(rss_at_start - rss_before_clients) / surfaces);
+    report("rss_growth_during_run_kb", rss_at_end - rss_at_start);
+    report("composite_p50_us", composite_time.percentile(50).count());
+    report("composite_p99_us", composite_time.percentile(99).count());
+    report("buffer_queue_depth_mean", queue_depths.empty() ? 0 : sum_depth / queue_depths.size());
+    report("buffer_queue_depth_max", queue_depths.empty() ? 0 : *std::max_element(begin(queue_depths), end(queue_depths)));
+    report("client_fps_min", *std::min_element(begin(client_fps), end(client_fps)));
+    report("client_fps_mean", sum_fps / client_fps.size());
+    report("client_fps_max", *std::max_element(begin(client_fps), end(client_fps)));
+    report("client_fps_fairness", fairness);
+
+    EXPECT_THAT(composited_frames, Gt(0u));
+    // A starved client is the clearest sign of a scaling cliff
+    EXPECT_THAT(*std::min_element(begin(client_fps), end(client_fps)), Gt(0.0));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    StressLadder,
+    Scalability,
+    Values(
+        StressParameters{8, 8, 2, 60},
+        StressParameters{50, 50, 3, 30},
+        StressParameters{150, 150, 4, 20}));
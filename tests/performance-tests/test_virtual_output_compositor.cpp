@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_test_framework/connected_client_with_a_window.h"
+#include "mir_test_framework/virtual_output_platform.h"
+
+#include "mir_toolkit/mir_client_library.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+int const frames{240};
+double const refresh_rate_hz{60.0};
+
+// Runs on the simulated outputs of graphics-virtual.so, so needs no GPU
+struct VirtualOutputCompositorPerformance : mtf::ConnectedClientWithAWindow
+{
+    VirtualOutputCompositorPerformance()
+    {
+        mtf::VirtualOutputs outputs;
+        outputs.sizes = "1920x1080,1280x720";
+        outputs.refresh_rate_hz = refresh_rate_hz;
+        outputs.flip_latency = microseconds{2000};
+        outputs.flip_jitter = microseconds{500};
+        use_virtual_outputs(outputs);
+    }
+
+    void report(unsigned int output_id, std::vector<mtf::VirtualOutputFrame> const& output_frames)
+    {
+        std::vector<microseconds> latencies;
+        for (auto const& frame : output_frames)
+            latencies.push_back(duration_cast<microseconds>(frame.presented - frame.posted));
+        std::sort(begin(latencies), end(latencies));
+
+        auto const elapsed = output_frames.back().presented - output_frames.front().presented;
+        auto const fps = (output_frames.size() - 1) / duration<double>{elapsed}.count();
+        auto const vblanks = output_frames.back().msc - output_frames.front().msc;
+        auto const missed = vblanks - static_cast<int64_t>(output_frames.size() - 1);
+
+        auto const prefix = "output" + std::to_string(output_id);
+        RecordProperty(prefix + "_fps", static_cast<int>(fps));
+        RecordProperty(prefix + "_missed_vblanks", static_cast<int>(missed));
+        RecordProperty(prefix + "_flip_latency_p50_us", static_cast<int>(latencies[latencies.size() / 2].count()));
+        RecordProperty(prefix + "_flip_latency_max_us", static_cast<int>(latencies.back().count()));
+
+        std::cout << "Output " << output_id << ": " << fps << " FPS, " << missed << " missed vblanks, "
+                  << "post to present p50=" << latencies[latencies.size() / 2].count()
+                  << "us max=" << latencies.back().count() << "us" << std::endl;
+    }
+};
+}
+
+TEST_F(VirtualOutputCompositorPerformance, composites_every_output_at_its_refresh_rate)
+{
+    mtf::take_virtual_output_frames();
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    auto const stream = mir_window_get_buffer_stream(window);
+#pragma GCC diagnostic pop
+    for (int i = 0; i != frames; ++i)
+        mir_buffer_stream_swap_buffers_sync(stream);
+
+    std::map<unsigned int, std::vector<mtf::VirtualOutputFrame>> frames_by_output;
+    for (auto const& frame : mtf::take_virtual_output_frames())
+        frames_by_output[frame.output_id].push_back(frame);
+
+    ASSERT_THAT(frames_by_output.size(), Eq(2u));
+
+    for (auto const& output : frames_by_output)
+    {
+        ASSERT_THAT(output.second.size(), Gt(1u));
+
+        for (auto i = 1u; i != output.second.size(); ++i)
+            EXPECT_THAT(output.second[i].msc, Gt(output.second[i-1].msc));
+
+        report(output.first, output.second);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "system_performance_test.h"
+
+#include <xcb/xcb.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace std::literals::chrono_literals;
+using namespace mir::test;
+
+namespace
+{
+struct X11StartupPerformance : SystemPerformanceTest
+{
+    void start_server(std::string const& extra_args)
+    {
+        SystemPerformanceTest::set_up_with(
+            "--x11-display-experimental " + std::to_string(x11_display) + " " + extra_args);
+
+        // The X11 socket is Mir's, so it can be connected to before Xwayland runs
+        auto const socket = "/tmp/.X11-unix/X" + std::to_string(x11_display);
+        struct stat s;
+        for (int i = 0; i != 500 && stat(socket.c_str(), &s) != 0; ++i)
+            std::this_thread::sleep_for(10ms);
+    }
+
+    // Time from an X11 client connecting to its first window being mapped
+    std::chrono::milliseconds time_to_first_window()
+    {
+        auto const start = std::chrono::steady_clock::now();
+
+        auto const display = ":" + std::to_string(x11_display);
+        auto const connection = xcb_connect(display.c_str(), nullptr);
+        if (xcb_connection_has_error(connection))
+        {
+            xcb_disconnect(connection);
+            ADD_FAILURE() << "Failed to connect to X11 display " << display;
+            return std::chrono::milliseconds::max();
+        }
+
+        auto const screen = xcb_setup_roots_iterator(xcb_get_setup(connection)).data;
+        auto const window = xcb_generate_id(connection);
+        uint32_t const events = XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+        xcb_create_window(connection, XCB_COPY_FROM_PARENT, window, screen->root, 0, 0, 100, 100, 0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT, screen->root_visual, XCB_CW_EVENT_MASK, &events);
+        xcb_map_window(connection, window);
+        xcb_flush(connection);
+
+        bool mapped = false;
+        while (!mapped)
+        {
+            auto const event = xcb_wait_for_event(connection);
+            if (!event)
+                break;
+
+            mapped = (event->response_type & ~0x80) == XCB_MAP_NOTIFY;
+            free(event);
+        }
+
+        auto const elapsed = std::chrono::steady_clock::now() - start;
+        xcb_disconnect(connection);
+
+        EXPECT_TRUE(mapped);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    }
+
+    bool have_xwayland() const
+    {
+        if (access("/usr/bin/Xwayland", X_OK) == 0)
+            return true;
+
+        std::cout << "Skipping: /usr/bin/Xwayland is not installed" << std::endl;
+        return false;
+    }
+
+    int const x11_display = 100 + getpid() % 100;
+};
+}
+
+TEST_F(X11StartupPerformance, first_window_when_xserver_starts_on_demand)
+{
+    if (!have_xwayland())
+        return;
+
+    start_server("");
+
+    auto const first_window = time_to_first_window();
+
+    RecordProperty("time_to_first_x11_window_ms", first_window.count());
+    std::cout << "First X11 window mapped after " << first_window.count() << "ms (on demand)" << std::endl;
+}
+
+TEST_F(X11StartupPerformance, first_window_when_xserver_is_prespawned)
+{
+    if (!have_xwayland())
+        return;
+
+    start_server("--x11-prespawn-delay 0");
+
+    // Give the prespawned Xwayland time to become ready
+    std::this_thread::sleep_for(3s);
+
+    auto const first_window = time_to_first_window();
+
+    RecordProperty("time_to_first_x11_window_ms", first_window.count());
+    std::cout << "First X11 window mapped after " << first_window.count() << "ms (prespawned)" << std::endl;
+}
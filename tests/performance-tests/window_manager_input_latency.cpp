@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_window_manager_tools.h"
+
+#include <mir/events/event_builders.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <thread>
+
+using namespace miral;
+using namespace testing;
+using namespace std::chrono;
+namespace mev = mir::events;
+
+namespace
+{
+Rectangle const display_area{{0,  0}, {1280, 720}};
+
+int const pointer_events = 10000;
+auto const pointer_interval = microseconds{100};
+size_t const max_churned_windows = 50;
+
+struct PointerLatency : TestWindowManagerTools
+{
+    void SetUp() override
+    {
+        basic_window_manager.add_display_for_testing(display_area);
+        basic_window_manager.add_session(session);
+    }
+
+    void TearDown() override
+    {
+        stop_churn();
+    }
+
+    // Creates and destroys windows as fast as possible until stopped
+    void start_churn()
+    {
+        churn = std::thread{[this]
+            {
+                std::deque<std::shared_ptr<mir::scene::Surface>> surfaces;
+
+                while (!stop_churning)
+                {
+                    mir::scene::SurfaceCreationParameters creation_parameters;
+                    creation_parameters.type = mir_window_type_normal;
+                    creation_parameters.size = Size{400, 300};
+
+                    auto const id = basic_window_manager.add_surface(session, creation_parameters, &create_surface);
+                    surfaces.push_back(session->surface(id));
+
+                    if (surfaces.size() > max_churned_windows)
+                    {
+                        basic_window_manager.remove_surface(session, surfaces.front());
+                        surfaces.pop_front();
+                    }
+                }
+
+                for (auto const& surface : surfaces)
+                    basic_window_manager.remove_surface(session, surface);
+            }};
+    }
+
+    void stop_churn()
+    {
+        stop_churning = true;
+        if (churn.joinable())
+            churn.join();
+    }
+
+    auto measure_pointer_latency() -> std::vector<nanoseconds>
+    {
+        std::vector<nanoseconds> latencies;
+        latencies.reserve(pointer_events);
+
+        for (int i = 0; i != pointer_events; ++i)
+        {
+            auto const event = mev::make_event(
+                MirInputDeviceId{0}, steady_clock::now().time_since_epoch(), std::vector<uint8_t>{},
+                mir_input_event_modifier_none, mir_pointer_action_motion, 0,
+                i % display_area.size.width.as_int(), i % display_area.size.height.as_int(), 0, 0, 1, 1);
+
+            auto const pointer_event = mir_input_event_get_pointer_event(mir_event_get_input_event(event.get()));
+
+            auto const start = steady_clock::now();
+            basic_window_manager.handle_pointer_event(pointer_event);
+            latencies.push_back(steady_clock::now() - start);
+
+            std::this_thread::sleep_for(pointer_interval);
+        }
+
+        std::sort(begin(latencies), end(latencies));
+        return latencies;
+    }
+
+    void report(std::string const& scenario, std::vector<nanoseconds> const& latencies)
+    {
+        auto const percentile = [&](double p)
+            { return duration_cast<microseconds>(latencies[static_cast<size_t>(p * (latencies.size() - 1))]).count(); };
+
+        RecordProperty(scenario + "_p50_us", static_cast<int>(percentile(0.5)));
+        RecordProperty(scenario + "_p99_us", static_cast<int>(percentile(0.99)));
+        RecordProperty(scenario + "_p999_us", static_cast<int>(percentile(0.999)));
+        RecordProperty(scenario + "_max_us", static_cast<int>(percentile(1.0)));
+
+        std::cout << "Pointer handling latency (" << scenario << "): p50=" << percentile(0.5)
+                  << "us p99=" << percentile(0.99) << "us p99.9=" << percentile(0.999)
+                  << "us max=" << percentile(1.0) << "us" << std::endl;
+    }
+
+    std::atomic<bool> stop_churning{false};
+    std::thread churn;
+};
+}
+
+TEST_F(PointerLatency, without_surface_churn)
+{
+    report("idle", measure_pointer_latency());
+}
+
+TEST_F(PointerLatency, with_concurrent_surface_churn)
+{
+    start_churn();
+
+    auto const latencies = measure_pointer_latency();
+
+    stop_churn();
+
+    report("churn", latencies);
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_window_manager_tools.h"
+
+#include <miral/minimal_window_manager.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace miral;
+using namespace testing;
+namespace mt = mir::test;
+
+namespace
+{
+Rectangle const display_area{{0,  0}, {1280, 720}};
+
+int const sessions_count = 10;
+int const iterations = 100;
+
+// Unlike StubFocusController this has enough state for focus_next_application() to terminate
+struct CyclingFocusController : mir::shell::FocusController
+{
+    void focus_next_session() override
+    {
+        current = (current + 1) % sessions.size();
+        surface.reset();
+    }
+
+    void focus_prev_session() override
+    {
+        current = (current + sessions.size() - 1) % sessions.size();
+        surface.reset();
+    }
+
+    auto focused_session() const -> std::shared_ptr<mir::scene::Session> override
+    {
+        return sessions.empty() ? nullptr : sessions[current];
+    }
+
+    void set_focus_to(
+        std::shared_ptr<mir::scene::Session> const& focus_session,
+        std::shared_ptr<mir::scene::Surface> const& focus_surface) override
+    {
+        auto const found = std::find(begin(sessions), end(sessions), focus_session);
+        if (found != end(sessions))
+            current = found - begin(sessions);
+        surface = focus_surface;
+    }
+
+    auto focused_surface() const -> std::shared_ptr<mir::scene::Surface> override { return surface; }
+
+    void raise(mir::shell::SurfaceSet const& /*windows*/) override {}
+
+    auto surface_at(mir::geometry::Point /*cursor*/) const -> std::shared_ptr<mir::scene::Surface> override
+        { return {}; }
+
+    void set_drag_and_drop_handle(std::vector<uint8_t> const& /*handle*/) override {}
+
+    void clear_drag_and_drop_handle() override {}
+
+    std::vector<std::shared_ptr<mir::scene::Session>> sessions;
+    size_t current = 0;
+    std::shared_ptr<mir::scene::Surface> surface;
+};
+
+struct Policy
+{
+    char const* name;
+    WindowManagementPolicyBuilder build;
+};
+
+auto operator<<(std::ostream& out, Policy const& policy) -> std::ostream&
+{
+    return out << policy.name;
+}
+
+// CanonicalWindowManagerPolicy leaves input handling to the shell built on it
+struct CanonicalWindowManager : CanonicalWindowManagerPolicy
+{
+    using CanonicalWindowManagerPolicy::CanonicalWindowManagerPolicy;
+
+    bool handle_keyboard_event(MirKeyboardEvent const* /*event*/) override { return false; }
+    bool handle_touch_event(MirTouchEvent const* /*event*/) override { return false; }
+    bool handle_pointer_event(MirPointerEvent const* /*event*/) override { return false; }
+
+    void handle_request_move(WindowInfo& /*window_info*/, MirInputEvent const* /*input_event*/) override {}
+    void handle_request_resize(WindowInfo& /*window_info*/, MirInputEvent const* /*input_event*/, MirResizeEdge /*edge*/) override {}
+};
+
+Policy const minimal{"MinimalWindowManager", [](WindowManagerTools const& tools)
+    { return std::unique_ptr<WindowManagementPolicy>{std::make_unique<MinimalWindowManager>(tools)}; }};
+
+Policy const canonical{"CanonicalWindowManager", [](WindowManagerTools const& tools)
+    { return std::unique_ptr<WindowManagementPolicy>{std::make_unique<CanonicalWindowManager>(tools)}; }};
+
+struct WindowManagerScaling : TestWithParam<std::tuple<Policy, int>>
+{
+    CyclingFocusController focus_controller;
+    StubDisplayLayout display_layout;
+    StubPersistentSurfaceStore persistent_surface_store;
+    StubDisplayConfigurationObserver display_configuration_observer;
+
+    Policy const policy{std::get<0>(GetParam())};
+    int const window_count{std::get<1>(GetParam())};
+
+    BasicWindowManager basic_window_manager{
+        &focus_controller,
+        mt::fake_shared(display_layout),
+        mt::fake_shared(persistent_surface_store),
+        display_configuration_observer,
+        policy.build};
+
+    std::vector<Window> windows;
+
+    void SetUp() override
+    {
+        basic_window_manager.add_display_for_testing(display_area);
+
+        for (int i = 0; i != sessions_count; ++i)
+        {
+            focus_controller.sessions.push_back(std::make_shared<StubStubSession>());
+            basic_window_manager.add_session(focus_controller.sessions.back());
+        }
+
+        for (int i = 0; i != window_count; ++i)
+        {
+            auto const& session = focus_controller.sessions[i % sessions_count];
+
+            mir::scene::SurfaceCreationParameters creation_parameters;
+            creation_parameters.type = mir_window_type_normal;
+            creation_parameters.size = Size{400, 300};
+
+            auto const id = basic_window_manager.add_surface(session, creation_parameters, &create_surface);
+            windows.push_back(basic_window_manager.info_for(session->surface(id)).window());
+            basic_window_manager.select_active_window(windows.back());
+        }
+    }
+
+    static auto create_surface(
+        std::shared_ptr<mir::scene::Session> const& session,
+        mir::scene::SurfaceCreationParameters const& params) -> mir::frontend::SurfaceId
+    {
+        std::shared_ptr<mir::frontend::EventSink> const sink;
+        return session->create_surface(params, sink);
+    }
+
+    template<typename Operation>
+    void time(char const* operation_name, Operation const& operation)
+    {
+        auto const start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i != iterations; ++i)
+            operation(i);
+
+        auto const elapsed = std::chrono::steady_clock::now() - start;
+        auto const per_call = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / iterations;
+
+        RecordProperty(std::string{operation_name} + "_ns", static_cast<int>(per_call));
+        std::cout << policy.name << ": " << operation_name << " with " << window_count
+                  << " windows took " << per_call << "ns" << std::endl;
+    }
+};
+}
+
+TEST_P(WindowManagerScaling, focus_next_application)
+{
+    time("focus_next_application", [this](int) { basic_window_manager.focus_next_application(); });
+
+    EXPECT_THAT(basic_window_manager.active_window(), Ne(Window{}));
+}
+
+TEST_P(WindowManagerScaling, focus_next_within_application)
+{
+    time("focus_next_within_application", [this](int) { basic_window_manager.focus_next_within_application(); });
+
+    EXPECT_THAT(basic_window_manager.active_window(), Ne(Window{}));
+}
+
+TEST_P(WindowManagerScaling, select_active_window)
+{
+    time("select_active_window", [this](int i)
+        { basic_window_manager.select_active_window(windows[(i * 7919) % windows.size()]); });
+
+    EXPECT_THAT(basic_window_manager.active_window(), Ne(Window{}));
+}
+
+TEST_P(WindowManagerScaling, remove_active_window)
+{
+    time("remove_active_window", [this](int i)
+        {
+            // Removing the active window refocuses within its application
+            auto const window = basic_window_manager.active_window();
+            if (window && i < window_count)
+            {
+                basic_window_manager.remove_surface(window.application(), window);
+            }
+        });
+}
+
+INSTANTIATE_TEST_CASE_P(WindowManagerScaling, WindowManagerScaling, Combine(
+    Values(minimal, canonical),
+    Values(10, 100, 1000, 5000)));
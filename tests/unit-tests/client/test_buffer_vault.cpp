@@ -621,3 +621,127 @@ TEST_F(StartedBufferVault, can_increase_count_after_resize)
         vault.wire_transfer_inbound(package4.buffer_id());
     }
 }
+
+TEST_F(StartedBufferVault, try_withdraw_gives_an_available_buffer)
+{
+    auto buffer = vault.try_withdraw();
+    ASSERT_THAT(buffer, Ne(nullptr));
+    vault.deposit(buffer);
+}
+
+TEST_F(BufferVault, try_withdraw_gives_nothing_if_no_buffer_is_available)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(initial_nbuffers);
+
+    auto vault = make_vault();
+    EXPECT_THAT(vault->try_withdraw(), Eq(nullptr));
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+TEST_F(StartedBufferVault, try_withdraw_and_withdraw_draw_from_the_same_buffers)
+{
+    auto b1 = vault.try_withdraw();
+    auto b2 = vault.withdraw().get();
+    auto b3 = vault.try_withdraw();
+
+    ASSERT_THAT(b1, Ne(nullptr));
+    ASSERT_THAT(b3, Ne(nullptr));
+    EXPECT_THAT(b1, Ne(b2));
+    EXPECT_THAT(b2, Ne(b3));
+    EXPECT_THAT(b1, Ne(b3));
+    EXPECT_THAT(vault.try_withdraw(), Eq(nullptr));
+}
+
+TEST_F(StartedBufferVault, try_withdraw_gives_only_newly_sized_buffers_after_resize)
+{
+    EXPECT_CALL(mock_requests, free_buffer(_))
+        .Times(initial_nbuffers);
+    vault.set_size(new_size);
+
+    EXPECT_THAT(vault.try_withdraw(), Eq(nullptr));
+
+    vault.wire_transfer_inbound(package4.buffer_id());
+    auto buffer = vault.try_withdraw();
+    ASSERT_THAT(buffer, Ne(nullptr));
+    EXPECT_THAT(buffer->size(), Eq(new_size));
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+TEST_F(StartedBufferVault, each_resize_frees_the_buffers_of_the_old_size)
+{
+    EXPECT_CALL(mock_requests, free_buffer(_))
+        .Times(initial_nbuffers);
+    vault.set_size(new_size);
+    EXPECT_THAT(vault.try_withdraw(), Eq(nullptr));
+    Mock::VerifyAndClearExpectations(&mock_requests);
+
+    vault.wire_transfer_inbound(package4.buffer_id());
+
+    EXPECT_CALL(mock_requests, free_buffer(package4.buffer_id()))
+        .Times(1);
+    vault.set_size(size);
+    EXPECT_THAT(vault.try_withdraw(), Eq(nullptr));
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+// Only the most recently returned buffer is avoided: the others are not ordered by age
+TEST_F(StartedBufferVault, try_withdraw_avoids_the_buffer_returned_most_recently)
+{
+    auto buffer = vault.try_withdraw();
+    vault.deposit(buffer);
+    vault.wire_transfer_outbound(buffer, []{});
+    auto first_id = buffer->rpc_id();
+
+    buffer = vault.try_withdraw();
+    vault.deposit(buffer);
+    vault.wire_transfer_outbound(buffer, []{});
+    auto second_id = buffer->rpc_id();
+
+    vault.wire_transfer_inbound(second_id);
+    vault.wire_transfer_inbound(first_id);
+
+    EXPECT_THAT(vault.try_withdraw()->rpc_id(), Ne(first_id));
+}
+
+TEST_F(StartedBufferVault, try_withdraw_doesnt_take_a_buffer_promised_to_a_waiting_withdraw)
+{
+    std::vector<std::shared_ptr<mcl::MirBuffer>> buffers;
+    for (auto i = 0u; i != initial_nbuffers; ++i)
+        buffers.push_back(vault.withdraw().get());
+
+    auto waiting = vault.withdraw();
+
+    vault.deposit(buffers.front());
+    vault.wire_transfer_outbound(buffers.front(), []{});
+    vault.wire_transfer_inbound(buffers.front()->rpc_id());
+
+    EXPECT_THAT(vault.try_withdraw(), Eq(nullptr));
+    EXPECT_THAT(waiting.get(), Eq(buffers.front()));
+}
+
+TEST_F(StartedBufferVault, try_withdraw_throws_if_disconnected)
+{
+    vault.disconnected();
+    EXPECT_THROW({
+        vault.try_withdraw();
+    }, std::logic_error);
+}
+
+TEST_F(StartedBufferVault, observes_presentation_of_submitted_buffers_only)
+{
+    int presentations = 0;
+    vault.set_presentation_observer([&presentations] { ++presentations; });
+
+    auto buffer = vault.withdraw().get();
+    vault.deposit(buffer);
+    vault.wire_transfer_outbound(buffer, []{});
+    EXPECT_THAT(presentations, Eq(0));
+
+    vault.wire_transfer_inbound(buffer->rpc_id());
+    EXPECT_THAT(presentations, Eq(1));
+
+    // A buffer that was never submitted hasn't been presented
+    vault.wire_transfer_inbound(package4.buffer_id());
+    EXPECT_THAT(presentations, Eq(1));
+}
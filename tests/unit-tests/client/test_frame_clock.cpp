@@ -453,3 +453,105 @@ TEST_F(FrameClockTest, nesting_adds_zero_lag)
     EXPECT_EQ(one_frame, in2 - in1);
     EXPECT_EQ(one_frame, out2 - out1);
 }
+
+TEST_F(FrameClockTest, locks_onto_presentation_phase_without_resyncing)
+{
+    auto& now = fake_time[CLOCK_MONOTONIC];
+    auto const vblank = now - (now % one_frame) + 5ms;
+
+    int callbacks = 0;
+    FrameClock clock(with_fake_time);
+    clock.set_period(one_frame);
+    clock.set_resync_callback([&callbacks, &now]
+        {
+            ++callbacks;
+            return now;
+        });
+
+    clock.presented(vblank - 2*one_frame);
+    clock.presented(vblank - one_frame);
+    clock.presented(vblank);
+
+    PosixTimestamp a;
+    auto b = clock.next_frame_after(a);
+    EXPECT_EQ(0, callbacks);
+    EXPECT_EQ(vblank % one_frame, b % one_frame);
+    EXPECT_GT(b, now);
+    EXPECT_LE(b - now, one_frame);
+}
+
+TEST_F(FrameClockTest, ignores_presentation_jitter)
+{
+    auto& now = fake_time[CLOCK_MONOTONIC];
+    auto const vblank = now - (now % one_frame) + 5ms;
+
+    FrameClock clock(with_fake_time);
+    clock.set_period(one_frame);
+
+    clock.presented(vblank);
+    clock.presented(vblank + one_frame);
+    clock.presented(vblank + 2*one_frame + one_frame/3);  // delayed feedback
+
+    EXPECT_EQ(vblank % one_frame, clock.predicted_present_after(now) % one_frame);
+}
+
+TEST_F(FrameClockTest, smooths_small_presentation_errors)
+{
+    auto& now = fake_time[CLOCK_MONOTONIC];
+    auto const vblank = now - (now % one_frame) + 5ms;
+
+    FrameClock clock(with_fake_time);
+    clock.set_period(one_frame);
+
+    clock.presented(vblank);
+    clock.presented(vblank + one_frame + 400us);
+
+    auto const phase = clock.predicted_present_after(now) % one_frame;
+    EXPECT_GT(phase, vblank % one_frame);
+    EXPECT_LT(phase, (vblank + 400us) % one_frame);
+}
+
+TEST_F(FrameClockTest, follows_presentations_that_consistently_move)
+{
+    auto& now = fake_time[CLOCK_MONOTONIC];
+    auto const vblank = now - (now % one_frame) + 5ms;
+    auto const moved = vblank + one_frame/2;
+
+    FrameClock clock(with_fake_time);
+    clock.set_period(one_frame);
+
+    clock.presented(vblank);
+    clock.presented(vblank + one_frame);
+
+    clock.presented(moved + one_frame);
+    clock.presented(moved + 2*one_frame);
+    clock.presented(moved + 3*one_frame);
+
+    EXPECT_EQ(moved % one_frame, clock.predicted_present_after(now) % one_frame);
+}
+
+TEST_F(FrameClockTest, predicts_presentation_at_the_next_vblank)
+{
+    auto& now = fake_time[CLOCK_MONOTONIC];
+    auto const vblank = now - (now % one_frame) + 5ms;
+
+    FrameClock clock(with_fake_time);
+    clock.set_period(one_frame);
+    clock.presented(vblank);
+
+    auto const predicted = clock.predicted_present_after(vblank);
+    EXPECT_EQ(vblank + one_frame, predicted);
+
+    auto const later = vblank + one_frame/3;
+    EXPECT_EQ(vblank + one_frame, clock.predicted_present_after(later));
+}
+
+TEST_F(FrameClockTest, predicts_immediate_presentation_when_unthrottled)
+{
+    auto& now = fake_time[CLOCK_MONOTONIC];
+
+    FrameClock clock(with_fake_time);
+    clock.presented(now);
+
+    EXPECT_EQ(now, clock.predicted_present_after(now));
+}
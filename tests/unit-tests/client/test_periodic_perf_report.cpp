@@ -39,7 +39,7 @@ public:
     {
     }
 
-    MOCK_CONST_METHOD5(display, void(const char*,long,long,long,int));
+    MOCK_CONST_METHOD8(display, void(const char*,long,long,long,int,long,long,long));
 };
 
 struct PeriodicPerfReport : ::testing::Test
@@ -73,13 +73,19 @@ TEST_F(PeriodicPerfReport, reports_the_right_numbers_at_full_speed)
                                 fps*100,
                                 expected_render_time,
                                 Le(expected_lag), // first report is less
-                                nbuffers))
+                                nbuffers,
+                                Le(expected_lag),
+                                Le(expected_lag),
+                                0))
                 .Times(1);
     EXPECT_CALL(report, display(StrEq(name),
                                 fps*100,
                                 expected_render_time,
                                 expected_lag, // exact, after first report
-                                nbuffers))
+                                nbuffers,
+                                expected_lag,
+                                expected_lag,
+                                0))
                 .Times(nreports - 1);
 
     for (int f = 0; f < nframes; ++f)
@@ -110,6 +116,9 @@ TEST_F(PeriodicPerfReport, reports_the_right_numbers_at_low_speed)
                                 100/frame_time.count(),
                                 render_time.count(),
                                 _,
+                                _,
+                                _,
+                                _,
                                 _))
                 .Times(nframes);
 
@@ -126,7 +135,45 @@ TEST_F(PeriodicPerfReport, reports_the_right_numbers_at_low_speed)
 TEST_F(PeriodicPerfReport, reports_nothing_on_idle)
 {
     using namespace testing;
-    EXPECT_CALL(report, display(_,_,_,_,_)).Times(0);
+    EXPECT_CALL(report, display(_,_,_,_,_,_,_,_)).Times(0);
     clock->advance_by(std::chrono::seconds(10));
 }
 
+TEST_F(PeriodicPerfReport, reports_missed_frames_and_lag_percentiles)
+{
+    int const fps = 50;
+    int const nbuffers = 3;
+    std::chrono::microseconds const render_time = std::chrono::milliseconds(3);
+    auto const frame_time = std::chrono::microseconds(1000000 / fps);
+
+    using namespace testing;
+
+    long lag_p50 = 0, lag_p99 = 0, missed100 = 0;
+    EXPECT_CALL(report, display(_,_,_,_,_,_,_,_))
+        .WillRepeatedly(Invoke([&](const char*, long, long, long, int, long p50, long p99, long missed)
+            {
+                lag_p50 = p50;
+                lag_p99 = p99;
+                missed100 = missed;
+            }));
+
+    int const nframes = 500;
+    for (int f = 0; f < nframes; ++f)
+    {
+        int const buffer_id = f % nbuffers;
+
+        // Every tenth frame misses a whole frame
+        clock->advance_by(frame_time - render_time);
+        if (f % 10 == 9)
+            clock->advance_by(frame_time);
+
+        report.begin_frame(buffer_id);
+        clock->advance_by(render_time);
+        report.end_frame(buffer_id);
+    }
+
+    // About one in eleven frame slots was missed (depending where the report falls)
+    EXPECT_THAT(missed100, AllOf(Gt(700), Lt(1100)));
+    EXPECT_THAT(lag_p50, Eq(nbuffers * frame_time.count() - render_time.count()));
+    EXPECT_THAT(lag_p99, Gt(lag_p50));
+}
@@ -134,6 +134,8 @@ TEST_F(DefaultDisplayBufferCompositor, optimization_skips_composition)
     Sequence seq;
     EXPECT_CALL(*report, began_frame(_))
         .InSequence(seq);
+    EXPECT_CALL(*report, filtered_occlusions(_,_))
+        .InSequence(seq);
     EXPECT_CALL(display_buffer, overlay(_))
         .InSequence(seq)
         .WillOnce(Return(true));
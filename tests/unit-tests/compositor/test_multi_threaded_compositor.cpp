@@ -27,6 +27,7 @@
 #include "mir/raii.h"
 
 #include "mir/test/current_thread_name.h"
+#include "mir/test/signal.h"
 #include "mir/test/doubles/null_display.h"
 #include "mir/test/doubles/null_display_buffer.h"
 #include "mir/test/doubles/mock_display_buffer.h"
@@ -35,9 +36,11 @@
 #include "mir/test/doubles/stub_scene.h"
 #include "mir/test/doubles/stub_display.h"
 #include "mir/test/doubles/null_display_buffer_compositor_factory.h"
+#include "mir/test/doubles/stub_display_configuration.h"
 
 #include <boost/throw_exception.hpp>
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <thread>
@@ -69,12 +72,23 @@ public:
             f(db);
     }
 
+    void for_each_display_sync_group_preserved_by(
+        mg::DisplayConfiguration const&,
+        std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        for (auto i = 0u; i != preserved_groups && i != buffers.size(); ++i)
+            f(buffers[i]);
+    }
+
     void for_each_mock_buffer(std::function<void(mtd::MockDisplayBuffer&)> const& f)
     {
         for (auto& db : buffers)
             f(db.buffer);
     }
 
+    // The number of groups reported as surviving a reconfiguration
+    unsigned int preserved_groups{0};
+
 private:
     struct StubDisplaySyncGroup : mg::DisplaySyncGroup
     {
@@ -270,6 +284,48 @@ private:
     std::unordered_map<mg::DisplayBuffer*,Record> records;
 };
 
+// Counts the compositors alive, and signals each frame composited for watched_buffer
+class CountingDisplayBufferCompositorFactory : public mc::DisplayBufferCompositorFactory
+{
+public:
+    std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(mg::DisplayBuffer& display_buffer) override
+    {
+        return std::make_unique<CountingDisplayBufferCompositor>(*this, display_buffer);
+    }
+
+    mg::DisplayBuffer* watched_buffer{nullptr};
+    mt::Signal composited;
+    std::atomic<int> live_compositors{0};
+
+private:
+    class CountingDisplayBufferCompositor : public mc::DisplayBufferCompositor
+    {
+    public:
+        CountingDisplayBufferCompositor(CountingDisplayBufferCompositorFactory& factory, mg::DisplayBuffer& buffer)
+            : factory{factory}, buffer{buffer}
+        {
+            ++factory.live_compositors;
+        }
+
+        ~CountingDisplayBufferCompositor()
+        {
+            --factory.live_compositors;
+        }
+
+        void composite(mc::SceneElementSequence&&) override
+        {
+            if (&buffer == factory.watched_buffer)
+                factory.composited.raise();
+            /* Reduce run-time under valgrind */
+            std::this_thread::yield();
+        }
+
+    private:
+        CountingDisplayBufferCompositorFactory& factory;
+        mg::DisplayBuffer& buffer;
+    };
+};
+
 class SurfaceUpdatingDisplayBufferCompositor : public mc::DisplayBufferCompositor
 {
 public:
@@ -457,6 +513,10 @@ TEST(MultiThreadedCompositor, reports_in_the_right_places)
         .Times(1);
     EXPECT_CALL(*mock_report, scheduled())
         .Times(2);
+    EXPECT_CALL(*mock_report, began_scene_snapshot(_))
+        .Times(AtLeast(1));
+    EXPECT_CALL(*mock_report, posted_frame(_))
+        .Times(AtLeast(1));
 
     EXPECT_CALL(*mock_report, stopped())
         .Times(AtLeast(1));
@@ -948,3 +1008,152 @@ TEST(MultiThreadedCompositor, can_schedule_from_display_observer_when_removing_d
         display, stub_scene, db_compositor_factory, mock_display_listener, mock_report, default_delay, true};
     compositor.start();
 }
+
+TEST(MultiThreadedCompositor, reconfigure_only_restarts_compositing_for_groups_not_preserved)
+{
+    using namespace testing;
+    unsigned int const nbuffers{3};
+    auto display = std::make_shared<StubDisplayWithMockBuffers>(nbuffers);
+    auto stub_scene = std::make_shared<NiceMock<StubScene>>();
+    auto mock_display_listener = std::make_shared<NiceMock<MockDisplayListener>>();
+    auto db_compositor_factory = std::make_shared<mtd::NullDisplayBufferCompositorFactory>();
+    mtd::StubDisplayConfig const conf;
+
+    mc::MultiThreadedCompositor compositor{
+        display, stub_scene, db_compositor_factory, mock_display_listener, null_report, default_delay, true};
+
+    compositor.start();
+    Mock::VerifyAndClearExpectations(mock_display_listener.get());
+
+    display->preserved_groups = 1;
+    bool applied{false};
+
+    InSequence seq;
+    EXPECT_CALL(*mock_display_listener, remove_display(_)).Times(nbuffers - 1);
+    EXPECT_CALL(*mock_display_listener, add_display(_)).Times(nbuffers - 1);
+
+    compositor.reconfigure(conf, [&] { applied = true; });
+
+    EXPECT_TRUE(applied);
+    Mock::VerifyAndClearExpectations(mock_display_listener.get());
+
+    EXPECT_CALL(*mock_display_listener, remove_display(_)).Times(nbuffers);
+    compositor.stop();
+}
+
+TEST(MultiThreadedCompositor, reconfigure_restarts_all_compositing_when_nothing_is_preserved)
+{
+    using namespace testing;
+    unsigned int const nbuffers{3};
+    auto display = std::make_shared<StubDisplayWithMockBuffers>(nbuffers);
+    auto stub_scene = std::make_shared<NiceMock<StubScene>>();
+    auto mock_display_listener = std::make_shared<NiceMock<MockDisplayListener>>();
+    auto db_compositor_factory = std::make_shared<mtd::NullDisplayBufferCompositorFactory>();
+    mtd::StubDisplayConfig const conf;
+
+    mc::MultiThreadedCompositor compositor{
+        display, stub_scene, db_compositor_factory, mock_display_listener, null_report, default_delay, true};
+
+    compositor.start();
+    Mock::VerifyAndClearExpectations(mock_display_listener.get());
+
+    InSequence seq;
+    EXPECT_CALL(*mock_display_listener, remove_display(_)).Times(nbuffers);
+    EXPECT_CALL(*mock_display_listener, add_display(_)).Times(nbuffers);
+
+    compositor.reconfigure(conf, [] {});
+
+    Mock::VerifyAndClearExpectations(mock_display_listener.get());
+}
+
+TEST(MultiThreadedCompositor, preserved_groups_are_composited_while_reconfiguration_is_applied)
+{
+    using namespace testing;
+    unsigned int const nbuffers{3};
+    auto display = std::make_shared<StubDisplayWithMockBuffers>(nbuffers);
+    auto scene = std::make_shared<StubScene>();
+    auto db_compositor_factory = std::make_shared<CountingDisplayBufferCompositorFactory>();
+    mtd::StubDisplayConfig const conf;
+
+    display->preserved_groups = nbuffers - 1;
+    display->for_each_mock_buffer([&](mtd::MockDisplayBuffer& buffer)
+        {
+            if (!db_compositor_factory->watched_buffer)
+                db_compositor_factory->watched_buffer = &buffer;
+        });
+
+    mc::MultiThreadedCompositor compositor{
+        display, scene, db_compositor_factory, null_display_listener, null_report, default_delay, true};
+
+    compositor.start();
+
+    compositor.reconfigure(conf, [&]
+        {
+            // Only the group being replaced has stopped compositing...
+            EXPECT_THAT(db_compositor_factory->live_compositors.load(), Eq(static_cast<int>(nbuffers - 1)));
+
+            // ...the others still composite frames while the change is applied
+            db_compositor_factory->composited.reset();
+            scene->emit_change_event();
+            EXPECT_TRUE(db_compositor_factory->composited.wait_for(10s));
+        });
+
+    EXPECT_THAT(db_compositor_factory->live_compositors.load(), Eq(static_cast<int>(nbuffers)));
+
+    compositor.stop();
+}
+
+TEST(MultiThreadedCompositor, stop_while_reconfiguration_is_applied_stops_compositing_afterwards)
+{
+    using namespace testing;
+    unsigned int const nbuffers{3};
+    auto display = std::make_shared<StubDisplayWithMockBuffers>(nbuffers);
+    auto scene = std::make_shared<StubScene>();
+    auto db_compositor_factory = std::make_shared<CountingDisplayBufferCompositorFactory>();
+    auto mock_report = std::make_shared<NiceMock<mtd::MockCompositorReport>>();
+    mtd::StubDisplayConfig const conf;
+
+    display->preserved_groups = 1;
+
+    mc::MultiThreadedCompositor compositor{
+        display, scene, db_compositor_factory, null_display_listener, mock_report, default_delay, true};
+
+    compositor.start();
+
+    EXPECT_CALL(*mock_report, stopped()).Times(1);
+
+    compositor.reconfigure(conf, [&] { compositor.stop(); });
+
+    EXPECT_THAT(db_compositor_factory->live_compositors.load(), Eq(0));
+    Mock::VerifyAndClearExpectations(mock_report.get());
+
+    compositor.start();
+
+    EXPECT_THAT(db_compositor_factory->live_compositors.load(), Eq(static_cast<int>(nbuffers)));
+
+    compositor.stop();
+}
+
+TEST(MultiThreadedCompositor, nothing_is_composited_while_reconfiguration_is_applied_when_nothing_is_preserved)
+{
+    using namespace testing;
+    unsigned int const nbuffers{3};
+    auto display = std::make_shared<StubDisplayWithMockBuffers>(nbuffers);
+    auto scene = std::make_shared<StubScene>();
+    auto db_compositor_factory = std::make_shared<CountingDisplayBufferCompositorFactory>();
+    mtd::StubDisplayConfig const conf;
+
+    mc::MultiThreadedCompositor compositor{
+        display, scene, db_compositor_factory, null_display_listener, null_report, default_delay, true};
+
+    compositor.start();
+
+    compositor.reconfigure(conf, [&]
+        {
+            EXPECT_THAT(db_compositor_factory->live_compositors.load(), Eq(0));
+        });
+
+    EXPECT_THAT(db_compositor_factory->live_compositors.load(), Eq(static_cast<int>(nbuffers)));
+
+    compositor.stop();
+}
@@ -23,6 +23,7 @@
 #include "src/server/frontend/event_sender.h"
 
 #include "mir/events/event_builders.h"
+#include "mir/events/event_private.h"
 #include "mir/client_visible_error.h"
 
 #include "mir/test/display_config_matchers.h"
@@ -109,6 +110,12 @@ struct MockMsgSender : public mf::MessageSender
 {
     MOCK_METHOD3(send, void(char const*, size_t, mf::FdSets const&));
 };
+struct MockSupersedingMsgSender : public mf::MessageSender
+{
+    MOCK_METHOD3(send, void(char const*, size_t, mf::FdSets const&));
+    MOCK_METHOD3(send_superseding, void(uint64_t, char const*, size_t));
+};
+
 struct EventSender : public testing::Test
 {
     EventSender()
@@ -120,6 +127,36 @@ struct EventSender : public testing::Test
     mfd::EventSender event_sender;
 };
 
+struct SupersedingEventSender : public testing::Test
+{
+    SupersedingEventSender()
+        : event_sender(mt::fake_shared(mock_msg_sender), mt::fake_shared(mock_buffer_packer))
+    {
+    }
+
+    auto key_for(mir::EventUPtr&& event) -> uint64_t
+    {
+        using namespace testing;
+
+        uint64_t key{0};
+        EXPECT_CALL(mock_msg_sender, send_superseding(_, _, _))
+            .WillOnce(SaveArg<0>(&key));
+        event_sender.handle_event(std::move(event));
+        Mock::VerifyAndClearExpectations(&mock_msg_sender);
+        return key;
+    }
+
+    static auto pointer_motion(MirInputDeviceId device, float x, float relative_x = 0) -> mir::EventUPtr
+    {
+        return mev::make_event(device, std::chrono::nanoseconds(0), std::vector<uint8_t>{},
+            mir_input_event_modifier_none, mir_pointer_action_motion, 0, x, 0, 0, 0, relative_x, 0);
+    }
+
+    testing::NiceMock<MockSupersedingMsgSender> mock_msg_sender;
+    mtd::MockPlatformIpcOperations mock_buffer_packer;
+    mfd::EventSender event_sender;
+};
+
 std::function<void(char const*, size_t, mir::frontend::FdSets)>
 make_validator(std::function<void(mir::protobuf::EventSequence const&)> const& sequence_validator)
 {
@@ -179,6 +216,31 @@ TEST_F(EventSender, sends_input_events)
     event_sender.handle_event(move(ev));
 }
 
+TEST_F(EventSender, sent_events_are_wire_compatible_with_protobuf_sequence)
+{
+    using namespace testing;
+
+    auto ev = mev::make_event(MirInputDeviceId(), std::chrono::nanoseconds(42), std::vector<uint8_t>{}, mir_keyboard_action_down,
+                              0, 0, mir_input_event_modifier_none);
+    auto const expected_raw = MirEvent::serialize(ev.get());
+
+    mir::protobuf::EventSequence expected_seq;
+    expected_seq.add_event()->set_raw(expected_raw);
+    mir::protobuf::wire::Result expected_result;
+    expected_result.add_events(expected_seq.SerializeAsString());
+
+    auto msg_validator = [&](char const* data, size_t len, mir::frontend::FdSets)
+        {
+            EXPECT_THAT(std::string(data, len), Eq(expected_result.SerializeAsString()));
+        };
+
+    EXPECT_CALL(mock_msg_sender, send(_, _, _))
+        .Times(1)
+        .WillOnce(Invoke(msg_validator));
+
+    event_sender.handle_event(move(ev));
+}
+
 TEST_F(EventSender, packs_buffer_with_platform_packer)
 {
     using namespace testing;
@@ -307,3 +369,67 @@ TEST_F(EventSender, sends_errors)
 
     event_sender.handle_error(error);
 }
+
+TEST_F(SupersedingEventSender, pointer_motion_supersedes_earlier_motion_of_the_same_device)
+{
+    using namespace testing;
+
+    auto const first = key_for(pointer_motion(MirInputDeviceId{1}, 1));
+    auto const second = key_for(pointer_motion(MirInputDeviceId{1}, 2));
+    auto const other_device = key_for(pointer_motion(MirInputDeviceId{2}, 2));
+
+    EXPECT_THAT(first, Ne(0u));
+    EXPECT_THAT(second, Eq(first));
+    EXPECT_THAT(other_device, Ne(first));
+}
+
+TEST_F(SupersedingEventSender, relative_pointer_motion_is_never_superseded)
+{
+    using namespace testing;
+
+    // Each event's relative motion would be lost with it
+    EXPECT_THAT(key_for(pointer_motion(MirInputDeviceId{1}, 1, 1)), Eq(0u));
+}
+
+TEST_F(SupersedingEventSender, resize_supersedes_earlier_resize_of_the_same_surface)
+{
+    using namespace testing;
+
+    auto const first = key_for(mev::make_event(mf::SurfaceId{1}, {10, 10}));
+    auto const second = key_for(mev::make_event(mf::SurfaceId{1}, {20, 20}));
+    auto const other_surface = key_for(mev::make_event(mf::SurfaceId{2}, {20, 20}));
+
+    EXPECT_THAT(first, Ne(0u));
+    EXPECT_THAT(second, Eq(first));
+    EXPECT_THAT(other_surface, Ne(first));
+}
+
+TEST_F(SupersedingEventSender, key_and_button_events_are_never_superseded)
+{
+    using namespace testing;
+
+    auto const key = key_for(mev::make_event(MirInputDeviceId{1}, std::chrono::nanoseconds(0), std::vector<uint8_t>{},
+        mir_keyboard_action_down, 0, 0, mir_input_event_modifier_none));
+    auto const button = key_for(mev::make_event(MirInputDeviceId{1}, std::chrono::nanoseconds(0), std::vector<uint8_t>{},
+        mir_input_event_modifier_none, mir_pointer_action_button_down, mir_pointer_button_primary, 0, 0, 0, 0, 0, 0));
+
+    EXPECT_THAT(key, Eq(0u));
+    EXPECT_THAT(button, Eq(0u));
+}
+
+TEST_F(SupersedingEventSender, pings_supersede_earlier_pings)
+{
+    using namespace testing;
+
+    std::vector<uint64_t> keys;
+    EXPECT_CALL(mock_msg_sender, send_superseding(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](uint64_t key, char const*, size_t) { keys.push_back(key); }));
+
+    event_sender.send_ping(1);
+    event_sender.send_ping(2);
+
+    ASSERT_THAT(keys, SizeIs(2));
+    EXPECT_THAT(keys[0], Ne(0u));
+    EXPECT_THAT(keys[1], Eq(keys[0]));
+}
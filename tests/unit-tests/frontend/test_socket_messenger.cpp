@@ -0,0 +1,236 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/socket_messenger.h"
+
+#include <boost/asio.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+
+namespace mfd = mir::frontend::detail;
+namespace ba = boost::asio;
+
+using namespace testing;
+
+namespace
+{
+size_t const message_size = 60000;
+
+struct SocketMessenger : Test
+{
+    void create_messenger(size_t queue_limit, mfd::QueueOverflowPolicy policy)
+    {
+        auto const server_socket = std::make_shared<ba::local::stream_protocol::socket>(io);
+        ba::local::connect_pair(*server_socket, client_socket);
+        client_socket.set_option(ba::socket_base::receive_buffer_size(4096));
+
+        messenger = std::make_shared<mfd::SocketMessenger>(server_socket, queue_limit, policy);
+    }
+
+    ~SocketMessenger()
+    {
+        io.stop();
+        if (io_thread.joinable())
+            io_thread.join();
+    }
+
+    // Messages are numbered so that the client can check their order
+    std::vector<char> message(uint32_t number, size_t size = message_size)
+    {
+        std::vector<char> result(size, 'M');
+        memcpy(result.data(), &number, sizeof number);
+        return result;
+    }
+
+    void send(uint32_t number)
+    {
+        auto const data = message(number);
+        messenger->send(data.data(), data.size(), {});
+    }
+
+    void send_event(uint32_t number)
+    {
+        auto const data = message(number);
+        messenger->send_superseding(0, data.data(), data.size());
+    }
+
+    // Sends numbered messages until the client's socket is full and they are queued
+    uint32_t send_until_queued()
+    {
+        uint32_t number = 0;
+        while (messenger->queue_stats().queued_messages == 0)
+        {
+            if (number == 1000)
+                throw std::runtime_error{"Messages never queued"};
+            send(number++);
+        }
+        return number;
+    }
+
+    void start_writing_queued_messages()
+    {
+        io_thread = std::thread{[this]
+            {
+                ba::io_service::work work{io};
+                io.run();
+            }};
+    }
+
+    uint32_t receive()
+    {
+        unsigned char header[2];
+        ba::read(client_socket, ba::buffer(header));
+        std::vector<char> data(header[0] << 8 | header[1]);
+        ba::read(client_socket, ba::buffer(data));
+
+        uint32_t number;
+        memcpy(&number, data.data(), sizeof number);
+        return number;
+    }
+
+    ba::io_service io;
+    ba::local::stream_protocol::socket client_socket{io};
+    std::shared_ptr<mfd::SocketMessenger> messenger;
+    std::thread io_thread;
+};
+}
+
+TEST_F(SocketMessenger, sends_immediately_when_client_keeps_up)
+{
+    create_messenger(mfd::SocketMessenger::default_queue_limit, mfd::QueueOverflowPolicy::disconnect);
+
+    send(7);
+
+    EXPECT_THAT(messenger->queue_stats().queued_messages, Eq(0u));
+    EXPECT_THAT(receive(), Eq(7u));
+}
+
+TEST_F(SocketMessenger, queued_messages_are_delivered_in_order_when_client_reads)
+{
+    create_messenger(mfd::SocketMessenger::default_queue_limit, mfd::QueueOverflowPolicy::disconnect);
+
+    auto const sent = send_until_queued();
+    send(sent);
+    send(sent + 1);
+
+    EXPECT_THAT(messenger->queue_stats().queued_messages, Ge(2u));
+
+    start_writing_queued_messages();
+
+    for (uint32_t expected = 0; expected != sent + 2; ++expected)
+        EXPECT_THAT(receive(), Eq(expected));
+
+    EXPECT_THAT(messenger->queue_stats().queued_messages, Eq(0u));
+    EXPECT_THAT(messenger->queue_stats().peak_queued_bytes, Gt(0u));
+}
+
+TEST_F(SocketMessenger, queued_message_is_replaced_by_superseding_message)
+{
+    create_messenger(mfd::SocketMessenger::default_queue_limit, mfd::QueueOverflowPolicy::disconnect);
+
+    auto const sent = send_until_queued();
+    auto const queued = messenger->queue_stats().queued_messages;
+
+    auto const first = message(1000, 16);
+    auto const second = message(1001, 16);
+    messenger->send_superseding(42, first.data(), first.size());
+    messenger->send_superseding(42, second.data(), second.size());
+
+    auto const stats = messenger->queue_stats();
+    EXPECT_THAT(stats.queued_messages, Eq(queued + 1));
+    EXPECT_THAT(stats.coalesced_messages, Eq(1u));
+
+    start_writing_queued_messages();
+
+    for (uint32_t expected = 0; expected != sent; ++expected)
+        EXPECT_THAT(receive(), Eq(expected));
+    EXPECT_THAT(receive(), Eq(1001u));
+}
+
+TEST_F(SocketMessenger, messages_with_different_keys_are_not_coalesced)
+{
+    create_messenger(mfd::SocketMessenger::default_queue_limit, mfd::QueueOverflowPolicy::disconnect);
+
+    send_until_queued();
+    auto const queued = messenger->queue_stats().queued_messages;
+
+    auto const data = message(1000, 16);
+    messenger->send_superseding(1, data.data(), data.size());
+    messenger->send_superseding(2, data.data(), data.size());
+
+    EXPECT_THAT(messenger->queue_stats().queued_messages, Eq(queued + 2));
+    EXPECT_THAT(messenger->queue_stats().coalesced_messages, Eq(0u));
+}
+
+TEST_F(SocketMessenger, client_exceeding_queue_limit_is_disconnected)
+{
+    create_messenger(4 * message_size, mfd::QueueOverflowPolicy::disconnect);
+
+    auto number = send_until_queued();
+    while (messenger->queue_stats().dropped_messages == 0)
+        send(number++);
+
+    EXPECT_THAT(messenger->queue_stats().queued_messages, Eq(0u));
+    EXPECT_THROW(send(number), std::runtime_error);
+
+    // The client gets what was already written, then end of stream
+    boost::system::error_code error;
+    std::vector<char> buffer(message_size);
+    while (!error)
+        ba::read(client_socket, ba::buffer(buffer), error);
+
+    EXPECT_THAT(error, Eq(ba::error::eof));
+}
+
+TEST_F(SocketMessenger, client_exceeding_queue_limit_misses_events_when_dropping)
+{
+    create_messenger(4 * message_size, mfd::QueueOverflowPolicy::drop_messages);
+
+    auto number = send_until_queued();
+    while (messenger->queue_stats().dropped_messages == 0)
+        send_event(number++);
+
+    auto const dropped = number - 1;
+    EXPECT_NO_THROW(send_event(number));
+
+    start_writing_queued_messages();
+
+    for (uint32_t expected = 0; expected != dropped; ++expected)
+        EXPECT_THAT(receive(), Eq(expected));
+
+    // Once the client catches up it gets new messages again
+    while (messenger->queue_stats().queued_messages != 0)
+        std::this_thread::yield();
+
+    send_event(2000);
+    EXPECT_THAT(receive(), Eq(2000u));
+}
+
+TEST_F(SocketMessenger, client_exceeding_queue_limit_with_a_reply_is_disconnected_when_dropping)
+{
+    create_messenger(4 * message_size, mfd::QueueOverflowPolicy::drop_messages);
+
+    auto number = send_until_queued();
+    while (messenger->queue_stats().dropped_messages == 0)
+        send(number++);
+
+    EXPECT_THAT(messenger->queue_stats().queued_messages, Eq(0u));
+    EXPECT_THROW(send(number), std::runtime_error);
+}
@@ -18,14 +18,20 @@
  */
 
 #include "src/gl/recently_used_cache.h"
+#include "src/gl/shared_uploads.h"
+#include "mir/gl/texture.h"
 #include "mir/test/doubles/mock_gl_buffer.h"
 #include "mir/test/doubles/mock_renderable.h"
 #include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_egl.h"
 #include <gtest/gtest.h>
 
+#include <future>
+
 namespace mtd=mir::test::doubles;
 namespace mgl=mir::gl;
 namespace mg=mir::graphics;
+namespace geom=mir::geometry;
 
 namespace
 {
@@ -45,6 +51,7 @@ public:
     }
 
     testing::NiceMock<mtd::MockGL> mock_gl;
+    testing::NiceMock<mtd::MockEGL> mock_egl;
     std::shared_ptr<mtd::MockGLBuffer> mock_buffer;
     std::shared_ptr<testing::NiceMock<mtd::MockRenderable>> renderable;
     GLuint const stub_texture{1};
@@ -140,3 +147,260 @@ TEST_F(RecentlyUsedCache, invalidated_buffers_are_reloaded)
     cache.invalidate();
     cache.load(*renderable);
 }
+
+TEST_F(RecentlyUsedCache, keeps_texture_of_renderable_missing_from_a_frame)
+{
+    using namespace testing;
+    EXPECT_CALL(mock_gl, glGenTextures(1, _))
+        .Times(1);
+    EXPECT_CALL(*mock_buffer, bind())
+        .Times(1);
+
+    mgl::RecentlyUsedCache cache;
+    cache.load(*renderable);
+    cache.drop_unused();
+
+    cache.drop_unused();  // e.g. window hidden during a workspace switch
+
+    cache.load(*renderable);
+    cache.drop_unused();
+
+    auto const stats = cache.statistics();
+    EXPECT_THAT(stats.hits, Eq(1u));
+    EXPECT_THAT(stats.misses, Eq(1u));
+    EXPECT_THAT(stats.evictions, Eq(0u));
+}
+
+TEST_F(RecentlyUsedCache, retires_textures_idle_for_too_long)
+{
+    using namespace testing;
+    unsigned const max_idle_frames{2};
+    mgl::RecentlyUsedCache cache{mgl::RecentlyUsedCache::default_budget_bytes, max_idle_frames};
+
+    cache.load(*renderable);
+    cache.drop_unused();
+
+    for (auto i = 0u; i != max_idle_frames; ++i)
+        cache.drop_unused();
+    EXPECT_THAT(cache.statistics().evictions, Eq(0u));
+
+    cache.drop_unused();
+    EXPECT_THAT(cache.statistics().evictions, Eq(1u));
+
+    EXPECT_CALL(*mock_buffer, bind());
+    cache.load(*renderable);
+}
+
+TEST_F(RecentlyUsedCache, reuses_texture_of_retired_renderable_with_same_size)
+{
+    using namespace testing;
+    geom::Size const size{64, 32};
+    ON_CALL(*mock_buffer, size()).WillByDefault(Return(size));
+
+    auto const other_buffer = std::make_shared<NiceMock<mtd::MockGLBuffer>>();
+    auto const other_renderable = std::make_shared<NiceMock<mtd::MockRenderable>>();
+    ON_CALL(*other_buffer, size()).WillByDefault(Return(size));
+    ON_CALL(*other_buffer, id()).WillByDefault(Return(mg::BufferID(456)));
+    ON_CALL(*other_renderable, buffer()).WillByDefault(Return(other_buffer));
+    ON_CALL(*other_renderable, id()).WillByDefault(Return(other_renderable.get()));
+
+    EXPECT_CALL(mock_gl, glGenTextures(1, _))
+        .Times(1);
+    EXPECT_CALL(*other_buffer, bind());
+
+    mgl::RecentlyUsedCache cache{mgl::RecentlyUsedCache::default_budget_bytes, 0};
+    cache.load(*renderable);
+    cache.drop_unused();
+    cache.drop_unused();
+    EXPECT_THAT(cache.statistics().evictions, Eq(1u));
+
+    cache.load(*other_renderable);
+    cache.drop_unused();
+}
+
+TEST_F(RecentlyUsedCache, evicts_least_recently_used_textures_over_budget)
+{
+    using namespace testing;
+    geom::Size const size{16, 16};
+    std::size_t const texture_bytes{16 * 16 * 4};
+    ON_CALL(*mock_buffer, size()).WillByDefault(Return(size));
+    ON_CALL(*mock_buffer, pixel_format()).WillByDefault(Return(mir_pixel_format_abgr_8888));
+
+    auto const other_renderable = std::make_shared<NiceMock<mtd::MockRenderable>>();
+    ON_CALL(*other_renderable, buffer()).WillByDefault(Return(mock_buffer));
+    ON_CALL(*other_renderable, id()).WillByDefault(Return(other_renderable.get()));
+
+    mgl::RecentlyUsedCache cache{texture_bytes, mgl::RecentlyUsedCache::default_max_idle_frames};
+
+    // Textures needed for the current frame are never evicted
+    cache.load(*renderable);
+    cache.load(*other_renderable);
+    cache.drop_unused();
+    EXPECT_THAT(cache.statistics().evictions, Eq(0u));
+    EXPECT_THAT(cache.statistics().resident_bytes, Eq(2 * texture_bytes));
+    EXPECT_THAT(cache.statistics().uploaded_bytes, Eq(2 * texture_bytes));
+
+    cache.load(*other_renderable);
+    cache.drop_unused();
+    EXPECT_THAT(cache.statistics().evictions, Eq(1u));
+    EXPECT_THAT(cache.statistics().resident_bytes, Eq(texture_bytes));
+    EXPECT_THAT(cache.statistics().uploaded_bytes, Eq(2 * texture_bytes));
+
+    EXPECT_CALL(mock_gl, glGenTextures(1, _));
+    cache.load(*renderable);
+}
+
+TEST_F(RecentlyUsedCache, buffer_shown_on_two_outputs_is_uploaded_once)
+{
+    using namespace testing;
+    auto const shared_uploads = std::make_shared<mgl::SharedUploads>();
+    mgl::RecentlyUsedCache left_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+    mgl::RecentlyUsedCache right_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+
+    EGLSyncKHR const fence{reinterpret_cast<EGLSyncKHR>(0xFE)};
+    ON_CALL(mock_egl, eglQueryString(_, EGL_EXTENSIONS))
+        .WillByDefault(Return("EGL_KHR_fence_sync"));
+    EXPECT_CALL(*mock_buffer, bind())
+        .Times(1);
+    EXPECT_CALL(mock_egl, eglCreateSyncKHR(_, EGL_SYNC_FENCE_KHR, _))
+        .WillOnce(Return(fence));
+    EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_, fence, _, _));
+
+    auto const left_texture = left_output.load(*renderable);
+    auto const right_texture = right_output.load(*renderable);
+
+    EXPECT_THAT(right_texture, Eq(left_texture));
+    EXPECT_THAT(right_output.statistics().misses, Eq(0u));
+}
+
+TEST_F(RecentlyUsedCache, does_not_load_into_texture_another_output_draws_from)
+{
+    using namespace testing;
+    auto const shared_uploads = std::make_shared<mgl::SharedUploads>();
+    mgl::RecentlyUsedCache left_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+    mgl::RecentlyUsedCache right_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+
+    left_output.load(*renderable);
+    left_output.drop_unused();
+    auto const right_texture = right_output.load(*renderable);
+
+    ON_CALL(*mock_buffer, id())
+        .WillByDefault(Return(mg::BufferID(456)));
+
+    EXPECT_CALL(*mock_buffer, bind());
+    auto const left_texture = left_output.load(*renderable);
+
+    EXPECT_THAT(left_texture, Ne(right_texture));
+}
+
+TEST_F(RecentlyUsedCache, shared_upload_completes_before_publishing_without_fences)
+{
+    using namespace testing;
+    auto const shared_uploads = std::make_shared<mgl::SharedUploads>();
+    mgl::RecentlyUsedCache left_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+    mgl::RecentlyUsedCache right_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+
+    ON_CALL(mock_egl, eglQueryString(_, EGL_EXTENSIONS))
+        .WillByDefault(Return(""));
+    EXPECT_CALL(mock_egl, eglCreateSyncKHR(_, _, _))
+        .Times(0);
+
+    InSequence seq;
+    EXPECT_CALL(*mock_buffer, bind());
+    EXPECT_CALL(mock_gl, glFinish());
+
+    left_output.load(*renderable);
+    right_output.load(*renderable);
+}
+
+TEST_F(RecentlyUsedCache, buffer_shown_on_two_outputs_is_counted_as_resident_once)
+{
+    using namespace testing;
+    geom::Size const size{16, 16};
+    std::size_t const texture_bytes{16 * 16 * 4};
+    ON_CALL(*mock_buffer, size()).WillByDefault(Return(size));
+    ON_CALL(*mock_buffer, pixel_format()).WillByDefault(Return(mir_pixel_format_abgr_8888));
+
+    auto const shared_uploads = std::make_shared<mgl::SharedUploads>();
+    mgl::RecentlyUsedCache left_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+    mgl::RecentlyUsedCache right_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+
+    left_output.load(*renderable);
+    right_output.load(*renderable);
+
+    EXPECT_THAT(left_output.statistics().resident_bytes, Eq(texture_bytes));
+    EXPECT_THAT(right_output.statistics().resident_bytes, Eq(0u));
+
+    // Once it loads a buffer of its own the texture is counted again
+    ON_CALL(*mock_buffer, id())
+        .WillByDefault(Return(mg::BufferID(456)));
+    left_output.drop_unused();
+    right_output.drop_unused();
+    right_output.load(*renderable);
+
+    EXPECT_THAT(right_output.statistics().resident_bytes, Eq(texture_bytes));
+}
+
+TEST_F(RecentlyUsedCache, other_outputs_can_use_shared_uploads_while_one_waits_for_a_fence)
+{
+    using namespace testing;
+    auto const shared_uploads = std::make_shared<mgl::SharedUploads>();
+    mgl::RecentlyUsedCache left_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+    mgl::RecentlyUsedCache right_output{
+        mgl::RecentlyUsedCache::default_budget_bytes,
+        mgl::RecentlyUsedCache::default_max_idle_frames,
+        shared_uploads};
+
+    EGLSyncKHR const fence{reinterpret_cast<EGLSyncKHR>(0xFE)};
+    ON_CALL(mock_egl, eglQueryString(_, EGL_EXTENSIONS))
+        .WillByDefault(Return("EGL_KHR_fence_sync"));
+    EXPECT_CALL(mock_egl, eglCreateSyncKHR(_, EGL_SYNC_FENCE_KHR, _))
+        .WillOnce(Return(fence));
+    // Outlives the wait, so a blocked withdraw() can finish when the lock is released
+    std::future<void> other_output;
+    EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_, fence, _, _))
+        .WillOnce(InvokeWithoutArgs([&]
+            {
+                other_output = std::async(std::launch::async, [&]
+                    {
+                        shared_uploads->withdraw(std::make_shared<mgl::Texture>());
+                    });
+                EXPECT_THAT(other_output.wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+                return EGL_CONDITION_SATISFIED_KHR;
+            }));
+
+    // The fence is only destroyed once nothing is waiting for it
+    EXPECT_CALL(mock_egl, eglDestroySyncKHR(_, fence))
+        .Times(1);
+
+    left_output.load(*renderable);
+    right_output.load(*renderable);
+    Mock::VerifyAndClearExpectations(&mock_egl);
+}
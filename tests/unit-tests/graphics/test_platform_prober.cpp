@@ -17,9 +17,16 @@
  */
 
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
 #include <fcntl.h>
+#include <sys/sysmacros.h>
 #include <boost/throw_exception.hpp>
 
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
 #include "mir/options/program_option.h"
@@ -141,6 +148,56 @@ public:
     }
 };
 
+// Like logind, rejects a device being acquired while it is already held
+class ExclusiveConsoleServices : public StubConsoleServices
+{
+public:
+    std::future<std::unique_ptr<mir::Device>> acquire_device(
+        int major, int minor,
+        std::unique_ptr<mir::Device::Observer> observer) override
+    {
+        auto const devnum = makedev(major, minor);
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!acquired_devices.insert(devnum).second)
+            {
+                ++multiple_acquisitions;
+                BOOST_THROW_EXCEPTION((std::runtime_error{"Attempted to acquire a device multiple times"}));
+            }
+        }
+
+        std::stringstream filename;
+        filename << "/dev/dri/" << major << ":" << minor;
+        observer->activated(mir::Fd{::open(filename.str().c_str(), O_RDWR | O_CLOEXEC)});
+
+        // Give any concurrent probe the chance to try for the same device
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+        std::promise<std::unique_ptr<mir::Device>> promise;
+        promise.set_value(std::make_unique<HeldDevice>(this, devnum));
+        return promise.get_future();
+    }
+
+    std::mutex mutex;
+    std::set<dev_t> acquired_devices;
+    int multiple_acquisitions{0};
+
+private:
+    struct HeldDevice : mir::Device
+    {
+        HeldDevice(ExclusiveConsoleServices* console, dev_t devnum) : console{console}, devnum{devnum} {}
+
+        ~HeldDevice()
+        {
+            std::lock_guard<std::mutex> lock{console->mutex};
+            console->acquired_devices.erase(devnum);
+        }
+
+        ExclusiveConsoleServices* const console;
+        dev_t const devnum;
+    };
+};
+
 class ServerPlatformProbeMockDRM : public ::testing::Test
 {
 #if defined(MIR_BUILD_PLATFORM_MESA_KMS) || defined(MIR_BUILD_PLATFORM_MESA_X11)
@@ -247,6 +304,27 @@ TEST(ServerPlatformProbe, LoadsSupportedModuleWhenNoBestModule)
     EXPECT_THAT(description->name, HasSubstr("mir:stub-graphics"));
 }
 
+#ifdef MIR_BUILD_PLATFORM_MESA_KMS
+TEST_F(ServerPlatformProbeMockDRM, modules_probing_the_same_device_do_not_acquire_it_at_once)
+{
+    using namespace testing;
+    mir::options::ProgramOption options;
+    auto fake_mesa = ensure_mesa_probing_succeeds();
+
+    auto modules = available_platforms();
+    auto const second_module = std::make_shared<mir::SharedLibrary>(mtf::server_platform("graphics-mesa-kms"));
+    modules.push_back(second_module);
+
+    auto const console = std::make_shared<ExclusiveConsoleServices>();
+
+    auto module = mir::graphics::module_for_device(modules, options, console);
+
+    EXPECT_THAT(module, NotNull());
+    EXPECT_THAT(console->multiple_acquisitions, Eq(0));
+    EXPECT_THAT(console->acquired_devices, IsEmpty());
+}
+#endif
+
 TEST_F(ServerPlatformProbeMockDRM, IgnoresNonPlatformModules)
 {
     using namespace testing;
@@ -17,6 +17,7 @@
  */
 
 #include "src/server/input/default_input_device_hub.h"
+#include "src/server/input/seats.h"
 
 #include "mir/test/doubles/mock_input_device.h"
 #include "mir/test/doubles/mock_input_device_observer.h"
@@ -155,6 +156,38 @@ TEST_F(InputDeviceHubTest, input_device_hub_start_stop_happens_in_order)
     hub.remove_device(mt::fake_shared(third_device));
 }
 
+TEST_F(InputDeviceHubTest, devices_are_added_to_the_seat_they_belong_to)
+{
+    NiceMock<mtd::MockInputSeat> other_seat;
+    std::vector<std::string> seats_built;
+    mi::DefaultInputDeviceHub multi_seat_hub{
+        std::make_shared<mi::Seats>(
+            "seat0",
+            mt::fake_shared(mock_seat),
+            [&](std::string const& name, std::shared_ptr<mi::InputDeviceHub> const&)
+            {
+                seats_built.push_back(name);
+                return mt::fake_shared(other_seat);
+            }),
+        mt::fake_shared(multiplexer), cookie_authority, mt::fake_shared(mock_key_mapper),
+        mt::fake_shared(mock_server_status_listener)};
+
+    ON_CALL(another_device, get_device_info())
+        .WillByDefault(Return(mi::InputDeviceInfo{"another_device", "dev-2", mi::DeviceCapability::keyboard, "seat1"}));
+    ON_CALL(mouse, get_device_info())
+        .WillByDefault(Return(mi::InputDeviceInfo{"mouse", "dev-4", mi::DeviceCapability::pointer, "seat1"}));
+
+    EXPECT_CALL(mock_seat, add_device(WithName("device")));
+    EXPECT_CALL(other_seat, add_device(WithName("another_device")));
+    EXPECT_CALL(other_seat, add_device(WithName("mouse")));
+
+    multi_seat_hub.add_device(mt::fake_shared(device));
+    multi_seat_hub.add_device(mt::fake_shared(another_device));
+    multi_seat_hub.add_device(mt::fake_shared(mouse));
+
+    EXPECT_THAT(seats_built, ElementsAre("seat1"));
+}
+
 TEST_F(InputDeviceHubTest, observers_receive_devices_on_add)
 {
     std::shared_ptr<mi::Device> handle_1, handle_2;
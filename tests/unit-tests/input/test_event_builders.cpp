@@ -283,3 +283,21 @@ TEST_F(InputEventBuilder, when_deserialized_input_device_state_event_has_supplie
         EXPECT_THAT(mir_input_device_state_event_device_pressed_keys_for_index(ids_event, 2, i), Eq(pressed_keys[i]));
     }
 }
+
+TEST_F(InputEventBuilder, event_deserializes_from_a_buffer_that_is_not_word_aligned)
+{
+    auto const pos_x = 124.5f;
+    auto const modifiers = mir_input_event_modifier_shift;
+    auto ev = mev::make_event(timestamp, mir_pointer_button_primary, modifiers, pos_x, 0.0f, {});
+
+    auto const encoded = MirEvent::serialize(ev.get());
+    std::vector<char> buffer(encoded.size() + 1);
+    std::copy(begin(encoded), end(encoded), begin(buffer) + 1);
+
+    auto deserialized_event = MirEvent::deserialize(buffer.data() + 1, encoded.size());
+
+    ASSERT_THAT(mir_event_get_type(deserialized_event.get()), Eq(mir_event_type_input_device_state));
+    auto ids_event = mir_event_get_input_device_state_event(deserialized_event.get());
+    EXPECT_THAT(mir_input_device_state_event_modifiers(ids_event), Eq(modifiers));
+    EXPECT_THAT(mir_input_device_state_event_pointer_axis(ids_event, mir_pointer_axis_x), Eq(pos_x));
+}
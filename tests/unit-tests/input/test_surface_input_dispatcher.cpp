@@ -547,3 +547,47 @@ TEST_F(SurfaceInputDispatcher, touch_gesture_target_may_vanish_but_things_contin
     EXPECT_FALSE(dispatcher.dispatch(toucher.release_at({0, 0})));
     EXPECT_TRUE(dispatcher.dispatch(toucher.touch_at({0, 0})));
 }
+
+TEST_F(SurfaceInputDispatcher, with_focus_on_press_a_click_focuses_the_surface_under_the_pointer)
+{
+    StubInputScene focus_on_press_scene;
+    mi::SurfaceInputDispatcher focus_on_press_dispatcher{mt::fake_shared(focus_on_press_scene), true};
+    auto const surface = focus_on_press_scene.add_surface({{0, 0}, {10, 10}});
+
+    FakeKeyboard keyboard;
+    auto key = keyboard.press();
+
+    EXPECT_CALL(*surface, consume(_)).Times(AnyNumber());
+    EXPECT_CALL(*surface, consume(mt::MirKeyboardEventMatches(key.get()))).Times(1);
+
+    focus_on_press_dispatcher.start();
+
+    FakePointer pointer;
+    EXPECT_TRUE(focus_on_press_dispatcher.dispatch(pointer.press_button({5, 5})));
+    EXPECT_TRUE(focus_on_press_dispatcher.dispatch(pointer.release_button({5, 5})));
+    EXPECT_TRUE(focus_on_press_dispatcher.dispatch(std::move(key)));
+
+    focus_on_press_dispatcher.stop();
+}
+
+TEST_F(SurfaceInputDispatcher, with_focus_on_press_a_touch_focuses_the_surface_touched)
+{
+    StubInputScene focus_on_press_scene;
+    mi::SurfaceInputDispatcher focus_on_press_dispatcher{mt::fake_shared(focus_on_press_scene), true};
+    auto const surface = focus_on_press_scene.add_surface({{0, 0}, {10, 10}});
+
+    FakeKeyboard keyboard;
+    auto key = keyboard.press();
+
+    EXPECT_CALL(*surface, consume(_)).Times(AnyNumber());
+    EXPECT_CALL(*surface, consume(mt::MirKeyboardEventMatches(key.get()))).Times(1);
+
+    focus_on_press_dispatcher.start();
+
+    FakeToucher toucher;
+    EXPECT_TRUE(focus_on_press_dispatcher.dispatch(toucher.touch_at({5, 5})));
+    EXPECT_TRUE(focus_on_press_dispatcher.dispatch(toucher.release_at({5, 5})));
+    EXPECT_TRUE(focus_on_press_dispatcher.dispatch(std::move(key)));
+
+    focus_on_press_dispatcher.stop();
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/threaded_input_dispatcher.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/test/doubles/mock_input_dispatcher.h"
+#include "mir/test/fake_shared.h"
+#include "mir/test/signal.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+using namespace std::chrono_literals;
+using namespace testing;
+
+namespace
+{
+struct ThreadedInputDispatcher : Test
+{
+    std::shared_ptr<MirEvent const> a_key_event() const
+    {
+        return mev::make_event(
+            MirInputDeviceId{0}, 0ns, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, 7, mir_input_event_modifier_none);
+    }
+
+    NiceMock<mtd::MockInputDispatcher> next_dispatcher;
+    mi::ThreadedInputDispatcher dispatcher{"Mir/Input/seat1", mt::fake_shared(next_dispatcher)};
+};
+}
+
+TEST_F(ThreadedInputDispatcher, start_and_stop_are_forwarded)
+{
+    InSequence seq;
+    EXPECT_CALL(next_dispatcher, start());
+    EXPECT_CALL(next_dispatcher, stop());
+
+    dispatcher.start();
+    dispatcher.stop();
+}
+
+TEST_F(ThreadedInputDispatcher, dispatches_events_on_its_own_thread)
+{
+    auto const event = a_key_event();
+    mt::Signal dispatched;
+    std::thread::id dispatching_thread;
+
+    EXPECT_CALL(next_dispatcher, dispatch(Eq(event)))
+        .WillOnce(Invoke([&](auto const&)
+            {
+                dispatching_thread = std::this_thread::get_id();
+                dispatched.raise();
+                return true;
+            }));
+
+    dispatcher.start();
+    EXPECT_TRUE(dispatcher.dispatch(event));
+
+    ASSERT_TRUE(dispatched.wait_for(5s));
+    EXPECT_THAT(dispatching_thread, Ne(std::this_thread::get_id()));
+}
+
+TEST_F(ThreadedInputDispatcher, events_dispatched_while_stopped_are_delivered_after_start)
+{
+    auto const event = a_key_event();
+    mt::Signal dispatched;
+
+    EXPECT_CALL(next_dispatcher, dispatch(Eq(event)))
+        .WillOnce(InvokeWithoutArgs([&] { dispatched.raise(); return true; }));
+
+    EXPECT_TRUE(dispatcher.dispatch(event));
+    dispatcher.start();
+
+    EXPECT_TRUE(dispatched.wait_for(5s));
+}
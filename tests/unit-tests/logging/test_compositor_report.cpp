@@ -189,3 +189,27 @@ TEST_F(LoggingCompositorReport, bypass_has_no_render_time)
 
     report.stopped();
 }
+
+TEST_F(LoggingCompositorReport, reports_texture_cache_usage_over_interval)
+{
+    const void* const id = "My Screen";
+    const void* const cache = "My Renderer";
+
+    report.started();
+
+    report.began_frame(id);
+    report.texture_cache_usage(cache, 3, 1, 0, 4096, 4096);
+    report.finished_frame(id);
+    clock->advance_by(chrono::seconds(2));
+
+    report.began_frame(id);
+    report.texture_cache_usage(cache, 6, 2, 1, 8192, 8192);
+    report.finished_frame(id);
+
+    EXPECT_TRUE(recorder->last_message_contains("Texture cache"))
+        << recorder->last_message();
+    EXPECT_TRUE(recorder->last_message_contains("75% hits, 2 uploads (8 KiB), 1 evictions, 8 KiB resident"))
+        << recorder->last_message();
+
+    report.stopped();
+}
@@ -35,6 +35,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <deque>
 #include <unordered_map>
 #include <algorithm>
 
@@ -806,3 +807,103 @@ TEST_F(MesaCursorTest, show_cursor_sets_cursor_with_hotspot)
     cursor.move_to(cursor_location_2);
 }
 
+
+namespace
+{
+struct ManualExecutor : mir::Executor
+{
+    void spawn(std::function<void()>&& work) override
+    {
+        work_queue.push_back(std::move(work));
+    }
+
+    void run_all()
+    {
+        while (!work_queue.empty())
+        {
+            auto const work = std::move(work_queue.front());
+            work_queue.pop_front();
+            work();
+        }
+    }
+
+    std::deque<std::function<void()>> work_queue;
+};
+
+struct MesaCursorWithMoveExecutorTest : MesaCursorTest
+{
+    ~MesaCursorWithMoveExecutorTest()
+    {
+        executor.run_all();
+    }
+
+    ManualExecutor executor;
+    mgm::Cursor deferred_cursor{output_container, mt::fake_shared(current_configuration), mt::fake_shared(executor)};
+};
+}
+
+TEST_F(MesaCursorWithMoveExecutorTest, moves_cursor_on_the_move_executor)
+{
+    using namespace testing;
+
+    deferred_cursor.show(stub_image);
+    output_container.verify_and_clear_expectations();
+
+    EXPECT_CALL(*output_container.outputs[0], move_cursor(_)).Times(0);
+
+    deferred_cursor.move_to({10, 10});
+
+    output_container.verify_and_clear_expectations();
+
+    EXPECT_CALL(*output_container.outputs[0], move_cursor(geom::Point{10,10}));
+
+    executor.run_all();
+
+    output_container.verify_and_clear_expectations();
+}
+
+TEST_F(MesaCursorWithMoveExecutorTest, moves_made_while_a_move_is_pending_are_coalesced)
+{
+    using namespace testing;
+
+    deferred_cursor.show(stub_image);
+    output_container.verify_and_clear_expectations();
+
+    EXPECT_CALL(*output_container.outputs[0], move_cursor(geom::Point{30,30}));
+    EXPECT_CALL(*output_container.outputs[0], move_cursor(Ne(geom::Point{30,30}))).Times(0);
+
+    deferred_cursor.move_to({10, 10});
+    deferred_cursor.move_to({20, 20});
+    deferred_cursor.move_to({30, 30});
+
+    EXPECT_THAT(executor.work_queue.size(), Eq(1u));
+
+    executor.run_all();
+
+    output_container.verify_and_clear_expectations();
+}
+
+TEST_F(MesaCursorWithMoveExecutorTest, cursor_update_thread_applies_moves)
+{
+    using namespace testing;
+
+    {
+        mgm::Cursor threaded_cursor{
+            output_container,
+            mt::fake_shared(current_configuration),
+            std::make_shared<mgm::CursorUpdateThread>()};
+
+        threaded_cursor.show(stub_image);
+        output_container.verify_and_clear_expectations();
+
+        EXPECT_CALL(*output_container.outputs[0], move_cursor(geom::Point{20,20})).Times(AtMost(1));
+        EXPECT_CALL(*output_container.outputs[0], move_cursor(geom::Point{40,40}));
+
+        threaded_cursor.move_to({20, 20});
+        threaded_cursor.move_to({40, 40});
+
+        // Destroying the cursor waits for pending moves
+    }
+
+    output_container.verify_and_clear_expectations();
+}
@@ -882,3 +882,39 @@ TEST_F(MesaDisplayTest, can_change_configuration_metadata_without_invalidating_d
         EXPECT_THAT(display_buffer->transformation(), Eq(rotate_inverted));
     }
 }
+
+TEST_F(MesaDisplayTest, unchanged_configuration_preserves_every_display_sync_group)
+{
+    using namespace testing;
+
+    auto display = create_display(create_platform());
+    auto config = display->configuration();
+
+    int groups{0};
+    display->for_each_display_sync_group([&groups](auto&) { ++groups; });
+
+    int preserved{0};
+    display->for_each_display_sync_group_preserved_by(*config, [&preserved](auto&) { ++preserved; });
+
+    EXPECT_THAT(groups, Gt(0));
+    EXPECT_THAT(preserved, Eq(groups));
+}
+
+TEST_F(MesaDisplayTest, compatible_configuration_that_rotates_outputs_does_not_preserve_their_display_sync_groups)
+{
+    using namespace testing;
+
+    auto display = create_display(create_platform());
+    auto config = display->configuration();
+
+    config->for_each_output(
+        [](mg::UserDisplayConfigurationOutput& output)
+        {
+            output.orientation = mir_orientation_inverted;
+        });
+
+    int preserved{0};
+    display->for_each_display_sync_group_preserved_by(*config, [&preserved](auto&) { ++preserved; });
+
+    EXPECT_THAT(preserved, Eq(0));
+}
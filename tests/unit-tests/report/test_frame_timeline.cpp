@@ -0,0 +1,218 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/frame_timeline/compositor_report.h"
+#include "src/server/report/frame_timeline/recorder.h"
+#include "mir/server_action_queue.h"
+#include "mir/test/doubles/mock_compositor_report.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_renderable.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mrf = mir::report::frame_timeline;
+namespace mtd = mir::test::doubles;
+namespace mg = mir::graphics;
+namespace fs = boost::filesystem;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+struct ImmediateServerActionQueue : mir::ServerActionQueue
+{
+    void enqueue(void const*, mir::ServerAction const& action) override { action(); }
+    void enqueue_with_guaranteed_execution(mir::ServerAction const& action) override { action(); }
+    void pause_processing_for(void const*) override {}
+    void resume_processing_for(void const*) override {}
+};
+
+struct FrameTimeline : Test
+{
+    FrameTimeline()
+    {
+        char tmp_name[] = "/tmp/mir_frame_timeline_XXXXXX";
+        if (mkdtemp(tmp_name) == NULL)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        temporary_directory = tmp_name;
+    }
+
+    ~FrameTimeline()
+    {
+        fs::remove_all(temporary_directory);
+    }
+
+    auto report_with_budget(milliseconds budget) -> std::unique_ptr<mrf::CompositorReport>
+    {
+        return std::make_unique<mrf::CompositorReport>(
+            wrapped,
+            std::make_shared<mrf::Recorder>(
+                budget, seconds{5}, temporary_directory, std::make_shared<ImmediateServerActionQueue>()));
+    }
+
+    void composite_frame(
+        mrf::CompositorReport& report,
+        milliseconds snapshot_time = milliseconds{0},
+        mg::RenderableList const& renderables = {})
+    {
+        report.began_scene_snapshot(output);
+        std::this_thread::sleep_for(snapshot_time);
+        report.began_frame(output);
+        report.filtered_occlusions(output, 0);
+        report.rendered_frame(output);
+        report.renderables_in_frame(output, renderables);
+        report.finished_frame(output);
+        report.posted_frame(output);
+    }
+
+    auto timelines_written() const -> std::vector<std::string>
+    {
+        std::vector<std::string> timelines;
+        for (auto const& entry : fs::directory_iterator{temporary_directory})
+        {
+            std::ifstream file{entry.path().string()};
+            timelines.emplace_back(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+        }
+        return timelines;
+    }
+
+    std::string temporary_directory;
+    std::shared_ptr<NiceMock<mtd::MockCompositorReport>> const wrapped{
+        std::make_shared<NiceMock<mtd::MockCompositorReport>>()};
+    mir::compositor::CompositorReport::SubCompositorId const output{this};
+};
+}
+
+TEST_F(FrameTimeline, forwards_to_the_wrapped_report)
+{
+    auto const report = report_with_budget(hours{1});
+
+    EXPECT_CALL(*wrapped, began_scene_snapshot(output));
+    EXPECT_CALL(*wrapped, began_frame(output));
+    EXPECT_CALL(*wrapped, filtered_occlusions(output, 0));
+    EXPECT_CALL(*wrapped, finished_frame(output));
+    EXPECT_CALL(*wrapped, posted_frame(output));
+
+    composite_frame(*report);
+}
+
+TEST_F(FrameTimeline, writes_nothing_while_frames_are_within_budget)
+{
+    auto const report = report_with_budget(hours{1});
+
+    for (int i = 0; i != 10; ++i)
+        composite_frame(*report);
+
+    EXPECT_THAT(timelines_written(), IsEmpty());
+}
+
+TEST_F(FrameTimeline, writes_the_timeline_when_a_frame_is_over_budget)
+{
+    auto const report = report_with_budget(milliseconds{0});
+
+    report->added_display(1920, 1080, 0, 0, output);
+    composite_frame(*report, milliseconds{1});
+
+    auto const timelines = timelines_written();
+    ASSERT_THAT(timelines.size(), Eq(1u));
+    EXPECT_THAT(timelines.front(), HasSubstr("\"area\": \"1920x1080+0+0\""));
+    EXPECT_THAT(timelines.front(), HasSubstr("\"bypassed\": false"));
+}
+
+TEST_F(FrameTimeline, writes_at_most_one_timeline_per_history_period)
+{
+    auto const report = report_with_budget(milliseconds{0});
+
+    for (int i = 0; i != 10; ++i)
+        composite_frame(*report, milliseconds{1});
+
+    EXPECT_THAT(timelines_written().size(), Eq(1u));
+}
+
+TEST_F(FrameTimeline, links_frames_to_the_submissions_they_first_show)
+{
+    auto const report = report_with_budget(milliseconds{0});
+    auto const buffer = std::make_shared<mtd::StubBuffer>();
+    mg::RenderableList const renderables{std::make_shared<mtd::StubRenderable>(buffer)};
+
+    report->submitted_buffer(buffer->id());
+    composite_frame(*report, milliseconds{1}, renderables);
+
+    auto const timelines = timelines_written();
+    ASSERT_THAT(timelines.size(), Eq(1u));
+    EXPECT_THAT(timelines.front(), HasSubstr("\"renderables\": 1"));
+    EXPECT_THAT(
+        timelines.front(),
+        HasSubstr("\"submissions\": [{\"buffer\": " + std::to_string(buffer->id().as_value()) + ","));
+}
+
+TEST_F(FrameTimeline, writes_timelines_readable_only_by_the_owner)
+{
+    auto const report = report_with_budget(milliseconds{0});
+
+    composite_frame(*report, milliseconds{1});
+
+    for (auto const& entry : fs::directory_iterator{temporary_directory})
+    {
+        struct stat status;
+        ASSERT_THAT(stat(entry.path().c_str(), &status), Eq(0));
+        EXPECT_THAT(status.st_mode & 0777, Eq(0600u));
+    }
+}
+
+TEST_F(FrameTimeline, does_not_write_through_an_existing_file)
+{
+    auto const report = report_with_budget(milliseconds{0});
+    auto const target = temporary_directory + "/target";
+    auto const timeline = temporary_directory + "/mir-frame-timeline-" + std::to_string(getpid()) + "-1.json";
+    std::ofstream{target} << "untouched";
+    ASSERT_THAT(symlink(target.c_str(), timeline.c_str()), Eq(0));
+
+    composite_frame(*report, milliseconds{1});
+
+    std::ifstream file{target};
+    EXPECT_THAT(
+        (std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}}),
+        Eq("untouched"));
+}
+
+TEST_F(FrameTimeline, tolerates_renderables_without_a_buffer)
+{
+    auto const report = report_with_budget(milliseconds{0});
+    mg::RenderableList const renderables{std::make_shared<mtd::StubRenderable>(nullptr)};
+
+    report->submitted_buffer(std::make_shared<mtd::StubBuffer>()->id());
+    composite_frame(*report, milliseconds{1}, renderables);
+
+    auto const timelines = timelines_written();
+    ASSERT_THAT(timelines.size(), Eq(1u));
+    EXPECT_THAT(timelines.front(), HasSubstr("\"submissions\": []"));
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/metrics/metrics.h"
+#include "src/server/report/metrics/compositor_report.h"
+#include "src/server/report/metrics/metrics_socket.h"
+#include "mir/test/doubles/mock_compositor_report.h"
+#include "mir/test/doubles/mock_event_handler_register.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace mrm = mir::report::metrics;
+namespace mtd = mir::test::doubles;
+namespace fs = boost::filesystem;
+
+using namespace testing;
+
+namespace
+{
+struct Metrics : Test
+{
+    auto prometheus_text() const -> std::string
+    {
+        std::ostringstream out;
+        registry->write_prometheus(out);
+        return out.str();
+    }
+
+    std::shared_ptr<mrm::Registry> const registry{std::make_shared<mrm::Registry>()};
+};
+
+struct CompositorMetrics : Metrics
+{
+    // As the compositor does before its renderers (whose addresses may be reused) are destroyed
+    void TearDown() override
+    {
+        report.stopped();
+    }
+
+    std::shared_ptr<NiceMock<mtd::MockCompositorReport>> const wrapped{
+        std::make_shared<NiceMock<mtd::MockCompositorReport>>()};
+    mrm::CompositorReport report{wrapped, registry};
+    mir::compositor::CompositorReport::SubCompositorId const renderer{this};
+};
+
+struct MetricsSocket : Metrics
+{
+    MetricsSocket()
+    {
+        char tmp_name[] = "/tmp/mir_metrics_socket_XXXXXX";
+        if (mkdtemp(tmp_name) == NULL)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        temporary_directory = tmp_name;
+        path = temporary_directory + "/metrics";
+    }
+
+    ~MetricsSocket()
+    {
+        fs::remove_all(temporary_directory);
+    }
+
+    auto socket() -> std::unique_ptr<mrm::MetricsSocket>
+    {
+        return std::make_unique<mrm::MetricsSocket>(path, registry, main_loop);
+    }
+
+    auto mode_of(std::string const& file) -> mode_t
+    {
+        struct stat status;
+        EXPECT_THAT(lstat(file.c_str(), &status), Eq(0));
+        return status.st_mode;
+    }
+
+    std::string temporary_directory;
+    std::string path;
+    std::shared_ptr<NiceMock<mtd::MockEventHandlerRegister>> const main_loop{
+        std::make_shared<NiceMock<mtd::MockEventHandlerRegister>>()};
+};
+}
+
+TEST_F(Metrics, histogram_quantiles_are_within_a_bucket_of_the_value)
+{
+    auto& histogram = registry->histogram("test_us", "A test histogram");
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+        histogram.record(value);
+
+    EXPECT_THAT(histogram.count(), Eq(1000u));
+    EXPECT_THAT(histogram.sum(), Eq(500500u));
+
+    for (auto const q : {0.5, 0.9, 0.99})
+    {
+        auto const exact = 1000 * q;
+        EXPECT_THAT(histogram.quantile(q), AllOf(Ge(exact), Le(exact * (1.0 + 1.0/mrm::Histogram::sub_buckets))))
+            << "q=" << q;
+    }
+}
+
+TEST_F(Metrics, empty_histogram_has_zero_quantiles)
+{
+    auto& histogram = registry->histogram("test_us", "A test histogram");
+
+    EXPECT_THAT(histogram.quantile(0.5), Eq(0u));
+}
+
+TEST_F(Metrics, histogram_records_extreme_values)
+{
+    auto& histogram = registry->histogram("test_us", "A test histogram");
+
+    histogram.record(0);
+    histogram.record(UINT64_MAX);
+
+    EXPECT_THAT(histogram.quantile(0), Eq(0u));
+    EXPECT_THAT(histogram.quantile(1), Eq(UINT64_MAX));
+}
+
+TEST_F(Metrics, creating_a_metric_twice_returns_the_same_metric)
+{
+    auto& first = registry->counter("test_total", "A test counter");
+    auto& second = registry->counter("test_total", "A test counter");
+
+    EXPECT_THAT(&second, Eq(&first));
+}
+
+TEST_F(Metrics, reusing_a_name_for_another_type_throws)
+{
+    registry->counter("test", "A test counter");
+
+    EXPECT_THROW(registry->gauge("test", "A test gauge"), std::logic_error);
+}
+
+TEST_F(Metrics, writes_prometheus_text_format)
+{
+    registry->counter("test_total", "A test counter").increment(3);
+    registry->gauge("test_bytes", "A test gauge").set(-7);
+    registry->histogram("test_us", "A test histogram").record(1);
+
+    auto const text = prometheus_text();
+
+    EXPECT_THAT(text, HasSubstr("# HELP test_total A test counter\n# TYPE test_total counter\ntest_total 3\n"));
+    EXPECT_THAT(text, HasSubstr("# TYPE test_bytes gauge\ntest_bytes -7\n"));
+    EXPECT_THAT(text, HasSubstr("# TYPE test_us summary\n"));
+    EXPECT_THAT(text, HasSubstr("test_us{quantile=\"0.5\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("test_us_sum 1\n"));
+    EXPECT_THAT(text, HasSubstr("test_us_count 1\n"));
+}
+
+TEST_F(Metrics, labelled_counters_are_written_as_series_until_removed)
+{
+    registry->labelled_counter("commits_total", "Commits", "client", "one").increment(2);
+    registry->labelled_counter("commits_total", "Commits", "client", "say \"two\"").increment(5);
+
+    EXPECT_THAT(prometheus_text(), HasSubstr("commits_total{client=\"one\"} 2\n"));
+    EXPECT_THAT(prometheus_text(), HasSubstr("commits_total{client=\"say \\\"two\\\"\"} 5\n"));
+
+    registry->remove_labelled_counter("commits_total", "one");
+
+    EXPECT_THAT(prometheus_text(), Not(HasSubstr("client=\"one\"")));
+}
+
+TEST_F(CompositorMetrics, forwards_to_the_wrapped_report)
+{
+    EXPECT_CALL(*wrapped, began_frame(renderer));
+    EXPECT_CALL(*wrapped, rendered_frame(renderer));
+    EXPECT_CALL(*wrapped, finished_frame(renderer));
+    EXPECT_CALL(*wrapped, texture_cache_usage(renderer, 1, 2, 0, 4096, 4096));
+
+    report.began_frame(renderer);
+    report.rendered_frame(renderer);
+    report.texture_cache_usage(renderer, 1, 2, 0, 4096, 4096);
+    report.finished_frame(renderer);
+}
+
+TEST_F(CompositorMetrics, counts_frames_that_were_not_rendered_as_bypassed)
+{
+    auto const& frames = registry->counter("mir_compositor_frames_total", "");
+    auto const& bypassed = registry->counter("mir_compositor_bypassed_frames_total", "");
+
+    report.began_frame(renderer);
+    report.rendered_frame(renderer);
+    report.finished_frame(renderer);
+
+    report.began_frame(renderer);
+    report.finished_frame(renderer);
+
+    EXPECT_THAT(frames.value(), Eq(2u));
+    EXPECT_THAT(bypassed.value(), Eq(1u));
+}
+
+TEST_F(CompositorMetrics, counts_texture_uploads_since_the_previous_report)
+{
+    auto const& uploads = registry->counter("mir_texture_uploads_total", "");
+    auto const& uploaded_bytes = registry->counter("mir_texture_uploaded_bytes_total", "");
+    auto const& resident_bytes = registry->gauge("mir_texture_resident_bytes", "");
+
+    report.texture_cache_usage(renderer, 3, 1, 0, 4096, 4096);
+    report.texture_cache_usage(renderer, 6, 3, 1, 12288, 8192);
+
+    EXPECT_THAT(uploads.value(), Eq(3u));
+    EXPECT_THAT(uploaded_bytes.value(), Eq(12288u));
+    EXPECT_THAT(resident_bytes.value(), Eq(8192));
+
+    report.stopped();
+
+    EXPECT_THAT(resident_bytes.value(), Eq(0));
+}
+
+TEST_F(MetricsSocket, is_accessible_only_to_the_owner)
+{
+    auto const metrics_socket = socket();
+
+    EXPECT_TRUE(S_ISSOCK(mode_of(path)));
+    EXPECT_THAT(mode_of(path) & 0777, Eq(0600u));
+}
+
+TEST_F(MetricsSocket, replaces_a_stale_socket)
+{
+    mir::Fd const stale{::socket(AF_UNIX, SOCK_STREAM, 0)};
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof address.sun_path - 1);
+    ASSERT_THAT(bind(stale, reinterpret_cast<sockaddr*>(&address), sizeof address), Eq(0));
+
+    EXPECT_NO_THROW(socket());
+}
+
+TEST_F(MetricsSocket, refuses_to_replace_a_file_that_is_not_a_socket)
+{
+    std::ofstream{path} << "precious";
+
+    EXPECT_THROW(socket(), std::runtime_error);
+
+    std::ifstream file{path};
+    EXPECT_THAT(
+        (std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}}),
+        Eq("precious"));
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/scene/scene_change_transaction.h"
+#include "mir/scene/surface_observers.h"
+#include "mir/scene/null_surface_observer.h"
+#include "src/server/scene/surface_stack.h"
+
+#include "mir/test/fake_shared.h"
+#include "mir/test/doubles/stub_surface.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+struct MockSurfaceObserver : ms::NullSurfaceObserver
+{
+    MOCK_METHOD2(moved_to, void(ms::Surface const*, geom::Point const&));
+    MOCK_METHOD2(resized_to, void(ms::Surface const*, geom::Size const&));
+    MOCK_METHOD3(attrib_changed, void(ms::Surface const*, MirWindowAttrib, int));
+};
+
+struct MockSceneObserver : ms::Observer
+{
+    MOCK_METHOD1(surface_added, void(ms::Surface*));
+    MOCK_METHOD1(surface_removed, void(ms::Surface*));
+    MOCK_METHOD0(surfaces_reordered, void());
+    MOCK_METHOD0(scene_changed, void());
+    MOCK_METHOD1(surface_exists, void(ms::Surface*));
+    MOCK_METHOD0(end_observation, void());
+};
+
+struct SceneChangeTransaction : Test
+{
+    SceneChangeTransaction()
+    {
+        surface_observers.add(mt::fake_shared(surface_observer));
+        scene_observers.add(mt::fake_shared(scene_observer));
+    }
+
+    mtd::StubSurface surface;
+    NiceMock<MockSurfaceObserver> surface_observer;
+    NiceMock<MockSceneObserver> scene_observer;
+    ms::SurfaceObservers surface_observers;
+    ms::Observers scene_observers;
+};
+}
+
+TEST_F(SceneChangeTransaction, without_a_transaction_every_move_is_notified)
+{
+    EXPECT_CALL(surface_observer, moved_to(&surface, _)).Times(3);
+
+    surface_observers.moved_to(&surface, {1, 1});
+    surface_observers.moved_to(&surface, {2, 2});
+    surface_observers.moved_to(&surface, {3, 3});
+}
+
+TEST_F(SceneChangeTransaction, within_a_transaction_only_the_final_geometry_is_notified)
+{
+    ms::SceneChangeTransaction transaction;
+
+    EXPECT_CALL(surface_observer, moved_to(_, _)).Times(0);
+    EXPECT_CALL(surface_observer, resized_to(_, _)).Times(0);
+
+    surface_observers.moved_to(&surface, {1, 1});
+    surface_observers.resized_to(&surface, {10, 10});
+    surface_observers.moved_to(&surface, {3, 3});
+    surface_observers.resized_to(&surface, {30, 30});
+
+    Mock::VerifyAndClearExpectations(&surface_observer);
+
+    EXPECT_CALL(surface_observer, moved_to(&surface, geom::Point{3, 3})).Times(1);
+    EXPECT_CALL(surface_observer, resized_to(&surface, geom::Size{30, 30})).Times(1);
+
+    transaction.commit();
+}
+
+TEST_F(SceneChangeTransaction, a_state_change_is_notified_after_the_geometry_that_preceded_it)
+{
+    geom::Size const maximized_size{1024, 768};
+
+    {
+        InSequence seq;
+        EXPECT_CALL(surface_observer, resized_to(&surface, maximized_size)).Times(1);
+        EXPECT_CALL(surface_observer, moved_to(&surface, geom::Point{0, 0})).Times(1);
+        EXPECT_CALL(surface_observer, attrib_changed(&surface, mir_window_attrib_state, mir_window_state_maximized))
+            .Times(1);
+    }
+
+    ms::SceneChangeTransaction transaction;
+
+    surface_observers.resized_to(&surface, maximized_size);
+    surface_observers.moved_to(&surface, {0, 0});
+    surface_observers.attrib_changed(&surface, mir_window_attrib_state, mir_window_state_maximized);
+    transaction.commit();
+}
+
+TEST_F(SceneChangeTransaction, geometry_changed_after_a_state_change_is_still_deferred)
+{
+    ms::SceneChangeTransaction transaction;
+
+    surface_observers.resized_to(&surface, {10, 10});
+    surface_observers.attrib_changed(&surface, mir_window_attrib_state, mir_window_state_maximized);
+
+    EXPECT_CALL(surface_observer, resized_to(_, _)).Times(0);
+
+    surface_observers.resized_to(&surface, {20, 20});
+    surface_observers.resized_to(&surface, {30, 30});
+
+    Mock::VerifyAndClearExpectations(&surface_observer);
+
+    EXPECT_CALL(surface_observer, resized_to(&surface, geom::Size{30, 30})).Times(1);
+
+    transaction.commit();
+}
+
+TEST_F(SceneChangeTransaction, nested_transactions_notify_when_the_outermost_is_committed)
+{
+    EXPECT_CALL(surface_observer, moved_to(_, _)).Times(0);
+
+    ms::SceneChangeTransaction outer;
+    {
+        ms::SceneChangeTransaction inner;
+        surface_observers.moved_to(&surface, {1, 1});
+        inner.commit();
+    }
+
+    Mock::VerifyAndClearExpectations(&surface_observer);
+    EXPECT_CALL(surface_observer, moved_to(&surface, geom::Point{1, 1})).Times(1);
+
+    outer.commit();
+}
+
+TEST_F(SceneChangeTransaction, reordering_is_notified_once)
+{
+    EXPECT_CALL(scene_observer, surfaces_reordered()).Times(0);
+
+    {
+        ms::SceneChangeTransaction transaction;
+
+        scene_observers.surfaces_reordered();
+        scene_observers.surfaces_reordered();
+        scene_observers.surfaces_reordered();
+
+        Mock::VerifyAndClearExpectations(&scene_observer);
+        EXPECT_CALL(scene_observer, surfaces_reordered()).Times(1);
+
+        transaction.commit();
+    }
+}
+
+TEST_F(SceneChangeTransaction, changes_for_observers_destroyed_during_the_transaction_are_dropped)
+{
+    NiceMock<MockSurfaceObserver> other_observer;
+    EXPECT_CALL(other_observer, moved_to(_, _)).Times(0);
+
+    ms::SceneChangeTransaction transaction;
+    {
+        ms::SurfaceObservers short_lived;
+        short_lived.add(mt::fake_shared(other_observer));
+        short_lived.moved_to(&surface, {1, 1});
+    }
+
+    transaction.commit();
+}
+
+TEST_F(SceneChangeTransaction, changes_on_other_threads_are_not_deferred)
+{
+    ms::SceneChangeTransaction transaction;
+
+    EXPECT_CALL(surface_observer, moved_to(&surface, geom::Point{1, 1})).Times(1);
+
+    std::thread{[this] { surface_observers.moved_to(&surface, {1, 1}); }}.join();
+
+    Mock::VerifyAndClearExpectations(&surface_observer);
+}
+
+TEST_F(SceneChangeTransaction, changes_for_observers_destroyed_on_another_thread_are_dropped)
+{
+    NiceMock<MockSurfaceObserver> other_observer;
+    EXPECT_CALL(other_observer, moved_to(_, _)).Times(0);
+
+    ms::SceneChangeTransaction transaction;
+    auto short_lived = std::make_unique<ms::SurfaceObservers>();
+    short_lived->add(mt::fake_shared(other_observer));
+    short_lived->moved_to(&surface, {1, 1});
+
+    std::thread{[&] { short_lived.reset(); }}.join();
+
+    transaction.commit();
+}
+
+TEST_F(SceneChangeTransaction, an_abandoned_transaction_notifies_nothing)
+{
+    EXPECT_CALL(surface_observer, moved_to(_, _)).Times(0);
+    EXPECT_CALL(scene_observer, surfaces_reordered()).Times(0);
+
+    {
+        ms::SceneChangeTransaction transaction;
+        surface_observers.moved_to(&surface, {1, 1});
+        scene_observers.surfaces_reordered();
+    }
+
+    Mock::VerifyAndClearExpectations(&surface_observer);
+    EXPECT_CALL(surface_observer, moved_to(&surface, geom::Point{2, 2})).Times(1);
+
+    surface_observers.moved_to(&surface, {2, 2});
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/platform_probe_cache.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <system_error>
+
+#include <stdlib.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+namespace fs = boost::filesystem;
+
+namespace
+{
+struct PlatformProbeCache : Test
+{
+    PlatformProbeCache()
+    {
+        char tmp_name[] = "/tmp/mir_probe_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == NULL)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        temporary_directory = tmp_name;
+        module_path = temporary_directory + "/modules";
+        cache_file = temporary_directory + "/probe-cache";
+        module = module_path + "/graphics-fake.so";
+
+        fs::create_directory(module_path);
+        std::ofstream{module} << "not really a module";
+    }
+
+    ~PlatformProbeCache()
+    {
+        fs::remove_all(temporary_directory);
+    }
+
+    std::string temporary_directory;
+    std::string module_path;
+    std::string cache_file;
+    std::string module;
+};
+}
+
+TEST_F(PlatformProbeCache, remembers_nothing_initially)
+{
+    mir::PlatformProbeCache const cache{cache_file, module_path};
+
+    EXPECT_FALSE(cache.selected_module("graphics"));
+}
+
+TEST_F(PlatformProbeCache, remembers_selected_module_across_instances)
+{
+    mir::PlatformProbeCache{cache_file, module_path}.module_selected("graphics", module);
+
+    mir::PlatformProbeCache const cache{cache_file, module_path};
+
+    ASSERT_TRUE(cache.selected_module("graphics"));
+    EXPECT_THAT(cache.selected_module("graphics").value(), Eq(module));
+    EXPECT_FALSE(cache.selected_module("input"));
+}
+
+TEST_F(PlatformProbeCache, forgets_selection_when_modules_change)
+{
+    mir::PlatformProbeCache{cache_file, module_path}.module_selected("graphics", module);
+
+    std::ofstream{module_path + "/graphics-new.so"} << "another module";
+
+    mir::PlatformProbeCache const cache{cache_file, module_path};
+
+    EXPECT_FALSE(cache.selected_module("graphics"));
+}
+
+TEST_F(PlatformProbeCache, forgets_selection_when_module_is_removed)
+{
+    mir::PlatformProbeCache{cache_file, module_path}.module_selected("graphics", module);
+
+    fs::remove(module);
+
+    mir::PlatformProbeCache const cache{cache_file, module_path};
+
+    EXPECT_FALSE(cache.selected_module("graphics"));
+}
+
+TEST_F(PlatformProbeCache, without_cache_file_remembers_nothing)
+{
+    mir::PlatformProbeCache{"", module_path}.module_selected("graphics", module);
+
+    mir::PlatformProbeCache const cache{"", module_path};
+
+    EXPECT_FALSE(cache.selected_module("graphics"));
+    EXPECT_FALSE(fs::exists(cache_file));
+}
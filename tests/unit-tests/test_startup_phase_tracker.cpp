@@ -0,0 +1,137 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_phase_tracker.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <thread>
+
+using namespace std::chrono_literals;
+using namespace testing;
+using mir::StartupPhaseTracker;
+
+namespace
+{
+auto names_of(std::vector<StartupPhaseTracker::Record> const& records) -> std::vector<std::string>
+{
+    std::vector<std::string> names;
+    for (auto const& record : records)
+        names.push_back(record.name);
+    return names;
+}
+
+auto depths_of(std::vector<StartupPhaseTracker::Record> const& records) -> std::vector<int>
+{
+    std::vector<int> depths;
+    for (auto const& record : records)
+        depths.push_back(record.depth);
+    return depths;
+}
+}
+
+TEST(StartupPhaseTracker, records_phases_in_the_order_they_start)
+{
+    StartupPhaseTracker tracker;
+
+    tracker.phase("first");
+    tracker.phase("second");
+    tracker.phase("third");
+
+    EXPECT_THAT(names_of(tracker.records()), ElementsAre("first", "second", "third"));
+}
+
+TEST(StartupPhaseTracker, phase_duration_covers_the_time_it_is_in_progress)
+{
+    StartupPhaseTracker tracker;
+
+    {
+        auto const phase = tracker.phase("slow");
+        std::this_thread::sleep_for(10ms);
+    }
+
+    auto const records = tracker.records();
+    ASSERT_THAT(records.size(), Eq(1u));
+    EXPECT_THAT(records[0].duration, Ge(StartupPhaseTracker::Clock::duration{10ms}));
+}
+
+TEST(StartupPhaseTracker, phases_started_within_a_phase_are_nested)
+{
+    StartupPhaseTracker tracker;
+
+    {
+        auto const outer = tracker.phase("outer");
+        {
+            auto const inner = tracker.phase("inner");
+            tracker.phase("innermost");
+        }
+        tracker.phase("sibling of inner");
+    }
+    tracker.phase("after outer");
+
+    EXPECT_THAT(depths_of(tracker.records()), ElementsAre(0, 1, 2, 1, 0));
+}
+
+TEST(StartupPhaseTracker, phases_on_another_thread_are_not_nested_in_this_threads_phases)
+{
+    StartupPhaseTracker tracker;
+
+    auto const outer = tracker.phase("outer");
+    std::thread{[&] { tracker.phase("elsewhere"); }}.join();
+
+    EXPECT_THAT(depths_of(tracker.records()), ElementsAre(0, 0));
+}
+
+TEST(StartupPhaseTracker, phase_ending_on_another_thread_does_not_affect_later_nesting)
+{
+    StartupPhaseTracker tracker;
+
+    auto handed_over = tracker.phase("handed over");
+    std::thread{[&] { handed_over.reset(); tracker.phase("on the other thread"); }}.join();
+    tracker.phase("back on this thread");
+
+    EXPECT_THAT(depths_of(tracker.records()), ElementsAre(0, 0, 0));
+}
+
+TEST(StartupPhaseTracker, records_phases_from_concurrent_threads)
+{
+    StartupPhaseTracker tracker;
+    auto const phases_per_thread = 100;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i != 4; ++i)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                for (auto j = 0; j != phases_per_thread; ++j)
+                {
+                    auto const outer = tracker.phase("outer");
+                    tracker.phase("inner");
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    auto const depths = depths_of(tracker.records());
+    EXPECT_THAT(depths.size(), Eq(4u * 2 * phases_per_thread));
+    EXPECT_THAT(depths, Each(AllOf(Ge(0), Le(1))));
+    EXPECT_THAT(std::count(begin(depths), end(depths), 1), Eq(4 * phases_per_thread));
+}
@@ -0,0 +1,438 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/linux_dmabuf.h"
+#include "src/wayland/generated/linux-dmabuf-unstable-v1_wrapper.h"
+
+#include "mir/test/doubles/mock_egl.h"
+#include "mir/test/doubles/mock_gl.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <wayland-client.h>
+#include <wayland-server-core.h>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <limits>
+
+namespace mf = mir::frontend;
+namespace mw = mir::wayland;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+using namespace testing;
+
+namespace mir
+{
+namespace wayland
+{
+extern struct wl_interface const wl_buffer_interface_data;
+extern struct wl_interface const zwp_linux_buffer_params_v1_interface_data;
+extern struct wl_interface const zwp_linux_dmabuf_v1_interface_data;
+}
+}
+
+namespace
+{
+uint32_t const drm_format_argb8888 = 0x34325241;    // 'AR24'
+uint32_t const drm_format_nv12 = 0x3231564e;        // 'NV12'
+uint64_t const drm_format_mod_linear = 0;
+uint64_t const i915_format_mod_x_tiled = 0x0100000000000001ull;
+
+int const width = 4;
+int const height = 3;
+uint32_t const stride = 32;     // padded beyond width × 4 bytes
+uint32_t const offset = 64;
+
+/* A plain memory dmabuf stand-in, as udmabuf would export, so no GPU is needed.
+ * The fd is mapped by the test to play the part of the client drawing into it.
+ */
+struct LinuxDmaBuf : Test
+{
+    LinuxDmaBuf() :
+        fd{mir::IntOwnedFd{static_cast<int>(syscall(SYS_memfd_create, "test-dmabuf", 0))}}
+    {
+        EXPECT_THAT(ftruncate(fd, length), Eq(0));
+        pixels = static_cast<unsigned char*>(mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    }
+
+    ~LinuxDmaBuf()
+    {
+        munmap(pixels, length);
+    }
+
+    void client_draws(unsigned char value)
+    {
+        memset(pixels + offset, value, stride * height);
+    }
+
+    auto an_image() -> std::shared_ptr<mf::DmaBufImage>
+    {
+        return std::make_shared<mf::DmaBufImage>(mf::DmaBufAttributes{
+            geom::Size{width, height}, drm_format_argb8888, 0, {{fd, offset, stride, drm_format_mod_linear}}});
+    }
+
+    size_t const length = offset + stride * height;
+    mir::Fd const fd;
+    unsigned char* pixels;
+
+    std::function<void()> const do_nothing = []{};
+};
+
+struct LinuxDmaBufImport : LinuxDmaBuf
+{
+    LinuxDmaBufImport()
+    {
+        mock_egl.provide_egl_extensions();
+    }
+
+    void egl_supports_modifiers()
+    {
+        ON_CALL(mock_egl, eglQueryString(_, EGL_EXTENSIONS))
+            .WillByDefault(Return("EGL_EXT_image_dma_buf_import EGL_EXT_image_dma_buf_import_modifiers"));
+    }
+
+    NiceMock<mtd::MockEGL> mock_egl;
+    NiceMock<mtd::MockGL> mock_gl;
+};
+
+MATCHER(DescribesAModifier, "")
+{
+    for (auto attr = arg; *attr != EGL_NONE; attr += 2)
+    {
+        if (*attr == EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT || *attr == EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT)
+            return true;
+    }
+    return false;
+}
+
+// Client request opcodes, in the order the protocol declares them
+uint32_t const create_params_opcode = 1;
+uint32_t const add_opcode = 1;
+uint32_t const create_opcode = 2;
+uint32_t const create_immed_opcode = 3;
+
+uint32_t const no_error = std::numeric_limits<uint32_t>::max();
+
+/* A client of the zwp_linux_dmabuf_v1 global, connected over a socketpair and run on the
+ * test thread along with the server. There's no client side protocol code, so requests are
+ * marshalled directly.
+ */
+struct LinuxBufferParams : Test
+{
+    LinuxBufferParams() :
+        server{wl_display_create()},
+        linux_dmabuf_global{mf::create_linux_dmabuf_unstable_v1(server)},
+        fd{mir::IntOwnedFd{static_cast<int>(syscall(SYS_memfd_create, "test-dmabuf", 0))}}
+    {
+        EXPECT_THAT(ftruncate(fd, length), Eq(0));
+
+        int sockets[2];
+        EXPECT_THAT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets), Eq(0));
+        wl_client_create(server, sockets[0]);
+        client = wl_display_connect_to_fd(sockets[1]);
+
+        auto const registry = wl_display_get_registry(client);
+        wl_registry_add_listener(registry, &registry_listener, this);
+        exchange_messages();
+        wl_registry_destroy(registry);
+
+        params = wl_proxy_marshal_constructor(
+            linux_dmabuf, create_params_opcode, &mw::zwp_linux_buffer_params_v1_interface_data, nullptr);
+    }
+
+    ~LinuxBufferParams()
+    {
+        wl_proxy_destroy(params);
+        wl_proxy_destroy(linux_dmabuf);
+        wl_display_disconnect(client);
+
+        linux_dmabuf_global.reset();
+        wl_display_destroy(server);
+    }
+
+    void add_plane(
+        uint32_t plane_idx,
+        uint32_t plane_stride = stride,
+        uint32_t plane_offset = offset,
+        uint64_t modifier = drm_format_mod_linear)
+    {
+        wl_proxy_marshal(
+            params, add_opcode, static_cast<int>(fd), plane_idx, plane_offset, plane_stride,
+            static_cast<uint32_t>(modifier >> 32), static_cast<uint32_t>(modifier));
+    }
+
+    void create(int32_t buffer_width, int32_t buffer_height, uint32_t format = drm_format_argb8888)
+    {
+        wl_proxy_marshal(params, create_opcode, buffer_width, buffer_height, format, 0u);
+    }
+
+    void create_immed(int32_t buffer_width, int32_t buffer_height, uint32_t format = drm_format_argb8888)
+    {
+        wl_proxy_destroy(wl_proxy_marshal_constructor(
+            params, create_immed_opcode, &mw::wl_buffer_interface_data,
+            nullptr, buffer_width, buffer_height, format, 0u));
+    }
+
+    /// The error the server posted on the params, or no_error
+    auto params_error() -> uint32_t
+    {
+        exchange_messages();
+
+        wl_interface const* interface{nullptr};
+        uint32_t id{0};
+        auto const code = wl_display_get_protocol_error(client, &interface, &id);
+
+        return interface == &mw::zwp_linux_buffer_params_v1_interface_data ? code : no_error;
+    }
+
+    // Delivers the client's requests, then the server's replies (which include at least the sync)
+    void exchange_messages()
+    {
+        wl_callback_destroy(wl_display_sync(client));
+        wl_display_flush(client);
+
+        wl_event_loop_dispatch(wl_display_get_event_loop(server), 5000);
+        wl_display_flush_clients(server);
+
+        wl_display_dispatch(client);
+    }
+
+    static void global(void* data, wl_registry* registry, uint32_t name, char const* interface, uint32_t version)
+    {
+        if (strcmp(interface, mw::zwp_linux_dmabuf_v1_interface_data.name) == 0)
+        {
+            static_cast<LinuxBufferParams*>(data)->linux_dmabuf = static_cast<wl_proxy*>(
+                wl_registry_bind(registry, name, &mw::zwp_linux_dmabuf_v1_interface_data, version));
+        }
+    }
+
+    static void global_remove(void*, wl_registry*, uint32_t)
+    {
+    }
+
+    wl_display* const server;
+    std::shared_ptr<mf::LinuxDmaBufUnstableV1> linux_dmabuf_global;
+
+    size_t const length = offset + stride * height;
+    mir::Fd const fd;
+
+    wl_registry_listener const registry_listener{&global, &global_remove};
+    wl_display* client{nullptr};
+    wl_proxy* linux_dmabuf{nullptr};
+    wl_proxy* params{nullptr};
+};
+}
+
+TEST_F(LinuxDmaBuf, buffer_has_the_attributes_of_the_dmabuf)
+{
+    mf::DmaBufBuffer buffer{an_image(), std::function<void()>{do_nothing}, std::function<void()>{do_nothing}};
+
+    EXPECT_THAT(buffer.size(), Eq(geom::Size{width, height}));
+    EXPECT_THAT(buffer.pixel_format(), Eq(mir_pixel_format_argb_8888));
+    EXPECT_THAT(buffer.stride(), Eq(geom::Stride{stride}));
+}
+
+TEST_F(LinuxDmaBuf, reading_a_buffer_reads_the_client_memory_without_a_copy)
+{
+    auto const image = an_image();
+    mf::DmaBufBuffer first{image, std::function<void()>{do_nothing}, std::function<void()>{do_nothing}};
+
+    client_draws(0x11);
+    first.read([](unsigned char const* data) { EXPECT_THAT(data[0], Eq(0x11)); });
+
+    // Later commits of the same wl_buffer see what the client has drawn since
+    client_draws(0x22);
+    mf::DmaBufBuffer second{image, std::function<void()>{do_nothing}, std::function<void()>{do_nothing}};
+    second.read(
+        [](unsigned char const* data)
+        {
+            EXPECT_THAT(data[0], Eq(0x22));
+            EXPECT_THAT(data[stride * height - 1], Eq(0x22));
+        });
+}
+
+TEST_F(LinuxDmaBuf, buffer_is_consumed_once_and_released_on_destruction)
+{
+    int consumed{0};
+    int released{0};
+
+    {
+        mf::DmaBufBuffer buffer{an_image(), [&]{ ++consumed; }, [&]{ ++released; }};
+        EXPECT_THAT(consumed, Eq(0));
+
+        buffer.read([](unsigned char const*) {});
+        buffer.read([](unsigned char const*) {});
+        EXPECT_THAT(consumed, Eq(1));
+        EXPECT_THAT(released, Eq(0));
+    }
+
+    EXPECT_THAT(released, Eq(1));
+}
+
+TEST_F(LinuxDmaBufImport, linear_buffer_is_imported_without_a_modifier_if_egl_cannot_take_one)
+{
+    EXPECT_CALL(mock_egl, eglCreateImageKHR(_, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, _, Not(DescribesAModifier())));
+    EXPECT_CALL(mock_gl, glTexImage2D(_, _, _, _, _, _, _, _, _)).Times(0);
+
+    an_image()->bind_to_texture();
+}
+
+TEST_F(LinuxDmaBufImport, modifier_is_imported_if_egl_can_take_one)
+{
+    egl_supports_modifiers();
+
+    EXPECT_CALL(mock_egl, eglCreateImageKHR(_, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, _, DescribesAModifier()));
+
+    an_image()->bind_to_texture();
+}
+
+TEST_F(LinuxDmaBufImport, linear_buffer_is_mapped_if_the_import_fails)
+{
+    auto const image = an_image();
+
+    // The import isn't retried, but the padded rows are uploaded on every bind
+    EXPECT_CALL(mock_egl, eglCreateImageKHR(_, _, _, _, _)).WillOnce(Return(EGL_NO_IMAGE_KHR));
+    EXPECT_CALL(mock_gl, glTexSubImage2D(GL_TEXTURE_2D, 0, 0, _, width, 1, _, _, _)).Times(2 * height);
+
+    image->bind_to_texture();
+    image->bind_to_texture();
+}
+
+TEST_F(LinuxBufferParams, complete_params_create_a_buffer)
+{
+    add_plane(0);
+    create_immed(width, height);
+
+    EXPECT_THAT(params_error(), Eq(no_error));
+}
+
+TEST_F(LinuxBufferParams, creating_a_second_buffer_is_an_error)
+{
+    add_plane(0);
+    create(width, height);
+    create(width, height);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::already_used));
+}
+
+TEST_F(LinuxBufferParams, adding_a_plane_after_creating_a_buffer_is_an_error)
+{
+    add_plane(0);
+    create_immed(width, height);
+    add_plane(1);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::already_used));
+}
+
+TEST_F(LinuxBufferParams, plane_index_beyond_the_last_plane_is_an_error)
+{
+    add_plane(4);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::plane_idx));
+}
+
+TEST_F(LinuxBufferParams, setting_a_plane_twice_is_an_error)
+{
+    add_plane(0);
+    add_plane(0);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::plane_set));
+}
+
+TEST_F(LinuxBufferParams, unsupported_format_is_an_error)
+{
+    add_plane(0);
+    create_immed(width, height, drm_format_nv12);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::invalid_format));
+}
+
+TEST_F(LinuxBufferParams, missing_the_first_plane_is_an_error)
+{
+    add_plane(1);
+    create_immed(width, height);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::incomplete));
+}
+
+TEST_F(LinuxBufferParams, planes_beyond_those_of_the_format_are_an_error)
+{
+    add_plane(0);
+    add_plane(1);
+    create_immed(width, height);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::incomplete));
+}
+
+TEST_F(LinuxBufferParams, empty_size_is_an_error)
+{
+    add_plane(0);
+    create_immed(0, height);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::invalid_dimensions));
+}
+
+TEST_F(LinuxBufferParams, stride_narrower_than_a_row_is_an_error)
+{
+    add_plane(0, width * 4 - 1);
+    create_immed(width, height);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::out_of_bounds));
+}
+
+TEST_F(LinuxBufferParams, buffer_extending_beyond_the_dmabuf_is_an_error)
+{
+    add_plane(0, stride, offset + 1);
+    create_immed(width, height);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::out_of_bounds));
+}
+
+TEST_F(LinuxBufferParams, unsupported_modifier_is_an_error)
+{
+    add_plane(0, stride, offset, i915_format_mod_x_tiled);
+    create_immed(width, height);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::invalid_format));
+}
+
+TEST_F(LinuxBufferParams, row_wider_than_32_bits_is_an_error)
+{
+    // (width × 4 bytes) wraps to 4 in 32 bits
+    add_plane(0, stride, 0);
+    create_immed(0x40000001, 1);
+
+    EXPECT_THAT(params_error(), Eq(mw::LinuxBufferParamsV1::Error::out_of_bounds));
+}
+
+TEST_F(LinuxBufferParams, checking_the_size_leaves_the_client_file_offset_alone)
+{
+    off_t const client_offset = 7;
+    ASSERT_THAT(lseek(fd, client_offset, SEEK_SET), Eq(client_offset));
+
+    add_plane(0);
+    create_immed(width, height);
+
+    ASSERT_THAT(params_error(), Eq(no_error));
+    EXPECT_THAT(lseek(fd, 0, SEEK_CUR), Eq(client_offset));
+}